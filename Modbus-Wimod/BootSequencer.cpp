@@ -0,0 +1,120 @@
+/*
+ * BootSequencer.cpp
+ *
+ * Implementation of the fast boot sequencer.
+ * see BootSequencer.h for details.
+ */
+
+#include "BootSequencer.h"
+
+#include <string.h>
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Constructor
+ *
+ * @param wimod  LoRaWAN modem; begin() must have been called
+ * @param log    output for the progress messages
+ */
+BootSequencer::BootSequencer(WiMODLoRaWAN& wimod, Print& log) :
+  wimod(wimod),
+  log(log)
+{
+  memset(&timing, 0x00, sizeof(timing));
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Bring the modem into a state where uplinks can be sent
+ *
+ * @param radioCfg         radio config to apply
+ * @param activationData   ABP parameters; only sent for a full activation
+ * @param forceActivation  true: always do a full ABP activation
+ *                         (e.g. after the keys have been changed)
+ */
+TBootResult BootSequencer::run(TWiMODLORAWAN_RadioStackConfig& radioCfg,
+                               TWiMODLORAWAN_ActivateDeviceData& activationData,
+                               bool forceActivation)
+{
+  TWiMODLORAWAN_NwkStatus_Data nwkStatus;
+  TBootResult                  result;
+  uint32_t                     start = micros();
+  uint32_t                     t     = start;
+  uint32_t                     devAddr;
+
+  memset(&timing, 0x00, sizeof(timing));
+
+  // phase 1: network status; proves the serial link as well
+  if (!wimod.GetNwkStatus(&nwkStatus)) {
+    timing.StatusUs = micros() - t;
+    timing.TotalUs  = timing.StatusUs;
+    log.println(F("Boot: no response from modem"));
+    return BootResult_NoModem;
+  }
+  timing.StatusUs = micros() - t;
+
+  // phase 2: radio config; unchanged settings are not written
+  t = micros();
+  if (!wimod.SetRadioStackConfig(&radioCfg)) {
+    log.print(F("Boot: radio config failed: "));
+    log.println((int) wimod.GetLastResponseStatus());
+  }
+  timing.ConfigUs = micros() - t;
+
+  // phase 3: session
+  t = micros();
+  if (!forceActivation
+      && (nwkStatus.NetworkStatus == LORAWAN_NWK_STATUS_ACTIVE_ABP)
+      && (nwkStatus.DeviceAddress == activationData.DeviceAddress)) {
+    result = BootResult_Resumed;
+  } else if (!forceActivation
+             && (nwkStatus.NetworkStatus == LORAWAN_NWK_SATUS_INACTIVE)
+             && wimod.ReactivateDevice(&devAddr)
+             && (devAddr == activationData.DeviceAddress)) {
+    // stored session of the module; frame counters are continued
+    result = BootResult_Reactivated;
+  } else if (wimod.ActivateDevice(activationData)) {
+    result = BootResult_Activated;
+  } else {
+    log.print(F("Boot: ABP activation failed: "));
+    log.println((int) wimod.GetLastResponseStatus());
+    result = BootResult_Failed;
+  }
+  timing.ActivateUs = micros() - t;
+  timing.TotalUs    = micros() - start;
+
+  log.print(F("Boot: "));
+  log.println(resultName(result));
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Print the phase durations
+ */
+void BootSequencer::printTiming(void) const
+{
+  log.print(F("Boot timing [us]: status "));
+  log.print(timing.StatusUs);
+  log.print(F(", config "));
+  log.print(timing.ConfigUs);
+  log.print(F(", activation "));
+  log.print(timing.ActivateUs);
+  log.print(F(", total "));
+  log.println(timing.TotalUs);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Printable name of a boot result
+ */
+const __FlashStringHelper* BootSequencer::resultName(TBootResult result)
+{
+  switch (result) {
+    case BootResult_Resumed:      return F("session resumed");
+    case BootResult_Reactivated:  return F("session reactivated");
+    case BootResult_Activated:    return F("ABP activation done");
+    case BootResult_NoModem:      return F("no modem");
+    default:                      return F("failed");
+  }
+}
@@ -0,0 +1,81 @@
+/*
+ * BootSequencer.h
+ *
+ * Fast start of the LoRaWAN modem after a reset of the host.
+ *
+ * The WiMOD keeps its ABP session (DevAddr, keys, frame counters) over a
+ * reset of the host and stores it in its NVM over a reset of the module.
+ * Instead of tearing the session down and rebuilding it on every boot the
+ * sequencer
+ *
+ *  1. queries the network status (also proves the serial link)
+ *  2. applies the radio config; the config cache of WiMODLoRaWAN skips
+ *     the write if nothing changed
+ *  3. keeps an active session with the expected DevAddr, else tries to
+ *     reactivate the stored session, else does a full ABP activation
+ *
+ * The HCI allows only one outstanding request, so the requests cannot be
+ * pipelined; they are issued back to back without delays instead. Every
+ * phase is timed.
+ */
+
+#ifndef MODBUS_WIMOD_BOOTSEQUENCER_H_
+#define MODBUS_WIMOD_BOOTSEQUENCER_H_
+
+#include <Arduino.h>
+#include <WiMODLoRaWAN.h>
+
+//-----------------------------------------------------------------------------
+// user defined types
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Result of a boot sequence
+ */
+typedef enum TBootResult
+{
+  BootResult_Resumed = 0,         /*!< session still active; nothing sent */
+  BootResult_Reactivated,         /*!< stored session restored by ReactivateDevice */
+  BootResult_Activated,           /*!< new ABP activation */
+  BootResult_NoModem,             /*!< no response from the modem */
+  BootResult_Failed,              /*!< activation failed */
+} TBootResult;
+
+/**
+ * @brief Duration of the boot phases in us
+ */
+typedef struct TBootTiming
+{
+  uint32_t  StatusUs;             /*!< GetNwkStatus */
+  uint32_t  ConfigUs;             /*!< SetRadioStackConfig (incl. cache fill) */
+  uint32_t  ActivateUs;           /*!< ReactivateDevice / ActivateDevice */
+  uint32_t  TotalUs;              /*!< whole sequence */
+} TBootTiming;
+
+//-----------------------------------------------------------------------------
+// class declaration
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Boot sequencer for an ABP end node
+ */
+class BootSequencer {
+public:
+  BootSequencer(WiMODLoRaWAN& wimod, Print& log);
+
+  TBootResult run(TWiMODLORAWAN_RadioStackConfig& radioCfg,
+                  TWiMODLORAWAN_ActivateDeviceData& activationData,
+                  bool forceActivation = false);
+
+  const TBootTiming& getTiming(void) const { return timing; }
+  void        printTiming(void) const;
+
+  static const __FlashStringHelper* resultName(TBootResult result);
+
+private:
+  WiMODLoRaWAN&       wimod;
+  Print&              log;
+  TBootTiming         timing;
+};
+
+#endif /* MODBUS_WIMOD_BOOTSEQUENCER_H_ */
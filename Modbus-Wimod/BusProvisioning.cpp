@@ -0,0 +1,238 @@
+/*
+ * BusProvisioning.cpp
+ *
+ * Implementation of the XY-MD02 bus provisioning.
+ * see BusProvisioning.h for details.
+ */
+
+#include "BusProvisioning.h"
+
+//-----------------------------------------------------------------------------
+// local defines
+//-----------------------------------------------------------------------------
+
+/** baud rates supported by the XY-MD02; index = register value */
+static const uint32_t XYMD02_BAUDS[] = { 9600, 14400, 19200 };
+
+#define XYMD02_NUM_BAUDS            (sizeof(XYMD02_BAUDS) / sizeof(XYMD02_BAUDS[0]))
+
+/** time for the sensors to apply a new setting */
+#define SETTLE_TIME_MS              100
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Constructor
+ *
+ * @param baud  baud rate the bus is currently running at
+ * @param log   output for the provisioning report
+ */
+BusProvisioner::BusProvisioner(ModbusMaster& node, HardwareSerial& port, uint32_t baud, Print& log)
+  : node(node), port(port), log(log)
+{
+  this->baud = baud;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Search sensors in an address range at the current baud rate
+ *
+ * Every absent address costs one Modbus response timeout.
+ *
+ * @return number of sensors found
+ */
+uint8_t BusProvisioner::discover(uint8_t firstID, uint8_t lastID, uint8_t* ids, uint8_t maxIds)
+{
+  uint8_t  n = 0;
+  uint16_t value;
+
+  for (uint16_t id = firstID; (id <= lastID) && (n < maxIds); id++) {
+    if (readRegister((uint8_t) id, XYMD02_REG_ADDRESS, &value)) {
+      log.print(F("Found sensor "));
+      log.print(id);
+      log.print(F(" @ "));
+      log.println(baud);
+      ids[n++] = (uint8_t) id;
+    }
+  }
+  return n;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Change the slave address of a sensor and verify it
+ *
+ * The new address must not be in use; only one sensor may answer to oldID.
+ */
+bool BusProvisioner::setAddress(uint8_t oldID, uint8_t newID)
+{
+  uint16_t value;
+
+  if ((newID == 0) || (newID > 247)) {
+    return false;
+  }
+
+  node.begin(oldID, port);
+  if (node.writeSingleRegister(XYMD02_REG_ADDRESS, newID) != node.ku8MBSuccess) {
+    return false;
+  }
+  delay(SETTLE_TIME_MS);
+
+  if (!readRegister(newID, XYMD02_REG_ADDRESS, &value) || (value != newID)) {
+    log.print(F("Address change not verified: "));
+    log.println(oldID);
+    return false;
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Raise all given sensors to the highest stable baud rate
+ *
+ * The candidates are tried from the highest baud rate downwards. A baud
+ * rate is taken over if all sensors read back the new register value at the
+ * new baud rate and answer all test transactions. Otherwise the sensors are
+ * set back and the next lower baud rate is tried.
+ *
+ * @return the baud rate the bus runs at afterwards
+ */
+uint32_t BusProvisioner::raiseBaud(const uint8_t* ids, uint8_t numIds)
+{
+  int8_t oldCode = baudToCode(baud);
+  int8_t code;
+
+  if ((oldCode < 0) || (numIds == 0)) {
+    return baud;
+  }
+
+  for (code = XYMD02_NUM_BAUDS - 1; code > oldCode; code--) {
+    uint32_t oldBaud = baud;
+
+    log.print(F("Trying "));
+    log.println(XYMD02_BAUDS[code]);
+
+    writeBaud(ids, numIds, (uint8_t) code);
+    switchMaster(XYMD02_BAUDS[code]);
+
+    if (verifyBaud(ids, numIds, (uint8_t) code) && isStable(ids, numIds)) {
+      log.print(F("Bus running at "));
+      log.println(baud);
+      return baud;
+    }
+
+    // set all sensors back; sensors that still run at the old baud rate
+    // (power cycle needed) are set back at the old baud rate
+    log.println(F("Not stable or power cycle needed; reverting"));
+    writeBaud(ids, numIds, (uint8_t) oldCode);
+    switchMaster(oldBaud);
+    writeBaud(ids, numIds, (uint8_t) oldCode);
+  }
+  return baud;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Average time of a data read transaction in us
+ *
+ * @return 0 if no transaction succeeded
+ */
+uint32_t BusProvisioner::measureTransactionUs(uint8_t id, uint8_t count)
+{
+  uint32_t sum = 0;
+  uint8_t  ok  = 0;
+
+  node.begin(id, port);
+  for (uint8_t i = 0; i < count; i++) {
+    uint32_t start = micros();
+    if (node.readInputRegisters(XYMD02_REG_DATA, 2) == node.ku8MBSuccess) {
+      sum += micros() - start;
+      ok++;
+    }
+  }
+  return ok ? (sum / ok) : 0;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Register value for a baud rate; -1 if not supported
+ */
+int8_t BusProvisioner::baudToCode(uint32_t baud)
+{
+  for (uint8_t i = 0; i < XYMD02_NUM_BAUDS; i++) {
+    if (XYMD02_BAUDS[i] == baud) {
+      return (int8_t) i;
+    }
+  }
+  return -1;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Baud rate of a register value; 0 if unknown
+ */
+uint32_t BusProvisioner::codeToBaud(uint8_t code)
+{
+  return (code < XYMD02_NUM_BAUDS) ? XYMD02_BAUDS[code] : 0;
+}
+
+//-----------------------------------------------------------------------------
+// private functions
+//-----------------------------------------------------------------------------
+
+void BusProvisioner::writeBaud(const uint8_t* ids, uint8_t numIds, uint8_t code)
+{
+  // no check of the result: a sensor that switches immediately may not
+  // answer at the old baud rate anymore
+  for (uint8_t i = 0; i < numIds; i++) {
+    node.begin(ids[i], port);
+    node.writeSingleRegister(XYMD02_REG_BAUD, code);
+    delay(SETTLE_TIME_MS);
+  }
+}
+
+bool BusProvisioner::verifyBaud(const uint8_t* ids, uint8_t numIds, uint8_t code)
+{
+  uint16_t value;
+
+  for (uint8_t i = 0; i < numIds; i++) {
+    if (!readRegister(ids[i], XYMD02_REG_BAUD, &value) || (value != code)) {
+      log.print(F("Baud readback failed: "));
+      log.println(ids[i]);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool BusProvisioner::isStable(const uint8_t* ids, uint8_t numIds)
+{
+  for (uint8_t i = 0; i < numIds; i++) {
+    node.begin(ids[i], port);
+    for (uint8_t n = 0; n < BUS_PROV_TEST_TRANSACTIONS; n++) {
+      if (node.readInputRegisters(XYMD02_REG_DATA, 2) != node.ku8MBSuccess) {
+        log.print(F("No answer at new baud: "));
+        log.println(ids[i]);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool BusProvisioner::readRegister(uint8_t id, uint16_t reg, uint16_t* value)
+{
+  node.begin(id, port);
+  if (node.readHoldingRegisters(reg, 1) != node.ku8MBSuccess) {
+    return false;
+  }
+  *value = node.getResponseBuffer(0);
+  return true;
+}
+
+void BusProvisioner::switchMaster(uint32_t newBaud)
+{
+  port.flush();
+  port.updateBaudRate(newBaud);
+  baud = newBaud;
+  delay(SETTLE_TIME_MS);
+}
@@ -0,0 +1,78 @@
+/*
+ * BusProvisioning.h
+ *
+ * Provisioning of XY-MD02 sensors on the RS485 bus.
+ *
+ * - discover sensors in an address range
+ * - assign a new slave address (holding register 0x0101)
+ * - raise all sensors to the highest baud rate that works stable
+ *   (holding register 0x0102), verify the readback and switch the master
+ *   UART over
+ * - measure the time per Modbus transaction before and after
+ *
+ * Some sensors only take over a new baud rate after a power cycle. Those
+ * are detected when they do not answer at the new baud rate; in that case
+ * all sensors are set back to the previous baud rate and the master stays
+ * at the old baud rate. Power cycle the sensors and run the provisioning
+ * again if the bus was reverted.
+ */
+
+#ifndef MODBUS_WIMOD_BUSPROVISIONING_H_
+#define MODBUS_WIMOD_BUSPROVISIONING_H_
+
+#include <Arduino.h>
+#include <ModbusMaster.h>
+#include <HardwareSerial.h>
+
+//-----------------------------------------------------------------------------
+// common defines
+//-----------------------------------------------------------------------------
+
+/** XY-MD02 holding registers */
+#define XYMD02_REG_ADDRESS          0x0101
+#define XYMD02_REG_BAUD             0x0102
+
+/** XY-MD02 input register holding temperature and humidity */
+#define XYMD02_REG_DATA             0x0001
+
+/** max. number of sensors handled in one provisioning run */
+#define BUS_PROV_MAX_SENSORS        16
+
+/** number of transactions used to check a baud rate / measure timing */
+#define BUS_PROV_TEST_TRANSACTIONS  10
+
+//-----------------------------------------------------------------------------
+// class declaration
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Discovers and reconfigures XY-MD02 sensors
+ */
+class BusProvisioner {
+public:
+  BusProvisioner(ModbusMaster& node, HardwareSerial& port, uint32_t baud, Print& log);
+
+  uint8_t   discover(uint8_t firstID, uint8_t lastID, uint8_t* ids, uint8_t maxIds);
+  bool      setAddress(uint8_t oldID, uint8_t newID);
+  uint32_t  raiseBaud(const uint8_t* ids, uint8_t numIds);
+  uint32_t  measureTransactionUs(uint8_t id, uint8_t count);
+
+  uint32_t  getBaud(void) const { return baud; }
+
+  static int8_t   baudToCode(uint32_t baud);
+  static uint32_t codeToBaud(uint8_t code);
+
+private:
+  void      writeBaud(const uint8_t* ids, uint8_t numIds, uint8_t code);
+  bool      verifyBaud(const uint8_t* ids, uint8_t numIds, uint8_t code);
+  bool      isStable(const uint8_t* ids, uint8_t numIds);
+  bool      readRegister(uint8_t id, uint16_t reg, uint16_t* value);
+  void      switchMaster(uint32_t newBaud);
+
+  ModbusMaster&       node;
+  HardwareSerial&     port;
+  Print&              log;
+  uint32_t            baud;
+};
+
+#endif /* MODBUS_WIMOD_BUSPROVISIONING_H_ */
@@ -1,6 +1,14 @@
 #include <ModbusMaster.h>
 #include "FreeRTOS.h"
 #include <WiMODLoRaWAN.h>
+#include "ReportByException.h"
+#include "SlaveHealth.h"
+#include "SampleAggregator.h"
+#include "SampleLog.h"
+#include "BusProvisioning.h"
+#include "BootSequencer.h"
+#include "RemoteConfig.h"
+#include <Preferences.h>
 #ifndef HAVE_HW_SERIAL1
 #include <HardwareSerial.h>
 HardwareSerial mySerial(1); //
@@ -23,13 +31,90 @@ struct Meter
 
 Meter meter ;
 
+// uplink channels in the order of the legacy payload
+#define CH_TEMP1      0
+#define CH_TEMP2      1
+#define CH_HUM1       2
+#define CH_HUM2       3
+#define NUM_CHANNELS  4
+
+// report-by-exception: temperature in 0.1 degC, humidity in 0.1 %RH
+#define HEARTBEAT_MS  (15UL * 60UL * 1000UL)
+
+const TReportChannelCfg RBE_CFG[NUM_CHANNELS] = {
+  // AbsDeadband, RelDeadband, HeartbeatMs
+  {  3, 0, HEARTBEAT_MS },  // CH_TEMP1: 0.3 degC
+  {  3, 0, HEARTBEAT_MS },  // CH_TEMP2: 0.3 degC
+  { 20, 0, HEARTBEAT_MS },  // CH_HUM1:  2.0 %RH
+  { 20, 0, HEARTBEAT_MS },  // CH_HUM2:  2.0 %RH
+};
+
+ReportByException rbe(RBE_CFG, NUM_CHANNELS);
+
+// local sensor sample rate; uplinks summarize all samples since the last uplink
+#define SAMPLE_INTERVAL_MS 2000UL
+// summary uplink rate
+#define UPLINK_INTERVAL_MS 30000UL
+// bus idle time between two slaves
+#define MODBUS_GAP_MS      50
+
+SlaveHealthTracker health(SAMPLE_INTERVAL_MS);
+SampleAggregator   agg(NUM_CHANNELS);
+
+// store-and-forward log for summaries that could not be sent
+#if defined(ARDUINO_ARCH_ESP32)
+SampleLogNvsStorage  logStorage("samplelog");
+#elif defined(__linux__)
+SampleLogFileStorage logStorage("samplelog.bin");
+#endif
+SampleLog            sampleLog(logStorage);
+
+// backfill: 1% duty cycle, max. 10 s airtime saved up, 1 s kept for live uplinks
+#define BACKFILL_DUTY_CYCLE_PERMILLE  10
+#define BACKFILL_BATCH_SIZE           3
+#define ACTIVATE_RETRY_MS             (5UL * 60UL * 1000UL)
+// network time is requested again after this interval to bound the drift
+#define TIME_SYNC_INTERVAL_MS         (6UL * 60UL * 60UL * 1000UL)
+// uplink slots: clock error between the nodes, collisions before a new slot
+#define UPLINK_SLOT_GUARD_MS          100
+#define UPLINK_SLOT_COLLISIONS        2
+// Class C after a downlink (follow-up commands of a config session)
+#define CLASS_C_WINDOW_MS             (2UL * 60UL * 1000UL)
+
+BackfillScheduler  backfill(BACKFILL_DUTY_CYCLE_PERMILLE, 10000, 1000);
+
 #if defined(ARDUINO_ARCH_AVR)
 #include <avr/pgmspace.h>
 #endif
 #define SERIAL1_RXPIN 23
 #define SERIAL1_TXPIN 19
+#define ID_First  3
 #define ID_Add  4
+// RS485 bus speed; raised by the bus provisioning and kept in NVS
+#define BUS_BAUD_DEFAULT      9600
+// address range scanned by the bus provisioning
+#define PROV_SCAN_LAST        16
+// time window after reset to enter the bus provisioning via debug serial ('p')
+#define PROV_PROMPT_MS        3000
 #define data_    0x0001
+
+// defaults of the remotely configurable parameters; overridden by NVS / downlinks
+TRuntimeConfig defaultRuntimeConfig()
+{
+  TRuntimeConfig cfg;
+
+  memset(&cfg, 0x00, sizeof(cfg));
+  cfg.SampleIntervalMs = SAMPLE_INTERVAL_MS;
+  cfg.UplinkIntervalMs = UPLINK_INTERVAL_MS;
+  cfg.SlaveIDs[0]      = ID_First;
+  cfg.SlaveIDs[1]      = ID_Add;
+  cfg.DataRateIndex    = RCFG_DATA_RATE_UNCHANGED;
+  cfg.NumChannels      = NUM_CHANNELS;
+  memcpy(cfg.Channels, RBE_CFG, sizeof(RBE_CFG));
+  return cfg;
+}
+
+RemoteConfig remoteCfg(defaultRuntimeConfig());
 //HardwareSerial MySerial(1);
 //-----------------------------------------------------------------------------
 // constant values
@@ -84,7 +169,19 @@ WiMODLoRaWAN wimod(mySerial);  // use the Arduino Serial3 as serial interface
 
 TRuntimeInfo RIB = {  };
 
-static uint32_t loopCnt = 0;
+// next sample / summary slot (millis); computed from the network aligned clock
+static uint32_t nextSampleTime = 0;
+static uint32_t nextSummaryTime = 0;
+static uint32_t timeSyncCount = 0;
+static uint32_t lastTimeRequest = 0;
+static uint32_t busBaud = BUS_BAUD_DEFAULT;
+static uint32_t lastActivateTime = 0;
+// airtime estimates; updated from the TX indications
+static uint32_t liveAirtimeMs = 100;
+static uint32_t backfillAirtimeMs = 200;
+static bool     lastTxWasBackfill = false;
+// send the first summary right after the first sample instead of waiting a full interval
+static bool     bootUplinkPending = true;
 static TWiMODLORAWAN_TX_Data txData;
 
 
@@ -126,12 +223,309 @@ void printStartMsg()
   debugMsg(F(__FILE__));
   debugMsg(F("\r\n"));
   debugMsg(F("Starting...\n"));
-  debugMsg(F("This simple demo will try to "));
-  debugMsg(F("do the ABP procedure and "));
-  debugMsg(F("send a demo message each 30 sec.\n"));
+  debugMsg(F("This demo samples the XY-MD02 sensors via Modbus, "));
+  debugMsg(F("joins via ABP and sends min/max/mean summaries "));
+  debugMsg(F("in its uplink slot (interval set by remote config).\n"));
   debugMsg(F("==================================================\n"));
 }
 
+/*****************************************************************************
+   configure the radio stack and activate the device via ABP
+ ****************************************************************************/
+void connectModem()
+{
+  lastActivateTime = millis();
+
+  //AS923 Thailand radio config variable
+  TWiMODLORAWAN_RadioStackConfig radioCfg;
+  // setup new config
+  radioCfg.DataRateIndex   = LoRaWAN_DataRate_AS923_LoRa_SF7_125kHz;
+  radioCfg.TXPowerLevel    = 16;
+  // Class A with power saving; the power policy switches to Class C on demand
+  radioCfg.Options         = // LORAWAN_STK_OPTION_ADR |
+    LORAWAN_STK_OPTION_EXT_PKT_FORMAT |
+    LORAWAN_STK_OPTION_MAC_CMD;   // forward MAC commands (DeviceTimeAns)
+  radioCfg.PowerSavingMode = LORAWAN_POWER_SAVING_MODE_AUTO;
+  radioCfg.Retransmissions = 7;
+  radioCfg.BandIndex       = LoRaWAN_FreqBand_AS_923_Thailand;
+  if (remoteCfg.get().DataRateIndex != RCFG_DATA_RATE_UNCHANGED) {
+    radioCfg.DataRateIndex = remoteCfg.get().DataRateIndex;
+  }
+
+  //setup ABP data
+  TWiMODLORAWAN_ActivateDeviceData activationData;
+  activationData.DeviceAddress = DEV_ADR;
+  memcpy(activationData.NwkSKey, NWKSKEY, 16);
+  memcpy(activationData.AppSKey, APPSKEY, 16);
+
+  // keep / restore the session of the module if possible
+  BootSequencer boot(wimod, Serial);
+  TBootResult   result = boot.run(radioCfg, activationData);
+  boot.printTiming();
+
+  if ((result == BootResult_Resumed)
+      || (result == BootResult_Reactivated)
+      || (result == BootResult_Activated)) {
+    RIB.ModemState = ModemState_Connected;
+    // spread the nodes over the slots by their DevAddr; the slots computed
+    // before the activation used the default seed
+    wimod.SetUplinkSchedulerSeed(DEV_ADR);
+    scheduleSlots();
+    // network time is delivered with the answer to the next uplink
+    wimod.RequestDeviceTime();
+    lastTimeRequest = millis();
+  } else {
+    RIB.ModemState = ModemState_FailedToConnect;
+  }
+}
+
+/*****************************************************************************
+   compute the next sample / summary slot from the network aligned clock
+ ****************************************************************************/
+void configureUplinkSlots()
+{
+  TWiMODLORAWAN_SchedulerConfig sched;
+
+  // one slot per uplink interval; wide enough for a full summary frame
+  sched.PeriodMs           = remoteCfg.get().UplinkIntervalMs;
+  sched.MaxPayloadLen      = AGG_HEADER_SIZE + NUM_CHANNELS * AGG_SUMMARY_SIZE + RCFG_ACK_SIZE;
+  sched.GuardMs            = UPLINK_SLOT_GUARD_MS;
+  sched.CollisionThreshold = UPLINK_SLOT_COLLISIONS;
+  wimod.SetUplinkSchedulerConfig(sched);
+}
+
+void scheduleSlots()
+{
+  uint32_t now = millis();
+
+  nextSampleTime  = now + wimod.GetMsUntilSlot(remoteCfg.get().SampleIntervalMs);
+  nextSummaryTime = now + wimod.GetMsUntilUplinkSlot();
+}
+
+/*****************************************************************************
+   power policy: Class A with power saving, Class C after a downlink or
+   during a maintenance session
+ ****************************************************************************/
+void servicePowerPolicy()
+{
+  bool changed = false;
+
+  if (!wimod.ApplyPowerPolicy(&changed)) {
+    debugMsg(F("Device class change failed\n"));
+    return;
+  }
+  if (!changed) {
+    return;
+  }
+
+  TWiMODLORAWAN_PowerReport report;
+  wimod.GetPowerReport(&report);
+  debugMsg((report.Mode == LORAWAN_POWER_MODE_CLASS_C) ? F("Class C") : F("Class A"));
+  debugMsg(F("; time A/C "));
+  debugMsg((int) report.TimeS[LORAWAN_POWER_MODE_CLASS_A]);
+  debugMsg(F("/"));
+  debugMsg((int) report.TimeS[LORAWAN_POWER_MODE_CLASS_C]);
+  debugMsg(F(" s, energy A/C/TX "));
+  debugMsg((int) report.EnergyMJ[LORAWAN_POWER_MODE_CLASS_A]);
+  debugMsg(F("/"));
+  debugMsg((int) report.EnergyMJ[LORAWAN_POWER_MODE_CLASS_C]);
+  debugMsg(F("/"));
+  debugMsg((int) report.TxEnergyMJ);
+  debugMsg(F(" mJ\n"));
+}
+
+/*****************************************************************************
+   time sync: re-align the slots and the module RTC after a DeviceTimeAns
+ ****************************************************************************/
+void serviceTimeSync()
+{
+  TWiMODLORAWAN_TimeSyncInfo info;
+
+  wimod.GetTimeSyncInfo(&info);
+  if (info.NumSyncs != timeSyncCount) {
+    timeSyncCount = info.NumSyncs;
+    debugMsg(F("Network time; correction "));
+    debugMsg((int) info.LastCorrectionMs);
+    debugMsg(F(" ms\n"));
+    scheduleSlots();
+  }
+  if (info.RtcUpdatePending) {
+    wimod.UpdateRtc();
+  }
+
+  if ((RIB.ModemState == ModemState_Connected)
+      && ((uint32_t)(millis() - lastTimeRequest) >= TIME_SYNC_INTERVAL_MS)) {
+    wimod.RequestDeviceTime();
+    lastTimeRequest = millis();
+  }
+}
+
+/*****************************************************************************
+   persistent RS485 bus speed
+ ****************************************************************************/
+uint32_t loadBusBaud()
+{
+  uint32_t baud = BUS_BAUD_DEFAULT;
+#if defined(ARDUINO_ARCH_ESP32)
+  Preferences prefs;
+  if (prefs.begin("bus", true)) {
+    baud = prefs.getUInt("baud", BUS_BAUD_DEFAULT);
+    prefs.end();
+  }
+#endif
+  if (BusProvisioner::baudToCode(baud) < 0) {
+    baud = BUS_BAUD_DEFAULT;
+  }
+  return baud;
+}
+
+void saveBusBaud(uint32_t baud)
+{
+#if defined(ARDUINO_ARCH_ESP32)
+  Preferences prefs;
+  if (prefs.begin("bus", false)) {
+    prefs.putUInt("baud", baud);
+    prefs.end();
+  }
+#endif
+}
+
+/*****************************************************************************
+   persistent runtime configuration
+ ****************************************************************************/
+void loadRuntimeConfig()
+{
+#if defined(ARDUINO_ARCH_ESP32)
+  Preferences    prefs;
+  TRuntimeConfig cfg;
+  if (prefs.begin("rcfg", true)) {
+    if (prefs.getBytes("cfg", &cfg, sizeof(cfg)) == sizeof(cfg)) {
+      // ignored by remoteCfg if invalid
+      remoteCfg.set(cfg);
+    }
+    prefs.end();
+  }
+#endif
+}
+
+void saveRuntimeConfig(const TRuntimeConfig& cfg)
+{
+#if defined(ARDUINO_ARCH_ESP32)
+  Preferences prefs;
+  if (prefs.begin("rcfg", false)) {
+    prefs.putBytes("cfg", &cfg, sizeof(cfg));
+    prefs.end();
+  }
+#endif
+}
+
+/*****************************************************************************
+   register the configured slaves at the health tracker
+ ****************************************************************************/
+void trackSlaves(const TRuntimeConfig& cfg)
+{
+  for (uint8_t i = 0; i < RCFG_NUM_SLAVES; i++) {
+    if (!health.addSlave(cfg.SlaveIDs[i])) {
+      // not tracked means never polled
+      debugMsg(F("Slave health: cannot track slave "));
+      debugMsg((int) cfg.SlaveIDs[i]);
+      debugMsg(F("\n"));
+    }
+  }
+}
+
+/*****************************************************************************
+   take over a configuration received via downlink
+ ****************************************************************************/
+void applyRuntimeConfig(const TRuntimeConfig& cfg)
+{
+  for (uint8_t ch = 0; ch < NUM_CHANNELS; ch++) {
+    rbe.setChannelConfig(ch, cfg.Channels[ch]);
+  }
+  // drop slaves that are no longer configured; already known slaves keep
+  // their health history
+  health.retainSlaves(cfg.SlaveIDs, RCFG_NUM_SLAVES);
+  trackSlaves(cfg);
+
+  if (cfg.DataRateIndex != RCFG_DATA_RATE_UNCHANGED) {
+    TWiMODLORAWAN_RadioStackConfig radioCfg;
+    if (wimod.GetRadioStackConfig(&radioCfg)
+        && (radioCfg.DataRateIndex != cfg.DataRateIndex)) {
+      radioCfg.DataRateIndex = cfg.DataRateIndex;
+      if (!wimod.SetRadioStackConfig(&radioCfg)) {
+        debugMsg(F("Data rate change failed\n"));
+      }
+    }
+  }
+  saveRuntimeConfig(cfg);
+  configureUplinkSlots();
+  scheduleSlots();
+
+  debugMsg(F("Remote config applied: sample "));
+  debugMsg((int) (cfg.SampleIntervalMs / 1000));
+  debugMsg(F(" s, uplink "));
+  debugMsg((int) (cfg.UplinkIntervalMs / 1000));
+  debugMsg(F(" s\n"));
+}
+
+/*****************************************************************************
+   bus provisioning: discover the sensors, move them into the configured
+   address range and raise the bus speed
+ ****************************************************************************/
+void runProvisioning()
+{
+  uint8_t        ids[BUS_PROV_MAX_SENSORS];
+  uint32_t       before[BUS_PROV_MAX_SENSORS];
+  BusProvisioner prov(node, modbus, busBaud, Serial);
+
+  debugMsg(F("Bus provisioning @ "));
+  debugMsg((int) busBaud);
+  debugMsg(F("\n"));
+
+  uint8_t n = prov.discover(1, PROV_SCAN_LAST, ids, BUS_PROV_MAX_SENSORS);
+
+  // sensors outside of the polled range get the next free address;
+  // sensors sharing the factory address must be connected one at a time
+  for (uint8_t i = 0; i < n; i++) {
+    if ((ids[i] >= ID_First) && (ids[i] <= ID_Add)) {
+      continue;
+    }
+    for (uint8_t newID = ID_First; newID <= ID_Add; newID++) {
+      bool used = false;
+      for (uint8_t k = 0; k < n; k++) {
+        used |= (ids[k] == newID);
+      }
+      if (!used) {
+        if (prov.setAddress(ids[i], newID)) {
+          debugMsg(F("Sensor moved to address "));
+          debugMsg((int) newID);
+          debugMsg(F("\n"));
+          ids[i] = newID;
+        }
+        break;
+      }
+    }
+  }
+
+  for (uint8_t i = 0; i < n; i++) {
+    before[i] = prov.measureTransactionUs(ids[i], BUS_PROV_TEST_TRANSACTIONS);
+  }
+
+  busBaud = prov.raiseBaud(ids, n);
+  saveBusBaud(busBaud);
+
+  // report time per transaction
+  for (uint8_t i = 0; i < n; i++) {
+    debugMsg(F("Sensor "));
+    debugMsg((int) ids[i]);
+    debugMsg(F(": "));
+    debugMsg((int) before[i]);
+    debugMsg(F(" us -> "));
+    debugMsg((int) prov.measureTransactionUs(ids[i], BUS_PROV_TEST_TRANSACTIONS));
+    debugMsg(F(" us per transaction\n"));
+  }
+}
+
 /*****************************************************************************
    Arduino setup function
  ****************************************************************************/
@@ -139,10 +533,18 @@ void setup()
 {
 
   mySerial.begin(115200, SERIAL_8N1, SERIAL1_RXPIN, SERIAL1_TXPIN);
-  modbus.begin(9600, SERIAL_8N1, 16, 17);
+  busBaud = loadBusBaud();
+  modbus.begin(busBaud, SERIAL_8N1, 16, 17);
   // communicate with Modbus slave ID 1 over Serial (port 2)
 
 //  node.begin(3, modbus);
+  node.preTransmission(preTransmission);
+  node.postTransmission(postTransmission);
+  loadRuntimeConfig();
+  trackSlaves(remoteCfg.get());
+  for (uint8_t ch = 0; ch < NUM_CHANNELS; ch++) {
+    rbe.setChannelConfig(ch, remoteCfg.get().Channels[ch]);
+  }
   wimod.begin();
 
   // debug interface
@@ -150,60 +552,45 @@ void setup()
   Serial.println("Start");
   printStartMsg();
 
-  // do a software reset of the WiMOD
-  delay(100);
-  //    wimod.Reset();
-  delay(100);
-  // deactivate device in order to get a clean start for this demo
-  wimod.DeactivateDevice();
-
-  // do a simple ping to check the local serial connection
-  debugMsg(F("Ping WiMOD: "));
-  if (wimod.Ping() != true) {
-    debugMsg(F("FAILED\n"));
-  } else {
-    debugMsg(F("OK\n"));
-    //AS923 Thailand radio config variable
-    TWiMODLORAWAN_RadioStackConfig radioCfg;
-    // setup new config
-    radioCfg.DataRateIndex   = LoRaWAN_DataRate_AS923_LoRa_SF7_125kHz;
-    radioCfg.TXPowerLevel    = 16;
-    radioCfg.Options         = // LORAWAN_STK_OPTION_ADR |
-      LORAWAN_STK_OPTION_DEV_CLASS_C |
-      LORAWAN_STK_OPTION_EXT_PKT_FORMAT;
-    radioCfg.PowerSavingMode = LORAWAN_POWER_SAVING_MODE_OFF;
-    radioCfg.Retransmissions = 7;
-    radioCfg.BandIndex       = LoRaWAN_FreqBand_AS_923_Thailand;
-    // set new radio config
-    if (wimod.SetRadioStackConfig(&radioCfg) != true)
-      debugMsg(F("Radio config failed\n"));
-    else
-      debugMsg(F("Radio config OK\n"));
-
-    // try to register the device at network server via OTAA procedure
-    debugMsg(F("Starting join ABP procedure...\n"));
-    TWiMODLORAWAN_ActivateDeviceData activationData;
-
-    //setup ABP data
-    activationData.DeviceAddress = DEV_ADR;
-    memcpy(activationData.NwkSKey, NWKSKEY, 16);
-    memcpy(activationData.AppSKey, APPSKEY, 16);
-
-
-    // activate device
-    if (wimod.ActivateDevice(activationData)) {
-      debugMsg(F("ABP procedure done\n"));
-      debugMsg(F("(An 'alive' message has been sent to server)\n"));
-      RIB.ModemState = ModemState_Connected;
-    } else {
-      debugMsg("Error executing ABP join request: ");
-      debugMsg((int) wimod.GetLastResponseStatus());
-      RIB.ModemState = ModemState_FailedToConnect;
+  // optional bus provisioning
+  debugMsg(F("Press 'p' for bus provisioning\n"));
+  for (uint32_t start = millis(); (uint32_t)(millis() - start) < PROV_PROMPT_MS; ) {
+    if (Serial.available() && (Serial.read() == 'p')) {
+      runProvisioning();
+      break;
     }
+    delay(10);
   }
 
-}
+  wimod.RegisterTxUDataIndicationClient(onTxUDataIndication);
+  // configuration commands may arrive in unconfirmed or confirmed downlinks
+  wimod.RegisterRxUDataIndicationClient(onRxDataIndication);
+  wimod.RegisterRxCDataIndicationClient(onRxDataIndication);
+
+  TWiMODLORAWAN_PowerPolicyConfig powerCfg;
+  powerCfg.ClassCWindowMs = CLASS_C_WINDOW_MS;
+  powerCfg.SupplyMv       = LORAWAN_POWER_DEFAULT_SUPPLY_MV;
+  powerCfg.SleepCurrentUA = LORAWAN_POWER_DEFAULT_SLEEP_UA;
+  powerCfg.RxCurrentUA    = LORAWAN_POWER_DEFAULT_RX_UA;
+  powerCfg.TxCurrentUA    = LORAWAN_POWER_DEFAULT_TX_UA;
+  wimod.SetPowerPolicyConfig(powerCfg);
+  wimod.EnablePowerPolicy(true);
+
+  if (!sampleLog.begin()) {
+    debugMsg(F("Sample log not available\n"));
+  } else {
+    debugMsg(F("Sample log: "));
+    debugMsg((int) sampleLog.getPendingCount());
+    debugMsg(F(" records pending\n"));
+  }
 
+  // coarse time from the module RTC until the network answers
+  wimod.LoadTimeFromRtc();
+  configureUplinkSlots();
+  scheduleSlots();
+
+  connectModem();
+}
 
 /*****************************************************************************
    Arduino loop function
@@ -211,53 +598,106 @@ void setup()
 
 
 
-void readMeter(uint8_t ID) {
+bool read_Modbus(uint16_t REG, uint8_t Slave_Add);
 
+void printHealth(uint8_t ID)
+{
+  const TSlaveHealth* h = health.getHealth(ID);
 
-  read_Modbus(data_, ID) ;
+  if (h == NULL) {
+    return;
+  }
+  debugMsg(F("Slave "));
+  debugMsg((int) ID);
+  debugMsg(F(": ok "));
+  debugMsg((int) health.getSuccessRate(ID));
+  debugMsg(F("% rsp "));
+  debugMsg((int) (h->AvgResponseMs8 / 8));
+  debugMsg(F("ms tmo "));
+  debugMsg((int) health.getTimeout(ID));
+  debugMsg(F("ms fails "));
+  debugMsg((int) h->ConsecutiveFailures);
+  debugMsg(F("\n"));
+}
+
+/*
+   poll one slave; returns false if the slave has been skipped due to backoff
+*/
+bool readMeter(uint8_t ID) {
+
+  uint32_t now = millis();
+
+  if (!health.shouldPoll(ID, now)) {
+    debugMsg(F("Slave "));
+    debugMsg((int) ID);
+    debugMsg(F(" offline; skipped\n"));
+    return false;
+  }
 
-  delay(2000);
+  node.begin(ID, modbus);
+
+  uint32_t start = millis();
+  bool     ok    = read_Modbus(data_, ID);
+  now = millis();
+
+  if (ok) {
+    health.recordSuccess(ID, now - start, now);
+  } else {
+    health.recordFailure(ID, now);
+  }
+  printHealth(ID);
+
+  return true;
 }
-void read_Modbus(uint16_t  REG, uint8_t Slave_Add)
+
+bool read_Modbus(uint16_t  REG, uint8_t Slave_Add)
 {
-  
-  static uint32_t i;
   uint8_t j, result;
   uint16_t data[2];
-  uint16_t dat[2];
-  uint32_t value = 0;
 
-
-  // slave: read (6) 16-bit registers starting at register 2 to RX buffer
+  // slave: read (2) 16-bit registers starting at register REG to RX buffer
   result = node.readInputRegisters(REG, 2);
 
-  // do something with data if read is successful
-  if (result == node.ku8MBSuccess)
+  // only use the data if read is successful
+  if (result != node.ku8MBSuccess)
   {
-    for (j = 0; j < 2; j++)
-    {
-      data[j] = node.getResponseBuffer(j);
-    }
+    Serial.print("Modbus");
+    Serial.print(Slave_Add);
+    Serial.print(" read failed: 0x");
+    Serial.println(result, HEX);
+    return false;
   }
-  if (Slave_Add == 3)
+
+  for (j = 0; j < 2; j++)
+  {
+    data[j] = node.getResponseBuffer(j);
+  }
+
+  Serial.print("Modbus");
+  Serial.print(Slave_Add);
+  Serial.println(" DATA");
+
+  if (Slave_Add == remoteCfg.get().SlaveIDs[0])
   {
-    Serial.println("Modbus3 DATA");
     meter.temp1 = data[0];
     meter.hum1 = data[1];
+    agg.add(CH_TEMP1, (int16_t) meter.temp1);
+    agg.add(CH_HUM1, (int16_t) meter.hum1);
     Serial.println(meter.temp1);
     Serial.println(meter.hum1);
     Serial.println("----------------------");
   }
-  else if (Slave_Add == 4)
+  else if (Slave_Add == remoteCfg.get().SlaveIDs[1])
   {
-    Serial.println("Modbus4 DATA");
     meter.temp2 = data[0];
     meter.hum2 = data[1];
+    agg.add(CH_TEMP2, (int16_t) meter.temp2);
+    agg.add(CH_HUM2, (int16_t) meter.hum2);
     Serial.println(meter.temp2);
     Serial.println(meter.hum2);
     Serial.println("----------------------");
   }
-
+  return true;
 }
 
 void preTransmission()
@@ -276,59 +716,239 @@ void printPayload(uint8_t* buf, uint8_t size)
   }
 }
 
-void loop()
+/*
+   TX indication: take over the measured airtime for the budget estimates
+*/
+void onTxUDataIndication(TWiMODLR_HCIMessage& rxMsg)
 {
-  // check of ABP procedure has finished
-  if (RIB.ModemState == ModemState_Connected) {
+  TWiMODLORAWAN_TxIndData txInd;
 
-    //    Serial.println(loopCnt);
+  if (wimod.convert(rxMsg, &txInd)
+      && (txInd.FieldAvailability != LORAWAN_OPT_TX_IND_INFOS_NOT_AVAILABLE)
+      && txInd.RfMsgAirtime) {
+    if (lastTxWasBackfill) {
+      backfillAirtimeMs = txInd.RfMsgAirtime;
+    } else {
+      liveAirtimeMs = txInd.RfMsgAirtime;
+    }
+  }
+}
 
-    if ((loopCnt > 0) && (loopCnt % (6 * 50)) == 0) {
-      // send out a simple HelloWorld messsage
-      for (uint8_t ID = 3; ID <= ID_Add ; ID++) {
-        node.begin(ID, modbus);
-        readMeter(ID);
-        node.preTransmission(preTransmission);
-        node.postTransmission(postTransmission);
-        delay(1000);
-      }
+/*
+   RX indication: configuration commands are parsed in place from the HCI
+   message; the new configuration is applied from loop()
+*/
+void onRxDataIndication(TWiMODLR_HCIMessage& rxMsg)
+{
+  TWiMODLORAWAN_RX_DataView rxData;
 
+  if (wimod.convert(rxMsg, &rxData) && (rxData.Port == RCFG_LORAWAN_PORT)) {
+    uint8_t status = remoteCfg.process(rxData.Payload, rxData.Length);
+    debugMsg(F("Remote config received; status "));
+    debugMsg((int) status);
+    debugMsg(F("\n"));
+  }
+}
 
+/*
+   send a pending remote config ack on its own
+*/
+void sendConfigAck()
+{
+  txData.Port   = RCFG_LORAWAN_PORT;
+  txData.Length = remoteCfg.encodeAck(txData.Payload, WiMODLORAWAN_APP_PAYLOAD_LEN);
+  if (txData.Length == 0) {
+    return;
+  }
+  lastTxWasBackfill = false;
+  if (wimod.SendUData(&txData)) {
+    remoteCfg.ackSent();
+  }
+}
 
-      // prepare TX data structure
-      txData.Port = 0x22;
-      txData.Payload[0] = meter.temp1 >> 8;
-      txData.Payload[1] = meter.temp1;
-      txData.Payload[2] = meter.temp2 >> 8;
-      txData.Payload[3] = meter.temp2;
-      txData.Payload[4] = meter.hum1 >> 8;
-      txData.Payload[5] = meter.hum1;
-      txData.Payload[6] = meter.hum2 >> 8;
-      txData.Payload[7] = meter.hum2;
+/*
+   put a summary into the store-and-forward log
+*/
+void logSummary(const int16_t* values, uint8_t validMask, uint32_t now)
+{
+  TSampleRecord record;
 
+  record.Time      = now / 1000;
+  record.ValidMask = validMask;
+  for (uint8_t ch = 0; ch < SAMPLE_LOG_NUM_VALUES; ch++) {
+    record.Values[ch] = (ch < NUM_CHANNELS) ? values[ch] : 0;
+  }
 
-      txData.Length = 8;
-      printPayload(txData.Payload, txData.Length);
-      Serial.println("");
+  if (sampleLog.append(record)) {
+    debugMsg(F("Summary logged; seq "));
+    debugMsg((int) record.Seq);
+    debugMsg(F("\n"));
+  } else {
+    debugMsg(F("Sample log write failed\n"));
+  }
+}
 
-      // try to send a message
-      if (false == wimod.SendUData(&txData)) {
-        // an error occurred
+/*
+   send a batch of logged records if the airtime budget allows it
+*/
+void sendBackfill()
+{
+  TSampleRecord records[BACKFILL_BATCH_SIZE];
+  uint32_t      now = millis();
 
-        // check if we have got a duty cycle problem
-        if (LORAWAN_STATUS_CHANNEL_BLOCKED == wimod.GetLastResponseStatus()) {
-          // yes; it is a duty cycle violation
-          // -> try again later
-          debugMsg(F("TX failed: Blocked due to DutyCycle...\n"));
-        }
+  if (!sampleLog.hasPending() || !backfill.canSend(backfillAirtimeMs, now)) {
+    return;
+  }
+
+  uint8_t n = sampleLog.read(records, BACKFILL_BATCH_SIZE);
+  if (n == 0) {
+    return;
+  }
+
+  txData.Port   = SAMPLE_LOG_LORAWAN_PORT;
+  txData.Length = SampleLog::encode(records, n, txData.Payload, WiMODLORAWAN_APP_PAYLOAD_LEN);
+  if (txData.Length == 0) {
+    return;
+  }
+
+  lastTxWasBackfill = true;
+  if (wimod.SendUData(&txData)) {
+    backfill.onAirtime(backfillAirtimeMs, now);
+    // the frame may hold fewer records than have been read
+    sampleLog.markDrained(records[txData.Payload[0] - 1].Seq);
+    debugMsg(F("Backfill: "));
+    debugMsg((int) txData.Payload[0]);
+    debugMsg(F(" records sent\n"));
+  } else if (LORAWAN_STATUS_CHANNEL_BLOCKED == wimod.GetLastResponseStatus()) {
+    // module enforces the duty cycle; drop the saved up budget
+    backfill.onAirtime(backfillAirtimeMs * BACKFILL_BATCH_SIZE, now);
+  }
+}
+
+/*
+   send a summary of all samples since the last uplink
+*/
+void sendSummary()
+{
+  TChannelAggregate summary[NUM_CHANNELS];
+  int16_t           values[NUM_CHANNELS];
+  uint8_t           validMask = 0;
+  uint32_t          now       = millis();
+
+  // take and reset the aggregates in one step
+  agg.take(summary);
+
+  for (uint8_t ch = 0; ch < NUM_CHANNELS; ch++) {
+    values[ch] = 0;
+    if (summary[ch].Count) {
+      validMask |= (1 << ch);
+      values[ch] = SampleAggregator::getMean(summary[ch]);
+    }
+  }
+
+  // only send channels whose mean left the deadband, changed validity or need a heartbeat
+  uint8_t bitmap = rbe.evaluate(values, validMask, now);
+
+  // ... or that had a short excursion within the interval
+  for (uint8_t ch = 0; ch < NUM_CHANNELS; ch++) {
+    if ((validMask & (1 << ch))
+        && (((int32_t) summary[ch].Max - summary[ch].Min) > 2 * (int32_t) remoteCfg.get().Channels[ch].AbsDeadband)) {
+      bitmap |= (1 << ch);
+    }
+  }
+
+  if (RIB.ModemState != ModemState_Connected) {
+    // no link; keep the summary for the backfill
+    logSummary(values, validMask, now);
+    return;
+  }
+
+  if (bitmap == 0) {
+    // keep accumulating; the next summary covers this interval too
+    agg.merge(summary);
+    debugMsg(F("No change; uplink suppressed\n"));
+    // a pending remote config ack is sent anyway
+    sendConfigAck();
+    return;
+  }
+
+  // prepare TX data structure
+  txData.Port   = AGG_LORAWAN_PORT;
+  txData.Length = agg.encode(bitmap, summary, txData.Payload, WiMODLORAWAN_APP_PAYLOAD_LEN);
+  // piggyback a pending remote config ack behind the summaries
+  bool withAck = false;
+  if (txData.Length) {
+    uint8_t ackLen = remoteCfg.encodeAck(&txData.Payload[txData.Length], WiMODLORAWAN_APP_PAYLOAD_LEN - txData.Length);
+    txData.Length += ackLen;
+    withAck        = (ackLen != 0);
+  }
+
+  printPayload(txData.Payload, txData.Length);
+  Serial.println("");
+
+  // try to send a message
+  lastTxWasBackfill = false;
+  if (wimod.SendUData(&txData)) {
+    backfill.onAirtime(liveAirtimeMs, now);
+    rbe.commit(bitmap, values, validMask, now);
+    if (withAck) {
+      remoteCfg.ackSent();
+    }
+    // channels not contained in this frame keep their samples
+    agg.merge(summary, (uint8_t) ~bitmap);
+  } else {
+    // an error occurred; keep the summary for the backfill
+    logSummary(values, validMask, now);
+
+    // check if we have got a duty cycle problem
+    if (LORAWAN_STATUS_CHANNEL_BLOCKED == wimod.GetLastResponseStatus()) {
+      // yes; it is a duty cycle violation
+      // -> try again later
+      debugMsg(F("TX failed: Blocked due to DutyCycle...\n"));
+    }
+  }
+}
+
+void loop()
+{
+  // sample all sensors at the local rate; also while the link is down
+  if ((int32_t)(millis() - nextSampleTime) >= 0) {
+    for (uint8_t i = 0; i < RCFG_NUM_SLAVES; i++) {
+      if (readMeter(remoteCfg.get().SlaveIDs[i])) {
+        delay(MODBUS_GAP_MS);
       }
-     }
     }
-  
+    nextSampleTime = millis() + wimod.GetMsUntilSlot(remoteCfg.get().SampleIntervalMs);
+  }
+
+  if ((int32_t)(millis() - nextSummaryTime) >= 0) {
+    nextSummaryTime = millis() + wimod.GetMsUntilUplinkSlot();
+    sendSummary();
+  } else if (bootUplinkPending && (RIB.ModemState == ModemState_Connected) && agg.getValidMask()) {
+    bootUplinkPending = false;
+    sendSummary();
+  } else if (RIB.ModemState == ModemState_Connected) {
+    // drain the log in between the regular uplinks
+    sendBackfill();
+  } else if ((uint32_t)(millis() - lastActivateTime) >= ACTIVATE_RETRY_MS) {
+    connectModem();
+  }
 
   // check for any pending data of the WiMOD
   wimod.Process();
 
+  // apply a configuration received during Process(); HCI requests are not
+  // allowed from within the indication callbacks
+  TRuntimeConfig newCfg;
+  if (remoteCfg.takePending(newCfg)) {
+    applyRuntimeConfig(newCfg);
+  }
+  uint16_t maintenanceMin;
+  if (remoteCfg.takeMaintenance(maintenanceMin)) {
+    wimod.RequestClassC(maintenanceMin * 60000UL);
+  }
+  servicePowerPolicy();
+  serviceTimeSync();
+
   delay(40);
-  loopCnt++;
 }
@@ -0,0 +1,261 @@
+/*
+ * RemoteConfig.cpp
+ *
+ * Implementation of the remote configuration.
+ * see RemoteConfig.h for the frame layout.
+ */
+
+#include "RemoteConfig.h"
+
+#include <string.h>
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Constructor
+ *
+ * @param defaults  configuration used until set() or a command changes it
+ */
+RemoteConfig::RemoteConfig(const TRuntimeConfig& defaults)
+{
+  active         = defaults;
+  pending        = defaults;
+  pendingValid   = false;
+  seqValid       = false;
+  lastSeq        = 0;
+  lastStatus     = RCFG_STATUS_OK;
+  ackPending     = false;
+  maintenanceMin = 0;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Replace the active configuration (e.g. by the one restored from NVS)
+ *
+ * The configuration is ignored if it does not pass the validation.
+ */
+void RemoteConfig::set(const TRuntimeConfig& cfg)
+{
+  if (validate(cfg) == RCFG_STATUS_OK) {
+    active = cfg;
+  }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Parse a command frame
+ *
+ * The payload is parsed in place; e.g. directly from the HCI message.
+ *
+ * @return RCFG_STATUS_* of the frame; this status is acknowledged
+ */
+uint8_t RemoteConfig::process(const uint8_t* payload, uint8_t length)
+{
+  TRuntimeConfig staged;
+  uint16_t       maintenance = 0;
+  uint8_t        seq;
+
+  if ((payload == NULL) || (length < 1)) {
+    return RCFG_STATUS_BAD_LENGTH;
+  }
+
+  seq = payload[0];
+  if (seqValid && (seq == lastSeq)) {
+    // repeated downlink; the ack has probably been lost
+    ackPending = true;
+    return lastStatus;
+  }
+
+  // commands of not yet applied frames are kept
+  staged = pendingValid ? pending : active;
+
+  lastStatus = parse(&payload[1], length - 1, staged, maintenance);
+  if (lastStatus == RCFG_STATUS_OK) {
+    lastStatus = validate(staged);
+  }
+  if (lastStatus == RCFG_STATUS_OK) {
+    pending      = staged;
+    pendingValid = true;
+    if (maintenance) {
+      maintenanceMin = maintenance;
+    }
+  }
+
+  lastSeq    = seq;
+  seqValid   = true;
+  ackPending = true;
+  return lastStatus;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Take over a new configuration
+ *
+ * @param cfg  receives the new configuration
+ *
+ * @return true if a new configuration has been accepted since the last call
+ */
+bool RemoteConfig::takePending(TRuntimeConfig& cfg)
+{
+  if (!pendingValid) {
+    return false;
+  }
+  active       = pending;
+  pendingValid = false;
+  cfg          = active;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Take over a requested maintenance session
+ *
+ * @param minutes  receives the requested Class C time
+ *
+ * @return true if a session has been requested since the last call
+ */
+bool RemoteConfig::takeMaintenance(uint16_t& minutes)
+{
+  if (maintenanceMin == 0) {
+    return false;
+  }
+  minutes        = maintenanceMin;
+  maintenanceMin = 0;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Encode the acknowledgement of the last command frame
+ *
+ * @return number of bytes written; 0 if no ack is pending or the buffer is too small
+ */
+uint8_t RemoteConfig::encodeAck(uint8_t* buf, uint8_t size) const
+{
+  if (!ackPending || (buf == NULL) || (size < RCFG_ACK_SIZE)) {
+    return 0;
+  }
+  buf[0] = RCFG_ACK_TAG;
+  buf[1] = lastSeq;
+  buf[2] = lastStatus;
+  return RCFG_ACK_SIZE;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief The uplink containing the ack has been accepted by the module
+ */
+void RemoteConfig::ackSent(void)
+{
+  ackPending = false;
+}
+
+//-----------------------------------------------------------------------------
+// private functions
+//-----------------------------------------------------------------------------
+
+uint8_t RemoteConfig::parse(const uint8_t* p, uint8_t length, TRuntimeConfig& staged, uint16_t& maintenance) const
+{
+  uint8_t offset = 0;
+
+  while (offset < length) {
+    if ((offset + 2) > length) {
+      return RCFG_STATUS_BAD_LENGTH;
+    }
+    uint8_t        tag = p[offset++];
+    uint8_t        len = p[offset++];
+    const uint8_t* v   = &p[offset];
+
+    if ((offset + len) > length) {
+      return RCFG_STATUS_BAD_LENGTH;
+    }
+    offset += len;
+
+    switch (tag) {
+      case RCFG_TAG_SAMPLE_INTERVAL:
+      case RCFG_TAG_UPLINK_INTERVAL:
+        {
+          if (len != 2) {
+            return RCFG_STATUS_BAD_LENGTH;
+          }
+          uint32_t ms = ((uint32_t) v[0] << 8 | v[1]) * 1000UL;
+          if (tag == RCFG_TAG_SAMPLE_INTERVAL) {
+            staged.SampleIntervalMs = ms;
+          } else {
+            staged.UplinkIntervalMs = ms;
+          }
+        }
+        break;
+      case RCFG_TAG_SLAVE_ID:
+        if (len != 2) {
+          return RCFG_STATUS_BAD_LENGTH;
+        }
+        if (v[0] >= RCFG_NUM_SLAVES) {
+          return RCFG_STATUS_BAD_VALUE;
+        }
+        staged.SlaveIDs[v[0]] = v[1];
+        break;
+      case RCFG_TAG_DEADBAND:
+        if (len != 5) {
+          return RCFG_STATUS_BAD_LENGTH;
+        }
+        if (v[0] >= staged.NumChannels) {
+          return RCFG_STATUS_BAD_VALUE;
+        }
+        staged.Channels[v[0]].AbsDeadband = (uint16_t) v[1] << 8 | v[2];
+        staged.Channels[v[0]].RelDeadband = (uint16_t) v[3] << 8 | v[4];
+        break;
+      case RCFG_TAG_HEARTBEAT:
+        if (len != 3) {
+          return RCFG_STATUS_BAD_LENGTH;
+        }
+        if (v[0] >= staged.NumChannels) {
+          return RCFG_STATUS_BAD_VALUE;
+        }
+        staged.Channels[v[0]].HeartbeatMs = ((uint32_t) v[1] << 8 | v[2]) * 60000UL;
+        break;
+      case RCFG_TAG_DATA_RATE:
+        if (len != 1) {
+          return RCFG_STATUS_BAD_LENGTH;
+        }
+        staged.DataRateIndex = v[0];
+        break;
+      case RCFG_TAG_MAINTENANCE:
+        if (len != 2) {
+          return RCFG_STATUS_BAD_LENGTH;
+        }
+        maintenance = (uint16_t) v[0] << 8 | v[1];
+        break;
+      default:
+        return RCFG_STATUS_UNKNOWN_TAG;
+    }
+  }
+  return RCFG_STATUS_OK;
+}
+
+uint8_t RemoteConfig::validate(const TRuntimeConfig& cfg) const
+{
+  uint8_t i, k;
+
+  if ((cfg.SampleIntervalMs < RCFG_MIN_SAMPLE_INTERVAL_S * 1000UL)
+      || (cfg.UplinkIntervalMs < RCFG_MIN_UPLINK_INTERVAL_S * 1000UL)
+      || (cfg.UplinkIntervalMs < cfg.SampleIntervalMs)) {
+    return RCFG_STATUS_BAD_VALUE;
+  }
+  if ((cfg.DataRateIndex != RCFG_DATA_RATE_UNCHANGED) && (cfg.DataRateIndex > RCFG_MAX_DATA_RATE)) {
+    return RCFG_STATUS_BAD_VALUE;
+  }
+  if (cfg.NumChannels > RBE_MAX_CHANNELS) {
+    return RCFG_STATUS_BAD_VALUE;
+  }
+  for (i = 0; i < RCFG_NUM_SLAVES; i++) {
+    if ((cfg.SlaveIDs[i] == 0) || (cfg.SlaveIDs[i] > RCFG_MAX_SLAVE_ID)) {
+      return RCFG_STATUS_BAD_VALUE;
+    }
+    for (k = 0; k < i; k++) {
+      if (cfg.SlaveIDs[k] == cfg.SlaveIDs[i]) {
+        return RCFG_STATUS_BAD_VALUE;
+      }
+    }
+  }
+  return RCFG_STATUS_OK;
+}
@@ -0,0 +1,136 @@
+/*
+ * RemoteConfig.h
+ *
+ * Remote configuration of the runtime parameters via LoRaWAN downlinks.
+ *
+ * Command frame layout (downlink, LoRaWAN port RCFG_LORAWAN_PORT):
+ *
+ *   [seq] [tag] [len] [value] [tag] [len] [value] ...
+ *
+ *   seq   : sequence number chosen by the server; a repeated seq is only
+ *           acknowledged again, its commands are not applied twice
+ *   tag   : RCFG_TAG_* ; len : length of the value field
+ *   value : big endian
+ *
+ *   RCFG_TAG_SAMPLE_INTERVAL  len 2 : sample interval in s
+ *   RCFG_TAG_UPLINK_INTERVAL  len 2 : uplink interval in s
+ *   RCFG_TAG_SLAVE_ID         len 2 : [sensor index] [Modbus address]
+ *   RCFG_TAG_DEADBAND         len 5 : [channel] [abs deadband u16] [rel deadband u16]
+ *   RCFG_TAG_HEARTBEAT        len 3 : [channel] [heartbeat in min u16]
+ *   RCFG_TAG_DATA_RATE        len 1 : [data rate index]
+ *   RCFG_TAG_MAINTENANCE      len 2 : Class C session in min (not stored)
+ *
+ * A frame is applied completely or not at all: the commands are parsed into
+ * a staged copy of the configuration; any error discards the copy.
+ *
+ * Acknowledgement (appended to the next uplink frame, or sent alone on
+ * RCFG_LORAWAN_PORT if no other uplink is due):
+ *
+ *   [RCFG_ACK_TAG] [seq] [status]
+ */
+
+#ifndef MODBUS_WIMOD_REMOTECONFIG_H_
+#define MODBUS_WIMOD_REMOTECONFIG_H_
+
+#include <stdint.h>
+
+#include "ReportByException.h"
+
+//-----------------------------------------------------------------------------
+// common defines
+//-----------------------------------------------------------------------------
+
+/** LoRaWAN port used for configuration commands and stand-alone acks */
+#define RCFG_LORAWAN_PORT           0x30
+
+/** number of configurable Modbus sensors */
+#define RCFG_NUM_SLAVES             2
+
+/** command tags */
+#define RCFG_TAG_SAMPLE_INTERVAL    0x01
+#define RCFG_TAG_UPLINK_INTERVAL    0x02
+#define RCFG_TAG_SLAVE_ID           0x03
+#define RCFG_TAG_DEADBAND           0x04
+#define RCFG_TAG_HEARTBEAT          0x05
+#define RCFG_TAG_DATA_RATE          0x06
+#define RCFG_TAG_MAINTENANCE        0x07
+
+/** acknowledgement trailer */
+#define RCFG_ACK_TAG                0xFE
+#define RCFG_ACK_SIZE               3
+
+/** status codes of the acknowledgement */
+#define RCFG_STATUS_OK              0x00
+#define RCFG_STATUS_UNKNOWN_TAG     0x01
+#define RCFG_STATUS_BAD_LENGTH      0x02
+#define RCFG_STATUS_BAD_VALUE       0x03
+
+/** DataRateIndex value: keep the data rate of the radio stack */
+#define RCFG_DATA_RATE_UNCHANGED    0xFF
+
+/** limits of the accepted values */
+#define RCFG_MIN_SAMPLE_INTERVAL_S  1
+#define RCFG_MIN_UPLINK_INTERVAL_S  10
+#define RCFG_MAX_DATA_RATE          7
+#define RCFG_MAX_SLAVE_ID           247
+
+//-----------------------------------------------------------------------------
+// user defined types
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Runtime parameters that can be changed via downlink
+ */
+typedef struct TRuntimeConfig
+{
+  uint32_t          SampleIntervalMs;                 /*!< local sensor sample interval */
+  uint32_t          UplinkIntervalMs;                 /*!< summary uplink interval */
+  uint8_t           SlaveIDs[RCFG_NUM_SLAVES];        /*!< Modbus address per sensor */
+  uint8_t           DataRateIndex;                    /*!< requested data rate; RCFG_DATA_RATE_UNCHANGED = keep */
+  uint8_t           NumChannels;                      /*!< number of used entries in Channels */
+  TReportChannelCfg Channels[RBE_MAX_CHANNELS];       /*!< deadband / heartbeat per channel */
+} TRuntimeConfig;
+
+//-----------------------------------------------------------------------------
+// class declaration
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Parser and holder of the remote configuration
+ *
+ * Usage:
+ *  1. process() the payload of a downlink on RCFG_LORAWAN_PORT; may be
+ *     called from the RX indication callback, it only parses
+ *  2. takePending() / takeMaintenance() in loop() and apply the result
+ *  3. encodeAck() into the next uplink; ackSent() once it has been accepted
+ */
+class RemoteConfig {
+public:
+  RemoteConfig(const TRuntimeConfig& defaults);
+
+  const TRuntimeConfig& get(void) const { return active; }
+  void      set(const TRuntimeConfig& cfg);
+
+  uint8_t   process(const uint8_t* payload, uint8_t length);
+  bool      takePending(TRuntimeConfig& cfg);
+  bool      takeMaintenance(uint16_t& minutes);
+
+  bool      hasAck(void) const { return ackPending; }
+  uint8_t   encodeAck(uint8_t* buf, uint8_t size) const;
+  void      ackSent(void);
+
+private:
+  uint8_t   parse(const uint8_t* payload, uint8_t length, TRuntimeConfig& staged, uint16_t& maintenance) const;
+  uint8_t   validate(const TRuntimeConfig& staged) const;
+
+  TRuntimeConfig      active;
+  TRuntimeConfig      pending;
+  bool                pendingValid;
+  bool                seqValid;
+  uint8_t             lastSeq;
+  uint8_t             lastStatus;
+  bool                ackPending;
+  uint16_t            maintenanceMin;
+};
+
+#endif /* MODBUS_WIMOD_REMOTECONFIG_H_ */
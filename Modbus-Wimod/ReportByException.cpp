@@ -0,0 +1,176 @@
+/*
+ * ReportByException.cpp
+ *
+ * Implementation of the report-by-exception filter.
+ * see ReportByException.h for the frame layout.
+ */
+
+#include "ReportByException.h"
+
+#include <string.h>
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Constructor
+ *
+ * @param cfg          array of numChannels channel configurations
+ * @param numChannels  number of channels; clipped to RBE_MAX_CHANNELS
+ */
+ReportByException::ReportByException(const TReportChannelCfg* cfg, uint8_t numChannels)
+{
+  if (numChannels > RBE_MAX_CHANNELS) {
+    numChannels = RBE_MAX_CHANNELS;
+  }
+  this->numChannels = numChannels;
+
+  memset(config, 0x00, sizeof(config));
+  if (cfg) {
+    memcpy(config, cfg, numChannels * sizeof(TReportChannelCfg));
+  }
+  reset();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Forget all reported values; the next evaluate() reports every channel
+ */
+void ReportByException::reset(void)
+{
+  memset(state, 0x00, sizeof(state));
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Replace the configuration of a single channel
+ */
+void ReportByException::setChannelConfig(uint8_t channel, const TReportChannelCfg& cfg)
+{
+  if (channel < numChannels) {
+    config[channel] = cfg;
+  }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Check which channels must be reported
+ *
+ * @param values     latest samples; one per channel
+ * @param validMask  bit i set -> values[i] holds a valid sample
+ * @param now        current time in ms
+ *
+ * @return bitmap of channels that left their deadband, changed their
+ *         validity or whose heartbeat expired; 0 if nothing has to be sent
+ */
+uint8_t ReportByException::evaluate(const int16_t* values, uint8_t validMask, uint32_t now) const
+{
+  uint8_t bitmap = 0;
+  uint8_t i;
+
+  if (values == NULL) {
+    return 0;
+  }
+
+  for (i = 0; i < numChannels; i++) {
+    bool valid = (validMask & (1 << i)) != 0;
+
+    if (!state[i].Reported) {
+      bitmap |= (1 << i);
+    } else if (valid != state[i].Valid) {
+      bitmap |= (1 << i);
+    } else if (valid && isOutsideDeadband(i, values[i])) {
+      bitmap |= (1 << i);
+    } else if (config[i].HeartbeatMs
+               && ((uint32_t)(now - state[i].LastReportTime) >= config[i].HeartbeatMs)) {
+      bitmap |= (1 << i);
+    }
+  }
+  return bitmap;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Encode the channels of the given bitmap into an uplink frame
+ *
+ * Channels without a valid sample are flagged in the invalid mask and
+ * carry no value.
+ *
+ * @return number of bytes written; 0 if the buffer is too small or bitmap is empty
+ */
+uint8_t ReportByException::encode(uint8_t bitmap, const int16_t* values, uint8_t validMask, uint8_t* buf, uint8_t size) const
+{
+  uint8_t offset = 0;
+  uint8_t i;
+
+  if ((bitmap == 0) || (values == NULL) || (buf == NULL) || (size < RBE_HEADER_SIZE)) {
+    return 0;
+  }
+
+  buf[offset++] = bitmap;
+  buf[offset++] = bitmap & ~validMask;
+  for (i = 0; i < numChannels; i++) {
+    if (bitmap & validMask & (1 << i)) {
+      if ((offset + RBE_VALUE_SIZE) > size) {
+        return 0;
+      }
+      buf[offset++] = (uint8_t)(values[i] >> 8);
+      buf[offset++] = (uint8_t)(values[i]);
+    }
+  }
+  return offset;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Mark the channels of the bitmap as reported
+ *
+ * Must only be called after the uplink has been accepted by the module.
+ */
+void ReportByException::commit(uint8_t bitmap, const int16_t* values, uint8_t validMask, uint32_t now)
+{
+  uint8_t i;
+
+  if (values == NULL) {
+    return;
+  }
+
+  for (i = 0; i < numChannels; i++) {
+    if (bitmap & (1 << i)) {
+      state[i].Valid          = (validMask & (1 << i)) != 0;
+      if (state[i].Valid) {
+        state[i].LastReported = values[i];
+      }
+      state[i].LastReportTime = now;
+      state[i].Reported       = true;
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+// private functions
+//-----------------------------------------------------------------------------
+
+bool ReportByException::isOutsideDeadband(uint8_t channel, int16_t value) const
+{
+  const TReportChannelCfg& cfg  = config[channel];
+  int32_t                  last = state[channel].LastReported;
+  int32_t                  diff = (int32_t) value - last;
+
+  if (diff < 0) {
+    diff = -diff;
+  }
+  if (last < 0) {
+    last = -last;
+  }
+
+  // no deadband configured: every change is reported
+  if ((cfg.AbsDeadband == 0) && (cfg.RelDeadband == 0)) {
+    return (diff != 0);
+  }
+  if (cfg.AbsDeadband && (diff > (int32_t) cfg.AbsDeadband)) {
+    return true;
+  }
+  if (cfg.RelDeadband && ((diff * 1000) > ((int32_t) cfg.RelDeadband * last))) {
+    return true;
+  }
+  return false;
+}
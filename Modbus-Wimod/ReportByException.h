@@ -0,0 +1,99 @@
+/*
+ * ReportByException.h
+ *
+ * Change detection layer between the Modbus acquisition and the LoRaWAN
+ * uplink. Every channel has an absolute and a relative deadband plus a
+ * heartbeat (max. silent interval). Only channels that left their deadband
+ * (or whose heartbeat expired) are put into the uplink frame.
+ *
+ * Frame layout (LoRaWAN port RBE_LORAWAN_PORT):
+ *
+ *   [bitmap] [invalid] [value ch(n)] [value ch(m)] ...
+ *
+ *   bitmap  : bit i set -> channel i is contained in this frame
+ *   invalid : bit i set -> channel i has no valid sample (sensor offline or
+ *             sample stale); no value is encoded for this channel
+ *   value   : signed 16 bit, big endian, raw sensor units; in channel order
+ */
+
+#ifndef MODBUS_WIMOD_REPORTBYEXCEPTION_H_
+#define MODBUS_WIMOD_REPORTBYEXCEPTION_H_
+
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------
+// common defines
+//-----------------------------------------------------------------------------
+
+/** max. number of channels; limited by the 8 bit channel bitmap */
+#define RBE_MAX_CHANNELS            8
+
+/** LoRaWAN port used for report-by-exception frames */
+#define RBE_LORAWAN_PORT            0x23
+
+/** size of the frame header (bitmap + invalid mask) */
+#define RBE_HEADER_SIZE             2
+
+/** size of one encoded channel value */
+#define RBE_VALUE_SIZE              2
+
+//-----------------------------------------------------------------------------
+// user defined types
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Per channel configuration of the change detection
+ */
+typedef struct TReportChannelCfg
+{
+  uint16_t  AbsDeadband;          /*!< absolute deadband in raw units; 0 = disabled */
+  uint16_t  RelDeadband;          /*!< relative deadband in 1/1000 of last reported value; 0 = disabled */
+  uint32_t  HeartbeatMs;          /*!< max. silent interval in ms; 0 = no heartbeat */
+} TReportChannelCfg;
+
+/**
+ * @brief Per channel runtime state of the change detection
+ */
+typedef struct TReportChannelState
+{
+  int16_t   LastReported;         /*!< last value that has been handed to the uplink */
+  uint32_t  LastReportTime;       /*!< time stamp (ms) of the last report */
+  bool      Reported;             /*!< false until the channel has been reported once */
+  bool      Valid;                /*!< validity of the last reported sample */
+} TReportChannelState;
+
+//-----------------------------------------------------------------------------
+// class declaration
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Report-by-exception filter for a fixed set of sensor channels
+ *
+ * Usage:
+ *  1. evaluate() the latest samples -> bitmap of channels to send
+ *  2. encode() the frame and send it
+ *  3. commit() the bitmap only if the uplink has been accepted by the module,
+ *     so a blocked uplink keeps the changes pending.
+ */
+class ReportByException {
+public:
+  ReportByException(const TReportChannelCfg* cfg, uint8_t numChannels);
+
+  void     reset(void);
+  void     setChannelConfig(uint8_t channel, const TReportChannelCfg& cfg);
+
+  uint8_t  evaluate(const int16_t* values, uint8_t validMask, uint32_t now) const;
+  uint8_t  encode(uint8_t bitmap, const int16_t* values, uint8_t validMask, uint8_t* buf, uint8_t size) const;
+  void     commit(uint8_t bitmap, const int16_t* values, uint8_t validMask, uint32_t now);
+
+  uint8_t  getNumChannels(void) const { return numChannels; }
+
+private:
+  bool     isOutsideDeadband(uint8_t channel, int16_t value) const;
+
+  TReportChannelCfg   config[RBE_MAX_CHANNELS];
+  TReportChannelState state[RBE_MAX_CHANNELS];
+  uint8_t             numChannels;
+};
+
+#endif /* MODBUS_WIMOD_REPORTBYEXCEPTION_H_ */
@@ -0,0 +1,212 @@
+/*
+ * SampleAggregator.cpp
+ *
+ * Implementation of the streaming sample aggregator.
+ * see SampleAggregator.h for the frame layout.
+ */
+
+#include "SampleAggregator.h"
+
+#include <string.h>
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Constructor
+ *
+ * @param numChannels  number of channels; clipped to AGG_MAX_CHANNELS
+ */
+SampleAggregator::SampleAggregator(uint8_t numChannels)
+{
+  if (numChannels > AGG_MAX_CHANNELS) {
+    numChannels = AGG_MAX_CHANNELS;
+  }
+  this->numChannels = numChannels;
+  reset();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Clear all aggregates
+ */
+void SampleAggregator::reset(void)
+{
+  memset(channels, 0x00, sizeof(channels));
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Add a single sample to a channel; O(1)
+ *
+ * Once the sample count saturates, sum and count are frozen (the mean stays
+ * exact for the counted samples) while min, max and last keep updating.
+ */
+void SampleAggregator::add(uint8_t channel, int16_t value)
+{
+  if (channel >= numChannels) {
+    return;
+  }
+  TChannelAggregate& agg = channels[channel];
+
+  if (agg.Count == 0) {
+    agg.Min = value;
+    agg.Max = value;
+  } else {
+    if (value < agg.Min) {
+      agg.Min = value;
+    }
+    if (value > agg.Max) {
+      agg.Max = value;
+    }
+  }
+  agg.Last = value;
+
+  if (agg.Count < 0xFFFF) {
+    agg.Sum += value;
+    agg.Count++;
+  }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Copy all aggregates to snapshot and reset them in one step
+ *
+ * @param snapshot  array of getNumChannels() entries
+ */
+void SampleAggregator::take(TChannelAggregate* snapshot)
+{
+  if (snapshot == NULL) {
+    return;
+  }
+  memcpy(snapshot, channels, numChannels * sizeof(TChannelAggregate));
+  reset();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Merge a snapshot back, e.g. if the uplink could not be queued
+ *
+ * Samples added after take() are newer than the snapshot; their last value
+ * is kept.
+ *
+ * @param bitmap  bit i set -> merge channel i
+ */
+void SampleAggregator::merge(const TChannelAggregate* snapshot, uint8_t bitmap)
+{
+  uint8_t  i;
+  uint32_t count;
+
+  if (snapshot == NULL) {
+    return;
+  }
+
+  for (i = 0; i < numChannels; i++) {
+    const TChannelAggregate& old = snapshot[i];
+    TChannelAggregate&       agg = channels[i];
+
+    if (!(bitmap & (1 << i)) || (old.Count == 0)) {
+      continue;
+    }
+    if (agg.Count == 0) {
+      agg = old;
+      continue;
+    }
+    if (old.Min < agg.Min) {
+      agg.Min = old.Min;
+    }
+    if (old.Max > agg.Max) {
+      agg.Max = old.Max;
+    }
+    count = (uint32_t) agg.Count + old.Count;
+    if (count <= 0xFFFF) {
+      agg.Sum  += old.Sum;
+      agg.Count = (uint16_t) count;
+    } else {
+      // keep the exact mean of the older samples
+      agg.Sum   = old.Sum;
+      agg.Count = old.Count;
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Bitmap of channels with at least one sample since the last take()
+ */
+uint8_t SampleAggregator::getValidMask(void) const
+{
+  uint8_t mask = 0;
+  uint8_t i;
+
+  for (i = 0; i < numChannels; i++) {
+    if (channels[i].Count) {
+      mask |= (1 << i);
+    }
+  }
+  return mask;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Rounded mean of an aggregate; 0 if no samples
+ */
+int16_t SampleAggregator::getMean(const TChannelAggregate& agg)
+{
+  int32_t half;
+
+  if (agg.Count == 0) {
+    return 0;
+  }
+  half = agg.Count / 2;
+  if (agg.Sum < 0) {
+    half = -half;
+  }
+  return (int16_t)((agg.Sum + half) / (int32_t) agg.Count);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Encode the channels of the given bitmap into a summary frame
+ *
+ * @return number of bytes written; 0 if the buffer is too small or bitmap is empty
+ */
+uint8_t SampleAggregator::encode(uint8_t bitmap, const TChannelAggregate* snapshot, uint8_t* buf, uint8_t size) const
+{
+  uint8_t offset = 0;
+  uint8_t valid  = 0;
+  uint8_t i;
+  int16_t mean;
+
+  if ((bitmap == 0) || (snapshot == NULL) || (buf == NULL) || (size < AGG_HEADER_SIZE)) {
+    return 0;
+  }
+
+  for (i = 0; i < numChannels; i++) {
+    if (snapshot[i].Count) {
+      valid |= (1 << i);
+    }
+  }
+
+  buf[offset++] = bitmap;
+  buf[offset++] = bitmap & ~valid;
+  for (i = 0; i < numChannels; i++) {
+    if (bitmap & valid & (1 << i)) {
+      if ((offset + AGG_SUMMARY_SIZE) > size) {
+        return 0;
+      }
+      const TChannelAggregate& agg = snapshot[i];
+      mean = getMean(agg);
+
+      buf[offset++] = (uint8_t)(agg.Min >> 8);
+      buf[offset++] = (uint8_t)(agg.Min);
+      buf[offset++] = (uint8_t)(agg.Max >> 8);
+      buf[offset++] = (uint8_t)(agg.Max);
+      buf[offset++] = (uint8_t)(mean >> 8);
+      buf[offset++] = (uint8_t)(mean);
+      buf[offset++] = (uint8_t)(agg.Last >> 8);
+      buf[offset++] = (uint8_t)(agg.Last);
+      buf[offset++] = (uint8_t)(agg.Count >> 8);
+      buf[offset++] = (uint8_t)(agg.Count);
+    }
+  }
+  return offset;
+}
@@ -0,0 +1,95 @@
+/*
+ * SampleAggregator.h
+ *
+ * Streaming aggregation of locally sampled sensor channels.
+ *
+ * The sensors are sampled at a higher rate than the uplink rate. Per channel
+ * min, max, sum (-> mean), last value and sample count are kept in fixed
+ * memory; every sample is an O(1) update. At uplink time the aggregates are
+ * taken and reset in one step; if the uplink can not be queued they are
+ * merged back, so no sample is lost or counted twice.
+ *
+ * Summary frame layout (LoRaWAN port AGG_LORAWAN_PORT):
+ *
+ *   [bitmap] [invalid] [summary ch(n)] [summary ch(m)] ...
+ *
+ *   bitmap  : bit i set -> channel i is contained in this frame
+ *   invalid : bit i set -> channel i has no sample in this interval;
+ *             no summary is encoded for this channel
+ *   summary : min, max, mean, last (signed 16 bit, big endian, raw units)
+ *             followed by the sample count (unsigned 16 bit, big endian)
+ */
+
+#ifndef MODBUS_WIMOD_SAMPLEAGGREGATOR_H_
+#define MODBUS_WIMOD_SAMPLEAGGREGATOR_H_
+
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------
+// common defines
+//-----------------------------------------------------------------------------
+
+/** max. number of channels; limited by the 8 bit channel bitmap */
+#define AGG_MAX_CHANNELS            8
+
+/** LoRaWAN port used for summary frames */
+#define AGG_LORAWAN_PORT            0x24
+
+/** size of the frame header (bitmap + invalid mask) */
+#define AGG_HEADER_SIZE             2
+
+/** size of one encoded channel summary */
+#define AGG_SUMMARY_SIZE            10
+
+//-----------------------------------------------------------------------------
+// user defined types
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Streaming aggregate of a single channel
+ */
+typedef struct TChannelAggregate
+{
+  int16_t   Min;                  /*!< smallest sample */
+  int16_t   Max;                  /*!< largest sample */
+  int16_t   Last;                 /*!< most recent sample */
+  int32_t   Sum;                  /*!< sum of all counted samples */
+  uint16_t  Count;                /*!< number of samples (saturating) */
+} TChannelAggregate;
+
+//-----------------------------------------------------------------------------
+// class declaration
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Fixed size min/max/mean/last aggregator for a set of channels
+ *
+ * Usage:
+ *  1. add() every local sample
+ *  2. take() the aggregates when the uplink is prepared (resets them)
+ *  3. merge() them back if the uplink could not be queued, or merge() the
+ *     channels that have not been part of the uplink
+ */
+class SampleAggregator {
+public:
+  SampleAggregator(uint8_t numChannels);
+
+  void     reset(void);
+  void     add(uint8_t channel, int16_t value);
+
+  void     take(TChannelAggregate* snapshot);
+  void     merge(const TChannelAggregate* snapshot, uint8_t bitmap = 0xFF);
+
+  uint8_t  getValidMask(void) const;
+  uint8_t  getNumChannels(void) const { return numChannels; }
+
+  static int16_t getMean(const TChannelAggregate& agg);
+
+  uint8_t  encode(uint8_t bitmap, const TChannelAggregate* snapshot, uint8_t* buf, uint8_t size) const;
+
+private:
+  TChannelAggregate   channels[AGG_MAX_CHANNELS];
+  uint8_t             numChannels;
+};
+
+#endif /* MODBUS_WIMOD_SAMPLEAGGREGATOR_H_ */
@@ -0,0 +1,490 @@
+/*
+ * SampleLog.cpp
+ *
+ * Implementation of the store-and-forward sample log and the backfill
+ * airtime budget.
+ * see SampleLog.h for the page layout.
+ */
+
+#include "SampleLog.h"
+
+#include <string.h>
+#include <utils/CRC16.h>
+
+//-----------------------------------------------------------------------------
+// local defines
+//-----------------------------------------------------------------------------
+
+#define PAGE_MAGIC_RECORDS          0x4C53
+#define PAGE_MAGIC_META             0x4D53
+
+#define PAGE_OFS_MAGIC              0
+#define PAGE_OFS_SEQ                2
+#define PAGE_OFS_COUNT              6
+#define PAGE_OFS_CRC                (SAMPLE_LOG_PAGE_SIZE - SAMPLE_LOG_PAGE_CRC_SIZE)
+
+#define NUM_RECORD_PAGES            (SAMPLE_LOG_NUM_PAGES - 1)
+
+//-----------------------------------------------------------------------------
+// local helpers
+//-----------------------------------------------------------------------------
+
+static void put16(uint8_t* p, uint16_t v)
+{
+  p[0] = (uint8_t)(v);
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static uint16_t get16(const uint8_t* p)
+{
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void put32(uint8_t* p, uint32_t v)
+{
+  put16(p, (uint16_t) v);
+  put16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint32_t get32(const uint8_t* p)
+{
+  return (uint32_t) get16(p) | ((uint32_t) get16(p + 2) << 16);
+}
+
+static void sealPage(uint8_t* buf)
+{
+  uint16_t crc16 = ~CRC16_Calc(buf, PAGE_OFS_CRC, CRC16_INIT_VALUE);
+  put16(&buf[PAGE_OFS_CRC], crc16);
+}
+
+//-----------------------------------------------------------------------------
+// storage backends
+//-----------------------------------------------------------------------------
+
+#if defined(ARDUINO_ARCH_ESP32)
+
+SampleLogNvsStorage::SampleLogNvsStorage(const char* nameSpace)
+{
+  this->nameSpace = nameSpace;
+}
+
+bool SampleLogNvsStorage::begin(void)
+{
+  return prefs.begin(nameSpace, false);
+}
+
+bool SampleLogNvsStorage::readPage(uint16_t index, uint8_t* buf)
+{
+  char key[8];
+
+  snprintf(key, sizeof(key), "p%u", index);
+  return (prefs.getBytes(key, buf, SAMPLE_LOG_PAGE_SIZE) == SAMPLE_LOG_PAGE_SIZE);
+}
+
+bool SampleLogNvsStorage::writePage(uint16_t index, const uint8_t* buf)
+{
+  char key[8];
+
+  snprintf(key, sizeof(key), "p%u", index);
+  return (prefs.putBytes(key, buf, SAMPLE_LOG_PAGE_SIZE) == SAMPLE_LOG_PAGE_SIZE);
+}
+
+#endif
+
+#if defined(__linux__)
+
+SampleLogFileStorage::SampleLogFileStorage(const char* fileName)
+{
+  this->fileName = fileName;
+  file           = NULL;
+}
+
+SampleLogFileStorage::~SampleLogFileStorage()
+{
+  if (file) {
+    fclose(file);
+  }
+}
+
+bool SampleLogFileStorage::begin(void)
+{
+  file = fopen(fileName, "r+b");
+  if (file == NULL) {
+    file = fopen(fileName, "w+b");
+  }
+  return (file != NULL);
+}
+
+bool SampleLogFileStorage::readPage(uint16_t index, uint8_t* buf)
+{
+  if ((file == NULL) || fseek(file, (long) index * SAMPLE_LOG_PAGE_SIZE, SEEK_SET)) {
+    return false;
+  }
+  return (fread(buf, 1, SAMPLE_LOG_PAGE_SIZE, file) == SAMPLE_LOG_PAGE_SIZE);
+}
+
+bool SampleLogFileStorage::writePage(uint16_t index, const uint8_t* buf)
+{
+  if ((file == NULL) || fseek(file, (long) index * SAMPLE_LOG_PAGE_SIZE, SEEK_SET)) {
+    return false;
+  }
+  if (fwrite(buf, 1, SAMPLE_LOG_PAGE_SIZE, file) != SAMPLE_LOG_PAGE_SIZE) {
+    return false;
+  }
+  return (fflush(file) == 0);
+}
+
+#endif
+
+//-----------------------------------------------------------------------------
+// SampleLog
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Constructor
+ */
+SampleLog::SampleLog(SampleLogStorage& storage)
+  : storage(storage)
+{
+  memset(page, 0x00, sizeof(page));
+  pageIndex  = 1;
+  pageSeq    = 1;
+  tailIndex  = 1;
+  nextSeq    = 1;
+  drainedSeq = 0;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Open the storage and restore the log state
+ *
+ * Scans all record pages; the page with the highest page sequence number
+ * becomes the write page, the one with the lowest the tail.
+ */
+bool SampleLog::begin(void)
+{
+  uint32_t newestSeq = 0;
+  uint32_t oldestSeq = 0xFFFFFFFF;
+  uint16_t newest    = 0;
+  uint16_t oldest    = 0;
+  uint16_t i;
+
+  if (!storage.begin()) {
+    return false;
+  }
+
+  drainedSeq = 0;
+  if (loadPage(0, readBuf) && (get16(&readBuf[PAGE_OFS_MAGIC]) == PAGE_MAGIC_META)) {
+    drainedSeq = get32(&readBuf[PAGE_OFS_SEQ]);
+  }
+
+  for (i = 1; i < SAMPLE_LOG_NUM_PAGES; i++) {
+    if (!loadPage(i, readBuf) || (get16(&readBuf[PAGE_OFS_MAGIC]) != PAGE_MAGIC_RECORDS)) {
+      continue;
+    }
+    uint32_t seq = get32(&readBuf[PAGE_OFS_SEQ]);
+    if (seq >= newestSeq) {
+      newestSeq = seq;
+      newest    = i;
+    }
+    if (seq < oldestSeq) {
+      oldestSeq = seq;
+      oldest    = i;
+    }
+  }
+
+  nextSeq = drainedSeq + 1;
+  if (newest == 0) {
+    // empty log
+    pageIndex = 1;
+    pageSeq   = 1;
+    tailIndex = 1;
+    memset(page, 0x00, sizeof(page));
+    put16(&page[PAGE_OFS_MAGIC], PAGE_MAGIC_RECORDS);
+    put32(&page[PAGE_OFS_SEQ], pageSeq);
+    return true;
+  }
+
+  loadPage(newest, page);
+  pageIndex = newest;
+  pageSeq   = newestSeq;
+  tailIndex = oldest;
+
+  if (page[PAGE_OFS_COUNT]) {
+    TSampleRecord last;
+    getRecord(page, page[PAGE_OFS_COUNT] - 1, last);
+    if (last.Seq >= nextSeq) {
+      nextSeq = last.Seq + 1;
+    }
+  }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Append a record; assigns its sequence number
+ *
+ * If the ring is full the oldest page is overwritten.
+ */
+bool SampleLog::append(TSampleRecord& record)
+{
+  uint8_t count = page[PAGE_OFS_COUNT];
+
+  if (count >= SAMPLE_LOG_RECORDS_PER_PAGE) {
+    pageIndex = nextPageIndex(pageIndex);
+    pageSeq++;
+    if (pageIndex == tailIndex) {
+      // oldest page gets overwritten
+      tailIndex = nextPageIndex(tailIndex);
+    }
+    memset(page, 0x00, sizeof(page));
+    put16(&page[PAGE_OFS_MAGIC], PAGE_MAGIC_RECORDS);
+    put32(&page[PAGE_OFS_SEQ], pageSeq);
+    count = 0;
+  }
+
+  record.Seq = nextSeq++;
+  putRecord(page, count, record);
+  page[PAGE_OFS_COUNT] = count + 1;
+
+  return storeCurrentPage();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Read up to maxRecords pending records, oldest first
+ *
+ * @return number of records copied to records
+ */
+uint8_t SampleLog::read(TSampleRecord* records, uint8_t maxRecords)
+{
+  uint8_t  n   = 0;
+  uint16_t idx = tailIndex;
+  uint16_t i;
+  uint8_t  slot;
+
+  if ((records == NULL) || (maxRecords == 0)) {
+    return 0;
+  }
+
+  for (i = 0; i < NUM_RECORD_PAGES; i++) {
+    const uint8_t* buf = page;
+
+    if (idx != pageIndex) {
+      if (!loadPage(idx, readBuf) || (get16(&readBuf[PAGE_OFS_MAGIC]) != PAGE_MAGIC_RECORDS)) {
+        if (n == 0) {
+          tailIndex = nextPageIndex(idx);
+        }
+        idx = nextPageIndex(idx);
+        continue;
+      }
+      buf = readBuf;
+    }
+
+    for (slot = 0; (slot < buf[PAGE_OFS_COUNT]) && (n < maxRecords); slot++) {
+      getRecord(buf, slot, records[n]);
+      if (records[n].Seq > drainedSeq) {
+        n++;
+      }
+    }
+
+    if ((n == 0) && (idx != pageIndex)) {
+      // page completely drained
+      tailIndex = nextPageIndex(idx);
+    }
+    if ((n >= maxRecords) || (idx == pageIndex)) {
+      break;
+    }
+    idx = nextPageIndex(idx);
+  }
+  return n;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Mark all records up to seq as sent
+ */
+void SampleLog::markDrained(uint32_t seq)
+{
+  if ((seq > drainedSeq) && (seq < nextSeq)) {
+    drainedSeq = seq;
+    storeMeta();
+  }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Number of pending records
+ *
+ * Clipped to the records still held by the ring: the full pages from the
+ * tail up to the write page plus the records of the write page. After a
+ * wrap the tail is the page behind the write page, so one page less than
+ * NUM_RECORD_PAGES is full.
+ */
+uint32_t SampleLog::getPendingCount(void) const
+{
+  uint32_t pending   = nextSeq - 1 - drainedSeq;
+  uint16_t fullPages = (pageIndex + NUM_RECORD_PAGES - tailIndex) % NUM_RECORD_PAGES;
+  uint32_t stored    = (uint32_t) fullPages * SAMPLE_LOG_RECORDS_PER_PAGE + page[PAGE_OFS_COUNT];
+
+  return (pending > stored) ? stored : pending;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Encode records into a backfill frame
+ *
+ * Frame layout (big endian):
+ *   [count] { [seq:4] [time:4] [valid mask:1] [value:2] * SAMPLE_LOG_NUM_VALUES } * count
+ *
+ * @return number of bytes written; 0 if not even one record fits
+ */
+uint8_t SampleLog::encode(const TSampleRecord* records, uint8_t numRecords, uint8_t* buf, uint8_t size)
+{
+  uint8_t offset = 1;
+  uint8_t n;
+  uint8_t i;
+
+  if ((records == NULL) || (buf == NULL) || (size < 1 + SAMPLE_LOG_RECORD_SIZE)) {
+    return 0;
+  }
+
+  for (n = 0; (n < numRecords) && ((offset + SAMPLE_LOG_RECORD_SIZE) <= size); n++) {
+    const TSampleRecord& r = records[n];
+
+    buf[offset++] = (uint8_t)(r.Seq >> 24);
+    buf[offset++] = (uint8_t)(r.Seq >> 16);
+    buf[offset++] = (uint8_t)(r.Seq >> 8);
+    buf[offset++] = (uint8_t)(r.Seq);
+    buf[offset++] = (uint8_t)(r.Time >> 24);
+    buf[offset++] = (uint8_t)(r.Time >> 16);
+    buf[offset++] = (uint8_t)(r.Time >> 8);
+    buf[offset++] = (uint8_t)(r.Time);
+    buf[offset++] = r.ValidMask;
+    for (i = 0; i < SAMPLE_LOG_NUM_VALUES; i++) {
+      buf[offset++] = (uint8_t)(r.Values[i] >> 8);
+      buf[offset++] = (uint8_t)(r.Values[i]);
+    }
+  }
+  buf[0] = n;
+  return (n == 0) ? 0 : offset;
+}
+
+//-----------------------------------------------------------------------------
+// private functions
+//-----------------------------------------------------------------------------
+
+bool SampleLog::loadPage(uint16_t index, uint8_t* buf)
+{
+  if (!storage.readPage(index, buf)) {
+    return false;
+  }
+  return CRC16_Check(buf, SAMPLE_LOG_PAGE_SIZE, CRC16_INIT_VALUE);
+}
+
+bool SampleLog::storeCurrentPage(void)
+{
+  sealPage(page);
+  return storage.writePage(pageIndex, page);
+}
+
+bool SampleLog::storeMeta(void)
+{
+  memset(readBuf, 0x00, sizeof(readBuf));
+  put16(&readBuf[PAGE_OFS_MAGIC], PAGE_MAGIC_META);
+  put32(&readBuf[PAGE_OFS_SEQ], drainedSeq);
+  sealPage(readBuf);
+  return storage.writePage(0, readBuf);
+}
+
+uint16_t SampleLog::nextPageIndex(uint16_t index) const
+{
+  return (index + 1 < SAMPLE_LOG_NUM_PAGES) ? (index + 1) : 1;
+}
+
+void SampleLog::getRecord(const uint8_t* page, uint8_t slot, TSampleRecord& record)
+{
+  const uint8_t* p = &page[SAMPLE_LOG_PAGE_HDR_SIZE + slot * SAMPLE_LOG_RECORD_SIZE];
+  uint8_t        i;
+
+  record.Seq       = get32(p);
+  record.Time      = get32(p + 4);
+  record.ValidMask = p[8];
+  for (i = 0; i < SAMPLE_LOG_NUM_VALUES; i++) {
+    record.Values[i] = (int16_t) get16(p + 9 + 2 * i);
+  }
+}
+
+void SampleLog::putRecord(uint8_t* page, uint8_t slot, const TSampleRecord& record)
+{
+  uint8_t* p = &page[SAMPLE_LOG_PAGE_HDR_SIZE + slot * SAMPLE_LOG_RECORD_SIZE];
+  uint8_t  i;
+
+  put32(p, record.Seq);
+  put32(p + 4, record.Time);
+  p[8] = record.ValidMask;
+  for (i = 0; i < SAMPLE_LOG_NUM_VALUES; i++) {
+    put16(p + 9 + 2 * i, (uint16_t) record.Values[i]);
+  }
+}
+
+//-----------------------------------------------------------------------------
+// BackfillScheduler
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Constructor
+ *
+ * @param dutyCyclePermille  allowed duty cycle in 1/1000 (e.g. 10 = 1%)
+ * @param maxBudgetMs        max. airtime that can be saved up
+ * @param reserveMs          airtime kept back for the regular uplinks
+ */
+BackfillScheduler::BackfillScheduler(uint16_t dutyCyclePermille, uint32_t maxBudgetMs, uint32_t reserveMs)
+{
+  dutyCycle   = dutyCyclePermille;
+  maxBudgetUs = maxBudgetMs * 1000;
+  reserveUs   = reserveMs * 1000;
+  budgetUs    = 0;
+  lastRefill  = 0;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Debit the airtime of an uplink (regular or backfill)
+ */
+void BackfillScheduler::onAirtime(uint32_t airtimeMs, uint32_t now)
+{
+  refill(now);
+  airtimeMs *= 1000;
+  budgetUs = (airtimeMs > budgetUs) ? 0 : (budgetUs - airtimeMs);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Check if a backfill uplink of the given airtime fits into the budget
+ */
+bool BackfillScheduler::canSend(uint32_t estAirtimeMs, uint32_t now)
+{
+  refill(now);
+  return (budgetUs >= (estAirtimeMs * 1000 + reserveUs));
+}
+
+//-----------------------------------------------------------------------------
+// private functions
+//-----------------------------------------------------------------------------
+
+void BackfillScheduler::refill(uint32_t now)
+{
+  uint32_t elapsed = now - lastRefill;
+
+  lastRefill = now;
+  // elapsed ms * duty cycle in permille = earned airtime in us
+  if (elapsed > (maxBudgetUs / (dutyCycle ? dutyCycle : 1))) {
+    budgetUs = maxBudgetUs;
+    return;
+  }
+  budgetUs += elapsed * dutyCycle;
+  if (budgetUs > maxBudgetUs) {
+    budgetUs = maxBudgetUs;
+  }
+}
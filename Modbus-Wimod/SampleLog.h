@@ -0,0 +1,203 @@
+/*
+ * SampleLog.h
+ *
+ * Persistent store-and-forward log for sensor records.
+ *
+ * Records that can not be sent (device not activated, uplink blocked) are
+ * appended to the log and drained later by the backfill path.
+ *
+ * The storage is split into fixed-size pages; page 0 holds the meta data
+ * (sequence number of the last drained record), all other pages form a ring
+ * of record pages. Every page is protected by a CRC16; pages with a bad CRC
+ * are ignored on start-up. When the ring is full the oldest page is
+ * overwritten.
+ *
+ * Record page layout (little endian):
+ *
+ *   [magic:2] [page seq:4] [count:1] [rfu:1] [record] ... [crc16:2]
+ *
+ * Every record carries a sequence number which is unique across resets, so
+ * the server can de-duplicate records that have been sent twice.
+ *
+ * Storage backends:
+ *   ESP32 : NVS (Preferences), one blob per page
+ *   Linux : single file; stand-in for host builds
+ */
+
+#ifndef MODBUS_WIMOD_SAMPLELOG_H_
+#define MODBUS_WIMOD_SAMPLELOG_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <Preferences.h>
+#endif
+
+//-----------------------------------------------------------------------------
+// common defines
+//-----------------------------------------------------------------------------
+
+/** size of a single storage page */
+#define SAMPLE_LOG_PAGE_SIZE        128
+
+/** number of storage pages incl. meta page */
+#define SAMPLE_LOG_NUM_PAGES        48
+
+/** number of sensor values per record */
+#define SAMPLE_LOG_NUM_VALUES       4
+
+/** size of a serialized record: seq, time, valid mask, values */
+#define SAMPLE_LOG_RECORD_SIZE      (4 + 4 + 1 + 2 * SAMPLE_LOG_NUM_VALUES)
+
+/** page header and trailer */
+#define SAMPLE_LOG_PAGE_HDR_SIZE    8
+#define SAMPLE_LOG_PAGE_CRC_SIZE    2
+
+/** records per page */
+#define SAMPLE_LOG_RECORDS_PER_PAGE ((SAMPLE_LOG_PAGE_SIZE - SAMPLE_LOG_PAGE_HDR_SIZE - SAMPLE_LOG_PAGE_CRC_SIZE) \
+                                     / SAMPLE_LOG_RECORD_SIZE)
+
+/** LoRaWAN port used for backfill frames */
+#define SAMPLE_LOG_LORAWAN_PORT     0x25
+
+//-----------------------------------------------------------------------------
+// user defined types
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief A single logged record
+ */
+typedef struct TSampleRecord
+{
+  uint32_t  Seq;                            /*!< unique sequence number; assigned by the log */
+  uint32_t  Time;                           /*!< node time stamp in s */
+  uint8_t   ValidMask;                      /*!< bit i set -> Values[i] is valid */
+  int16_t   Values[SAMPLE_LOG_NUM_VALUES];  /*!< sensor values in raw units */
+} TSampleRecord;
+
+//-----------------------------------------------------------------------------
+// storage backends
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Page based storage interface of the sample log
+ */
+class SampleLogStorage {
+public:
+  virtual ~SampleLogStorage() {}
+
+  virtual bool     begin(void) = 0;
+  virtual bool     readPage(uint16_t index, uint8_t* buf) = 0;
+  virtual bool     writePage(uint16_t index, const uint8_t* buf) = 0;
+};
+
+#if defined(ARDUINO_ARCH_ESP32)
+/**
+ * @brief NVS backend; NVS takes care of wear leveling
+ */
+class SampleLogNvsStorage : public SampleLogStorage {
+public:
+  SampleLogNvsStorage(const char* nameSpace);
+
+  bool     begin(void);
+  bool     readPage(uint16_t index, uint8_t* buf);
+  bool     writePage(uint16_t index, const uint8_t* buf);
+
+private:
+  Preferences         prefs;
+  const char*         nameSpace;
+};
+#endif
+
+#if defined(__linux__)
+/**
+ * @brief File backend for host builds
+ */
+class SampleLogFileStorage : public SampleLogStorage {
+public:
+  SampleLogFileStorage(const char* fileName);
+  ~SampleLogFileStorage();
+
+  bool     begin(void);
+  bool     readPage(uint16_t index, uint8_t* buf);
+  bool     writePage(uint16_t index, const uint8_t* buf);
+
+private:
+  FILE*               file;
+  const char*         fileName;
+};
+#endif
+
+//-----------------------------------------------------------------------------
+// class declaration
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Append-only ring log of sensor records
+ *
+ * Usage:
+ *  1. append() records that could not be sent
+ *  2. read() a batch of pending records, send them
+ *  3. markDrained() the last sequence number once the batch is queued
+ */
+class SampleLog {
+public:
+  SampleLog(SampleLogStorage& storage);
+
+  bool      begin(void);
+
+  bool      append(TSampleRecord& record);
+  uint8_t   read(TSampleRecord* records, uint8_t maxRecords);
+  void      markDrained(uint32_t seq);
+
+  bool      hasPending(void) const { return (nextSeq - 1) != drainedSeq; }
+  uint32_t  getPendingCount(void) const;
+
+  static uint8_t encode(const TSampleRecord* records, uint8_t numRecords, uint8_t* buf, uint8_t size);
+
+private:
+  bool      loadPage(uint16_t index, uint8_t* buf);
+  bool      storeCurrentPage(void);
+  bool      storeMeta(void);
+  uint16_t  nextPageIndex(uint16_t index) const;
+
+  static void     getRecord(const uint8_t* page, uint8_t slot, TSampleRecord& record);
+  static void     putRecord(uint8_t* page, uint8_t slot, const TSampleRecord& record);
+
+  SampleLogStorage&   storage;
+  uint8_t             page[SAMPLE_LOG_PAGE_SIZE];      /*!< RAM copy of the current write page */
+  uint8_t             readBuf[SAMPLE_LOG_PAGE_SIZE];   /*!< scratch buffer for read() */
+  uint16_t            pageIndex;                       /*!< index of the current write page */
+  uint32_t            pageSeq;                         /*!< sequence number of the current write page */
+  uint16_t            tailIndex;                       /*!< oldest page that may hold pending records */
+  uint32_t            nextSeq;                         /*!< sequence number of the next record */
+  uint32_t            drainedSeq;                      /*!< sequence number of the last drained record */
+};
+
+/**
+ * @brief Airtime budget for backfill uplinks
+ *
+ * Token bucket credited with the duty cycle share of the elapsed time and
+ * debited by the measured airtime of every uplink. Backfill is only allowed
+ * while the bucket keeps a reserve for the regular uplinks.
+ */
+class BackfillScheduler {
+public:
+  BackfillScheduler(uint16_t dutyCyclePermille, uint32_t maxBudgetMs, uint32_t reserveMs);
+
+  void      onAirtime(uint32_t airtimeMs, uint32_t now);
+  bool      canSend(uint32_t estAirtimeMs, uint32_t now);
+  uint32_t  getBudgetMs(void) const { return budgetUs / 1000; }
+
+private:
+  void      refill(uint32_t now);
+
+  uint16_t            dutyCycle;
+  uint32_t            maxBudgetUs;
+  uint32_t            reserveUs;
+  uint32_t            budgetUs;
+  uint32_t            lastRefill;
+};
+
+#endif /* MODBUS_WIMOD_SAMPLELOG_H_ */
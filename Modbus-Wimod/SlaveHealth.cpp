@@ -0,0 +1,273 @@
+/*
+ * SlaveHealth.cpp
+ *
+ * Implementation of the Modbus slave health tracker.
+ * see SlaveHealth.h for details.
+ */
+
+#include "SlaveHealth.h"
+
+#include <string.h>
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Constructor
+ *
+ * @param basePollIntervalMs  regular poll interval; used as first backoff step
+ */
+SlaveHealthTracker::SlaveHealthTracker(uint32_t basePollIntervalMs)
+{
+  memset(slaves, 0x00, sizeof(slaves));
+  numSlaves        = 0;
+  basePollInterval = basePollIntervalMs;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Register a slave address for tracking
+ *
+ * @retval true  if the slave is tracked (new or already known)
+ */
+bool SlaveHealthTracker::addSlave(uint8_t slaveID)
+{
+  if (find(slaveID)) {
+    return true;
+  }
+  if (numSlaves >= SLAVE_HEALTH_MAX_SLAVES) {
+    return false;
+  }
+  TSlaveHealth& s = slaves[numSlaves++];
+  memset(&s, 0x00, sizeof(s));
+  s.SlaveID        = slaveID;
+  // no history yet: start with the upper timeout bound
+  s.AvgResponseMs8 = (SLAVE_HEALTH_TIMEOUT_MAX_MS / 2) * 8;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Stop tracking a slave address
+ *
+ * @retval true  if the slave was tracked
+ */
+bool SlaveHealthTracker::removeSlave(uint8_t slaveID)
+{
+  TSlaveHealth* s = find(slaveID);
+
+  if (s == NULL) {
+    return false;
+  }
+  // order does not matter: move the last record into the gap
+  *s = slaves[--numSlaves];
+  memset(&slaves[numSlaves], 0x00, sizeof(TSlaveHealth));
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Stop tracking all slaves that are not in the given list
+ *
+ * The slaves in the list keep their health history; call addSlave() for
+ * them afterwards to track new addresses.
+ */
+void SlaveHealthTracker::retainSlaves(const uint8_t* slaveIDs, uint8_t count)
+{
+  uint8_t i = 0;
+  uint8_t j;
+
+  while (i < numSlaves) {
+    for (j = 0; (j < count) && (slaveIDs[j] != slaves[i].SlaveID); j++);
+    if (j == count) {
+      removeSlave(slaves[i].SlaveID);       // slot i is refilled, check again
+    } else {
+      i++;
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Check if a slave is due for polling
+ *
+ * Online slaves are always due; offline slaves only after their backoff
+ * interval has expired.
+ */
+bool SlaveHealthTracker::shouldPoll(uint8_t slaveID, uint32_t now) const
+{
+  const TSlaveHealth* s = getHealth(slaveID);
+
+  if (s == NULL) {
+    return false;
+  }
+  return ((int32_t)(now - s->NextPollTime) >= 0);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Record a valid response
+ *
+ * @param responseMs  time between request and complete response
+ */
+void SlaveHealthTracker::recordSuccess(uint8_t slaveID, uint32_t responseMs, uint32_t now)
+{
+  TSlaveHealth* s = find(slaveID);
+  int32_t       sample;
+  int32_t       err;
+
+  if (s == NULL) {
+    return;
+  }
+
+  if (s->Requests < 0xFFFF) {
+    s->Requests++;
+    s->Successes++;
+  }
+
+  if (responseMs > SLAVE_HEALTH_TIMEOUT_MAX_MS) {
+    responseMs = SLAVE_HEALTH_TIMEOUT_MAX_MS;
+  }
+  sample = (int32_t) responseMs * 8;
+
+  if (!s->Seen) {
+    // first sample initializes the estimator
+    s->AvgResponseMs8 = (uint16_t) sample;
+    s->DevResponseMs8 = (uint16_t)(sample / 2);
+  } else {
+    // smoothed mean (gain 1/8) and mean deviation (gain 1/4)
+    err = sample - (int32_t) s->AvgResponseMs8;
+    s->AvgResponseMs8 = (uint16_t)((int32_t) s->AvgResponseMs8 + err / 8);
+    if (err < 0) {
+      err = -err;
+    }
+    s->DevResponseMs8 = (uint16_t)((int32_t) s->DevResponseMs8 + (err - (int32_t) s->DevResponseMs8) / 4);
+  }
+
+  s->Seen                = true;
+  s->ConsecutiveFailures = 0;
+  s->LastSuccessTime     = now;
+  s->NextPollTime        = now;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Record a failed request (timeout, CRC error, exception response)
+ *
+ * After SLAVE_HEALTH_OFFLINE_FAILURES failures in a row the next poll is
+ * delayed exponentially; base interval doubled per further failure.
+ */
+void SlaveHealthTracker::recordFailure(uint8_t slaveID, uint32_t now)
+{
+  TSlaveHealth* s = find(slaveID);
+  uint32_t      backoff;
+  uint8_t       shift;
+
+  if (s == NULL) {
+    return;
+  }
+
+  if (s->Requests < 0xFFFF) {
+    s->Requests++;
+  }
+  if (s->ConsecutiveFailures < 0xFF) {
+    s->ConsecutiveFailures++;
+  }
+
+  s->NextPollTime = now;
+  if (s->ConsecutiveFailures >= SLAVE_HEALTH_OFFLINE_FAILURES) {
+    shift   = s->ConsecutiveFailures - SLAVE_HEALTH_OFFLINE_FAILURES;
+    backoff = SLAVE_HEALTH_BACKOFF_MAX_MS;
+    if ((shift < 16) && ((basePollInterval << shift) < SLAVE_HEALTH_BACKOFF_MAX_MS)) {
+      backoff = basePollInterval << shift;
+    }
+    s->NextPollTime = now + backoff;
+  }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Returns true if the slave answered recently (not in backoff)
+ */
+bool SlaveHealthTracker::isOnline(uint8_t slaveID) const
+{
+  const TSlaveHealth* s = getHealth(slaveID);
+
+  return (s && s->Seen && (s->ConsecutiveFailures < SLAVE_HEALTH_OFFLINE_FAILURES));
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Returns true if the last valid sample is older than maxAgeMs
+ */
+bool SlaveHealthTracker::isStale(uint8_t slaveID, uint32_t now, uint32_t maxAgeMs) const
+{
+  const TSlaveHealth* s = getHealth(slaveID);
+
+  if ((s == NULL) || !s->Seen) {
+    return true;
+  }
+  return ((uint32_t)(now - s->LastSuccessTime) > maxAgeMs);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Success rate in percent over the lifetime of the tracker
+ */
+uint8_t SlaveHealthTracker::getSuccessRate(uint8_t slaveID) const
+{
+  const TSlaveHealth* s = getHealth(slaveID);
+
+  if ((s == NULL) || (s->Requests == 0)) {
+    return 0;
+  }
+  return (uint8_t)(((uint32_t) s->Successes * 100) / s->Requests);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Response timeout derived from the observed response times
+ *
+ * timeout = mean + 4 * mean deviation; clipped to the configured bounds
+ */
+uint16_t SlaveHealthTracker::getTimeout(uint8_t slaveID) const
+{
+  const TSlaveHealth* s = getHealth(slaveID);
+  uint32_t            timeout;
+
+  if ((s == NULL) || !s->Seen) {
+    return SLAVE_HEALTH_TIMEOUT_MAX_MS;
+  }
+  timeout = ((uint32_t) s->AvgResponseMs8 + 4 * (uint32_t) s->DevResponseMs8) / 8;
+
+  if (timeout < SLAVE_HEALTH_TIMEOUT_MIN_MS) {
+    timeout = SLAVE_HEALTH_TIMEOUT_MIN_MS;
+  }
+  if (timeout > SLAVE_HEALTH_TIMEOUT_MAX_MS) {
+    timeout = SLAVE_HEALTH_TIMEOUT_MAX_MS;
+  }
+  return (uint16_t) timeout;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Read access to the health record of a slave; NULL if unknown
+ */
+const TSlaveHealth* SlaveHealthTracker::getHealth(uint8_t slaveID) const
+{
+  uint8_t i;
+
+  for (i = 0; i < numSlaves; i++) {
+    if (slaves[i].SlaveID == slaveID) {
+      return &slaves[i];
+    }
+  }
+  return NULL;
+}
+
+//-----------------------------------------------------------------------------
+// private functions
+//-----------------------------------------------------------------------------
+
+TSlaveHealth* SlaveHealthTracker::find(uint8_t slaveID)
+{
+  return (TSlaveHealth*) getHealth(slaveID);
+}
@@ -0,0 +1,88 @@
+/*
+ * SlaveHealth.h
+ *
+ * Health tracking for the Modbus slaves on the RS485 bus.
+ *
+ * For every slave the tracker records the success rate and a smoothed
+ * response time. A response timeout is derived from the observed response
+ * times and slaves that stop answering are polled with an exponential
+ * backoff, so a dead sensor does not block the bus on every cycle.
+ */
+
+#ifndef MODBUS_WIMOD_SLAVEHEALTH_H_
+#define MODBUS_WIMOD_SLAVEHEALTH_H_
+
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------
+// common defines
+//-----------------------------------------------------------------------------
+
+/** max. number of tracked slaves */
+#define SLAVE_HEALTH_MAX_SLAVES         8
+
+/** consecutive failures before a slave is considered offline */
+#define SLAVE_HEALTH_OFFLINE_FAILURES   2
+
+/** lower / upper bound of the derived response timeout in ms */
+#define SLAVE_HEALTH_TIMEOUT_MIN_MS     50
+#define SLAVE_HEALTH_TIMEOUT_MAX_MS     2000
+
+/** upper bound for the backoff poll interval of an offline slave in ms */
+#define SLAVE_HEALTH_BACKOFF_MAX_MS     (10UL * 60UL * 1000UL)
+
+//-----------------------------------------------------------------------------
+// user defined types
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Health information of a single slave
+ */
+typedef struct TSlaveHealth
+{
+  uint8_t   SlaveID;              /*!< Modbus slave address */
+  uint16_t  Requests;             /*!< number of requests sent (saturating) */
+  uint16_t  Successes;            /*!< number of valid responses (saturating) */
+  uint8_t   ConsecutiveFailures;  /*!< failures since the last valid response */
+  uint16_t  AvgResponseMs8;       /*!< smoothed response time in 1/8 ms */
+  uint16_t  DevResponseMs8;       /*!< smoothed mean deviation in 1/8 ms */
+  uint32_t  LastSuccessTime;      /*!< time stamp (ms) of the last valid response */
+  uint32_t  NextPollTime;         /*!< earliest time (ms) for the next request */
+  bool      Seen;                 /*!< true once a valid response has been received */
+} TSlaveHealth;
+
+//-----------------------------------------------------------------------------
+// class declaration
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Tracks the health of a set of Modbus slaves
+ */
+class SlaveHealthTracker {
+public:
+  SlaveHealthTracker(uint32_t basePollIntervalMs);
+
+  bool      addSlave(uint8_t slaveID);
+  bool      removeSlave(uint8_t slaveID);
+  void      retainSlaves(const uint8_t* slaveIDs, uint8_t count);
+
+  bool      shouldPoll(uint8_t slaveID, uint32_t now) const;
+  void      recordSuccess(uint8_t slaveID, uint32_t responseMs, uint32_t now);
+  void      recordFailure(uint8_t slaveID, uint32_t now);
+
+  bool      isOnline(uint8_t slaveID) const;
+  bool      isStale(uint8_t slaveID, uint32_t now, uint32_t maxAgeMs) const;
+  uint8_t   getSuccessRate(uint8_t slaveID) const;
+  uint16_t  getTimeout(uint8_t slaveID) const;
+
+  const TSlaveHealth* getHealth(uint8_t slaveID) const;
+
+private:
+  TSlaveHealth*       find(uint8_t slaveID);
+
+  TSlaveHealth        slaves[SLAVE_HEALTH_MAX_SLAVES];
+  uint8_t             numSlaves;
+  uint32_t            basePollInterval;
+};
+
+#endif /* MODBUS_WIMOD_SLAVEHEALTH_H_ */
@@ -0,0 +1,147 @@
+/*
+ * SampleLogTest.cpp
+ *
+ * Host check of the sample log (file backend): fills the ring beyond its
+ * capacity and compares the pending count with the records that can be
+ * drained, before and after a restart.
+ *
+ * Build and run (Linux), in this directory:
+ *   make test
+ */
+
+#include "../SampleLog.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+//-----------------------------------------------------------------------------
+// helpers
+//-----------------------------------------------------------------------------
+
+#define LOG_FILE        "SampleLogTest.bin"
+
+#define CHECK(cond)     check((cond), #cond, __LINE__)
+
+static int failures = 0;
+
+static void check(bool ok, const char* what, int line)
+{
+  if (!ok) {
+    printf("  FAILED (line %d): %s\n", line, what);
+    failures++;
+  }
+}
+
+static void appendRecords(SampleLog& log, uint32_t num)
+{
+  TSampleRecord r;
+  uint32_t      i;
+
+  for (i = 0; i < num; i++) {
+    memset(&r, 0x00, sizeof(r));
+    r.Time      = i;
+    r.ValidMask = 0x01;
+    r.Values[0] = (int16_t) i;
+    CHECK(log.append(r));
+  }
+}
+
+// read and mark drained until empty; returns the number of records
+static uint32_t drain(SampleLog& log, uint32_t* firstSeq)
+{
+  TSampleRecord batch[4];
+  uint32_t      total = 0;
+  uint32_t      last  = 0;
+  uint8_t       n;
+  uint8_t       i;
+
+  *firstSeq = 0;
+  while ((n = log.read(batch, 4)) != 0) {
+    for (i = 0; i < n; i++) {
+      if (total == 0) {
+        *firstSeq = batch[i].Seq;
+      } else {
+        CHECK(batch[i].Seq == last + 1);
+      }
+      last = batch[i].Seq;
+      total++;
+    }
+    log.markDrained(last);
+  }
+  CHECK(!log.hasPending());
+  return total;
+}
+
+//-----------------------------------------------------------------------------
+// tests
+//-----------------------------------------------------------------------------
+
+static void testNoWrap(void)
+{
+  SampleLogFileStorage storage(LOG_FILE);
+  SampleLog            log(storage);
+  uint32_t             first;
+
+  printf("no wrap\n");
+  unlink(LOG_FILE);
+  CHECK(log.begin());
+  appendRecords(log, 20);
+  CHECK(log.getPendingCount() == 20);
+  CHECK(drain(log, &first) == 20);
+  CHECK(first == 1);
+  CHECK(log.getPendingCount() == 0);
+}
+
+static void testWrap(void)
+{
+  const uint32_t numPages = SAMPLE_LOG_NUM_PAGES - 1;
+  const uint32_t perPage  = SAMPLE_LOG_RECORDS_PER_PAGE;
+  uint32_t       appended = numPages * perPage + 2 * perPage + 4;
+  uint32_t       first;
+  uint32_t       pending;
+
+  printf("wrap around\n");
+  unlink(LOG_FILE);
+  {
+    SampleLogFileStorage storage(LOG_FILE);
+    SampleLog            log(storage);
+
+    CHECK(log.begin());
+    appendRecords(log, appended);
+
+    // one page is always the partially filled write page
+    pending = log.getPendingCount();
+    CHECK(pending == (numPages - 1) * perPage + 4);
+  }
+  {
+    // same count after a restart
+    SampleLogFileStorage storage(LOG_FILE);
+    SampleLog            log(storage);
+
+    CHECK(log.begin());
+    CHECK(log.getPendingCount() == pending);
+    CHECK(drain(log, &first) == pending);
+    CHECK(first == appended - pending + 1);
+    CHECK(log.getPendingCount() == 0);
+
+    appendRecords(log, 3);
+    CHECK(log.getPendingCount() == 3);
+    CHECK(drain(log, &first) == 3);
+    CHECK(first == appended + 1);
+  }
+}
+
+//-----------------------------------------------------------------------------
+// main
+//-----------------------------------------------------------------------------
+
+int main(void)
+{
+  testNoWrap();
+  testWrap();
+  unlink(LOG_FILE);
+
+  printf("%s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
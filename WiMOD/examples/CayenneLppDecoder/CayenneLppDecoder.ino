@@ -0,0 +1,325 @@
+/*
+ * This is a simple example file to show how to use the WiMOD Arduino
+ * library in combination with the myDevices.com Cayenne LPP interface class
+ *
+ * http://www.wireless-solutions.de
+ *
+ */
+
+/*
+ * Example:
+ *
+ * This example demonstrates the decoder of the Cayenne LPP format, e.g.
+ * for downlinks in LPP format or for decoding uplinks on a host.
+ *
+ * - round trip: a frame is built with the CayenneLPP encoder and decoded
+ *   again; every value is compared with the fixed-point value the encoder
+ *   has written
+ * - malformed frames: unknown types and truncated records are detected
+ * - benchmark: a typical frame is decoded BENCH_LOOPS times via the
+ *   fixed-point and the float accessors; the result is printed in records/s
+ *
+ * The decoder does not allocate or copy anything; a record points into the
+ * payload buffer and converts the value on access.
+ *
+ * Setup requirements:
+ * -------------------
+ * - any Arduino board; no WiMOD module is needed. The sketch only uses the
+ *   debug output and can be compiled on a Linux host as well.
+ *
+ * Usage:
+ * -------
+ * - Start the program and watch the serial monitor @ 115200 baud
+ *
+ */
+
+
+#include <Cayenne/CayenneLPP.h>
+#include <Cayenne/CayenneLPP_Decoder.h>
+
+//-----------------------------------------------------------------------------
+// constant values
+//-----------------------------------------------------------------------------
+
+#define BUF_SIZE_CAYENNE    51          // max. payload of the slowest EU868 data rate
+#define BENCH_LOOPS         2000
+
+//-----------------------------------------------------------------------------
+// section RAM
+//-----------------------------------------------------------------------------
+
+static uint8_t bufCayenne[BUF_SIZE_CAYENNE];
+CayenneLPP cayenne(bufCayenne, BUF_SIZE_CAYENNE);
+
+// values of the round trip frame and the fixed-point value the encoder writes
+typedef struct TExpected
+{
+    uint8_t     Channel;
+    uint8_t     Type;
+    int32_t     Fixed[LPP_MAX_VALUES];
+} TExpected;
+
+static TExpected expected[12];
+static uint8_t   numExpected;
+
+static volatile int32_t benchSink;
+
+//-----------------------------------------------------------------------------
+// section code
+//-----------------------------------------------------------------------------
+
+/*****************************************************************************
+ * Function for printing out some debug infos via serial interface
+ ****************************************************************************/
+void debugMsg(String msg)
+{
+    Serial.print(msg);  // use default Arduino serial interface
+}
+
+void debugMsg(int a)
+{
+    Serial.print(a, DEC);
+}
+
+void debugMsg(unsigned long a)
+{
+    Serial.print(a, DEC);
+}
+
+/*****************************************************************************
+ * print out a welcome message
+ ****************************************************************************/
+void printStartMsg()
+{
+    debugMsg(F("==================================================\n"));
+    debugMsg(F("This is FileName: "));
+    debugMsg(F(__FILE__));
+    debugMsg(F("\r\n"));
+    debugMsg(F("Starting...\n"));
+    debugMsg(F("This simple demo will decode Cayenne LPP frames.\n"));
+    debugMsg(F("==================================================\n"));
+}
+
+/*****************************************************************************
+ * remember the expected value of the last added record
+ ****************************************************************************/
+void expect(uint8_t channel, uint8_t type, int32_t v0, int32_t v1 = 0, int32_t v2 = 0)
+{
+    TExpected& e = expected[numExpected++];
+
+    e.Channel  = channel;
+    e.Type     = type;
+    e.Fixed[0] = v0;
+    e.Fixed[1] = v1;
+    e.Fixed[2] = v2;
+}
+
+/*****************************************************************************
+ * build a frame with all LPP types
+ ****************************************************************************/
+void buildFrame()
+{
+    cayenne.reset();
+    numExpected = 0;
+
+    // the encoder truncates the scaled float; the casts below do the same
+    cayenne.addDigitalInput(1, 1);                  expect(1, LPP_DIGITAL_INPUT, 1);
+    cayenne.addDigitalOutput(2, 0);                 expect(2, LPP_DIGITAL_OUTPUT, 0);
+    cayenne.addAnalogInput(3, -12.5f);              expect(3, LPP_ANALOG_INPUT, (int16_t) (-12.5f * 100));
+    cayenne.addAnalogOutput(4, 3.3f);               expect(4, LPP_ANALOG_OUTPUT, (int16_t) (3.3f * 100));
+    cayenne.addLuminosity(5, 48000);                expect(5, LPP_LUMINOSITY, 48000);
+    cayenne.addPresence(6, 1);                      expect(6, LPP_PRESENCE, 1);
+    cayenne.addTemperature(7, -4.1f);               expect(7, LPP_TEMPERATURE, (int16_t) (-4.1f * 10));
+    cayenne.addRelativeHumidity(8, 63.5f);          expect(8, LPP_RELATIVE_HUMIDITY, (uint8_t) (63.5f * 2));
+    cayenne.addAccelerometer(9, 0.012f, -1.0f, 0.5f);
+    expect(9, LPP_ACCELEROMETER, (int16_t) (0.012f * 1000), (int16_t) (-1.0f * 1000), (int16_t) (0.5f * 1000));
+    cayenne.addBarometricPressure(10, 1013.2f);     expect(10, LPP_BAROMETRIC_PRESSURE, (int16_t) (1013.2f * 10));
+}
+
+/*****************************************************************************
+ * build a frame with GPS and gyrometer (does not fit into the frame above)
+ ****************************************************************************/
+void buildFrame2()
+{
+    cayenne.reset();
+    numExpected = 0;
+
+    cayenne.addGPS(1, 51.4924f, -6.5341f, -12.34f);
+    expect(1, LPP_GPS, (int32_t) (51.4924f * 10000), (int32_t) (-6.5341f * 10000), (int32_t) (-12.34f * 100));
+    cayenne.addGyrometer(2, 1.5f, -250.0f, 0.0f);
+    expect(2, LPP_GYROMETER, (int16_t) (1.5f * 100), (int16_t) (-250.0f * 100), 0);
+    cayenne.addTemperature(3, 21.5f);               expect(3, LPP_TEMPERATURE, (int16_t) (21.5f * 10));
+}
+
+/*****************************************************************************
+ * decode the frame of the encoder and compare with the expected values
+ ****************************************************************************/
+uint8_t checkRoundTrip()
+{
+    CayenneLPPDecoder decoder(cayenne.getBuffer(), cayenne.getSize());
+    CayenneLPPRecord  rec;
+    uint8_t           n      = 0;
+    uint8_t           errors = 0;
+    uint8_t           i;
+
+    while (decoder.next(rec)) {
+        const TExpected& e = expected[n++];
+
+        if ((rec.getChannel() != e.Channel) || (rec.getType() != e.Type)) {
+            errors++;
+            continue;
+        }
+        for (i = 0; i < rec.getNumValues(); i++) {
+            if (rec.getFixed(i) != e.Fixed[i]) {
+                debugMsg(F("  channel "));
+                debugMsg((int) e.Channel);
+                debugMsg(F(": got "));
+                debugMsg((int) rec.getFixed(i));
+                debugMsg(F(" expected "));
+                debugMsg((int) e.Fixed[i]);
+                debugMsg(F("\n"));
+                errors++;
+            }
+        }
+    }
+    if ((decoder.getError() != LPP_DECODE_OK) || (n != numExpected)) {
+        errors++;
+    }
+
+    debugMsg(F("round trip: "));
+    debugMsg((int) n);
+    debugMsg(F(" records, "));
+    debugMsg((int) cayenne.getSize());
+    debugMsg(F(" bytes, "));
+    debugMsg((int) errors);
+    debugMsg(F(" errors\n"));
+    return errors;
+}
+
+/*****************************************************************************
+ * print all records of the current frame
+ ****************************************************************************/
+void printFrame()
+{
+    CayenneLPPDecoder decoder(cayenne.getBuffer(), cayenne.getSize());
+    CayenneLPPRecord  rec;
+    uint8_t           i;
+
+    while (decoder.next(rec)) {
+        debugMsg(F("  channel "));
+        debugMsg((int) rec.getChannel());
+        debugMsg(F(" type "));
+        debugMsg((int) rec.getType());
+        debugMsg(F(":"));
+        for (i = 0; i < rec.getNumValues(); i++) {
+            debugMsg(F(" "));
+            debugMsg(String(rec.getFloat(i), 4));
+        }
+        debugMsg(F("\n"));
+    }
+}
+
+/*****************************************************************************
+ * malformed frames must stop the decoder
+ ****************************************************************************/
+uint8_t checkMalformed()
+{
+    static const uint8_t truncated[] = { 1, LPP_TEMPERATURE, 0x00, 0xD7, 2, LPP_TEMPERATURE, 0x01 };
+    static const uint8_t unknown[]   = { 1, LPP_PRESENCE, 1, 2, 200, 0x00 };
+    CayenneLPPRecord     rec;
+    uint8_t              errors = 0;
+    uint8_t              n;
+
+    CayenneLPPDecoder d1(truncated, sizeof(truncated));
+    for (n = 0; d1.next(rec); n++);
+    if ((n != 1) || (d1.getError() != LPP_DECODE_TRUNCATED) || (d1.getOffset() != 4)) {
+        errors++;
+    }
+
+    CayenneLPPDecoder d2(unknown, sizeof(unknown));
+    for (n = 0; d2.next(rec); n++);
+    if ((n != 1) || (d2.getError() != LPP_DECODE_UNKNOWN_TYPE) || (d2.getOffset() != 3)) {
+        errors++;
+    }
+
+    debugMsg(F("malformed frames: "));
+    debugMsg((int) errors);
+    debugMsg(F(" errors\n"));
+    return errors;
+}
+
+/*****************************************************************************
+ * decode the current frame BENCH_LOOPS times
+ ****************************************************************************/
+void benchmark(bool useFloat)
+{
+    CayenneLPPRecord rec;
+    unsigned long    start;
+    unsigned long    us;
+    unsigned long    records = 0;
+    int32_t          sum     = 0;
+    float            fsum    = 0;
+    uint16_t         loop;
+    uint8_t          i;
+
+    start = micros();
+    for (loop = 0; loop < BENCH_LOOPS; loop++) {
+        CayenneLPPDecoder decoder(cayenne.getBuffer(), cayenne.getSize());
+
+        while (decoder.next(rec)) {
+            for (i = 0; i < rec.getNumValues(); i++) {
+                if (useFloat) {
+                    fsum += rec.getFloat(i);
+                } else {
+                    sum += rec.getFixed(i);
+                }
+            }
+            records++;
+        }
+    }
+    us = micros() - start;
+    benchSink = sum + (int32_t) fsum;
+
+    debugMsg(useFloat ? F("float:       ") : F("fixed-point: "));
+    debugMsg(records);
+    debugMsg(F(" records in "));
+    debugMsg(us);
+    debugMsg(F(" us = "));
+    debugMsg((unsigned long) ((us > 0) ? (records * 1000ULL * 1000) / us : 0));
+    debugMsg(F(" records/s\n"));
+}
+
+/*****************************************************************************
+ * Arduino setup function
+ ****************************************************************************/
+void setup()
+{
+    uint8_t errors = 0;
+
+    // debug interface
+    Serial.begin(115200);
+
+    printStartMsg();
+
+    buildFrame2();
+    errors += checkRoundTrip();
+    printFrame();
+
+    buildFrame();
+    errors += checkRoundTrip();
+    printFrame();
+
+    errors += checkMalformed();
+
+    debugMsg(errors ? F("FAILED\n\n") : F("passed\n\n"));
+
+    benchmark(false);
+    benchmark(true);
+}
+
+/*****************************************************************************
+ * Arduino loop function
+ ****************************************************************************/
+void loop()
+{
+}
@@ -0,0 +1,215 @@
+/*
+ * This is a simple example file to show how to use the WiMOD Arduino
+ * library in combination with the myDevices.com Cayenne LPP interface class
+ *
+ * http://www.wireless-solutions.de
+ *
+ */
+
+/*
+ * Example:
+ *
+ * This example compares the two ways to build a Cayenne LPP frame:
+ *
+ * - runtime API: CayenneLPP::add*() with float values; each call checks
+ *   the remaining size and scales the float value
+ * - schema:      LppSchema<...> lists the fields at compile time and takes
+ *   integer values in the resolution of the LPP type; one size check per
+ *   frame, no float math
+ *
+ * Both frames are compared byte by byte, then each way is run BENCH_LOOPS
+ * times and the time is printed. On AVR boards the float
+ * conversion (soft-float) dominates the runtime API.
+ *
+ * Setup requirements:
+ * -------------------
+ * - any Arduino board with a C++11 compiler (Arduino IDE 1.6.6 or newer);
+ *   no WiMOD module is needed. The sketch only uses the debug output and
+ *   can be compiled on a Linux host as well.
+ *
+ * Usage:
+ * -------
+ * - Start the program and watch the serial monitor @ 115200 baud
+ *
+ */
+
+
+#include <Cayenne/CayenneLPP.h>
+#include <Cayenne/CayenneLPP_Schema.h>
+
+#include <string.h>
+
+//-----------------------------------------------------------------------------
+// constant values
+//-----------------------------------------------------------------------------
+
+#define BUF_SIZE_CAYENNE    51
+#define BENCH_LOOPS         1000
+
+//-----------------------------------------------------------------------------
+// user defined types
+//-----------------------------------------------------------------------------
+
+typedef LppSchema<LppTemperature<1>, LppRelativeHumidity<2>,
+                  LppTemperature<3>, LppRelativeHumidity<4>,
+                  LppBarometricPressure<5>, LppAccelerometer<6>,
+                  LppGPS<7> > TSensorFrame;
+
+//-----------------------------------------------------------------------------
+// section RAM
+//-----------------------------------------------------------------------------
+
+static uint8_t bufCayenne[BUF_SIZE_CAYENNE];
+CayenneLPP cayenne(bufCayenne, BUF_SIZE_CAYENNE);
+
+static uint8_t bufSchema[TSensorFrame::size()];
+
+// inputs of the benchmark; volatile so that the compiler can not fold them
+static volatile float   fTemp1 = 21.5f, fHum1 = 40.5f, fTemp2 = -4.0f, fHum2 = 91.0f;
+static volatile float   fPressure = 1013.5f, fAx = 0.5f, fAy = -1.0f, fAz = 0.25f;
+static volatile float   fLat = 51.5f, fLon = -6.25f, fAlt = 12.5f;
+
+static volatile int16_t iTemp1 = 215, iTemp2 = -40, iAx = 500, iAy = -1000, iAz = 250;
+static volatile uint8_t iHum1 = 81, iHum2 = 182;
+static volatile uint16_t iPressure = 10135;
+static volatile int32_t iLat = 515000, iLon = -62500, iAlt = 1250;
+
+//-----------------------------------------------------------------------------
+// section code
+//-----------------------------------------------------------------------------
+
+/*****************************************************************************
+ * Function for printing out some debug infos via serial interface
+ ****************************************************************************/
+void debugMsg(String msg)
+{
+    Serial.print(msg);  // use default Arduino serial interface
+}
+
+void debugMsg(int a)
+{
+    Serial.print(a, DEC);
+}
+
+void debugMsg(unsigned long a)
+{
+    Serial.print(a, DEC);
+}
+
+/*****************************************************************************
+ * print out a welcome message
+ ****************************************************************************/
+void printStartMsg()
+{
+    debugMsg(F("==================================================\n"));
+    debugMsg(F("This is FileName: "));
+    debugMsg(F(__FILE__));
+    debugMsg(F("\r\n"));
+    debugMsg(F("Starting...\n"));
+    debugMsg(F("This simple demo will compare the runtime and \n"));
+    debugMsg(F("the compile time encoding of Cayenne LPP frames.\n"));
+    debugMsg(F("==================================================\n"));
+}
+
+/*****************************************************************************
+ * build the frame with the runtime API
+ ****************************************************************************/
+uint8_t buildRuntime()
+{
+    cayenne.reset();
+    cayenne.addTemperature(1, fTemp1);
+    cayenne.addRelativeHumidity(2, fHum1);
+    cayenne.addTemperature(3, fTemp2);
+    cayenne.addRelativeHumidity(4, fHum2);
+    cayenne.addBarometricPressure(5, fPressure);
+    cayenne.addAccelerometer(6, fAx, fAy, fAz);
+    return cayenne.addGPS(7, fLat, fLon, fAlt);
+}
+
+/*****************************************************************************
+ * build the frame with the schema
+ ****************************************************************************/
+uint8_t buildSchema()
+{
+    return TSensorFrame::encode(bufSchema, sizeof(bufSchema),
+                                iTemp1, iHum1, iTemp2, iHum2, iPressure,
+                                iAx, iAy, iAz, iLat, iLon, iAlt);
+}
+
+/*****************************************************************************
+ * run one way BENCH_LOOPS times; returns the time in us
+ ****************************************************************************/
+unsigned long benchmark(uint8_t (*build)(void))
+{
+    unsigned long start;
+    uint16_t      loop;
+
+    start = micros();
+    for (loop = 0; loop < BENCH_LOOPS; loop++) {
+        build();
+    }
+    return micros() - start;
+}
+
+void printTime(const __FlashStringHelper* name, unsigned long us)
+{
+    debugMsg(name);
+    debugMsg((unsigned long) BENCH_LOOPS);
+    debugMsg(F(" frames in "));
+    debugMsg(us);
+    debugMsg(F(" us\n"));
+}
+
+/*****************************************************************************
+ * Arduino setup function
+ ****************************************************************************/
+void setup()
+{
+    uint8_t       sizeRuntime;
+    uint8_t       sizeSchema;
+    unsigned long tRuntime;
+    unsigned long tSchema;
+
+    // debug interface
+    Serial.begin(115200);
+
+    printStartMsg();
+
+    sizeRuntime = buildRuntime();
+    sizeSchema  = buildSchema();
+
+    debugMsg(F("frame size: runtime "));
+    debugMsg((int) sizeRuntime);
+    debugMsg(F(", schema "));
+    debugMsg((int) sizeSchema);
+    debugMsg(F(" (constexpr "));
+    debugMsg((int) TSensorFrame::size());
+    debugMsg(F(")\n"));
+
+    if ((sizeRuntime == sizeSchema) && (memcmp(bufCayenne, bufSchema, sizeSchema) == 0)) {
+        debugMsg(F("frames are identical\n"));
+    } else {
+        debugMsg(F("frames differ\n"));
+    }
+
+    // the schema can also be appended to a runtime frame
+    cayenne.reset();
+    cayenne.addDigitalInput(8, 1);
+    debugMsg(F("appended frame size: "));
+    debugMsg((int) TSensorFrame::append(cayenne, iTemp1, iHum1, iTemp2, iHum2, iPressure,
+                                        iAx, iAy, iAz, iLat, iLon, iAlt));
+    debugMsg(F("\n"));
+
+    tRuntime = benchmark(buildRuntime);
+    tSchema  = benchmark(buildSchema);
+
+    printTime(F("runtime API: "), tRuntime);
+    printTime(F("schema:      "), tSchema);
+}
+
+/*****************************************************************************
+ * Arduino loop function
+ ****************************************************************************/
+void loop()
+{
+}
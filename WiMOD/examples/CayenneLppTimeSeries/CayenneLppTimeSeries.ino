@@ -0,0 +1,235 @@
+/*
+ * This is a simple example file to show how to use the WiMOD Arduino
+ * library in combination with the myDevices.com Cayenne LPP interface class
+ *
+ * http://www.wireless-solutions.de
+ *
+ */
+
+/*
+ * Example:
+ *
+ * This example packs a window of temperature samples into Cayenne LPP
+ * frames with the time series extension (LPP_TIME_SERIES): one header
+ * per channel, a base time, the sample interval and the packed values,
+ * optionally as 8 bit differences.
+ *
+ * For the max. payload of each EU868 data rate the sketch prints how many
+ * samples fit into one uplink
+ * - with one standard LPP record per sample
+ * - as time series with full width values
+ * - as delta encoded time series
+ * and how many uplinks are needed for the whole window. Every frame is
+ * decoded again and compared with the samples.
+ *
+ * Note: LPP_TIME_SERIES is an extension of this library; the receiving
+ * side has to use CayenneLPPDecoder (or an equivalent decoder). It is not
+ * understood by the myDevices Cayenne platform.
+ *
+ * Setup requirements:
+ * -------------------
+ * - any Arduino board; no WiMOD module is needed. The sketch only uses the
+ *   debug output and can be compiled on a Linux host as well. With a
+ *   module use the MaxPayloadSize of WiMODLoRaWAN::GetNwkStatus().
+ *
+ * Usage:
+ * -------
+ * - Start the program and watch the serial monitor @ 115200 baud
+ *
+ */
+
+
+#include <Cayenne/CayenneLPP.h>
+#include <Cayenne/CayenneLPP_Decoder.h>
+
+//-----------------------------------------------------------------------------
+// constant values
+//-----------------------------------------------------------------------------
+
+#define BUF_SIZE_CAYENNE    242
+#define NUM_SAMPLES         240         // e.g. 4 hours, one sample per minute
+#define SAMPLE_INTERVAL_S   60
+#define WINDOW_START        1700000000UL
+
+// max. application payload of the EU868 data rates DR0 .. DR5
+static const uint8_t maxPayload[] = { 51, 51, 51, 115, 242, 242 };
+
+#define NUM_DATA_RATES      (sizeof(maxPayload) / sizeof(maxPayload[0]))
+
+//-----------------------------------------------------------------------------
+// section RAM
+//-----------------------------------------------------------------------------
+
+static uint8_t bufCayenne[BUF_SIZE_CAYENNE];
+CayenneLPP cayenne(bufCayenne, BUF_SIZE_CAYENNE);
+
+static int32_t samples[NUM_SAMPLES];    // 0.1 degC
+static int32_t decoded[LPP_TIME_SERIES_MAX_COUNT];
+static uint8_t errors;
+
+//-----------------------------------------------------------------------------
+// section code
+//-----------------------------------------------------------------------------
+
+/*****************************************************************************
+ * Function for printing out some debug infos via serial interface
+ ****************************************************************************/
+void debugMsg(String msg)
+{
+    Serial.print(msg);  // use default Arduino serial interface
+}
+
+void debugMsg(int a)
+{
+    Serial.print(a, DEC);
+}
+
+void debugMsg(unsigned long a)
+{
+    Serial.print(a, DEC);
+}
+
+/*****************************************************************************
+ * print out a welcome message
+ ****************************************************************************/
+void printStartMsg()
+{
+    debugMsg(F("==================================================\n"));
+    debugMsg(F("This is FileName: "));
+    debugMsg(F(__FILE__));
+    debugMsg(F("\r\n"));
+    debugMsg(F("Starting...\n"));
+    debugMsg(F("This simple demo will pack time series of samples\n"));
+    debugMsg(F("into Cayenne LPP frames.\n"));
+    debugMsg(F("==================================================\n"));
+}
+
+/*****************************************************************************
+ * slowly changing temperature around 20 degC with a few jumps
+ ****************************************************************************/
+void makeSamples()
+{
+    uint16_t i;
+    int32_t  t = 200;
+
+    for (i = 0; i < NUM_SAMPLES; i++) {
+        t += (int32_t) ((i * 37) % 7) - 3;
+        if ((i % 97) == 96) {
+            t += 150;                       // e.g. door opened
+        }
+        samples[i] = t;
+    }
+}
+
+/*****************************************************************************
+ * decode the frame and compare with samples[first ..]
+ ****************************************************************************/
+void checkFrame(uint16_t first)
+{
+    CayenneLPPDecoder decoder(cayenne.getBuffer(), cayenne.getSize());
+    CayenneLPPRecord  rec;
+    uint8_t           n;
+    uint8_t           i;
+
+    if (!decoder.next(rec) || !rec.isTimeSeries() || (rec.getSeriesType() != LPP_TEMPERATURE)) {
+        errors++;
+        return;
+    }
+    n = rec.getSeries(decoded, LPP_TIME_SERIES_MAX_COUNT);
+    for (i = 0; i < n; i++) {
+        if ((decoded[i] != samples[first + i]) || (rec.getFixed(i) != samples[first + i])) {
+            errors++;
+        }
+    }
+    if (rec.getSeriesTime(0) != WINDOW_START + (uint32_t) first * SAMPLE_INTERVAL_S) {
+        errors++;
+    }
+    if (decoder.next(rec) || (decoder.getError() != LPP_DECODE_OK)) {
+        errors++;
+    }
+}
+
+/*****************************************************************************
+ * send the whole window as time series; returns the number of uplinks
+ ****************************************************************************/
+uint16_t packWindow(uint8_t payload, bool delta, uint8_t* firstFrame)
+{
+    uint16_t first  = 0;
+    uint16_t frames = 0;
+    uint8_t  n;
+
+    while (first < NUM_SAMPLES) {
+        cayenne.reset();
+        n = cayenne.fillTimeSeries(1, LPP_TEMPERATURE, WINDOW_START + (uint32_t) first * SAMPLE_INTERVAL_S,
+                                   SAMPLE_INTERVAL_S, samples + first,
+                                   (NUM_SAMPLES - first > 0xFF) ? 0xFF : NUM_SAMPLES - first,
+                                   delta, payload);
+        if (n == 0) {
+            errors++;
+            break;
+        }
+        checkFrame(first);
+        if (frames == 0) {
+            *firstFrame = n;
+        }
+        first += n;
+        frames++;
+    }
+    return frames;
+}
+
+/*****************************************************************************
+ * Arduino setup function
+ ****************************************************************************/
+void setup()
+{
+    uint8_t  dr;
+    uint8_t  nPlain;
+    uint8_t  nRaw;
+    uint8_t  nDelta;
+    uint16_t fRaw;
+    uint16_t fDelta;
+
+    // debug interface
+    Serial.begin(115200);
+
+    printStartMsg();
+    makeSamples();
+
+    debugMsg(F("samples per uplink (uplinks for "));
+    debugMsg((int) NUM_SAMPLES);
+    debugMsg(F(" samples)\n"));
+    debugMsg(F("DR  payload  plain LPP   time series   delta encoded\n"));
+
+    for (dr = 0; dr < NUM_DATA_RATES; dr++) {
+        nPlain = maxPayload[dr] / LPP_TEMPERATURE_SIZE;
+        fRaw   = packWindow(maxPayload[dr], false, &nRaw);
+        fDelta = packWindow(maxPayload[dr], true, &nDelta);
+
+        debugMsg((int) dr);
+        debugMsg(F("   "));
+        debugMsg((int) maxPayload[dr]);
+        debugMsg(F("      "));
+        debugMsg((int) nPlain);
+        debugMsg(F(" ("));
+        debugMsg((int) ((NUM_SAMPLES + nPlain - 1) / nPlain));
+        debugMsg(F(")     "));
+        debugMsg((int) nRaw);
+        debugMsg(F(" ("));
+        debugMsg((int) fRaw);
+        debugMsg(F(")        "));
+        debugMsg((int) nDelta);
+        debugMsg(F(" ("));
+        debugMsg((int) fDelta);
+        debugMsg(F(")\n"));
+    }
+
+    debugMsg(errors ? F("round trip FAILED\n") : F("round trip passed\n"));
+}
+
+/*****************************************************************************
+ * Arduino loop function
+ ****************************************************************************/
+void loop()
+{
+}
@@ -0,0 +1,273 @@
+/*
+ * This is a simple example file to show how to use the WiMOD Arduino
+ * library to communicate with a WiMOD Module by IMST GmbH
+ *
+ * http://www.wireless-solutions.de
+ *
+ */
+
+/*
+ * Example:
+ *
+ * This example replays a recorded link trace through the host side link
+ * adaptation (WiMOD_LoRaWAN_LinkAdaptation) and compares the airtime and
+ * TX energy against fixed radio settings.
+ *
+ * The trace contains one SNR value (dB) per uplink as reported in the
+ * optional RX info of the acks, recorded with a fixed TX power level of
+ * TRACE_TX_POWER. To replay an own trace log the SNR of the RECV_ACK_IND
+ * of a confirmed uplink every few minutes and paste the values into
+ * linkTrace[].
+ *
+ * Channel model:
+ * - uplink SNR = trace SNR + fading - (TRACE_TX_POWER - used TX power)
+ * - a radio packet is delivered if the uplink SNR reaches the demodulation
+ *   floor of the used data rate
+ * - the fading is uniformly distributed in +/- FADING_DB (fixed seed, so
+ *   all runs see the same channel)
+ * - TX current = 20 mA + 2.5 mA / dBm @ 3.3 V (rough SX127x PA_BOOST model)
+ *
+ * Setup requirements:
+ * -------------------
+ * - any Arduino board; no WiMOD module is needed
+ *
+ * Usage:
+ * -------
+ * - Start the program and watch the serial monitor @ 115200 baud
+ *
+ */
+
+
+// make sure to use only the WiMODLoRaWAN.h
+// the WiMODLR_BASE.h must not be used for LoRaWAN firmware.
+#include <WiMODLoRaWAN.h>
+#include <utils/AirTimeCalc.h>
+#if defined(ARDUINO_ARCH_AVR)
+#include <avr/pgmspace.h>
+#endif
+
+//-----------------------------------------------------------------------------
+// constant values
+//-----------------------------------------------------------------------------
+
+#define TRACE_TX_POWER      14      // TX power level (dBm) used for the recording
+#define PAYLOAD_LEN         20      // application payload per uplink
+#define MAX_TX_PACKETS      8       // 1 transmission + 7 retransmissions
+#define FADING_DB           3       // per packet fading +/- dB
+#define SUPPLY_MV           3300
+
+/*
+ * recorded SNR per uplink in dB (one uplink every 10 min; 16 h):
+ * good link at night, slow fading during the day, short deep fades
+ */
+const int8_t linkTrace[] PROGMEM = {
+      6,   7,   6,   5,   6,   7,   7,   6,   5,   6,   6,   5,
+      4,   5,   4,   3,   2,   3,   1,   0,  -1,  -2,  -1,  -3,
+     -4,  -5,  -6,  -7,  -8,  -9,  -8, -10, -11, -10, -12, -13,
+    -12, -11, -13, -14, -12, -11, -12, -10, -11, -12, -13, -11,
+    -10,  -9, -10,  -8,  -9,  -7,  -6, -17, -16,  -5,  -4,  -3,
+     -2,  -1,   0,   1,   2,   3,   4,   5,   4,   5,   6,   5,
+      7,   8,   7,   6,   7,   6,   8,   7,   6,   7,   6,   7,
+    -10, -11,  -9,   5,   6,   5,   6,   7,   6,   7,   6,   7,
+};
+
+#define TRACE_LEN           (sizeof(linkTrace) / sizeof(linkTrace[0]))
+
+//-----------------------------------------------------------------------------
+// user defined types
+//-----------------------------------------------------------------------------
+
+typedef struct TSimResult
+{
+    uint16_t Delivered;
+    uint16_t TxPackets;
+    uint32_t AirtimeMs;
+    uint32_t EnergyMilliJ;
+    uint8_t  DataRateChanges;
+    uint8_t  TxPowerChanges;
+} TSimResult;
+
+//-----------------------------------------------------------------------------
+// section RAM
+//-----------------------------------------------------------------------------
+
+WiMOD_LoRaWAN_LinkAdaptation linkAdapt;
+
+static uint32_t rndState;
+
+//-----------------------------------------------------------------------------
+// section code
+//-----------------------------------------------------------------------------
+
+/*****************************************************************************
+ * Function for printing out some debug infos via serial interface
+ ****************************************************************************/
+void debugMsg(String msg)
+{
+    Serial.print(msg);  // use default Arduino serial interface
+}
+
+void debugMsg(int a)
+{
+    Serial.print(a, DEC);
+}
+
+void debugMsg(unsigned long a)
+{
+    Serial.print(a, DEC);
+}
+
+/*****************************************************************************
+ * print out a welcome message
+ ****************************************************************************/
+void printStartMsg()
+{
+    debugMsg(F("==================================================\n"));
+    debugMsg(F("This is FileName: "));
+    debugMsg(F(__FILE__));
+    debugMsg(F("\r\n"));
+    debugMsg(F("Starting...\n"));
+    debugMsg(F("This simple demo will replay a link trace "));
+    debugMsg(F("through the link adaptation.\n"));
+    debugMsg(F("==================================================\n"));
+}
+
+/*****************************************************************************
+ * reproducible fading in +/- FADING_DB
+ ****************************************************************************/
+int8_t nextFading()
+{
+    rndState = rndState * 1103515245UL + 12345UL;
+    return (int8_t)((rndState >> 16) % (2 * FADING_DB + 1)) - FADING_DB;
+}
+
+/*****************************************************************************
+ * replay the trace with a fixed or an adaptive setting
+ ****************************************************************************/
+void simulate(bool adaptive, uint8_t dr, uint8_t pwr, TSimResult& res)
+{
+    uint32_t airtimeUs;
+    uint16_t i;
+    uint8_t  n;
+    uint8_t  newDr;
+    uint8_t  newPwr;
+    bool     delivered;
+    int16_t  snr10;
+
+    memset(&res, 0x00, sizeof(res));
+    rndState = 0x1234;
+    linkAdapt.Reset();
+
+    for (i = 0; i < TRACE_LEN; i++) {
+        int8_t linkSnr = (int8_t) pgm_read_byte(&linkTrace[i]);
+
+        airtimeUs = AirTimeCalc_LoRaWanUs(dr, PAYLOAD_LEN);
+        delivered = false;
+        for (n = 1; n <= MAX_TX_PACKETS; n++) {
+            res.TxPackets++;
+            res.AirtimeMs    += airtimeUs / 1000;
+            // E [mJ] = t [ms] * I [mA] * U [V] / 1000
+            res.EnergyMilliJ += (uint32_t)(((uint64_t) airtimeUs * (200 + 25 * pwr) * SUPPLY_MV) / 10000000000ULL);
+
+            snr10 = ((int16_t) linkSnr + nextFading() - (TRACE_TX_POWER - pwr)) * 10;
+            if (snr10 >= WiMOD_LoRaWAN_LinkAdaptation::GetRequiredSNR10(dr)) {
+                delivered = true;
+                break;
+            }
+        }
+        if (delivered) {
+            res.Delivered++;
+        } else {
+            n = MAX_TX_PACKETS;
+        }
+
+        if (adaptive) {
+            // the ack carries the downlink SNR; rssi is not used by the engine
+            if (delivered) {
+                linkAdapt.OnDownlink(-120 + linkSnr, linkSnr + nextFading());
+            }
+            linkAdapt.OnUplink(n, delivered);
+
+            if (linkAdapt.Evaluate(dr, pwr, &newDr, &newPwr)) {
+                if (newDr != dr) {
+                    res.DataRateChanges++;
+                }
+                if (newPwr != pwr) {
+                    res.TxPowerChanges++;
+                }
+                dr  = newDr;
+                pwr = newPwr;
+            }
+        }
+    }
+}
+
+/*****************************************************************************
+ * print a result line
+ ****************************************************************************/
+void printResult(const __FlashStringHelper* name, const TSimResult& res)
+{
+    debugMsg(name);
+    debugMsg(F(": delivered "));
+    debugMsg((int) res.Delivered);
+    debugMsg(F("/"));
+    debugMsg((int) TRACE_LEN);
+    debugMsg(F(", packets "));
+    debugMsg((int) res.TxPackets);
+    debugMsg(F(", airtime "));
+    debugMsg((unsigned long) res.AirtimeMs);
+    debugMsg(F(" ms, energy "));
+    debugMsg((unsigned long) res.EnergyMilliJ);
+    debugMsg(F(" mJ"));
+    if (res.DataRateChanges || res.TxPowerChanges) {
+        debugMsg(F(", DR changes "));
+        debugMsg((int) res.DataRateChanges);
+        debugMsg(F(", power changes "));
+        debugMsg((int) res.TxPowerChanges);
+    }
+    debugMsg(F("\n"));
+}
+
+/*****************************************************************************
+ * Arduino setup function
+ ****************************************************************************/
+void setup()
+{
+    TWiMODLORAWAN_LinkAdaptConfig cfg;
+    TSimResult                    res;
+
+    // debug interface
+    Serial.begin(115200);
+
+    printStartMsg();
+
+    cfg.MinDataRateIndex       = 0;
+    cfg.MaxDataRateIndex       = 5;
+    cfg.MinTxPower             = 2;
+    cfg.MaxTxPower             = TRACE_TX_POWER;
+    cfg.TxPowerStep            = 2;
+    cfg.TargetDeliveryPermille = 900;
+    cfg.InstallMarginDb        = 5;
+    cfg.HysteresisDb           = 3;
+    cfg.MinSamples             = 6;
+    linkAdapt.SetConfig(cfg);
+
+    simulate(false, 5, TRACE_TX_POWER, res);
+    printResult(F("fixed DR5 / 14 dBm"), res);
+
+    simulate(false, 0, TRACE_TX_POWER, res);
+    printResult(F("fixed DR0 / 14 dBm"), res);
+
+    simulate(true, 0, TRACE_TX_POWER, res);
+    printResult(F("adaptive          "), res);
+}
+
+
+/*****************************************************************************
+ * Arduino loop function
+ ****************************************************************************/
+
+void loop()
+{
+    delay(1000);
+}
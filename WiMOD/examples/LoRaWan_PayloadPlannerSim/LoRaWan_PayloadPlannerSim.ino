@@ -0,0 +1,268 @@
+/*
+ * This is a simple example file to show how to use the WiMOD Arduino
+ * library to communicate with a WiMOD Module by IMST GmbH
+ *
+ * http://www.wireless-solutions.de
+ *
+ */
+
+/*
+ * Example:
+ *
+ * This example packs a set of Cayenne LPP records with the payload
+ * planner (WiMOD_LoRaWAN_PayloadPlanner) for the max. payload of several
+ * data rates and compares the result with packing the records in the
+ * order they were measured (start a new uplink whenever the next record
+ * does not fit; what a caller of CayenneLPP::add*() usually does).
+ *
+ * For each planned uplink the sketch prints the records, the fill ratio
+ * of the max. payload and the part of the radio frame spent on headers
+ * (LoRaWAN header and the 2 byte LPP record headers).
+ *
+ * With a module the same is done by WiMODLoRaWAN::AddPlannedRecord() and
+ * WiMODLoRaWAN::SendNextPlannedUplink(), which reads the max. payload of
+ * the current data rate from the module.
+ *
+ * Setup requirements:
+ * -------------------
+ * - any Arduino board; no WiMOD module is needed. The sketch only uses the
+ *   debug output and can be compiled on a Linux host as well.
+ *
+ * Usage:
+ * -------
+ * - Start the program and watch the serial monitor @ 115200 baud
+ *
+ */
+
+
+// make sure to use only the WiMODLoRaWAN.h
+// the WiMODLR_BASE.h must not be used for LoRaWAN firmware.
+#include <WiMODLoRaWAN.h>
+#include <Cayenne/CayenneLPP.h>
+#include <Cayenne/CayenneLPP_constants.h>
+
+//-----------------------------------------------------------------------------
+// constant values
+//-----------------------------------------------------------------------------
+
+#define LPP_RECORD_HEADER   2
+#define BUF_SIZE_CAYENNE    64
+
+// max. application payload to plan for: EU868 DR0..2, DR3, DR4..5
+// (the library limits uplinks to WiMODLORAWAN_APP_PAYLOAD_LEN)
+static const uint8_t maxPayload[] = { 51, 115, 128 };
+
+#define NUM_LIMITS          (sizeof(maxPayload) / sizeof(maxPayload[0]))
+
+//-----------------------------------------------------------------------------
+// section RAM
+//-----------------------------------------------------------------------------
+
+static uint8_t bufCayenne[BUF_SIZE_CAYENNE];
+CayenneLPP cayenne(bufCayenne, BUF_SIZE_CAYENNE);
+
+WiMOD_LoRaWAN_PayloadPlanner planner;
+
+// length of the records in measurement order (for the in-order packing)
+static uint8_t recordLen[LORAWAN_PLANNER_MAX_RECORDS];
+static uint8_t numRecords;
+
+//-----------------------------------------------------------------------------
+// section code
+//-----------------------------------------------------------------------------
+
+/*****************************************************************************
+ * Function for printing out some debug infos via serial interface
+ ****************************************************************************/
+void debugMsg(String msg)
+{
+    Serial.print(msg);  // use default Arduino serial interface
+}
+
+void debugMsg(int a)
+{
+    Serial.print(a, DEC);
+}
+
+void debugMsg(unsigned long a)
+{
+    Serial.print(a, DEC);
+}
+
+/*****************************************************************************
+ * print out a welcome message
+ ****************************************************************************/
+void printStartMsg()
+{
+    debugMsg(F("==================================================\n"));
+    debugMsg(F("This is FileName: "));
+    debugMsg(F(__FILE__));
+    debugMsg(F("\r\n"));
+    debugMsg(F("Starting...\n"));
+    debugMsg(F("This simple demo will pack measurement records \n"));
+    debugMsg(F("into the minimum number of uplinks.\n"));
+    debugMsg(F("==================================================\n"));
+}
+
+/*****************************************************************************
+ * hand the record in the Cayenne buffer to the planner
+ ****************************************************************************/
+void addRecord(uint8_t priority)
+{
+    if (planner.Add(cayenne.getBuffer(), cayenne.getSize(), priority)) {
+        recordLen[numRecords++] = cayenne.getSize();
+    }
+    cayenne.reset();
+}
+
+/*****************************************************************************
+ * one measurement cycle: alarms, position, climate, a window of samples
+ ****************************************************************************/
+void addRecords()
+{
+    static const int32_t tempWindow[] = { 211, 212, 212, 214, 215, 215, 216, 218, 219, 219, 220, 221 };
+    static const int32_t humWindow[]  = { 90, 90, 91, 92, 92, 93, 95, 96, 96, 97, 99, 100 };
+
+    planner.Clear();
+    numRecords = 0;
+
+    cayenne.addDigitalInput(1, 1);          addRecord(3);       // door alarm
+    cayenne.addGPS(2, 51.4924, 6.5341, 35); addRecord(2);
+    cayenne.addTemperature(3, 21.5);        addRecord(1);
+    cayenne.addRelativeHumidity(4, 45);     addRecord(1);
+    cayenne.addBarometricPressure(5, 1013); addRecord(0);
+    cayenne.addAccelerometer(6, 0, 0, 1);   addRecord(0);
+    cayenne.addTimeSeries(7, LPP_TEMPERATURE, 1700000000UL, 300,
+                          tempWindow, sizeof(tempWindow) / sizeof(tempWindow[0]));
+                                            addRecord(0);
+    cayenne.addTimeSeries(8, LPP_RELATIVE_HUMIDITY, 1700000000UL, 300,
+                          humWindow, sizeof(humWindow) / sizeof(humWindow[0]), true);
+                                            addRecord(0);
+    cayenne.addTemperature(9, 4.5);         addRecord(1);
+    cayenne.addRelativeHumidity(10, 80);    addRecord(1);
+    cayenne.addLuminosity(11, 300);         addRecord(0);
+    cayenne.addAnalogInput(12, 3.3);        addRecord(0);
+    cayenne.addDigitalOutput(13, 0);        addRecord(0);
+    cayenne.addPresence(14, 1);             addRecord(0);
+    cayenne.addGPS(15, 51.4930, 6.5350, 36); addRecord(0);      // last fix
+}
+
+/*****************************************************************************
+ * number of uplinks if the records are packed in measurement order
+ ****************************************************************************/
+uint8_t packInOrder(uint8_t limit)
+{
+    uint8_t frames = 0;
+    uint8_t fill   = 0;
+    uint8_t i;
+
+    for (i = 0; i < numRecords; i++) {
+        if ((frames == 0) || ((fill + recordLen[i]) > limit)) {
+            frames++;
+            fill = 0;
+        }
+        fill += recordLen[i];
+    }
+    return frames;
+}
+
+/*****************************************************************************
+ * plan for one max. payload and print the uplinks
+ ****************************************************************************/
+void planFor(uint8_t limit)
+{
+    TWiMODLORAWAN_PlannedFrame frame;
+    uint8_t                    payload[WiMODLORAWAN_APP_PAYLOAD_LEN];
+    uint8_t                    frames;
+    uint8_t                    i;
+    uint8_t                    dropped;
+
+    addRecords();
+    frames = planner.Plan(limit);
+
+    debugMsg(F("\nmax. payload "));
+    debugMsg((int) limit);
+    debugMsg(F(": "));
+    debugMsg((int) numRecords);
+    debugMsg(F(" records, planned "));
+    debugMsg((int) frames);
+    debugMsg(F(" uplinks, in order "));
+    debugMsg((int) packInOrder(limit));
+    debugMsg(F(" uplinks\n"));
+    debugMsg(F("uplink  records  bytes  priority  fill permille  header permille\n"));
+
+    for (i = 0; i < frames; i++) {
+        planner.GetFrameInfo(0, &frame);
+        debugMsg(F("  "));
+        debugMsg((int) i);
+        debugMsg(F("     "));
+        debugMsg((int) frame.Records);
+        debugMsg(F("        "));
+        debugMsg((int) frame.Length);
+        debugMsg(F("     "));
+        debugMsg((int) frame.Priority);
+        debugMsg(F("        "));
+        debugMsg((int) frame.FillPermille);
+        debugMsg(F("            "));
+        debugMsg((int) frame.HeaderPermille);
+        debugMsg(F("\n"));
+
+        // this is what SendNextPlannedUplink() hands to the module
+        if (planner.BuildFrame(payload, sizeof(payload)) != frame.Length) {
+            debugMsg(F("  build error\n"));
+        }
+        planner.OnFrameSent();
+    }
+    // SendNextPlannedUplink() drops these as well
+    dropped = planner.DropOversized();
+    if (dropped != 0) {
+        debugMsg(F("  records dropped (larger than the max. payload): "));
+        debugMsg((int) dropped);
+        debugMsg(F("\n"));
+    }
+}
+
+/*****************************************************************************
+ * Arduino setup function
+ ****************************************************************************/
+void setup()
+{
+    TWiMODLORAWAN_PlannerConfig       cfg;
+    const TWiMODLORAWAN_PlannerStats* stats;
+    uint8_t                           i;
+
+    // debug interface
+    Serial.begin(115200);
+
+    printStartMsg();
+
+    cfg.Port              = 1;
+    cfg.Confirmed         = false;
+    cfg.RecordHeaderLen   = LPP_RECORD_HEADER;
+    cfg.DefaultPayloadLen = maxPayload[0];
+    planner.SetConfig(cfg);
+
+    for (i = 0; i < NUM_LIMITS; i++) {
+        planFor(maxPayload[i]);
+    }
+
+    stats = &planner.GetStats();
+    debugMsg(F("\ntotal: "));
+    debugMsg((unsigned long) stats->Frames);
+    debugMsg(F(" uplinks, payload "));
+    debugMsg((unsigned long) stats->PayloadBytes);
+    debugMsg(F(" of "));
+    debugMsg((unsigned long) stats->CapacityBytes);
+    debugMsg(F(" bytes, headers "));
+    debugMsg((unsigned long) stats->HeaderBytes);
+    debugMsg(F(" bytes, dropped "));
+    debugMsg((unsigned long) stats->Dropped);
+    debugMsg(F(" records\n"));
+}
+
+/*****************************************************************************
+ * Arduino loop function
+ ****************************************************************************/
+void loop()
+{
+}
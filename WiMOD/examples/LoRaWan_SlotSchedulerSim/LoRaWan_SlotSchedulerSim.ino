@@ -0,0 +1,285 @@
+/*
+ * This is a simple example file to show how to use the WiMOD Arduino
+ * library to communicate with a WiMOD Module by IMST GmbH
+ *
+ * http://www.wireless-solutions.de
+ *
+ */
+
+/*
+ * Example:
+ *
+ * This example simulates a fleet of nodes sending one uplink per period
+ * to a single gateway and compares the delivery ratio of unsynchronised
+ * fixed-period uplinks (pure ALOHA) against the slotted uplink scheduler
+ * (WiMOD_LoRaWAN_UplinkScheduler) for a growing number of nodes.
+ *
+ * Model:
+ * - all nodes use the same data rate and payload size
+ * - every uplink uses one of NUM_CHANNELS channels at random
+ * - two uplinks on the same channel that overlap in time are both lost
+ *   (no capture effect)
+ * - ALOHA: each node has a random phase within the period; the uplink
+ *   time jitters by +/- ALOHA_JITTER_MS (processing time of the host)
+ * - slotted: each node starts at the offset of its slot (DevAddr used as
+ *   seed); the uplink time jitters by +/- SYNC_ERROR_MS (error of the
+ *   network time sync). A lost uplink is reported to the scheduler, as a
+ *   missing ack would be on a real node.
+ * - fixed random seed, so all runs see the same channel choices
+ *
+ * Setup requirements:
+ * -------------------
+ * - Arduino board with at least 32 kB RAM (e.g. ESP32, SAMD21);
+ *   no WiMOD module is needed
+ *
+ * Usage:
+ * -------
+ * - Start the program and watch the serial monitor @ 115200 baud
+ *
+ */
+
+
+// make sure to use only the WiMODLoRaWAN.h
+// the WiMODLR_BASE.h must not be used for LoRaWAN firmware.
+#include <WiMODLoRaWAN.h>
+#include <utils/AirTimeCalc.h>
+
+//-----------------------------------------------------------------------------
+// constant values
+//-----------------------------------------------------------------------------
+
+#define MAX_NODES           400
+#define PERIOD_MS           60000UL     // one uplink per node and minute
+#define NUM_PERIODS         30
+#define DATA_RATE           5           // SF7 / 125 kHz
+#define PAYLOAD_LEN         20
+#define NUM_CHANNELS        8
+#define GUARD_MS            50
+#define SYNC_ERROR_MS       20
+#define ALOHA_JITTER_MS     1000
+#define DEV_ADDR_BASE       0x26011000UL
+
+const uint16_t nodeCounts[] = { 25, 50, 100, 200, 400 };
+
+#define NUM_NODE_COUNTS     (sizeof(nodeCounts) / sizeof(nodeCounts[0]))
+
+//-----------------------------------------------------------------------------
+// user defined types
+//-----------------------------------------------------------------------------
+
+typedef struct TSimResult
+{
+    uint32_t Sent;
+    uint32_t Delivered;
+    uint32_t Reseeds;
+} TSimResult;
+
+//-----------------------------------------------------------------------------
+// section RAM
+//-----------------------------------------------------------------------------
+
+WiMOD_LoRaWAN_UplinkScheduler scheduler[MAX_NODES];
+
+static uint32_t phase[MAX_NODES];
+static uint32_t txStart[MAX_NODES];
+static uint8_t  txChannel[MAX_NODES];
+static bool     txLost[MAX_NODES];
+
+static uint32_t airtimeMs;
+static uint32_t rndState;
+
+//-----------------------------------------------------------------------------
+// section code
+//-----------------------------------------------------------------------------
+
+/*****************************************************************************
+ * Function for printing out some debug infos via serial interface
+ ****************************************************************************/
+void debugMsg(String msg)
+{
+    Serial.print(msg);  // use default Arduino serial interface
+}
+
+void debugMsg(int a)
+{
+    Serial.print(a, DEC);
+}
+
+void debugMsg(unsigned long a)
+{
+    Serial.print(a, DEC);
+}
+
+/*****************************************************************************
+ * print out a welcome message
+ ****************************************************************************/
+void printStartMsg()
+{
+    debugMsg(F("==================================================\n"));
+    debugMsg(F("This is FileName: "));
+    debugMsg(F(__FILE__));
+    debugMsg(F("\r\n"));
+    debugMsg(F("Starting...\n"));
+    debugMsg(F("This simple demo will compare ALOHA and "));
+    debugMsg(F("slotted uplinks for a growing fleet.\n"));
+    debugMsg(F("==================================================\n"));
+}
+
+/*****************************************************************************
+ * reproducible random numbers
+ ****************************************************************************/
+uint32_t nextRandom(uint32_t range)
+{
+    rndState = rndState * 1103515245UL + 12345UL;
+    return ((rndState >> 8) & 0xFFFFFF) % range;
+}
+
+int32_t nextJitter(uint32_t maxMs)
+{
+    return (int32_t) nextRandom(2 * maxMs + 1) - (int32_t) maxMs;
+}
+
+/*****************************************************************************
+ * mark all uplinks of this period that overlap on the same channel
+ ****************************************************************************/
+void detectCollisions(uint16_t numNodes)
+{
+    uint16_t i;
+    uint16_t k;
+
+    for (i = 0; i < numNodes; i++) {
+        txLost[i] = false;
+    }
+    for (i = 0; i < numNodes; i++) {
+        for (k = i + 1; k < numNodes; k++) {
+            if (txChannel[i] != txChannel[k]) {
+                continue;
+            }
+            uint32_t d = (txStart[i] > txStart[k]) ? (txStart[i] - txStart[k])
+                                                   : (txStart[k] - txStart[i]);
+            if (d < airtimeMs) {
+                txLost[i] = true;
+                txLost[k] = true;
+            }
+        }
+    }
+}
+
+/*****************************************************************************
+ * run NUM_PERIODS periods with numNodes nodes
+ ****************************************************************************/
+void simulate(bool slotted, uint16_t numNodes, TSimResult& res)
+{
+    TWiMODLORAWAN_SchedulerConfig cfg;
+    uint16_t                      i;
+    uint16_t                      p;
+
+    memset(&res, 0x00, sizeof(res));
+    rndState = 0x5EED;
+
+    cfg.PeriodMs           = PERIOD_MS;
+    cfg.MaxPayloadLen      = PAYLOAD_LEN;
+    cfg.GuardMs            = GUARD_MS;
+    cfg.CollisionThreshold = 1;
+
+    for (i = 0; i < numNodes; i++) {
+        phase[i] = nextRandom(PERIOD_MS);
+        scheduler[i].SetConfig(cfg);
+        scheduler[i].SetDataRate(DATA_RATE);
+        scheduler[i].SetSeed(DEV_ADDR_BASE + i);
+    }
+
+    for (p = 0; p < NUM_PERIODS; p++) {
+        for (i = 0; i < numNodes; i++) {
+            int32_t t;
+
+            if (slotted) {
+                t = (int32_t) scheduler[i].GetOffsetMs() + nextJitter(SYNC_ERROR_MS);
+            } else {
+                t = (int32_t) phase[i] + nextJitter(ALOHA_JITTER_MS);
+            }
+            // keep everything within one period (+ margin); wrap at the end
+            txStart[i]   = (uint32_t)(t + (int32_t) PERIOD_MS) % PERIOD_MS;
+            txChannel[i] = (uint8_t) nextRandom(NUM_CHANNELS);
+        }
+
+        detectCollisions(numNodes);
+
+        for (i = 0; i < numNodes; i++) {
+            res.Sent++;
+            if (!txLost[i]) {
+                res.Delivered++;
+            }
+            if (slotted) {
+                scheduler[i].OnUplink(1, !txLost[i]);
+            }
+        }
+    }
+
+    if (slotted) {
+        for (i = 0; i < numNodes; i++) {
+            res.Reseeds += scheduler[i].GetInfo().Reseeds;
+        }
+    }
+}
+
+/*****************************************************************************
+ * print a result line
+ ****************************************************************************/
+void printResult(const __FlashStringHelper* name, const TSimResult& res)
+{
+    debugMsg(name);
+    debugMsg((unsigned long)((res.Delivered * 1000UL) / res.Sent));
+    debugMsg(F(" permille"));
+}
+
+/*****************************************************************************
+ * Arduino setup function
+ ****************************************************************************/
+void setup()
+{
+    TSimResult aloha;
+    TSimResult slotted;
+    uint8_t    n;
+
+    // debug interface
+    Serial.begin(115200);
+
+    printStartMsg();
+
+    airtimeMs = (AirTimeCalc_LoRaWanUs(DATA_RATE, PAYLOAD_LEN) + 999) / 1000;
+    scheduler[0].SetDataRate(DATA_RATE);
+
+    debugMsg(F("time on air "));
+    debugMsg((unsigned long) airtimeMs);
+    debugMsg(F(" ms, slot width "));
+    debugMsg((unsigned long) scheduler[0].GetInfo().SlotWidthMs);
+    debugMsg(F(" ms, "));
+    debugMsg((int) scheduler[0].GetInfo().NumSlots);
+    debugMsg(F(" slots x "));
+    debugMsg((int) NUM_CHANNELS);
+    debugMsg(F(" channels per period\n"));
+
+    for (n = 0; n < NUM_NODE_COUNTS; n++) {
+        simulate(false, nodeCounts[n], aloha);
+        simulate(true, nodeCounts[n], slotted);
+
+        debugMsg(F("nodes "));
+        debugMsg((int) nodeCounts[n]);
+        printResult(F(": ALOHA "), aloha);
+        printResult(F(", slotted "), slotted);
+        debugMsg(F(", slot changes "));
+        debugMsg((unsigned long) slotted.Reseeds);
+        debugMsg(F("\n"));
+    }
+}
+
+
+/*****************************************************************************
+ * Arduino loop function
+ ****************************************************************************/
+
+void loop()
+{
+    delay(1000);
+}
@@ -0,0 +1,245 @@
+/*
+ * This is a simple example file to show how to use the WiMOD Arduino
+ * library to communicate with a WiMOD Module by IMST GmbH
+ *
+ * http://www.wireless-solutions.de
+ *
+ */
+
+/*
+ * Example usage:
+ *
+ * This example demonstrates the bulk transfer on top of the data link
+ * service of the LR-Base firmware.
+ *
+ * A buffer larger than a single radio message (e.g. a sensor log dump) is
+ * split into fragments. The fragments are sent with a sliding window; the
+ * receiver acknowledges each window with a selective ack, so only the lost
+ * fragments are sent again. The receiver reassembles the fragments in its
+ * own buffer.
+ *
+ * Setup requirements:
+ * -------------------
+ * - 2 Arduinos with WiMOD modules running LR-Base firmware
+ *  - Both modules must have the same radio settings (SF/Datarate/GroupAdr/...)
+ *    (hint: simple way to archive that: do a factory reset on all devices)
+ *
+ * Usage:
+ * -------
+ * - Receiving device:
+ *      -- Start the program
+ *      -- open the serial monitor @ 115200 baud
+ *      -- type 'r' to wait for a transfer
+ *
+ * - Sending device:
+ *      -- type 's' to send the test buffer
+ *
+ * - Both devices print the statistics when the transfer has finished.
+ *
+ */
+
+
+// make sure to use only the WiMODLR_BASE.h
+// the WiMODLR_BASE.h must not be used for LoRaWAN firmware.
+#include <WiMODLR_BASE.h>
+#include <avr/pgmspace.h>
+
+//-----------------------------------------------------------------------------
+// section defines
+//-----------------------------------------------------------------------------
+
+#define BULK_SIZE                               2048
+#define PEER_GROUP_ADR                          0x10
+
+
+//-----------------------------------------------------------------------------
+// section global variables
+//-----------------------------------------------------------------------------
+
+/*
+ * transfer buffer; test pattern for sending, reassembly buffer for receiving
+ */
+static UINT8 bulkBuffer[BULK_SIZE];
+
+static TWiMODLR_BulkState lastState = LRBASE_BULK_STATE_IDLE;
+
+
+/*
+ * Create in instance of the interface to the WiMOD-LR-Base firmware
+ */
+WiMODLRBASE wimod(Serial3);  // use the Arduino Serial3 as serial interface
+
+
+/*****************************************************************************
+ * Functions for printing out some debug infos via serial interface
+ ****************************************************************************/
+void debugMsg(String msg)
+{
+    Serial.print(msg);  // use default Arduino serial interface
+}
+
+void debugMsg(int a)
+{
+    Serial.print(a, DEC);
+}
+
+void debugMsg(unsigned long a)
+{
+    Serial.print(a, DEC);
+}
+
+/*****************************************************************************
+ * print out a welcome message
+ ****************************************************************************/
+void printStartMsg()
+{
+    debugMsg(F("==================================================\n"));
+    debugMsg(F("This is FileName: "));
+    debugMsg(F(__FILE__));
+    debugMsg(F("\r\n"));
+    debugMsg(F("Starting...\n"));
+    debugMsg(F("This simple demo will show \n"));
+    debugMsg(F("how to transfer a large buffer between two modules\n"));
+    debugMsg(F("running a LR-Base Firmware.\n"));
+    debugMsg(F("Type 's' to send, 'r' to receive.\n"));
+    debugMsg(F("==================================================\n"));
+}
+
+/*****************************************************************************
+ * test pattern; checked by the receiver
+ ****************************************************************************/
+UINT8 pattern(UINT16 i)
+{
+    return (UINT8) (i * 7 + 3);
+}
+
+/*****************************************************************************
+ * print the statistics once the transfer has finished
+ ****************************************************************************/
+void printStats()
+{
+    TWiMODLR_BulkStats stats;
+    UINT16             errors = 0;
+
+    wimod.GetBulkTransferStats(&stats);
+    if (stats.State == lastState) {
+        return;
+    }
+    lastState = stats.State;
+
+    if ((stats.State != LRBASE_BULK_STATE_DONE) && (stats.State != LRBASE_BULK_STATE_FAILED)) {
+        return;
+    }
+
+    debugMsg((stats.State == LRBASE_BULK_STATE_DONE) ? F("Transfer done: ") : F("Transfer failed: "));
+    debugMsg((unsigned long) stats.BytesDone);
+    debugMsg(F(" bytes in "));
+    debugMsg((unsigned long) stats.DurationMs);
+    debugMsg(F(" ms, goodput "));
+    debugMsg((unsigned long) stats.GoodputBps);
+    debugMsg(F(" bit/s\n"));
+    debugMsg(F("fragments "));
+    debugMsg((int) stats.NumFragments);
+    debugMsg(F(", frames sent "));
+    debugMsg((unsigned long) stats.FramesSent);
+    debugMsg(F(", retransmissions "));
+    debugMsg((unsigned long) stats.Retransmissions);
+    debugMsg(F(", duplicates "));
+    debugMsg((unsigned long) stats.Duplicates);
+    debugMsg(F(", SACKs "));
+    debugMsg((unsigned long) stats.Sacks);
+    debugMsg(F(", timeouts "));
+    debugMsg((unsigned long) stats.Timeouts);
+    debugMsg(F("\n"));
+
+    if ((stats.State == LRBASE_BULK_STATE_DONE) && (stats.FramesSent == 0)) {
+        // receiver: check the test pattern
+        for (UINT16 i = 0; i < stats.Length; i++) {
+            if (bulkBuffer[i] != pattern(i)) {
+                errors++;
+            }
+        }
+        debugMsg(F("pattern errors: "));
+        debugMsg((int) errors);
+        debugMsg(F("\n"));
+    }
+}
+
+/*****************************************************************************
+ * handle the user input
+ ****************************************************************************/
+void processSerialInputByte(const byte inByte)
+{
+    switch (inByte) {
+        case 's':
+            for (UINT16 i = 0; i < BULK_SIZE; i++) {
+                bulkBuffer[i] = pattern(i);
+            }
+            if (wimod.BulkSend(PEER_GROUP_ADR, RADIOLINK_BROADCAST_DEVICE_ADR, bulkBuffer, BULK_SIZE)) {
+                debugMsg(F("Sending...\n"));
+            }
+            break;
+        case 'r':
+            memset(bulkBuffer, 0x00, BULK_SIZE);
+            if (wimod.BulkReceive(bulkBuffer, BULK_SIZE)) {
+                debugMsg(F("Waiting for a transfer...\n"));
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+
+/*****************************************************************************
+ * Arduino setup function
+ ****************************************************************************/
+
+void setup()
+{
+    TWiMODLR_DevMgmt_RadioConfig radioCfg;
+
+    // init / setup the serial interface connected to WiMOD
+    Serial3.begin(WIMOD_LR_BASE_SERIAL_BAUDRATE);
+    // init the communication stack
+    wimod.begin();
+
+    // debug interface
+    Serial.begin(115200);
+
+    printStartMsg();
+
+    /*****************
+     * Reset the radio configuration to factory settings in order
+     * to get a "clean" setup.
+     *  (disable the next line if you whish to use other settings.)
+     *  note: the radio settings must be the same on both peers.
+     ****************/
+    wimod.ResetRadioConfig();
+
+    // the TX indication tells when the next fragment can be sent
+    if (wimod.GetRadioConfig(&radioCfg)) {
+        radioCfg.MiscOptions  |= DEVMGMT_RADIO_CFG_MISC_HCI_TX_IND_ENABLED;
+        radioCfg.StoreNwmFlag  = 0;
+        wimod.SetRadioConfig(&radioCfg);
+    }
+
+    // new session after every reset; a floating analog input as entropy
+    randomSeed(analogRead(0));
+    wimod.SetBulkTransferSession((UINT16) random(0x10000));
+}
+
+void loop()
+{
+    if (Serial.available()) {
+        processSerialInputByte(Serial.read());
+    }
+
+    // check for any pending data of the WiMOD
+    wimod.Process();
+
+    // send the next fragment / selective ack (if any)
+    wimod.ServiceBulkTransfer();
+
+    printStats();
+}
@@ -0,0 +1,215 @@
+/*
+ * This is a simple example file to show how to use the WiMOD Arduino
+ * library to communicate with a WiMOD Module by IMST GmbH
+ *
+ * http://www.wireless-solutions.de
+ *
+ */
+
+/*
+ * Example usage:
+ *
+ * This example demonstrates fast channel hopping with a module running
+ * the LR-Base firmware, e.g. for a site survey.
+ *
+ * The channel plan is a table whose frequency registers are calculated by
+ * the compiler. A retune only changes the registers of the last known
+ * radio config and sends it RAM-only (not stored in NVM). The device hops
+ * over all channels and sends one probe message per channel.
+ *
+ * At start the latency of a "classic" frequency change (read config,
+ * calculate registers, write config) is measured for comparison.
+ *
+ * Setup requirements:
+ * -------------------
+ * - 1 Arduino with a WiMOD module running LR-Base firmware
+ * - optional: a second device (e.g. a sniffer) listening on one channel
+ *
+ * Usage:
+ * -------
+ * - Start the program
+ * - open the serial monitor @ 115200 baud
+ * - the retune latency is printed after each round over all channels
+ *
+ */
+
+
+// make sure to use only the WiMODLR_BASE.h
+// the WiMODLR_BASE.h must not be used for LoRaWAN firmware.
+#include <WiMODLR_BASE.h>
+
+//-----------------------------------------------------------------------------
+// section defines
+//-----------------------------------------------------------------------------
+
+#define HOP_INTERVAL_MS                         2000
+#define PEER_GROUP_ADR                          0x10
+
+
+//-----------------------------------------------------------------------------
+// section global variables
+//-----------------------------------------------------------------------------
+
+/*
+ * channel plan; the registers are calculated at compile time
+ */
+static const TWiMODLR_Channel channelPlan[] = {
+    LRBASE_CHANNEL(868100000),
+    LRBASE_CHANNEL(868300000),
+    LRBASE_CHANNEL(868500000),
+    LRBASE_CHANNEL(867100000),
+    LRBASE_CHANNEL(867300000),
+    LRBASE_CHANNEL(867500000),
+    LRBASE_CHANNEL(867700000),
+    LRBASE_CHANNEL(867900000),
+};
+
+#define NUM_CHANNELS        (sizeof(channelPlan) / sizeof(channelPlan[0]))
+
+static UINT8         nextChannel = 0;
+static unsigned long lastHopTime = 0;
+
+
+/*
+ * Create in instance of the interface to the WiMOD-LR-Base firmware
+ */
+WiMODLRBASE wimod(Serial3);  // use the Arduino Serial3 as serial interface
+
+
+/*****************************************************************************
+ * Functions for printing out some debug infos via serial interface
+ ****************************************************************************/
+void debugMsg(String msg)
+{
+    Serial.print(msg);  // use default Arduino serial interface
+}
+
+void debugMsg(int a)
+{
+    Serial.print(a, DEC);
+}
+
+void debugMsg(unsigned long a)
+{
+    Serial.print(a, DEC);
+}
+
+/*****************************************************************************
+ * print out a welcome message
+ ****************************************************************************/
+void printStartMsg()
+{
+    debugMsg(F("==================================================\n"));
+    debugMsg(F("This is FileName: "));
+    debugMsg(F(__FILE__));
+    debugMsg(F("\r\n"));
+    debugMsg(F("Starting...\n"));
+    debugMsg(F("This simple demo will show \n"));
+    debugMsg(F("how to hop over a channel plan with a module\n"));
+    debugMsg(F("running a LR-Base Firmware.\n"));
+    debugMsg(F("==================================================\n"));
+}
+
+/*****************************************************************************
+ * measure a frequency change the classic way
+ ****************************************************************************/
+void measureClassicRetune()
+{
+    TWiMODLR_DevMgmt_RadioConfig radioCfg;
+    unsigned long                start = micros();
+
+    if (wimod.GetRadioConfig(&radioCfg)) {
+        wimod.calcFreqToRegister(channelPlan[0].Frequency,
+                                 &radioCfg.RfFreq_MSB,
+                                 &radioCfg.RfFreq_MID,
+                                 &radioCfg.RfFreq_LSB);
+        radioCfg.StoreNwmFlag = 0;
+        if (wimod.SetRadioConfig(&radioCfg)) {
+            debugMsg(F("classic retune: "));
+            debugMsg(micros() - start);
+            debugMsg(F(" us\n"));
+        }
+    }
+}
+
+/*****************************************************************************
+ * print the retune latency
+ ****************************************************************************/
+void printStats()
+{
+    TWiMODLR_RetuneStats stats;
+
+    wimod.GetRetuneStats(&stats);
+
+    debugMsg(F("retunes "));
+    debugMsg((unsigned long) stats.Retunes);
+    debugMsg(F(", failures "));
+    debugMsg((unsigned long) stats.Failures);
+    debugMsg(F(", config reads "));
+    debugMsg((unsigned long) stats.ConfigReads);
+    debugMsg(F(", latency min/avg/max "));
+    debugMsg((unsigned long) stats.MinUs);
+    debugMsg(F("/"));
+    debugMsg((unsigned long) stats.AvgUs);
+    debugMsg(F("/"));
+    debugMsg((unsigned long) stats.MaxUs);
+    debugMsg(F(" us\n"));
+}
+
+/*****************************************************************************
+ * retune to the next channel and send a probe
+ ****************************************************************************/
+void hop()
+{
+    TWiMODLR_RadioLink_Msg probe;
+
+    if (!wimod.Retune(nextChannel)) {
+        debugMsg(F("retune failed\n"));
+        return;
+    }
+
+    probe.DestinationGroupAddress  = PEER_GROUP_ADR;
+    probe.DestinationDeviceAddress = RADIOLINK_BROADCAST_DEVICE_ADR;
+    probe.Length                   = 0;
+    probe.Payload[probe.Length++]  = nextChannel;
+    wimod.SendUData(&probe);
+
+    nextChannel++;
+    if (nextChannel >= NUM_CHANNELS) {
+        nextChannel = 0;
+        printStats();
+    }
+}
+
+
+/*****************************************************************************
+ * Arduino setup function
+ ****************************************************************************/
+
+void setup()
+{
+    // init / setup the serial interface connected to WiMOD
+    Serial3.begin(WIMOD_LR_BASE_SERIAL_BAUDRATE);
+    // init the communication stack
+    wimod.begin();
+
+    // debug interface
+    Serial.begin(115200);
+
+    printStartMsg();
+
+    measureClassicRetune();
+
+    wimod.SetChannelPlan(channelPlan, NUM_CHANNELS);
+}
+
+void loop()
+{
+    // check for any pending data of the WiMOD
+    wimod.Process();
+
+    if ((millis() - lastHopTime) >= HOP_INTERVAL_MS) {
+        lastHopTime = millis();
+        hop();
+    }
+}
@@ -0,0 +1,256 @@
+/*
+ * This is a simple example file to show how to use the WiMOD Arduino
+ * library to communicate with a WiMOD Module by IMST GmbH
+ *
+ * http://www.wireless-solutions.de
+ *
+ */
+
+/*
+ * Example usage:
+ *
+ * This example demonstrates the concentrator receive path of a module
+ * running the LR-Base firmware.
+ *
+ * The concentrator keeps the state of every source (last sequence, RSSI
+ * and SNR, last seen time) in a fixed size table. C-Data retransmissions
+ * whose ack got lost and out of order frames are dropped, so each source
+ * is seen as an in-order stream.
+ *
+ * The first payload byte of every frame is a sequence number of the
+ * sender; it starts at a random value after a reset. With IS_SENDER set
+ * to 1 the sketch acts as such a sender.
+ *
+ * Setup requirements:
+ * -------------------
+ * - 1 Arduino with a WiMOD module running LR-Base firmware (concentrator)
+ * - 1..n Arduinos with this sketch and IS_SENDER 1 (unique device address each)
+ *
+ * Usage:
+ * -------
+ * - Start the program
+ * - open the serial monitor @ 115200 baud
+ * - the concentrator prints every delivered frame and the peer table
+ *
+ */
+
+
+// make sure to use only the WiMODLR_BASE.h
+// the WiMODLR_BASE.h must not be used for LoRaWAN firmware.
+#include <WiMODLR_BASE.h>
+
+//-----------------------------------------------------------------------------
+// section defines
+//-----------------------------------------------------------------------------
+
+#define IS_SENDER                               0
+
+#define CONCENTRATOR_GROUP_ADR                  0x10
+#define CONCENTRATOR_DEVICE_ADR                 0x1234
+
+#define PEER_TABLE_SIZE                         64          // power of two; thousands on a Linux host
+#define PEER_MAX_AGE_MS                         (30UL * 60 * 1000)
+#define REPORT_INTERVAL_MS                      60000
+#define SEND_INTERVAL_MS                        10000
+
+
+//-----------------------------------------------------------------------------
+// section global variables
+//-----------------------------------------------------------------------------
+
+#if IS_SENDER == 0
+static TWiMODLR_PeerInfo peerTable[PEER_TABLE_SIZE];
+#else
+static UINT8         txSequence = 0;
+#endif
+
+static unsigned long lastTime   = 0;
+
+
+/*
+ * Create in instance of the interface to the WiMOD-LR-Base firmware
+ */
+WiMODLRBASE wimod(Serial3);  // use the Arduino Serial3 as serial interface
+
+
+/*****************************************************************************
+ * Functions for printing out some debug infos via serial interface
+ ****************************************************************************/
+void debugMsg(String msg)
+{
+    Serial.print(msg);  // use default Arduino serial interface
+}
+
+void debugMsg(int a)
+{
+    Serial.print(a, DEC);
+}
+
+void debugMsg(unsigned long a)
+{
+    Serial.print(a, DEC);
+}
+
+void debugMsgHex(int a)
+{
+    if (a < 0x10) {
+        Serial.print(F("0"));
+    }
+    Serial.print(a, HEX);
+}
+
+/*****************************************************************************
+ * print out a welcome message
+ ****************************************************************************/
+void printStartMsg()
+{
+    debugMsg(F("==================================================\n"));
+    debugMsg(F("This is FileName: "));
+    debugMsg(F(__FILE__));
+    debugMsg(F("\r\n"));
+    debugMsg(F("Starting...\n"));
+    debugMsg(F("This simple demo will show \n"));
+    debugMsg(F("how to de-duplicate frames of many senders\n"));
+    debugMsg(F("with a module running a LR-Base Firmware.\n"));
+    debugMsg(F("==================================================\n"));
+}
+
+#if IS_SENDER == 0
+/*****************************************************************************
+ * concentrator callback: next frame of a source
+ ****************************************************************************/
+void onConcentratorRx(const TWiMODLR_RadioLink_Msg& rxMsg, const TWiMODLR_PeerInfo* peer)
+{
+    debugMsg(F("frame from "));
+    debugMsgHex(rxMsg.SourceGroupAddress);
+    debugMsg(F(":"));
+    debugMsgHex(rxMsg.SourceDeviceAddress >> 8);
+    debugMsgHex(rxMsg.SourceDeviceAddress & 0xFF);
+    if (peer) {
+        debugMsg(F(" seq "));
+        debugMsg((int) peer->LastSequence);
+        debugMsg(F(" lost "));
+        debugMsg((int) peer->Lost);
+    }
+    debugMsg(F(" data"));
+    for (int i = 0; i < rxMsg.Length; i++) {
+        debugMsg(F(" "));
+        debugMsgHex(rxMsg.Payload[i]);
+    }
+    debugMsg(F("\n"));
+}
+
+/*****************************************************************************
+ * print the peer table and remove silent sources
+ ****************************************************************************/
+void report()
+{
+    TWiMODLR_ConcentratorStats stats;
+    const TWiMODLR_PeerInfo*   peer;
+    UINT32                     it = 0;
+
+    wimod.ExpireConcentratorPeers(PEER_MAX_AGE_MS);
+
+    while ((peer = wimod.GetNextConcentratorPeer(&it)) != NULL) {
+        debugMsgHex(peer->GroupAddress);
+        debugMsg(F(":"));
+        debugMsgHex(peer->DeviceAddress >> 8);
+        debugMsgHex(peer->DeviceAddress & 0xFF);
+        debugMsg(F(" frames "));
+        debugMsg((unsigned long) peer->Frames);
+        debugMsg(F(" dup "));
+        debugMsg((int) peer->Duplicates);
+        debugMsg(F(" late "));
+        debugMsg((int) peer->Late);
+        debugMsg(F(" lost "));
+        debugMsg((int) peer->Lost);
+        debugMsg(F(" RSSI avg "));
+        debugMsg((int) (peer->AvgRSSI / 16));
+        debugMsg(F(" dBm, SNR avg "));
+        debugMsg((int) (peer->AvgSNR / 16));
+        debugMsg(F(" dB, seen "));
+        debugMsg((unsigned long) ((millis() - peer->LastSeen) / 1000));
+        debugMsg(F(" s ago\n"));
+    }
+
+    wimod.GetConcentratorStats(&stats);
+    debugMsg(F("peers "));
+    debugMsg((unsigned long) stats.Peers);
+    debugMsg(F("/"));
+    debugMsg((unsigned long) stats.Capacity);
+    debugMsg(F(", frames "));
+    debugMsg((unsigned long) stats.Frames);
+    debugMsg(F(", delivered "));
+    debugMsg((unsigned long) stats.Delivered);
+    debugMsg(F(", duplicates "));
+    debugMsg((unsigned long) stats.Duplicates);
+    debugMsg(F(", late "));
+    debugMsg((unsigned long) stats.Late);
+    debugMsg(F("\n"));
+}
+#else
+/*****************************************************************************
+ * send the next frame; the sequence is the first payload byte
+ ****************************************************************************/
+void sendFrame()
+{
+    TWiMODLR_RadioLink_Msg txMsg;
+
+    txMsg.DestinationGroupAddress  = CONCENTRATOR_GROUP_ADR;
+    txMsg.DestinationDeviceAddress = CONCENTRATOR_DEVICE_ADR;
+    txMsg.Length                   = 0;
+    txMsg.Payload[txMsg.Length++]  = txSequence;
+    txMsg.Payload[txMsg.Length++]  = (UINT8) (millis() >> 10);
+
+    // the module repeats the same payload until the ack is received
+    if (wimod.SendCData(&txMsg)) {
+        txSequence++;
+    }
+}
+#endif
+
+
+/*****************************************************************************
+ * Arduino setup function
+ ****************************************************************************/
+
+void setup()
+{
+    // init / setup the serial interface connected to WiMOD
+    Serial3.begin(WIMOD_LR_BASE_SERIAL_BAUDRATE);
+    // init the communication stack
+    wimod.begin();
+
+    // debug interface
+    Serial.begin(115200);
+
+    printStartMsg();
+
+#if IS_SENDER == 0
+    wimod.EnableConcentrator(peerTable, PEER_TABLE_SIZE);
+    wimod.RegisterConcentratorRxClient(onConcentratorRx);
+#else
+    // random start after every reset, so the concentrator does not drop
+    // the first frames as retransmissions; a floating analog input as entropy
+    randomSeed(analogRead(0));
+    txSequence = (UINT8) random(0x100);
+#endif
+}
+
+void loop()
+{
+    // check for any pending data of the WiMOD
+    wimod.Process();
+
+#if IS_SENDER == 0
+    if ((millis() - lastTime) >= REPORT_INTERVAL_MS) {
+        lastTime = millis();
+        report();
+    }
+#else
+    if ((millis() - lastTime) >= SEND_INTERVAL_MS) {
+        lastTime = millis();
+        sendFrame();
+    }
+#endif
+}
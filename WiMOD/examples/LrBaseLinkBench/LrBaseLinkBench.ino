@@ -0,0 +1,239 @@
+/*
+ * This is a simple example file to show how to use the WiMOD Arduino
+ * library to communicate with a WiMOD Module by IMST GmbH
+ *
+ * http://www.wireless-solutions.de
+ *
+ */
+
+/*
+ * Example usage:
+ *
+ * This example benchmarks a radio link between two modules running the
+ * LR-Base firmware.
+ *
+ * The sender walks through a list of radio settings. For every setting
+ * both nodes switch to it (RAM only, the stored config is not touched),
+ * the sender sends FRAMES_PER_POINT numbered frames and the receiver
+ * reports how many it got. Afterwards the sender prints the packet error
+ * rate, the goodput and the airtime per delivered byte of every setting.
+ *
+ * SETUP and REPORT frames are exchanged with the radio config that is
+ * active at start ("home" settings); it must be the same on both nodes
+ * and should be a robust one.
+ *
+ * Setup requirements:
+ * -------------------
+ * - 2 Arduinos with a WiMOD module running LR-Base firmware
+ * - one with IS_SENDER 1, one with IS_SENDER 0
+ * - the receiver must use RECEIVER_GROUP_ADR / RECEIVER_DEVICE_ADR
+ *
+ * Usage:
+ * -------
+ * - Start the receiver, then the sender
+ * - open the serial monitor of the sender @ 115200 baud
+ *
+ */
+
+
+// make sure to use only the WiMODLR_BASE.h
+// the WiMODLR_BASE.h must not be used for LoRaWAN firmware.
+#include <WiMODLR_BASE.h>
+
+//-----------------------------------------------------------------------------
+// section defines
+//-----------------------------------------------------------------------------
+
+#define IS_SENDER                               1
+
+#define RECEIVER_GROUP_ADR                      0x10
+#define RECEIVER_DEVICE_ADR                     0x1234
+
+#define FRAMES_PER_POINT                        50
+#define PAYLOAD_SIZE                            20
+#define CONFIRMED                               false
+
+
+//-----------------------------------------------------------------------------
+// section global variables
+//-----------------------------------------------------------------------------
+
+#if IS_SENDER == 1
+static const TWiMODLR_BenchPoint points[] = {
+    { Modulation_LoRa, LoRaBandwith_125kHz, LoRa7_SF7,   ErrorCoding1_4_5, FskDatarate_50kbps },
+    { Modulation_LoRa, LoRaBandwith_125kHz, LoRa8_SF8,   ErrorCoding1_4_5, FskDatarate_50kbps },
+    { Modulation_LoRa, LoRaBandwith_125kHz, LoRa9_SF9,   ErrorCoding1_4_5, FskDatarate_50kbps },
+    { Modulation_LoRa, LoRaBandwith_125kHz, LoRa10_SF10, ErrorCoding1_4_5, FskDatarate_50kbps },
+    { Modulation_LoRa, LoRaBandwith_250kHz, LoRa9_SF9,   ErrorCoding1_4_5, FskDatarate_50kbps },
+    { Modulation_LoRa, LoRaBandwith_500kHz, LoRa9_SF9,   ErrorCoding1_4_5, FskDatarate_50kbps },
+    { Modulation_FSK,  LoRaBandwith_125kHz, LoRa7_SF7,   ErrorCoding1_4_5, FskDatarate_50kbps },
+};
+
+#define NUM_POINTS                              (sizeof(points) / sizeof(points[0]))
+
+static TWiMODLR_BenchResult results[NUM_POINTS];
+static bool                 printed = false;
+#endif
+
+
+/*
+ * Create in instance of the interface to the WiMOD-LR-Base firmware
+ */
+WiMODLRBASE wimod(Serial3);  // use the Arduino Serial3 as serial interface
+
+
+/*****************************************************************************
+ * Functions for printing out some debug infos via serial interface
+ ****************************************************************************/
+void debugMsg(String msg)
+{
+    Serial.print(msg);  // use default Arduino serial interface
+}
+
+void debugMsg(int a)
+{
+    Serial.print(a, DEC);
+}
+
+void debugMsg(unsigned long a)
+{
+    Serial.print(a, DEC);
+}
+
+/*****************************************************************************
+ * print out a welcome message
+ ****************************************************************************/
+void printStartMsg()
+{
+    debugMsg(F("==================================================\n"));
+    debugMsg(F("This is FileName: "));
+    debugMsg(F(__FILE__));
+    debugMsg(F("\r\n"));
+    debugMsg(F("Starting...\n"));
+    debugMsg(F("This simple demo will benchmark radio settings \n"));
+    debugMsg(F("between two modules running a LR-Base Firmware.\n"));
+    debugMsg(F("==================================================\n"));
+}
+
+#if IS_SENDER == 1
+/*****************************************************************************
+ * print a radio setting
+ ****************************************************************************/
+void printPoint(const TWiMODLR_BenchPoint& p)
+{
+    static const uint16_t bw[]  = { 125, 250, 500 };
+    static const uint16_t fsk[] = { 50, 100, 250 };
+
+    if (p.Modulation == Modulation_FSK) {
+        debugMsg(F("FSK  "));
+        debugMsg((int) fsk[p.FskDatarate]);
+        debugMsg(F(" kbps        "));
+        return;
+    }
+    debugMsg(F("LoRa SF"));
+    debugMsg((int) ((p.LoRaSpreadingFactor <= LoRa7_SF7) ? 7 : p.LoRaSpreadingFactor));
+    debugMsg(F(" "));
+    debugMsg((int) bw[p.LoRaBandWidth]);
+    debugMsg(F(" kHz 4/"));
+    debugMsg((int) ((p.ErrorCoding == ErrorCoding0_4_5) ? 5 : p.ErrorCoding + 4));
+    debugMsg(F(" "));
+}
+
+/*****************************************************************************
+ * print the result table
+ ****************************************************************************/
+void printResults()
+{
+    uint8_t i;
+
+    debugMsg(F("\nsetting                  PER permille  goodput bit/s  airtime us/byte  RSSI  SNR  TX events\n"));
+
+    for (i = 0; i < wimod.GetLinkBenchPointsDone(); i++) {
+        const TWiMODLR_BenchResult& r = results[i];
+
+        debugMsg(F("  "));
+        printPoint(r.Point);
+        if (!r.Valid) {
+            debugMsg(F("  no report\n"));
+            continue;
+        }
+        debugMsg(F("  "));
+        debugMsg((unsigned long) r.PerPermille);
+        debugMsg(F("  "));
+        debugMsg((unsigned long) r.GoodputBps);
+        debugMsg(F("  "));
+        if (r.Unique == 0) {
+            // nothing delivered
+            debugMsg(F("N/A"));
+        } else {
+            debugMsg((unsigned long) r.AirTimeUsPerByte);
+        }
+        debugMsg(F("  "));
+        if (r.Received == 0) {
+            debugMsg(F("N/A  N/A"));
+        } else {
+            debugMsg((int) r.AvgRSSI);
+            debugMsg(F("  "));
+            debugMsg((int) r.AvgSNR);
+        }
+        debugMsg(F("  "));
+        debugMsg((unsigned long) r.TxEvents);
+        debugMsg(F("\n"));
+    }
+}
+#endif
+
+
+/*****************************************************************************
+ * Arduino setup function
+ ****************************************************************************/
+
+void setup()
+{
+    // init / setup the serial interface connected to WiMOD
+    Serial3.begin(WIMOD_LR_BASE_SERIAL_BAUDRATE);
+    // init the communication stack
+    wimod.begin();
+
+    // debug interface
+    Serial.begin(115200);
+
+    printStartMsg();
+
+#if IS_SENDER == 1
+    TWiMODLR_BenchConfig cfg;
+
+    cfg.Points            = points;
+    cfg.NumPoints         = NUM_POINTS;
+    cfg.FramesPerPoint    = FRAMES_PER_POINT;
+    cfg.PayloadSize       = PAYLOAD_SIZE;
+    cfg.Confirmed         = CONFIRMED;
+    cfg.GapMs             = 0;
+    cfg.PeerGroupAddress  = RECEIVER_GROUP_ADR;
+    cfg.PeerDeviceAddress = RECEIVER_DEVICE_ADR;
+
+    if (!wimod.StartLinkBenchSender(cfg, results)) {
+        debugMsg(F("starting the benchmark failed\n"));
+    }
+#else
+    if (!wimod.StartLinkBenchReceiver()) {
+        debugMsg(F("starting the benchmark failed\n"));
+    }
+#endif
+}
+
+void loop()
+{
+    // check for any pending data of the WiMOD
+    wimod.Process();
+
+    // next step of the benchmark; HCI requests are only issued from here
+    wimod.ServiceLinkBench();
+
+#if IS_SENDER == 1
+    if (!printed && wimod.IsLinkBenchDone()) {
+        printed = true;
+        printResults();
+    }
+#endif
+}
@@ -0,0 +1,488 @@
+/*
+ * This is a simple example file to show how to use the WiMOD Arduino
+ * library to communicate with a WiMOD Module by IMST GmbH
+ *
+ * http://www.wireless-solutions.de
+ *
+ */
+
+/*
+ * Example:
+ *
+ * This example runs the link benchmark (WiMOD_LRBASE_LinkBench) between
+ * two simulated LR-Base modules and prints the packet error rate, goodput
+ * and airtime per byte of every tested radio setting. The benchmark code
+ * is the same that WiMODLRBASE::ServiceLinkBench() drives with a real
+ * module (see example LrBaseLinkBench); only the transport is simulated.
+ *
+ * The sweep is repeated for each loss model:
+ * - none:        every frame is delivered
+ * - random:      each frame is lost with LOSS_PERMILLE
+ * - burst:       Gilbert-Elliott channel; a good state without loss and a
+ *                bad state with BAD_LOSS_PERCENT, state changes per frame
+ *                with P_GOOD_TO_BAD / P_BAD_TO_GOOD permille
+ * - link budget: SNR of LINK_SNR_DB at 125 kHz, +/- FADING_DB per frame;
+ *                a frame is lost below the demodulation floor of the
+ *                spreading factor (FSK: FSK_MIN_SNR_DB)
+ *
+ * Simulated module:
+ * - half duplex; a frame is only received with the same radio settings
+ * - C-Data is acked by the receiving module; the ack uses the same loss model
+ * - HCI_MS per request; requests while transmitting are rejected
+ * - fixed random seed, so all runs see the same random numbers
+ *
+ * Setup requirements:
+ * -------------------
+ * - any Arduino board; no WiMOD module is needed. The sketch only uses the
+ *   debug output and can be run on a Linux host as well:
+ *   'make run' in extras/simhost of the library
+ *
+ * Usage:
+ * -------
+ * - Start the program and watch the serial monitor @ 115200 baud
+ *
+ */
+
+
+// make sure to use only the WiMODLR_BASE.h
+// the WiMODLR_BASE.h must not be used for LoRaWAN firmware.
+#include <WiMODLR_BASE.h>
+
+//-----------------------------------------------------------------------------
+// constant values
+//-----------------------------------------------------------------------------
+
+#define FRAMES_PER_POINT    50
+#define PAYLOAD_SIZE        20
+#define CONFIRMED           false
+
+#define HCI_MS              15
+#define ACK_TIMEOUT_MS      100         // after the expected end of the ack
+#define MAX_SIM_MS          (60UL * 60 * 1000)
+
+#define LOSS_PERMILLE       100
+#define P_GOOD_TO_BAD       50
+#define P_BAD_TO_GOOD       250
+#define BAD_LOSS_PERCENT    80
+#define LINK_SNR_DB         (-9)
+#define FADING_DB           3
+#define FSK_MIN_SNR_DB      10
+
+#define SENDER_GROUP_ADR    0x10
+#define SENDER_DEVICE_ADR   0x0001
+#define RECEIVER_GROUP_ADR  0x10
+#define RECEIVER_DEVICE_ADR 0x0002
+
+/*
+ * home settings of both modules (SETUP / REPORT) and the tested points
+ */
+static const TWiMODLR_BenchPoint homePoint =
+    { Modulation_LoRa, LoRaBandwith_125kHz, LoRa10_SF10, ErrorCoding1_4_5, FskDatarate_50kbps };
+
+static const TWiMODLR_BenchPoint points[] = {
+    { Modulation_LoRa, LoRaBandwith_125kHz, LoRa7_SF7,   ErrorCoding1_4_5, FskDatarate_50kbps },
+    { Modulation_LoRa, LoRaBandwith_125kHz, LoRa8_SF8,   ErrorCoding1_4_5, FskDatarate_50kbps },
+    { Modulation_LoRa, LoRaBandwith_125kHz, LoRa9_SF9,   ErrorCoding1_4_5, FskDatarate_50kbps },
+    { Modulation_LoRa, LoRaBandwith_125kHz, LoRa10_SF10, ErrorCoding1_4_5, FskDatarate_50kbps },
+    { Modulation_LoRa, LoRaBandwith_125kHz, LoRa11_SF11, ErrorCoding1_4_5, FskDatarate_50kbps },
+    { Modulation_LoRa, LoRaBandwith_125kHz, LoRa12_S12, ErrorCoding1_4_5, FskDatarate_50kbps },
+    { Modulation_LoRa, LoRaBandwith_125kHz, LoRa9_SF9,   ErrorCoding4_4_8, FskDatarate_50kbps },
+    { Modulation_LoRa, LoRaBandwith_250kHz, LoRa9_SF9,   ErrorCoding1_4_5, FskDatarate_50kbps },
+    { Modulation_LoRa, LoRaBandwith_500kHz, LoRa9_SF9,   ErrorCoding1_4_5, FskDatarate_50kbps },
+    { Modulation_FSK,  LoRaBandwith_125kHz, LoRa7_SF7,   ErrorCoding1_4_5, FskDatarate_50kbps },
+    { Modulation_FSK,  LoRaBandwith_125kHz, LoRa7_SF7,   ErrorCoding1_4_5, FskDatarate_250kbps },
+};
+
+#define NUM_POINTS          (sizeof(points) / sizeof(points[0]))
+
+//-----------------------------------------------------------------------------
+// user defined types
+//-----------------------------------------------------------------------------
+
+typedef enum TLossModel
+{
+    LOSS_NONE = 0,
+    LOSS_RANDOM,
+    LOSS_BURST,
+    LOSS_LINK_BUDGET,
+    NUM_LOSS_MODELS,
+} TLossModel;
+
+typedef struct TSimModule
+{
+    WiMOD_LRBASE_LinkBench* Bench;
+    TWiMODLR_BenchPoint Radio;
+    uint8_t     GroupAddress;
+    uint16_t    DeviceAddress;
+    uint16_t    TxEventCounter;
+    uint32_t    BusyUntil;                      // HCI request in progress
+
+    bool        TxActive;
+    bool        TxConfirmed;
+    uint32_t    TxEnd;
+    uint32_t    TxAirMs;
+    TWiMODLR_BenchPoint TxRadio;
+    uint8_t     TxLen;
+    UINT8       TxBuf[WIMOD_RADIOLINK_PAYLOAD_LEN];
+
+    bool        AckPending;
+    bool        AckOk;
+    uint32_t    AckAt;
+} TSimModule;
+
+//-----------------------------------------------------------------------------
+// section RAM
+//-----------------------------------------------------------------------------
+
+WiMOD_LRBASE_LinkBench senderBench;
+WiMOD_LRBASE_LinkBench receiverBench;
+
+static TSimModule           module[2];
+static TWiMODLR_BenchResult results[NUM_POINTS];
+
+static TLossModel           lossModel;
+static bool                 burstBad;
+static uint32_t             rndState;
+
+//-----------------------------------------------------------------------------
+// section code
+//-----------------------------------------------------------------------------
+
+/*****************************************************************************
+ * Function for printing out some debug infos via serial interface
+ ****************************************************************************/
+void debugMsg(String msg)
+{
+    Serial.print(msg);  // use default Arduino serial interface
+}
+
+void debugMsg(int a)
+{
+    Serial.print(a, DEC);
+}
+
+void debugMsg(unsigned long a)
+{
+    Serial.print(a, DEC);
+}
+
+/*****************************************************************************
+ * print out a welcome message
+ ****************************************************************************/
+void printStartMsg()
+{
+    debugMsg(F("==================================================\n"));
+    debugMsg(F("This is FileName: "));
+    debugMsg(F(__FILE__));
+    debugMsg(F("\r\n"));
+    debugMsg(F("Starting...\n"));
+    debugMsg(F("This simple demo will benchmark radio settings "));
+    debugMsg(F("over simulated links.\n"));
+    debugMsg(F("==================================================\n"));
+}
+
+/*****************************************************************************
+ * reproducible random numbers
+ ****************************************************************************/
+uint32_t nextRandom(uint32_t range)
+{
+    rndState = rndState * 1103515245UL + 12345UL;
+    return ((rndState >> 8) & 0xFFFFFF) % range;
+}
+
+/*****************************************************************************
+ * link budget: SNR in 1/10 dB at the receiver and the demodulation floor
+ ****************************************************************************/
+int16_t linkSnr10(const TWiMODLR_BenchPoint& p)
+{
+    // noise bandwidth relative to 125 kHz; FSK: about 2 x datarate
+    static const int8_t loraGain10[] = { 0, -30, -60 };
+    static const int8_t fskGain10[]  = { 10, -20, -60 };
+
+    if (p.Modulation == Modulation_FSK) {
+        return LINK_SNR_DB * 10 + fskGain10[p.FskDatarate];
+    }
+    return LINK_SNR_DB * 10 + loraGain10[p.LoRaBandWidth];
+}
+
+int16_t floorSnr10(const TWiMODLR_BenchPoint& p)
+{
+    uint8_t sf = (p.LoRaSpreadingFactor <= LoRa7_SF7) ? 7 : (uint8_t) p.LoRaSpreadingFactor;
+
+    if (p.Modulation == Modulation_FSK) {
+        return FSK_MIN_SNR_DB * 10;
+    }
+    // -7.5 dB @ SF7, 2.5 dB less per SF step
+    return -75 - 25 * (sf - 7);
+}
+
+/*****************************************************************************
+ * loss model: true if a frame is received
+ ****************************************************************************/
+bool channelDelivers(const TWiMODLR_BenchPoint& p, int16_t* rssi, int8_t* snr)
+{
+    int16_t snr10  = linkSnr10(p);
+    int16_t gain10 = snr10 - LINK_SNR_DB * 10;     // noise bandwidth against 125 kHz
+    bool    ok     = true;
+
+    switch (lossModel) {
+        case LOSS_RANDOM:
+            ok = (nextRandom(1000) >= LOSS_PERMILLE);
+            break;
+        case LOSS_BURST:
+            if (burstBad) {
+                burstBad = (nextRandom(1000) >= P_BAD_TO_GOOD);
+            } else {
+                burstBad = (nextRandom(1000) < P_GOOD_TO_BAD);
+            }
+            ok = !burstBad || (nextRandom(100) >= BAD_LOSS_PERCENT);
+            break;
+        case LOSS_LINK_BUDGET:
+            snr10 += (int16_t) nextRandom(2 * FADING_DB * 10 + 1) - FADING_DB * 10;
+            ok     = (snr10 >= floorSnr10(p));
+            break;
+        default:
+            break;
+    }
+    // noise floor: -174 dBm/Hz + 51 dB (125 kHz) + 6 dB noise figure
+    *snr  = (int8_t) (snr10 / 10);
+    *rssi = (int16_t) (-174 + 51 + 6 - gain10 / 10 + snr10 / 10);
+    return ok;
+}
+
+/*****************************************************************************
+ * same radio settings on both sides
+ ****************************************************************************/
+bool sameRadio(const TWiMODLR_BenchPoint& a, const TWiMODLR_BenchPoint& b)
+{
+    if (a.Modulation != b.Modulation) {
+        return false;
+    }
+    if (a.Modulation == Modulation_FSK) {
+        return (a.FskDatarate == b.FskDatarate);
+    }
+    return (a.LoRaBandWidth == b.LoRaBandWidth) && (a.LoRaSpreadingFactor == b.LoRaSpreadingFactor)
+            && (a.ErrorCoding == b.ErrorCoding);
+}
+
+/*****************************************************************************
+ * simulated module: end of a transmission
+ ****************************************************************************/
+void endTx(TSimModule& m, TSimModule& peer, uint32_t now)
+{
+    int16_t  rssi;
+    int8_t   snr;
+    bool     rx;
+    uint32_t ackMs;
+
+    m.TxActive = false;
+    m.TxEventCounter++;
+    m.Bench->OnTxInd(m.TxEventCounter, m.TxAirMs, now);
+
+    rx = !peer.TxActive && sameRadio(m.TxRadio, peer.Radio) && channelDelivers(m.TxRadio, &rssi, &snr);
+    if (rx) {
+        peer.Bench->OnFrame(m.GroupAddress, m.DeviceAddress, m.TxBuf, m.TxLen, true, rssi, snr, now);
+    }
+    if (m.TxConfirmed) {
+        ackMs        = LRBASE_BENCH_ACK_TURNAROUND_MS
+                     + (WiMOD_LRBASE_LinkBench::CalcAirtimeUs(m.TxRadio, 0) + 999) / 1000;
+        m.AckPending = true;
+        m.AckOk      = rx && channelDelivers(m.TxRadio, &rssi, &snr);
+        m.AckAt      = now + ackMs + (m.AckOk ? 0 : ACK_TIMEOUT_MS);
+    }
+}
+
+/*****************************************************************************
+ * simulated module: execute the next step of the benchmark
+ ****************************************************************************/
+void service(TSimModule& m, uint32_t now)
+{
+    bool confirmed;
+    UINT8  group;
+    UINT16 device;
+
+    if ((int32_t) (now - m.BusyUntil) < 0) {
+        return;
+    }
+    switch (m.Bench->GetAction(now)) {
+        case LRBASE_BENCH_ACTION_SET_POINT:
+        case LRBASE_BENCH_ACTION_SET_HOME:
+            m.Radio     = m.Bench->GetActionPoint();
+            m.BusyUntil = now + HCI_MS;
+            m.Bench->OnActionDone(true, m.BusyUntil);
+            break;
+
+        case LRBASE_BENCH_ACTION_SEND:
+            m.BusyUntil = now + HCI_MS;
+            if (m.TxActive || m.AckPending) {
+                m.Bench->OnActionDone(false, m.BusyUntil);
+                break;
+            }
+            m.TxLen       = m.Bench->EncodeFrame(m.TxBuf, sizeof(m.TxBuf), &confirmed, &group, &device);
+            m.TxConfirmed = confirmed;
+            m.TxRadio     = m.Radio;
+            m.TxAirMs     = (WiMOD_LRBASE_LinkBench::CalcAirtimeUs(m.Radio, m.TxLen) + 999) / 1000;
+            m.TxEnd       = m.BusyUntil + m.TxAirMs;
+            m.TxActive    = true;
+            m.Bench->OnActionDone(true, m.BusyUntil);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*****************************************************************************
+ * run the sweep with the current loss model
+ ****************************************************************************/
+uint32_t simulate(void)
+{
+    TWiMODLR_BenchConfig cfg;
+    uint32_t             t;
+    uint8_t              i;
+
+    memset(module, 0x00, sizeof(module));
+    rndState = 0x5EED;
+    burstBad = false;
+
+    module[0].Bench         = &senderBench;
+    module[0].GroupAddress  = SENDER_GROUP_ADR;
+    module[0].DeviceAddress = SENDER_DEVICE_ADR;
+    module[1].Bench         = &receiverBench;
+    module[1].GroupAddress  = RECEIVER_GROUP_ADR;
+    module[1].DeviceAddress = RECEIVER_DEVICE_ADR;
+    for (i = 0; i < 2; i++) {
+        module[i].Radio = homePoint;
+    }
+
+    cfg.Points            = points;
+    cfg.NumPoints         = NUM_POINTS;
+    cfg.FramesPerPoint    = FRAMES_PER_POINT;
+    cfg.PayloadSize       = PAYLOAD_SIZE;
+    cfg.Confirmed         = CONFIRMED;
+    cfg.GapMs             = 0;
+    cfg.PeerGroupAddress  = RECEIVER_GROUP_ADR;
+    cfg.PeerDeviceAddress = RECEIVER_DEVICE_ADR;
+
+    receiverBench.StartReceiver(homePoint, 0);
+    senderBench.StartSender(cfg, results, homePoint, 0);
+
+    for (t = 1; !senderBench.IsDone() && (t < MAX_SIM_MS); t++) {
+        for (i = 0; i < 2; i++) {
+            if (module[i].TxActive && (module[i].TxEnd == t)) {
+                endTx(module[i], module[1 - i], t);
+            }
+            if (module[i].AckPending && (module[i].AckAt == t)) {
+                module[i].AckPending = false;
+                module[i].Bench->OnAck(module[i].AckOk, t);
+            }
+        }
+        for (i = 0; i < 2; i++) {
+            service(module[i], t);
+        }
+    }
+    receiverBench.Stop();
+    return t;
+}
+
+/*****************************************************************************
+ * print a radio setting
+ ****************************************************************************/
+void printPoint(const TWiMODLR_BenchPoint& p)
+{
+    static const uint16_t bw[]  = { 125, 250, 500 };
+    static const uint16_t fsk[] = { 50, 100, 250 };
+
+    if (p.Modulation == Modulation_FSK) {
+        debugMsg(F("FSK  "));
+        debugMsg((int) fsk[p.FskDatarate]);
+        debugMsg(F(" kbps        "));
+        return;
+    }
+    debugMsg(F("LoRa SF"));
+    debugMsg((int) ((p.LoRaSpreadingFactor <= LoRa7_SF7) ? 7 : p.LoRaSpreadingFactor));
+    debugMsg(F(" "));
+    debugMsg((int) bw[p.LoRaBandWidth]);
+    debugMsg(F(" kHz 4/"));
+    debugMsg((int) ((p.ErrorCoding == ErrorCoding0_4_5) ? 5 : p.ErrorCoding + 4));
+    debugMsg(F(" "));
+}
+
+/*****************************************************************************
+ * print the result table
+ ****************************************************************************/
+void printResults(const __FlashStringHelper* name, uint32_t simMs)
+{
+    uint8_t i;
+
+    debugMsg(F("\nloss model: "));
+    debugMsg(name);
+    debugMsg(F(" ("));
+    debugMsg((unsigned long) (simMs / 1000));
+    debugMsg(F(" s)\n"));
+    debugMsg(F("setting                  PER permille  goodput bit/s  airtime us/byte  SNR  TX events\n"));
+
+    for (i = 0; i < senderBench.GetPointsDone(); i++) {
+        const TWiMODLR_BenchResult& r = results[i];
+
+        debugMsg(F("  "));
+        printPoint(r.Point);
+        if (!r.Valid) {
+            debugMsg(F("  no report\n"));
+            continue;
+        }
+        debugMsg(F("  "));
+        debugMsg((unsigned long) r.PerPermille);
+        debugMsg(F("  "));
+        debugMsg((unsigned long) r.GoodputBps);
+        debugMsg(F("  "));
+        if (r.Unique == 0) {
+            // nothing delivered
+            debugMsg(F("N/A"));
+        } else {
+            debugMsg((unsigned long) r.AirTimeUsPerByte);
+        }
+        debugMsg(F("  "));
+        if (r.Received == 0) {
+            debugMsg(F("N/A"));
+        } else {
+            debugMsg((int) r.AvgSNR);
+        }
+        debugMsg(F("  "));
+        debugMsg((unsigned long) r.TxEvents);
+        debugMsg(F("\n"));
+    }
+}
+
+/*****************************************************************************
+ * Arduino setup function
+ ****************************************************************************/
+void setup()
+{
+    // debug interface
+    Serial.begin(115200);
+
+    printStartMsg();
+
+    lossModel = LOSS_NONE;
+    printResults(F("none"), simulate());
+
+    lossModel = LOSS_RANDOM;
+    printResults(F("random"), simulate());
+
+    lossModel = LOSS_BURST;
+    printResults(F("burst"), simulate());
+
+    lossModel = LOSS_LINK_BUDGET;
+    printResults(F("link budget"), simulate());
+}
+
+
+/*****************************************************************************
+ * Arduino loop function
+ ****************************************************************************/
+
+void loop()
+{
+    delay(1000);
+}
@@ -0,0 +1,184 @@
+/*
+ * This is a simple example file to show how to use the WiMOD Arduino
+ * library to communicate with a WiMOD Module by IMST GmbH
+ *
+ * http://www.wireless-solutions.de
+ *
+ */
+
+/*
+ * Example usage:
+ *
+ * This example demonstrates the raw frame sniffer of the LR-Base firmware.
+ *
+ * The module is switched to sniffer mode; each received radio frame is
+ * copied into a capture ring together with the time of reception, RSSI
+ * and SNR. The main loop drains the ring in blocks and writes them as a
+ * binary log to a second serial port. If the log port is too slow, frames
+ * are dropped and counted instead of stalling the HCI communication.
+ *
+ * Setup requirements:
+ * -------------------
+ * - 1 Arduino Due with a WiMOD module running LR-Base firmware
+ *  - the radio settings (frequency, SF, bandwidth) select the channel
+ *    to capture
+ *
+ * Usage:
+ * -------
+ * - Start the program
+ * - open the serial monitor (programming port) @ 115200 baud for the statistics
+ * - capture the log on the native USB port, e.g. on Linux:
+ *      cat /dev/ttyACM1 > capture.wmsn
+ * - convert the log:
+ *      sniffer2pcap capture.wmsn capture.pcap
+ *   (see extras/sniffer2pcap of this library)
+ *
+ */
+
+
+// make sure to use only the WiMODLR_BASE.h
+// the WiMODLR_BASE.h must not be used for LoRaWAN firmware.
+#include <WiMODLR_BASE.h>
+
+//-----------------------------------------------------------------------------
+// section defines
+//-----------------------------------------------------------------------------
+
+#define CAPTURE_RING_SIZE                       4096
+#define LOG_BLOCK_SIZE                          512
+#define STATS_INTERVAL_MS                       10000
+
+// serial port receiving the binary log
+#define LOG_PORT                                SerialUSB
+
+
+//-----------------------------------------------------------------------------
+// section global variables
+//-----------------------------------------------------------------------------
+
+/*
+ * capture ring; filled by the sniffer, drained by the main loop
+ */
+static UINT8 captureRing[CAPTURE_RING_SIZE];
+
+/*
+ * one block of the log
+ */
+static UINT8 logBlock[LOG_BLOCK_SIZE];
+
+static unsigned long lastStatsTime = 0;
+
+
+/*
+ * Create in instance of the interface to the WiMOD-LR-Base firmware
+ */
+WiMODLRBASE wimod(Serial3);  // use the Arduino Serial3 as serial interface
+
+
+/*****************************************************************************
+ * Functions for printing out some debug infos via serial interface
+ ****************************************************************************/
+void debugMsg(String msg)
+{
+    Serial.print(msg);  // use default Arduino serial interface
+}
+
+void debugMsg(int a)
+{
+    Serial.print(a, DEC);
+}
+
+void debugMsg(unsigned long a)
+{
+    Serial.print(a, DEC);
+}
+
+/*****************************************************************************
+ * print out a welcome message
+ ****************************************************************************/
+void printStartMsg()
+{
+    debugMsg(F("==================================================\n"));
+    debugMsg(F("This is FileName: "));
+    debugMsg(F(__FILE__));
+    debugMsg(F("\r\n"));
+    debugMsg(F("Starting...\n"));
+    debugMsg(F("This simple demo will show \n"));
+    debugMsg(F("how to capture raw radio frames with a module\n"));
+    debugMsg(F("running a LR-Base Firmware.\n"));
+    debugMsg(F("==================================================\n"));
+}
+
+/*****************************************************************************
+ * print the counters of the sniffer
+ ****************************************************************************/
+void printStats()
+{
+    TWiMODLR_SnifferStats stats;
+
+    wimod.GetSnifferStats(&stats);
+
+    debugMsg(F("captured "));
+    debugMsg((unsigned long) stats.Captured);
+    debugMsg(F(", dropped "));
+    debugMsg((unsigned long) stats.Dropped);
+    debugMsg(F(", logged "));
+    debugMsg((unsigned long) stats.Drained);
+    debugMsg(F(", ring high water "));
+    debugMsg((unsigned long) stats.HighWaterBytes);
+    debugMsg(F(" of "));
+    debugMsg((unsigned long) CAPTURE_RING_SIZE);
+    debugMsg(F(" bytes\n"));
+}
+
+
+/*****************************************************************************
+ * Arduino setup function
+ ****************************************************************************/
+
+void setup()
+{
+    UINT8 len;
+
+    // init / setup the serial interface connected to WiMOD
+    Serial3.begin(WIMOD_LR_BASE_SERIAL_BAUDRATE);
+    // init the communication stack
+    wimod.begin();
+
+    // debug interface
+    Serial.begin(115200);
+    // log interface
+    LOG_PORT.begin(115200);
+
+    printStartMsg();
+
+    if (!wimod.EnableSniffer(captureRing, CAPTURE_RING_SIZE)) {
+        debugMsg(F("Error: sniffer mode not available\n"));
+        return;
+    }
+
+    // the header describes the captured channel
+    len = wimod.GetSnifferLogHeader(logBlock, LOG_BLOCK_SIZE);
+    LOG_PORT.write(logBlock, len);
+
+    debugMsg(F("Capturing...\n"));
+}
+
+void loop()
+{
+    UINT32 len;
+
+    // check for any pending data of the WiMOD
+    wimod.Process();
+
+    // write the captured frames as one block
+    len = wimod.DrainSniffer(logBlock, LOG_BLOCK_SIZE);
+    if (len) {
+        LOG_PORT.write(logBlock, len);
+    }
+
+    if ((millis() - lastStatsTime) >= STATS_INTERVAL_MS) {
+        lastStatsTime = millis();
+        printStats();
+    }
+}
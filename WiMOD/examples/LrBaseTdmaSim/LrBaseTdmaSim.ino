@@ -0,0 +1,410 @@
+/*
+ * This is a simple example file to show how to use the WiMOD Arduino
+ * library to communicate with a WiMOD Module by IMST GmbH
+ *
+ * http://www.wireless-solutions.de
+ *
+ */
+
+/*
+ * Example:
+ *
+ * This example simulates a star network of LR-Base nodes sending C-Data
+ * messages to one collector and compares free contention (ALOHA with
+ * C-Data retransmissions after the ack timeout) against the TDMA network
+ * (WiMOD_LRBASE_Tdma) for a growing number of nodes.
+ *
+ * Model:
+ * - one channel; overlapping transmissions are all lost (no capture)
+ * - every node has one message per superframe; a message that is not
+ *   delivered before the next one is generated counts as lost
+ * - ALOHA: the message is sent at a random time of the superframe; a lost
+ *   message is sent again after ACK_TIMEOUT_MS + random backoff, at most
+ *   MAX_RETRIES times
+ * - TDMA: the collector and the nodes run WiMOD_LRBASE_Tdma; beacons, slot
+ *   requests and data share the channel. A node sends up to SYNC_ERROR_MS
+ *   after the start of its slot; each node misses BEACON_LOSS_PERCENT of
+ *   the beacons
+ * - fixed random seed, so all runs see the same random numbers
+ *
+ * Setup requirements:
+ * -------------------
+ * - Arduino board with at least 32 kB RAM (e.g. ESP32, SAMD21);
+ *   no WiMOD module is needed. On a Linux host: 'make run' in
+ *   extras/simhost of the library
+ *
+ * Usage:
+ * -------
+ * - Start the program and watch the serial monitor @ 115200 baud
+ *
+ */
+
+
+// make sure to use only the WiMODLR_BASE.h
+// the WiMODLR_BASE.h must not be used for LoRaWAN firmware.
+#include <WiMODLR_BASE.h>
+
+//-----------------------------------------------------------------------------
+// constant values
+//-----------------------------------------------------------------------------
+
+#define MAX_NODES           48
+#define NUM_SUPERFRAMES     40
+#define PAYLOAD_LEN         20
+#define NUM_SLOTS           32
+#define NUM_CONTENTION      2
+#define GUARD_MS            20
+#define SYNC_ERROR_MS       10
+#define BEACON_LOSS_PERCENT 2
+#define ACK_TIMEOUT_MS      500
+#define BACKOFF_MS          1000
+#define MAX_RETRIES         2
+#define NODE_ADR_BASE       0x0100
+
+#define MAX_TX              (MAX_NODES + 2)
+
+const uint16_t nodeCounts[] = { 4, 8, 16, 24, 32, 48 };
+
+#define NUM_NODE_COUNTS     (sizeof(nodeCounts) / sizeof(nodeCounts[0]))
+
+//-----------------------------------------------------------------------------
+// user defined types
+//-----------------------------------------------------------------------------
+
+typedef enum TTxKind
+{
+    TX_DATA = 0,
+    TX_SLOT_REQ,
+    TX_BEACON,
+} TTxKind;
+
+typedef struct TTx
+{
+    bool     Active;
+    bool     Collided;
+    uint8_t  Kind;
+    uint16_t Node;
+    uint32_t End;
+} TTx;
+
+typedef struct TNode
+{
+    bool     HasData;
+    uint8_t  Retries;
+    uint32_t TxAt;                              // planned start; 0 = none
+} TNode;
+
+typedef struct TSimResult
+{
+    uint32_t Offered;
+    uint32_t Delivered;
+    uint32_t Attempts;
+    uint32_t Collided;
+    uint32_t SlotRequests;
+} TSimResult;
+
+//-----------------------------------------------------------------------------
+// section RAM
+//-----------------------------------------------------------------------------
+
+WiMOD_LRBASE_Tdma collector;
+WiMOD_LRBASE_Tdma tdmaNode[MAX_NODES];
+
+static TNode    node[MAX_NODES];
+static TTx      channel[MAX_TX];
+
+static TWiMODLR_DevMgmt_RadioConfig radioCfg;
+static UINT8    beacon[WIMOD_RADIOLINK_PAYLOAD_LEN];
+static UINT8    beaconLen;
+
+static uint32_t dataMs;                         // data + ack
+static uint32_t slotReqMs;
+static uint32_t beaconMs;
+static uint32_t periodMs;
+static uint32_t rndState;
+
+//-----------------------------------------------------------------------------
+// section code
+//-----------------------------------------------------------------------------
+
+/*****************************************************************************
+ * Function for printing out some debug infos via serial interface
+ ****************************************************************************/
+void debugMsg(String msg)
+{
+    Serial.print(msg);  // use default Arduino serial interface
+}
+
+void debugMsg(int a)
+{
+    Serial.print(a, DEC);
+}
+
+void debugMsg(unsigned long a)
+{
+    Serial.print(a, DEC);
+}
+
+/*****************************************************************************
+ * print out a welcome message
+ ****************************************************************************/
+void printStartMsg()
+{
+    debugMsg(F("==================================================\n"));
+    debugMsg(F("This is FileName: "));
+    debugMsg(F(__FILE__));
+    debugMsg(F("\r\n"));
+    debugMsg(F("Starting...\n"));
+    debugMsg(F("This simple demo will compare contention and "));
+    debugMsg(F("TDMA for a growing star network.\n"));
+    debugMsg(F("==================================================\n"));
+}
+
+/*****************************************************************************
+ * reproducible random numbers
+ ****************************************************************************/
+uint32_t nextRandom(uint32_t range)
+{
+    rndState = rndState * 1103515245UL + 12345UL;
+    return ((rndState >> 8) & 0xFFFFFF) % range;
+}
+
+/*****************************************************************************
+ * channel: a new transmission collides with all active ones
+ ****************************************************************************/
+void startTx(uint8_t kind, uint16_t n, uint32_t now, uint32_t durationMs, TSimResult& res)
+{
+    uint8_t i;
+    bool    busy = false;
+
+    for (i = 0; i < MAX_TX; i++) {
+        if (channel[i].Active) {
+            channel[i].Collided = true;
+            busy                = true;
+        }
+    }
+    for (i = 0; i < MAX_TX; i++) {
+        if (!channel[i].Active) {
+            channel[i].Active   = true;
+            channel[i].Collided = busy;
+            channel[i].Kind     = kind;
+            channel[i].Node     = n;
+            channel[i].End      = now + durationMs;
+            break;
+        }
+    }
+    if (kind != TX_BEACON) {
+        res.Attempts++;
+    }
+}
+
+/*****************************************************************************
+ * channel: transmission has ended
+ ****************************************************************************/
+void endTx(bool tdma, const TTx& tx, uint32_t now, uint16_t numNodes, TSimResult& res)
+{
+    uint16_t i;
+
+    if (tx.Collided && (tx.Kind != TX_BEACON)) {
+        res.Collided++;
+    }
+
+    switch (tx.Kind) {
+        case TX_BEACON:
+            for (i = 0; i < numNodes; i++) {
+                if (!tx.Collided && (nextRandom(100) >= BEACON_LOSS_PERCENT)) {
+                    tdmaNode[i].OnFrame(NODE_ADR_BASE - 1, true, beacon, beaconLen, now);
+                }
+            }
+            break;
+        case TX_SLOT_REQ:
+            if (!tx.Collided) {
+                UINT8 req[LRBASE_TDMA_SLOT_REQ_SIZE];
+                UINT8 len = tdmaNode[tx.Node].EncodeSlotRequest(req, sizeof(req));
+                collector.OnFrame(NODE_ADR_BASE + tx.Node, true, req, len, now);
+            }
+            break;
+        default:
+            if (!tx.Collided) {
+                UINT8 data = 0;
+                res.Delivered++;
+                node[tx.Node].HasData = false;
+                if (tdma) {
+                    collector.OnFrame(NODE_ADR_BASE + tx.Node, false, &data, 1, now);
+                }
+            } else if (!tdma && (node[tx.Node].Retries < MAX_RETRIES)) {
+                node[tx.Node].Retries++;
+                node[tx.Node].TxAt = now + ACK_TIMEOUT_MS + nextRandom(BACKOFF_MS);
+            } else if (!tdma) {
+                node[tx.Node].HasData = false;
+            }
+            break;
+    }
+}
+
+/*****************************************************************************
+ * run NUM_SUPERFRAMES superframes with numNodes nodes
+ ****************************************************************************/
+void simulate(bool tdma, uint16_t numNodes, TSimResult& res)
+{
+    TWiMODLR_TdmaInfo info;
+    uint32_t          t;
+    uint32_t          end = NUM_SUPERFRAMES * periodMs;
+    uint16_t          i;
+
+    memset(&res, 0x00, sizeof(res));
+    memset(node, 0x00, sizeof(node));
+    memset(channel, 0x00, sizeof(channel));
+    rndState = 0x5EED;
+
+    collector.StartCollector(0x10, NODE_ADR_BASE - 1, 0x10);
+    for (i = 0; i < numNodes; i++) {
+        tdmaNode[i].SetRadioConfig(radioCfg);
+        tdmaNode[i].StartNode(NODE_ADR_BASE + i, 0);
+    }
+
+    // time starts at 1; TxAt = 0 means nothing planned
+    for (t = 1; t < end; t++) {
+        // new message of each node at the start of a superframe
+        if (((t - 1) % periodMs) == 0) {
+            for (i = 0; i < numNodes; i++) {
+                res.Offered++;
+                node[i].HasData = true;
+                node[i].Retries = 0;
+                node[i].TxAt    = tdma ? 0 : t + nextRandom(periodMs);
+            }
+        }
+
+        for (i = 0; i < MAX_TX; i++) {
+            if (channel[i].Active && (channel[i].End <= t)) {
+                channel[i].Active = false;
+                endTx(tdma, channel[i], t, numNodes, res);
+            }
+        }
+
+        if (tdma) {
+            if (collector.IsBeaconTimeDue(t)) {
+                collector.SetBeaconTime(0);
+            }
+            if (collector.IsBeaconDue(t)) {
+                beaconLen = collector.EncodeBeacon(beacon, sizeof(beacon));
+                collector.OnBeaconSent(t);
+                startTx(TX_BEACON, 0, t, beaconMs, res);
+            }
+            for (i = 0; i < numNodes; i++) {
+                tdmaNode[i].Update(t);
+                if (tdmaNode[i].IsSlotRequestDue(t)) {
+                    tdmaNode[i].OnSlotRequestSent();
+                    startTx(TX_SLOT_REQ, i, t, slotReqMs, res);
+                }
+                if (node[i].HasData && (node[i].TxAt == 0) && (tdmaNode[i].GetMsUntilSlot(t) == 0)) {
+                    tdmaNode[i].OnDataSent(t);
+                    node[i].TxAt = t + nextRandom(SYNC_ERROR_MS + 1);
+                }
+            }
+        }
+
+        for (i = 0; i < numNodes; i++) {
+            if (node[i].HasData && (node[i].TxAt == t)) {
+                startTx(TX_DATA, i, t, dataMs, res);
+                if (tdma) {
+                    // one attempt per slot; the next one in the next superframe
+                    node[i].TxAt = 0;
+                }
+            }
+        }
+    }
+
+    collector.GetInfo(&info);
+    res.SlotRequests = info.SlotRequests;
+}
+
+/*****************************************************************************
+ * print a result
+ ****************************************************************************/
+void printResult(const __FlashStringHelper* name, const TSimResult& res)
+{
+    debugMsg(name);
+    debugMsg((unsigned long)((res.Delivered * 1000UL) / res.Offered));
+    debugMsg(F(" permille delivered, "));
+    debugMsg((unsigned long)(res.Attempts ? (res.Collided * 1000UL) / res.Attempts : 0));
+    debugMsg(F(" permille collided, "));
+    debugMsg((unsigned long)((res.Delivered * PAYLOAD_LEN * 8UL * 1000UL) / (NUM_SUPERFRAMES * periodMs)));
+    debugMsg(F(" bit/s"));
+}
+
+/*****************************************************************************
+ * Arduino setup function
+ ****************************************************************************/
+void setup()
+{
+    TWiMODLR_TdmaConfig cfg;
+    TWiMODLR_TdmaInfo   info;
+    TSimResult          aloha;
+    TSimResult          tdma;
+    uint8_t             n;
+
+    // debug interface
+    Serial.begin(115200);
+
+    printStartMsg();
+
+    memset(&radioCfg, 0x00, sizeof(radioCfg));
+    radioCfg.Modulation          = Modulation_LoRa;
+    radioCfg.LoRaBandWidth       = LoRaBandwith_125kHz;
+    radioCfg.LoRaSpreadingFactor = LoRa9_SF9;
+    radioCfg.ErrorCoding         = ErrorCoding1_4_5;
+
+    cfg.NumSlots           = NUM_SLOTS;
+    cfg.NumContentionSlots = NUM_CONTENTION;
+    cfg.MaxPayloadLen      = PAYLOAD_LEN;
+    cfg.GuardMs            = GUARD_MS;
+    cfg.SlotTimeout        = 5;
+
+    collector.SetConfig(cfg);
+    collector.SetRadioConfig(radioCfg);
+    collector.StartCollector(0x10, NODE_ADR_BASE - 1, 0x10);
+    collector.GetInfo(&info);
+
+    periodMs  = info.SuperframeMs;
+    dataMs    = (WiMOD_LRBASE_Tdma::CalcAirtimeUs(radioCfg, PAYLOAD_LEN) + 999) / 1000
+              + LRBASE_TDMA_ACK_TURNAROUND_MS
+              + (WiMOD_LRBASE_Tdma::CalcAirtimeUs(radioCfg, 0) + 999) / 1000;
+    slotReqMs = (WiMOD_LRBASE_Tdma::CalcAirtimeUs(radioCfg, LRBASE_TDMA_SLOT_REQ_SIZE) + 999) / 1000;
+    beaconMs  = (WiMOD_LRBASE_Tdma::CalcAirtimeUs(radioCfg, LRBASE_TDMA_BEACON_HEADER_SIZE + 2 * NUM_SLOTS) + 999) / 1000;
+
+    debugMsg(F("data + ack "));
+    debugMsg((unsigned long) dataMs);
+    debugMsg(F(" ms, slot width "));
+    debugMsg((unsigned long) info.SlotWidthMs);
+    debugMsg(F(" ms, superframe "));
+    debugMsg((unsigned long) periodMs);
+    debugMsg(F(" ms with "));
+    debugMsg((int) NUM_SLOTS);
+    debugMsg(F(" slots\n"));
+
+    for (n = 0; n < NUM_NODE_COUNTS; n++) {
+        simulate(false, nodeCounts[n], aloha);
+        simulate(true, nodeCounts[n], tdma);
+
+        debugMsg(F("nodes "));
+        debugMsg((int) nodeCounts[n]);
+        debugMsg(F("\n"));
+        printResult(F("  ALOHA: "), aloha);
+        debugMsg(F("\n"));
+        printResult(F("  TDMA:  "), tdma);
+        debugMsg(F(", slot requests "));
+        debugMsg((unsigned long) tdma.SlotRequests);
+        debugMsg(F("\n"));
+    }
+}
+
+
+/*****************************************************************************
+ * Arduino loop function
+ ****************************************************************************/
+
+void loop()
+{
+    delay(1000);
+}
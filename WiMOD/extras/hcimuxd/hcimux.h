@@ -0,0 +1,93 @@
+/*
+ * hcimux.h
+ *
+ * Client protocol of hcimuxd, the HCI multiplexer for Linux gateways.
+ *
+ * hcimuxd owns the serial port of the WiMOD module and accepts clients on
+ * a Unix socket of type SOCK_SEQPACKET. Every packet carries one message:
+ *
+ *   [type] [SapID] [MsgID] [payload ...]
+ *
+ * i.e. a HCI message without SLIP framing and CRC (the daemon adds / checks
+ * them). Packets of the client:
+ *
+ *   HCIMUX_MSG_REQ          request to the module; the response (MsgID + 1)
+ *                           is returned to this client only as HCIMUX_MSG_RSP.
+ *                           Requests of all clients are queued and sent one
+ *                           after another, like the library does.
+ *   HCIMUX_MSG_SUBSCRIBE    [SapID] [MsgID]; receive all unsolicited messages
+ *                           (indications) that match as HCIMUX_MSG_IND.
+ *                           HCIMUX_ANY matches every SapID / MsgID.
+ *   HCIMUX_MSG_UNSUBSCRIBE  [SapID] [MsgID]; remove a filter
+ *   HCIMUX_MSG_GET_STATS    returns HCIMUX_MSG_STATS with THCIMuxStats
+ *
+ * Packets of the daemon:
+ *
+ *   HCIMUX_MSG_RSP          response to the own request
+ *   HCIMUX_MSG_IND          indication matching a filter
+ *   HCIMUX_MSG_TIMEOUT      [SapID] [MsgID] of a request without response
+ *   HCIMUX_MSG_ERROR        [reason] request / filter rejected
+ *   HCIMUX_MSG_STATS        [THCIMuxStats] of this client
+ */
+
+#ifndef HCIMUXD_HCIMUX_H_
+#define HCIMUXD_HCIMUX_H_
+
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------
+// defines
+//-----------------------------------------------------------------------------
+
+#define HCIMUX_DEFAULT_SOCKET       "/run/wimod-hci.sock"
+
+// type byte + SapID + MsgID + WIMODLR_HCI_MSG_PAYLOAD_SIZE
+#define HCIMUX_MAX_PACKET_SIZE      (1 + 2 + 280)
+
+// wildcard for SapID / MsgID of a filter
+#define HCIMUX_ANY                  0xFF
+
+// packets of the client
+#define HCIMUX_MSG_REQ              0x01
+#define HCIMUX_MSG_SUBSCRIBE        0x02
+#define HCIMUX_MSG_UNSUBSCRIBE      0x03
+#define HCIMUX_MSG_GET_STATS        0x04
+
+// packets of the daemon
+#define HCIMUX_MSG_RSP              0x81
+#define HCIMUX_MSG_IND              0x82
+#define HCIMUX_MSG_TIMEOUT          0x83
+#define HCIMUX_MSG_ERROR            0x84
+#define HCIMUX_MSG_STATS            0x85
+
+// reasons of HCIMUX_MSG_ERROR
+#define HCIMUX_ERR_FORMAT           0x01    /* packet too short / unknown type */
+#define HCIMUX_ERR_QUEUE_FULL       0x02    /* too many requests queued */
+#define HCIMUX_ERR_FILTERS_FULL     0x03    /* too many filters */
+
+//-----------------------------------------------------------------------------
+// statistics
+//-----------------------------------------------------------------------------
+
+/*
+ * Per client counters and the latency the daemon adds (us):
+ *
+ * - request path: request received from the socket until it is written to
+ *   the serial port; includes waiting for requests of other clients
+ * - response path: frame received from the serial port until it is handed
+ *   to the socket of the client (SLIP decoding, CRC check, routing)
+ */
+typedef struct THCIMuxStats
+{
+    uint32_t    Requests;                   /* requests sent to the module */
+    uint32_t    Responses;                  /* responses returned */
+    uint32_t    Timeouts;                   /* requests without response */
+    uint32_t    Indications;                /* indications delivered */
+    uint32_t    Dropped;                    /* packets lost, client too slow */
+    uint32_t    ReqUsAvg;
+    uint32_t    ReqUsMax;
+    uint32_t    RspUsAvg;
+    uint32_t    RspUsMax;
+} THCIMuxStats;
+
+#endif /* HCIMUXD_HCIMUX_H_ */
@@ -0,0 +1,515 @@
+/*
+ * hcimux_bench.cpp
+ *
+ * Measures the latency hcimuxd adds, without hardware: a simulated module
+ * answers HCI requests on the master side of a pty and sends an
+ * indication every few ms, hcimuxd is started on the slave side.
+ *
+ * 1. baseline: ping requests sent directly to the pty (no daemon)
+ * 2. the same pings from 1 client and from <clients> parallel clients via
+ *    hcimuxd; every second client subscribes to the LoRaWAN indications
+ *
+ * Per client the round trip time is printed together with the difference
+ * to the baseline and the request / response path latency measured by
+ * the daemon itself (HCIMUX_MSG_GET_STATS). With several clients the
+ * round trip includes waiting for the requests of the other clients,
+ * because the module handles one request at a time.
+ *
+ * The pty transfers the bytes without the delay of a real UART; the time
+ * on the wire at 115200 baud (~1 ms for a short frame) comes on top, for
+ * the module and the baseline alike.
+ *
+ * Build (Linux), in this directory (build hcimuxd first):
+ *   g++ -O2 -Wall -Iposix -I../../src -o hcimux_bench hcimux_bench.cpp posix/PosixStream.cpp \
+ *       ../../src/HCI/WiMODLRHCI.cpp ../../src/utils/ComSLIP.cpp ../../src/utils/CRC16.cpp -lpthread
+ *
+ * Usage:
+ *   hcimux_bench [-c <clients>] [-n <requests per client>] [-i <indication interval ms>]
+ *                [-d <module processing time us>] <path of hcimuxd>
+ */
+
+#include "HCI/WiMODLRHCI.h"
+#include "SAP/WiMOD_SAP_DEVMGMT_IDs.h"
+#include "SAP/WiMOD_SAP_LORAWAN_IDs.h"
+#include "utils/CRC16.h"
+#include "PosixStream.h"
+#include "hcimux.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+//-----------------------------------------------------------------------------
+// defines
+//-----------------------------------------------------------------------------
+
+#define BENCH_MAX_CLIENTS       16
+#define BENCH_MAX_REQUESTS      10000
+#define BENCH_PING_SIZE         4           /* client, sequence number */
+#define BENCH_RSP_TIMEOUT_MS    2000
+
+//-----------------------------------------------------------------------------
+// helpers
+//-----------------------------------------------------------------------------
+
+static uint64_t nowUs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + (uint64_t) ts.tv_nsec / 1000;
+}
+
+static int compareU32(const void* a, const void* b)
+{
+    uint32_t x = *(const uint32_t*) a;
+    uint32_t y = *(const uint32_t*) b;
+
+    return (x > y) - (x < y);
+}
+
+typedef struct TLatency
+{
+    uint32_t    Avg;
+    uint32_t    P50;
+    uint32_t    P99;
+    uint32_t    Max;
+} TLatency;
+
+static void evaluate(uint32_t* us, uint32_t count, TLatency& lat)
+{
+    uint64_t sum = 0;
+    uint32_t i;
+
+    memset(&lat, 0, sizeof(lat));
+    if (count == 0) {
+        return;
+    }
+    for (i = 0; i < count; i++) {
+        sum += us[i];
+    }
+    qsort(us, count, sizeof(uint32_t), compareU32);
+    lat.Avg = (uint32_t) (sum / count);
+    lat.P50 = us[count / 2];
+    lat.P99 = us[(count * 99) / 100];
+    lat.Max = us[count - 1];
+}
+
+//-----------------------------------------------------------------------------
+// simulated module
+//-----------------------------------------------------------------------------
+
+/*
+ * Answers every request with MsgID + 1, status OK and the request payload;
+ * sends LORAWAN_MSG_RECV_UDATA_IND in regular intervals.
+ */
+class TSimModule : public TComSlipClient
+{
+    public:
+    TSimModule(PosixStream& s) : serial(s), slip(s), rxCount(0), indCount(0), procUs(0) {}
+
+    void begin(uint32_t processingUs)
+    {
+        procUs = processingUs;
+        slip.RegisterClient(this);
+        slip.begin();
+        slip.SetRxBuffer(rxBuf, sizeof(rxBuf));
+    }
+
+    void process(void)
+    {
+        UINT8 rxByte;
+
+        while (serial.available() > 0) {
+            rxByte = (UINT8) serial.read();
+            slip.DecodeData(&rxByte, 1);
+        }
+    }
+
+    void sendIndication(void)
+    {
+        UINT8 payload[5];
+
+        payload[0] = 1;                         // port
+        HTON32(&payload[1], indCount++);
+        send(LORAWAN_SAP_ID, LORAWAN_MSG_RECV_UDATA_IND, payload, sizeof(payload));
+    }
+
+    uint32_t getRxCount(void) const { return rxCount; }
+
+    protected:
+    virtual UINT8* ProcessRxMessage(UINT8* rxBuffer, UINT16 length)
+    {
+        if (CRC16_Check(rxBuffer, length, CRC16_INIT_VALUE)
+                && (length >= WIMODLR_HCI_MSG_HEADER_SIZE + WIMODLR_HCI_MSG_FCS_SIZE)) {
+            UINT16 payloadLen = length - WIMODLR_HCI_MSG_HEADER_SIZE - WIMODLR_HCI_MSG_FCS_SIZE;
+
+            rxCount++;
+            if (procUs > 0) {
+                uint64_t end = nowUs() + procUs;
+                while (nowUs() < end);
+            }
+            txBuf[0] = 0x00;                    // status OK
+            memcpy(&txBuf[1], &rxBuffer[WIMODLR_HCI_MSG_HEADER_SIZE], payloadLen);
+            send(rxBuffer[0], rxBuffer[1] + 1, txBuf, payloadLen + 1);
+        }
+        return rxBuffer;
+    }
+
+    private:
+    void send(UINT8 sapID, UINT8 msgID, const UINT8* payload, UINT16 length)
+    {
+        UINT8  frame[WIMODLR_HCI_RX_MESSAGE_SIZE + 1];
+        UINT16 crc16;
+
+        frame[0] = sapID;
+        frame[1] = msgID;
+        memcpy(&frame[WIMODLR_HCI_MSG_HEADER_SIZE], payload, length);
+        length += WIMODLR_HCI_MSG_HEADER_SIZE;
+        crc16 = ~CRC16_Calc(frame, length, CRC16_INIT_VALUE);
+        frame[length++] = LOBYTE(crc16);
+        frame[length++] = HIBYTE(crc16);
+        slip.SendMessage(frame, length);
+        serial.flush();
+    }
+
+    PosixStream&    serial;
+    TComSlip        slip;
+    UINT8           rxBuf[WIMODLR_HCI_RX_MESSAGE_SIZE];
+    UINT8           txBuf[WIMODLR_HCI_MSG_PAYLOAD_SIZE + 1];
+    uint32_t        rxCount;
+    uint32_t        indCount;
+    uint32_t        procUs;
+};
+
+static PosixStream      simSerial;
+static TSimModule       sim(simSerial);
+static volatile bool    simRunning = true;
+static uint32_t         indIntervalMs = 20;
+
+static void* simThread(void*)
+{
+    struct pollfd pfd;
+    uint64_t      nextInd = nowUs() + indIntervalMs * 1000;
+
+    pfd.fd     = simSerial.getFd();
+    pfd.events = POLLIN;
+
+    while (simRunning) {
+        uint64_t now = nowUs();
+        int      timeout = (nextInd > now) ? (int) ((nextInd - now + 999) / 1000) : 0;
+
+        if (indIntervalMs == 0) {
+            timeout = 100;
+        }
+        if (poll(&pfd, 1, timeout) > 0) {
+            // EIO while the slave side is not opened
+            if (simSerial.fill() < 0) {
+                usleep(1000);
+            }
+            sim.process();
+        }
+        if ((indIntervalMs > 0) && (nowUs() >= nextInd)) {
+            sim.sendIndication();
+            nextInd += indIntervalMs * 1000;
+        }
+    }
+    return NULL;
+}
+
+//-----------------------------------------------------------------------------
+// baseline: direct access with the HCI layer of the library
+//-----------------------------------------------------------------------------
+
+class TDirectHCI : public TWiMODLRHCI
+{
+    public:
+    TDirectHCI(PosixStream& s) : TWiMODLRHCI(s), serial(s), done(false) {}
+
+    // one ping; returns the round trip time in us or 0 on timeout
+    uint32_t ping(UINT8* payload)
+    {
+        struct pollfd pfd;
+        uint64_t      start = nowUs();
+
+        done = false;
+        SendHCIMessageWithoutRx(DEVMGMT_SAP_ID, DEVMGMT_MSG_PING_REQ, payload, BENCH_PING_SIZE);
+        serial.flush();
+
+        pfd.fd     = serial.getFd();
+        pfd.events = POLLIN;
+        while (!done && (poll(&pfd, 1, BENCH_RSP_TIMEOUT_MS) > 0)) {
+            serial.fill();
+            Process();
+        }
+        return done ? (uint32_t) (nowUs() - start) : 0;
+    }
+
+    protected:
+    virtual void ProcessUnexpectedRxMessage(TWiMODLR_HCIMessage& rxMsg)
+    {
+        if ((rxMsg.SapID == DEVMGMT_SAP_ID) && (rxMsg.MsgID == DEVMGMT_MSG_PING_RSP)) {
+            done = true;
+        }
+    }
+
+    private:
+    PosixStream&    serial;
+    bool            done;
+};
+
+//-----------------------------------------------------------------------------
+// clients of hcimuxd
+//-----------------------------------------------------------------------------
+
+typedef struct TBenchClient
+{
+    pthread_t       Thread;
+    UINT8           Id;
+    bool            Subscribe;
+    uint32_t        Requests;
+    uint32_t        Done;
+    uint32_t        Errors;
+    uint32_t        Indications;
+    uint32_t        Rtt[BENCH_MAX_REQUESTS];
+    THCIMuxStats    Stats;
+} TBenchClient;
+
+static char          socketPath[96];
+static TBenchClient  benchClients[BENCH_MAX_CLIENTS];
+static uint32_t      numRequests = 1000;
+
+static int connectDaemon(void)
+{
+    struct sockaddr_un addr;
+    int                fd;
+    int                retry;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socketPath, sizeof(addr.sun_path) - 1);
+
+    for (retry = 0; retry < 200; retry++) {
+        fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        if (connect(fd, (struct sockaddr*) &addr, sizeof(addr)) == 0) {
+            return fd;
+        }
+        close(fd);
+        usleep(10000);
+    }
+    return -1;
+}
+
+// wait for a packet of the given type; indications are counted on the way
+static ssize_t waitFor(TBenchClient& c, int fd, UINT8 type, UINT8* buf)
+{
+    struct pollfd pfd;
+    ssize_t       n;
+
+    pfd.fd     = fd;
+    pfd.events = POLLIN;
+
+    while (poll(&pfd, 1, BENCH_RSP_TIMEOUT_MS) > 0) {
+        n = recv(fd, buf, HCIMUX_MAX_PACKET_SIZE, 0);
+        if (n <= 0) {
+            break;
+        }
+        if (buf[0] == HCIMUX_MSG_IND) {
+            c.Indications++;
+            continue;
+        }
+        if (buf[0] == type) {
+            return n;
+        }
+        return -1;                              // timeout / error of the daemon
+    }
+    return -1;
+}
+
+static void* clientThread(void* arg)
+{
+    TBenchClient& c = *(TBenchClient*) arg;
+    UINT8         req[3 + BENCH_PING_SIZE];
+    UINT8         rsp[HCIMUX_MAX_PACKET_SIZE];
+    uint32_t      seq;
+    uint64_t      start;
+    ssize_t       n;
+    int           fd;
+
+    fd = connectDaemon();
+    if (fd < 0) {
+        c.Errors = c.Requests;
+        return NULL;
+    }
+
+    if (c.Subscribe) {
+        req[0] = HCIMUX_MSG_SUBSCRIBE;
+        req[1] = LORAWAN_SAP_ID;
+        req[2] = HCIMUX_ANY;
+        send(fd, req, 3, 0);
+    }
+
+    for (seq = 0; seq < c.Requests; seq++) {
+        req[0] = HCIMUX_MSG_REQ;
+        req[1] = DEVMGMT_SAP_ID;
+        req[2] = DEVMGMT_MSG_PING_REQ;
+        req[3] = c.Id;
+        req[4] = (UINT8) (seq >> 16);
+        req[5] = (UINT8) (seq >> 8);
+        req[6] = (UINT8) seq;
+
+        start = nowUs();
+        send(fd, req, sizeof(req), 0);
+        n = waitFor(c, fd, HCIMUX_MSG_RSP, rsp);
+
+        // [type] [SapID] [MsgID] [status] [echoed payload]
+        if ((n == 4 + BENCH_PING_SIZE) && (rsp[2] == DEVMGMT_MSG_PING_RSP) && (memcmp(&rsp[4], &req[3], BENCH_PING_SIZE) == 0)) {
+            c.Rtt[c.Done++] = (uint32_t) (nowUs() - start);
+        } else {
+            c.Errors++;
+        }
+    }
+
+    req[0] = HCIMUX_MSG_GET_STATS;
+    send(fd, req, 1, 0);
+    if (waitFor(c, fd, HCIMUX_MSG_STATS, rsp) == 1 + (ssize_t) sizeof(THCIMuxStats)) {
+        memcpy(&c.Stats, &rsp[1], sizeof(THCIMuxStats));
+    }
+    close(fd);
+    return NULL;
+}
+
+static void runClients(uint8_t count, const TLatency& base)
+{
+    uint8_t  i;
+    TLatency lat;
+
+    for (i = 0; i < count; i++) {
+        TBenchClient& c = benchClients[i];
+
+        memset(&c, 0, sizeof(TBenchClient));
+        c.Id        = i;
+        c.Subscribe = (i % 2) == 1;
+        c.Requests  = numRequests;
+        pthread_create(&c.Thread, NULL, clientThread, &c);
+    }
+
+    printf("\n%u client(s) via hcimuxd\n", count);
+    printf("client  pings  errors  ind.  rtt avg/p50/p99/max us    added avg us  daemon req/rsp path avg (max) us\n");
+    for (i = 0; i < count; i++) {
+        TBenchClient& c = benchClients[i];
+
+        pthread_join(c.Thread, NULL);
+        evaluate(c.Rtt, c.Done, lat);
+        printf("%4u   %6u  %5u  %5u  %5u/%5u/%5u/%6u   %8d      %5u (%u) / %u (%u)\n",
+               i, c.Done, c.Errors, c.Indications, lat.Avg, lat.P50, lat.P99, lat.Max,
+               (int) lat.Avg - (int) base.Avg,
+               c.Stats.ReqUsAvg, c.Stats.ReqUsMax, c.Stats.RspUsAvg, c.Stats.RspUsMax);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// main
+//-----------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    static uint32_t rtt[BENCH_MAX_REQUESTS];
+    TLatency        base;
+    pthread_t       simTid;
+    const char*     slavePath;
+    uint32_t        procUs     = 0;
+    uint32_t        done       = 0;
+    uint32_t        i;
+    uint8_t         numClients = 4;
+    int             master;
+    int             opt;
+    int             status;
+    pid_t           daemon;
+
+    while ((opt = getopt(argc, argv, "c:n:i:d:")) != -1) {
+        switch (opt) {
+            case 'c':   numClients    = (uint8_t) atoi(optarg);     break;
+            case 'n':   numRequests   = (uint32_t) atoi(optarg);    break;
+            case 'i':   indIntervalMs = (uint32_t) atoi(optarg);    break;
+            case 'd':   procUs        = (uint32_t) atoi(optarg);    break;
+            default:    optind        = argc + 1;                   break;
+        }
+    }
+    if ((optind != argc - 1) || (numClients < 1) || (numClients > BENCH_MAX_CLIENTS)
+            || (numRequests < 1) || (numRequests > BENCH_MAX_REQUESTS)) {
+        fprintf(stderr, "usage: %s [-c <clients 1..%d>] [-n <requests 1..%d>] [-i <indication interval ms>] "
+                "[-d <module processing time us>] <path of hcimuxd>\n", argv[0], BENCH_MAX_CLIENTS, BENCH_MAX_REQUESTS);
+        return 1;
+    }
+
+    // simulated module on the pty master
+    master = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if ((master < 0) || (grantpt(master) < 0) || (unlockpt(master) < 0)) {
+        perror("pty");
+        return 1;
+    }
+    slavePath = ptsname(master);
+    simSerial.attach(master);
+    sim.begin(procUs);
+    pthread_create(&simTid, NULL, simThread, NULL);
+
+    printf("simulated module on %s, indication every %u ms, processing %u us\n",
+           slavePath, indIntervalMs, procUs);
+
+    // 1. baseline
+    {
+        PosixStream direct;
+        TDirectHCI  hci(direct);
+        UINT8       payload[BENCH_PING_SIZE] = { 0xFF, 0, 0, 0 };
+
+        if (!direct.open(slavePath, WIMODLR_SERIAL_BAUDRATE)) {
+            perror(slavePath);
+            return 1;
+        }
+        hci.begin();
+        for (i = 0; i < numRequests; i++) {
+            payload[3] = (UINT8) i;
+            rtt[done] = hci.ping(payload);
+            if (rtt[done] > 0) {
+                done++;
+            }
+        }
+        direct.close();
+    }
+    evaluate(rtt, done, base);
+    printf("\ndirect (no daemon): %u pings, rtt avg/p50/p99/max %u/%u/%u/%u us\n",
+           done, base.Avg, base.P50, base.P99, base.Max);
+
+    // 2. via hcimuxd
+    snprintf(socketPath, sizeof(socketPath), "/tmp/hcimux_bench.%d.sock", (int) getpid());
+    daemon = fork();
+    if (daemon == 0) {
+        execl(argv[optind], argv[optind], "-s", socketPath, slavePath, (char*) NULL);
+        perror(argv[optind]);
+        _exit(1);
+    }
+
+    runClients(1, base);
+    if (numClients > 1) {
+        runClients(numClients, base);
+    }
+
+    kill(daemon, SIGTERM);
+    waitpid(daemon, &status, 0);
+
+    simRunning = false;
+    pthread_join(simTid, NULL);
+    printf("\nmodule received %u requests\n", sim.getRxCount());
+    return 0;
+}
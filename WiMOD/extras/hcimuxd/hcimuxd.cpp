@@ -0,0 +1,668 @@
+/*
+ * hcimuxd.cpp
+ *
+ * HCI multiplexer for Linux gateways: owns the serial port of a WiMOD
+ * module and shares it among several processes (monitoring, provisioning,
+ * the data application) via a Unix socket. The client protocol is
+ * described in hcimux.h.
+ *
+ * - requests of all clients are queued and sent one after another; the
+ *   response (MsgID + 1) is routed back to the requesting client
+ * - unsolicited messages (indications) are fanned out to all clients with
+ *   a matching (SapID, MsgID) filter
+ * - single threaded epoll loop; requests are received from the socket
+ *   directly into the queue and SLIP encoded from there, received frames
+ *   are handed to the sockets straight from the SLIP decoder buffer
+ *
+ * The HCI layer is the one of the library (TWiMODLRHCI, TComSlip); the
+ * Arduino Stream is provided by posix/PosixStream.
+ *
+ * Build (Linux), in this directory:
+ *   g++ -O2 -Wall -Iposix -I../../src -o hcimuxd hcimuxd.cpp posix/PosixStream.cpp \
+ *       ../../src/HCI/WiMODLRHCI.cpp ../../src/utils/ComSLIP.cpp ../../src/utils/CRC16.cpp
+ *
+ * Usage:
+ *   hcimuxd [-b <baudrate>] [-s <socket>] [-w] [-v] <serial device>
+ *
+ *   -b  baudrate of the module, default 115200
+ *   -s  path of the Unix socket, default HCIMUX_DEFAULT_SOCKET
+ *   -w  send the wakeup sequence before each request (module in sleep mode)
+ *   -v  log clients and their statistics when they disconnect
+ *
+ * SIGUSR1 prints the statistics of all clients to stderr. hcimux_bench.cpp
+ * measures the latency added by the daemon against a simulated module.
+ */
+
+#include "HCI/WiMODLRHCI.h"
+#include "utils/CRC16.h"
+#include "PosixStream.h"
+#include "hcimux.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+
+//-----------------------------------------------------------------------------
+// defines
+//-----------------------------------------------------------------------------
+
+#define HCIMUX_MAX_CLIENTS      16
+#define HCIMUX_MAX_FILTERS      8
+#define HCIMUX_QUEUE_SIZE       32          /* requests of all clients */
+#define HCIMUX_RSP_TIMEOUT_MS   1000        /* like WIMODLR_RESPOMSE_TIMEOUT_MS */
+#define HCIMUX_MAX_EVENTS       16
+
+// epoll tags
+#define TAG_SERIAL              0x10000
+#define TAG_LISTEN              0x20000
+#define TAG_SIGNAL              0x30000
+#define TAG_CLIENT              0x40000     /* | client slot */
+#define TAG_MASK                0xF0000
+
+#define NO_CLIENT               (-1)
+
+//-----------------------------------------------------------------------------
+// types
+//-----------------------------------------------------------------------------
+
+typedef struct TFilter
+{
+    UINT8           SapID;
+    UINT8           MsgID;
+} TFilter;
+
+typedef struct TClient
+{
+    int             Fd;                     /* -1 = slot free */
+    TFilter         Filters[HCIMUX_MAX_FILTERS];
+    UINT8           NumFilters;
+    THCIMuxStats    Stats;
+    uint64_t        ReqUsSum;
+    uint64_t        RspUsSum;
+    uint32_t        RspCount;
+} TClient;
+
+typedef struct TRequest
+{
+    int             Client;                 /* slot or NO_CLIENT if gone */
+    uint64_t        RxTime;                 /* received from the socket */
+    TWiMODLR_HCIMessage Msg;                /* Length = payload length */
+} TRequest;
+
+//-----------------------------------------------------------------------------
+// HCI layer
+//-----------------------------------------------------------------------------
+
+static void onModuleMessage(TWiMODLR_HCIMessage& rxMsg);
+
+class THCIMux : public TWiMODLRHCI
+{
+    public:
+    THCIMux(Stream& s) : TWiMODLRHCI(s) {}
+
+    // send a request that was received directly into msg; the CRC is
+    // added in place behind the payload (like PostMessage, without copy)
+    void SendRequest(TWiMODLR_HCIMessage& msg)
+    {
+        UINT16 length = msg.Length + WIMODLR_HCI_MSG_HEADER_SIZE;
+        UINT16 crc16  = ~CRC16_Calc(&msg.SapID, length, CRC16_INIT_VALUE);
+
+        msg.Payload[msg.Length]     = LOBYTE(crc16);
+        msg.Payload[msg.Length + 1] = HIBYTE(crc16);
+        SendPacket(&msg.SapID, length + WIMODLR_HCI_MSG_FCS_SIZE);
+    }
+
+    protected:
+    // no request is sent via SendHCIMessage(), so every frame ends up here
+    virtual void ProcessUnexpectedRxMessage(TWiMODLR_HCIMessage& rxMsg)
+    {
+        onModuleMessage(rxMsg);
+    }
+};
+
+//-----------------------------------------------------------------------------
+// state
+//-----------------------------------------------------------------------------
+
+static PosixStream  serial;
+static THCIMux      hci(serial);
+
+static TClient      clients[HCIMUX_MAX_CLIENTS];
+
+static TRequest     queue[HCIMUX_QUEUE_SIZE];
+static TRequest     scratch;                /* receive buffer if the queue is full */
+static uint8_t      queueHead;
+static uint8_t      queueCount;
+static bool         pending;                /* queue head sent, waiting for response */
+static uint64_t     deadline;
+
+static uint64_t     serialRxTime;           /* serial port became readable */
+static bool         wakeup;
+static bool         verbose;
+static int          epfd;
+
+//-----------------------------------------------------------------------------
+// helpers
+//-----------------------------------------------------------------------------
+
+static uint64_t nowUs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + (uint64_t) ts.tv_nsec / 1000;
+}
+
+static bool sendPacket(TClient& c, UINT8 type, const UINT8* data, size_t length)
+{
+    struct iovec  iov[2];
+    struct msghdr mh;
+
+    iov[0].iov_base = &type;
+    iov[0].iov_len  = 1;
+    iov[1].iov_base = (void*) data;
+    iov[1].iov_len  = length;
+
+    memset(&mh, 0, sizeof(mh));
+    mh.msg_iov    = iov;
+    mh.msg_iovlen = 2;
+
+    if (sendmsg(c.Fd, &mh, MSG_DONTWAIT | MSG_NOSIGNAL) < 0) {
+        // EAGAIN: socket buffer of a slow client is full; other errors
+        // are handled when epoll reports the hang up
+        c.Stats.Dropped++;
+        return false;
+    }
+    return true;
+}
+
+// forward a frame of the module straight from the SLIP decoder buffer
+static bool forward(TClient& c, UINT8 type, const TWiMODLR_HCIMessage& msg)
+{
+    uint64_t us;
+
+    if (!sendPacket(c, type, &msg.SapID, msg.Length + WIMODLR_HCI_MSG_HEADER_SIZE)) {
+        return false;
+    }
+    us = nowUs() - serialRxTime;
+    c.RspUsSum += us;
+    c.RspCount++;
+    if (us > c.Stats.RspUsMax) {
+        c.Stats.RspUsMax = (uint32_t) us;
+    }
+    return true;
+}
+
+static void sendError(TClient& c, UINT8 reason)
+{
+    sendPacket(c, HCIMUX_MSG_ERROR, &reason, 1);
+}
+
+static void getStats(const TClient& c, THCIMuxStats& stats)
+{
+    stats          = c.Stats;
+    stats.ReqUsAvg = c.Stats.Requests ? (uint32_t) (c.ReqUsSum / c.Stats.Requests) : 0;
+    stats.RspUsAvg = c.RspCount ? (uint32_t) (c.RspUsSum / c.RspCount) : 0;
+}
+
+static void printStats(int slot)
+{
+    THCIMuxStats s;
+
+    getStats(clients[slot], s);
+    fprintf(stderr, "client %d: %u requests, %u responses, %u timeouts, %u indications, %u dropped, "
+            "request path %u/%u us, response path %u/%u us (avg/max)\n",
+            slot, s.Requests, s.Responses, s.Timeouts, s.Indications, s.Dropped,
+            s.ReqUsAvg, s.ReqUsMax, s.RspUsAvg, s.RspUsMax);
+}
+
+static bool matches(const TClient& c, UINT8 sapID, UINT8 msgID)
+{
+    UINT8 i;
+
+    for (i = 0; i < c.NumFilters; i++) {
+        if (((c.Filters[i].SapID == HCIMUX_ANY) || (c.Filters[i].SapID == sapID))
+                && ((c.Filters[i].MsgID == HCIMUX_ANY) || (c.Filters[i].MsgID == msgID))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+// request queue
+//-----------------------------------------------------------------------------
+
+static void popRequest(void)
+{
+    queueHead = (queueHead + 1) % HCIMUX_QUEUE_SIZE;
+    queueCount--;
+    pending = false;
+}
+
+// send the next request if the module is idle
+static void pump(void)
+{
+    while (!pending && (queueCount > 0)) {
+        TRequest& req = queue[queueHead];
+        uint64_t  us;
+
+        if (req.Client == NO_CLIENT) {
+            popRequest();                       // client has gone meanwhile
+            continue;
+        }
+        if (wakeup) {
+            hci.SendWakeUpSequence();
+        }
+        hci.SendRequest(req.Msg);
+        serial.flush();
+
+        TClient& c = clients[req.Client];
+        us = nowUs() - req.RxTime;
+        c.ReqUsSum += us;
+        c.Stats.Requests++;
+        if (us > c.Stats.ReqUsMax) {
+            c.Stats.ReqUsMax = (uint32_t) us;
+        }
+
+        pending  = true;
+        deadline = nowUs() + (uint64_t) HCIMUX_RSP_TIMEOUT_MS * 1000;
+    }
+}
+
+static void checkTimeout(void)
+{
+    if (pending && (nowUs() >= deadline)) {
+        TRequest& req = queue[queueHead];
+
+        if (req.Client != NO_CLIENT) {
+            clients[req.Client].Stats.Timeouts++;
+            sendPacket(clients[req.Client], HCIMUX_MSG_TIMEOUT, &req.Msg.SapID, WIMODLR_HCI_MSG_HEADER_SIZE);
+        }
+        popRequest();
+        pump();
+    }
+}
+
+//-----------------------------------------------------------------------------
+// module
+//-----------------------------------------------------------------------------
+
+static void onModuleMessage(TWiMODLR_HCIMessage& rxMsg)
+{
+    int slot;
+
+    // response to the pending request ?
+    if (pending) {
+        TRequest& req = queue[queueHead];
+
+        if ((rxMsg.SapID == req.Msg.SapID) && (rxMsg.MsgID == (UINT8) (req.Msg.MsgID + 1))) {
+            if ((req.Client != NO_CLIENT) && forward(clients[req.Client], HCIMUX_MSG_RSP, rxMsg)) {
+                clients[req.Client].Stats.Responses++;
+            }
+            popRequest();
+            return;
+        }
+    }
+
+    // indication: fan out to all subscribers
+    for (slot = 0; slot < HCIMUX_MAX_CLIENTS; slot++) {
+        TClient& c = clients[slot];
+
+        if ((c.Fd >= 0) && matches(c, rxMsg.SapID, rxMsg.MsgID) && forward(c, HCIMUX_MSG_IND, rxMsg)) {
+            c.Stats.Indications++;
+        }
+    }
+}
+
+static bool onSerial(void)
+{
+    serialRxTime = nowUs();
+    if (serial.fill() < 0) {
+        fprintf(stderr, "serial port closed\n");
+        return false;
+    }
+    hci.Process();
+    pump();
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// clients
+//-----------------------------------------------------------------------------
+
+static void onAccept(int listenFd)
+{
+    struct epoll_event ev;
+    int                fd;
+    int                slot;
+
+    fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+    for (slot = 0; (slot < HCIMUX_MAX_CLIENTS) && (clients[slot].Fd >= 0); slot++);
+    if (slot == HCIMUX_MAX_CLIENTS) {
+        fprintf(stderr, "too many clients\n");
+        close(fd);
+        return;
+    }
+
+    memset(&clients[slot], 0, sizeof(TClient));
+    clients[slot].Fd = fd;
+
+    ev.events   = EPOLLIN;
+    ev.data.u32 = TAG_CLIENT | slot;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+
+    if (verbose) {
+        fprintf(stderr, "client %d connected\n", slot);
+    }
+}
+
+static void closeClient(int slot)
+{
+    uint8_t i;
+
+    if (verbose) {
+        printStats(slot);
+    }
+
+    // keep the queue in order; the requests are skipped by pump() and a
+    // late response is dropped
+    for (i = 0; i < queueCount; i++) {
+        TRequest& req = queue[(queueHead + i) % HCIMUX_QUEUE_SIZE];
+
+        if (req.Client == slot) {
+            req.Client = NO_CLIENT;
+        }
+    }
+
+    epoll_ctl(epfd, EPOLL_CTL_DEL, clients[slot].Fd, NULL);
+    close(clients[slot].Fd);
+    clients[slot].Fd = -1;
+}
+
+static void addFilter(TClient& c, UINT8 sapID, UINT8 msgID)
+{
+    UINT8 i;
+
+    for (i = 0; i < c.NumFilters; i++) {
+        if ((c.Filters[i].SapID == sapID) && (c.Filters[i].MsgID == msgID)) {
+            return;
+        }
+    }
+    if (c.NumFilters == HCIMUX_MAX_FILTERS) {
+        sendError(c, HCIMUX_ERR_FILTERS_FULL);
+        return;
+    }
+    c.Filters[c.NumFilters].SapID = sapID;
+    c.Filters[c.NumFilters].MsgID = msgID;
+    c.NumFilters++;
+}
+
+static void removeFilter(TClient& c, UINT8 sapID, UINT8 msgID)
+{
+    UINT8 i;
+
+    for (i = 0; i < c.NumFilters; i++) {
+        if ((c.Filters[i].SapID == sapID) && (c.Filters[i].MsgID == msgID)) {
+            c.Filters[i] = c.Filters[--c.NumFilters];
+            return;
+        }
+    }
+}
+
+static void onClient(int slot, uint32_t events)
+{
+    TClient&      c = clients[slot];
+    TRequest*     req;
+    struct iovec  iov[2];
+    struct msghdr mh;
+    UINT8         type;
+    ssize_t       n;
+
+    if (events & EPOLLIN) {
+        // receive directly into the next free queue slot
+        req = (queueCount < HCIMUX_QUEUE_SIZE)
+            ? &queue[(queueHead + queueCount) % HCIMUX_QUEUE_SIZE] : &scratch;
+
+        iov[0].iov_base = &type;
+        iov[0].iov_len  = 1;
+        iov[1].iov_base = &req->Msg.SapID;
+        iov[1].iov_len  = WIMODLR_HCI_MSG_HEADER_SIZE + WIMODLR_HCI_MSG_PAYLOAD_SIZE;
+
+        memset(&mh, 0, sizeof(mh));
+        mh.msg_iov    = iov;
+        mh.msg_iovlen = 2;
+
+        n = recvmsg(c.Fd, &mh, MSG_DONTWAIT);
+        if (n > 0) {
+            if ((mh.msg_flags & MSG_TRUNC)
+                    || ((type != HCIMUX_MSG_GET_STATS) && (n < 1 + WIMODLR_HCI_MSG_HEADER_SIZE))) {
+                sendError(c, HCIMUX_ERR_FORMAT);
+                return;
+            }
+            switch (type) {
+                case HCIMUX_MSG_REQ:
+                    if (req == &scratch) {
+                        sendError(c, HCIMUX_ERR_QUEUE_FULL);
+                        break;
+                    }
+                    req->Client     = slot;
+                    req->RxTime     = nowUs();
+                    req->Msg.Length = (UINT16) (n - 1 - WIMODLR_HCI_MSG_HEADER_SIZE);
+                    queueCount++;
+                    pump();
+                    break;
+
+                case HCIMUX_MSG_SUBSCRIBE:
+                    addFilter(c, req->Msg.SapID, req->Msg.MsgID);
+                    break;
+
+                case HCIMUX_MSG_UNSUBSCRIBE:
+                    removeFilter(c, req->Msg.SapID, req->Msg.MsgID);
+                    break;
+
+                case HCIMUX_MSG_GET_STATS:
+                    {
+                        THCIMuxStats stats;
+
+                        getStats(c, stats);
+                        sendPacket(c, HCIMUX_MSG_STATS, (const UINT8*) &stats, sizeof(stats));
+                    }
+                    break;
+
+                default:
+                    sendError(c, HCIMUX_ERR_FORMAT);
+                    break;
+            }
+            return;
+        }
+        if ((n < 0) && ((errno == EAGAIN) || (errno == EINTR))) {
+            return;
+        }
+    }
+    // n == 0, error or hang up
+    closeClient(slot);
+}
+
+//-----------------------------------------------------------------------------
+// setup
+//-----------------------------------------------------------------------------
+
+static int openSocket(const char* path)
+{
+    struct sockaddr_un addr;
+    int                fd;
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "%s: path too long\n", path);
+        return -1;
+    }
+    fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    unlink(path);
+
+    if ((bind(fd, (struct sockaddr*) &addr, sizeof(addr)) < 0) || (listen(fd, HCIMUX_MAX_CLIENTS) < 0)) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void addFd(int fd, uint32_t tag)
+{
+    struct epoll_event ev;
+
+    ev.events   = EPOLLIN;
+    ev.data.u32 = tag;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+//-----------------------------------------------------------------------------
+// main
+//-----------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    struct epoll_event events[HCIMUX_MAX_EVENTS];
+    const char*        socketPath = HCIMUX_DEFAULT_SOCKET;
+    unsigned long      baudrate   = WIMODLR_SERIAL_BAUDRATE;
+    sigset_t           sigs;
+    int                listenFd;
+    int                sigFd;
+    int                opt;
+    int                i;
+    bool               running    = true;
+
+    while ((opt = getopt(argc, argv, "b:s:wv")) != -1) {
+        switch (opt) {
+            case 'b':   baudrate   = strtoul(optarg, NULL, 0);  break;
+            case 's':   socketPath = optarg;                    break;
+            case 'w':   wakeup     = true;                      break;
+            case 'v':   verbose    = true;                      break;
+            default:    optind     = argc + 1;                  break;
+        }
+    }
+    if (optind != argc - 1) {
+        fprintf(stderr, "usage: %s [-b <baudrate>] [-s <socket>] [-w] [-v] <serial device>\n", argv[0]);
+        return 1;
+    }
+
+    if (!serial.open(argv[optind], baudrate)) {
+        perror(argv[optind]);
+        return 1;
+    }
+    hci.begin();
+
+    listenFd = openSocket(socketPath);
+    if (listenFd < 0) {
+        return 1;
+    }
+
+    sigemptyset(&sigs);
+    sigaddset(&sigs, SIGINT);
+    sigaddset(&sigs, SIGTERM);
+    sigaddset(&sigs, SIGUSR1);
+    sigprocmask(SIG_BLOCK, &sigs, NULL);
+    sigFd = signalfd(-1, &sigs, SFD_CLOEXEC);
+    signal(SIGPIPE, SIG_IGN);
+
+    for (i = 0; i < HCIMUX_MAX_CLIENTS; i++) {
+        clients[i].Fd = -1;
+    }
+
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    addFd(serial.getFd(), TAG_SERIAL);
+    addFd(listenFd, TAG_LISTEN);
+    addFd(sigFd, TAG_SIGNAL);
+
+    if (verbose) {
+        fprintf(stderr, "%s: listening on %s\n", argv[optind], socketPath);
+    }
+
+    while (running) {
+        int timeout = -1;
+        int n;
+
+        if (pending) {
+            uint64_t now = nowUs();
+
+            timeout = (deadline > now) ? (int) ((deadline - now + 999) / 1000) : 0;
+        }
+
+        n = epoll_wait(epfd, events, HCIMUX_MAX_EVENTS, timeout);
+        if ((n < 0) && (errno != EINTR)) {
+            perror("epoll_wait");
+            break;
+        }
+
+        for (i = 0; i < n; i++) {
+            uint32_t tag = events[i].data.u32;
+
+            switch (tag & TAG_MASK) {
+                case TAG_SERIAL:
+                    running = onSerial() && running;
+                    break;
+
+                case TAG_LISTEN:
+                    onAccept(listenFd);
+                    break;
+
+                case TAG_SIGNAL:
+                    {
+                        struct signalfd_siginfo si;
+
+                        if (read(sigFd, &si, sizeof(si)) == sizeof(si)) {
+                            if (si.ssi_signo == SIGUSR1) {
+                                for (int slot = 0; slot < HCIMUX_MAX_CLIENTS; slot++) {
+                                    if (clients[slot].Fd >= 0) {
+                                        printStats(slot);
+                                    }
+                                }
+                            } else {
+                                running = false;
+                            }
+                        }
+                    }
+                    break;
+
+                case TAG_CLIENT:
+                    if (clients[tag & ~TAG_MASK].Fd >= 0) {
+                        onClient(tag & ~TAG_MASK, events[i].events);
+                    }
+                    break;
+            }
+        }
+        checkTimeout();
+    }
+
+    for (i = 0; i < HCIMUX_MAX_CLIENTS; i++) {
+        if (clients[i].Fd >= 0) {
+            closeClient(i);
+        }
+    }
+    close(listenFd);
+    unlink(socketPath);
+    hci.end();
+    serial.close();
+    return 0;
+}
@@ -0,0 +1,56 @@
+/*
+ * Arduino.h (POSIX)
+ *
+ * Minimal replacement of the Arduino core for building the HCI layer of
+ * the library (HCI/WiMODLRHCI.cpp, utils/ComSLIP.cpp, utils/CRC16.cpp) on
+ * Linux. Only what these files use is provided; the serial port itself is
+ * implemented by PosixStream.
+ */
+
+#ifndef HCIMUXD_POSIX_ARDUINO_H_
+#define HCIMUXD_POSIX_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+//-----------------------------------------------------------------------------
+// Print / Stream
+//-----------------------------------------------------------------------------
+
+class Print
+{
+    public:
+    virtual         ~Print() {}
+
+    virtual size_t  write(uint8_t c) = 0;
+
+    virtual size_t  write(const uint8_t* buffer, size_t size)
+    {
+        size_t n = 0;
+
+        while (size--) {
+            n += write(*buffer++);
+        }
+        return n;
+    }
+};
+
+class Stream : public Print
+{
+    public:
+    virtual int     available(void) = 0;
+    virtual int     read(void) = 0;
+    virtual int     peek(void) = 0;
+    virtual void    flush(void) {}
+};
+
+//-----------------------------------------------------------------------------
+// time
+//-----------------------------------------------------------------------------
+
+unsigned long   millis(void);
+unsigned long   micros(void);
+void            delay(unsigned long ms);
+
+#endif /* HCIMUXD_POSIX_ARDUINO_H_ */
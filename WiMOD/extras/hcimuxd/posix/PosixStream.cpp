@@ -0,0 +1,203 @@
+/*
+ * PosixStream.cpp
+ *
+ * Arduino Stream on top of a POSIX file descriptor, see PosixStream.h.
+ */
+
+#include "PosixStream.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+//-----------------------------------------------------------------------------
+// time (Arduino.h)
+//-----------------------------------------------------------------------------
+
+static uint64_t monotonicUs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + (uint64_t) ts.tv_nsec / 1000;
+}
+
+unsigned long millis(void)
+{
+    return (unsigned long) (monotonicUs() / 1000);
+}
+
+unsigned long micros(void)
+{
+    return (unsigned long) monotonicUs();
+}
+
+void delay(unsigned long ms)
+{
+    struct timespec ts;
+
+    ts.tv_sec  = ms / 1000;
+    ts.tv_nsec = (long) (ms % 1000) * 1000000;
+    while ((nanosleep(&ts, &ts) < 0) && (errno == EINTR));
+}
+
+//-----------------------------------------------------------------------------
+// helpers
+//-----------------------------------------------------------------------------
+
+static speed_t toSpeed(unsigned long baudrate)
+{
+    switch (baudrate) {
+        case 9600:      return B9600;
+        case 19200:     return B19200;
+        case 38400:     return B38400;
+        case 57600:     return B57600;
+        case 230400:    return B230400;
+        case 460800:    return B460800;
+        case 921600:    return B921600;
+        default:        return B115200;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// PosixStream
+//-----------------------------------------------------------------------------
+
+PosixStream::PosixStream() :
+    fd(-1),
+    rxHead(0),
+    rxTail(0),
+    txLen(0)
+{
+}
+
+PosixStream::~PosixStream()
+{
+    close();
+}
+
+bool PosixStream::open(const char* device, unsigned long baudrate)
+{
+    struct termios tio;
+    int            h;
+
+    h = ::open(device, O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (h < 0) {
+        return false;
+    }
+
+    // raw 8N1; a pty accepts (and ignores) the baudrate
+    if (tcgetattr(h, &tio) == 0) {
+        cfmakeraw(&tio);
+        tio.c_cflag |= CLOCAL | CREAD;
+        tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+        tio.c_cc[VMIN]  = 1;
+        tio.c_cc[VTIME] = 0;
+        cfsetispeed(&tio, toSpeed(baudrate));
+        cfsetospeed(&tio, toSpeed(baudrate));
+        tcsetattr(h, TCSANOW, &tio);
+        tcflush(h, TCIOFLUSH);
+    }
+    attach(h);
+    return true;
+}
+
+void PosixStream::attach(int h)
+{
+    close();
+    fd     = h;
+    rxHead = 0;
+    rxTail = 0;
+    txLen  = 0;
+}
+
+void PosixStream::close(void)
+{
+    if (fd >= 0) {
+        flush();
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+int PosixStream::fill(void)
+{
+    ssize_t n;
+
+    if (fd < 0) {
+        return -1;
+    }
+
+    // move the unread rest to the front
+    if (rxHead > 0) {
+        memmove(rxBuf, rxBuf + rxHead, rxTail - rxHead);
+        rxTail -= rxHead;
+        rxHead  = 0;
+    }
+    if (rxTail == sizeof(rxBuf)) {
+        return 0;
+    }
+
+    do {
+        n = ::read(fd, rxBuf + rxTail, sizeof(rxBuf) - rxTail);
+    } while ((n < 0) && (errno == EINTR));
+
+    if (n < 0) {
+        return ((errno == EAGAIN) || (errno == EWOULDBLOCK)) ? 0 : -1;
+    }
+    if (n == 0) {
+        return -1;                              // hang up
+    }
+    rxTail += (uint16_t) n;
+    return (int) n;
+}
+
+int PosixStream::available(void)
+{
+    return rxTail - rxHead;
+}
+
+int PosixStream::read(void)
+{
+    if (rxHead == rxTail) {
+        return -1;
+    }
+    return rxBuf[rxHead++];
+}
+
+int PosixStream::peek(void)
+{
+    if (rxHead == rxTail) {
+        return -1;
+    }
+    return rxBuf[rxHead];
+}
+
+size_t PosixStream::write(uint8_t c)
+{
+    if (txLen == sizeof(txBuf)) {
+        flush();
+    }
+    txBuf[txLen++] = c;
+    return 1;
+}
+
+void PosixStream::flush(void)
+{
+    uint16_t offset = 0;
+    ssize_t  n;
+
+    while ((fd >= 0) && (offset < txLen)) {
+        n = ::write(fd, txBuf + offset, txLen - offset);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;                              // port gone; frame is lost
+        }
+        offset += (uint16_t) n;
+    }
+    txLen = 0;
+}
@@ -0,0 +1,71 @@
+/*
+ * PosixStream.h
+ *
+ * Arduino Stream on top of a POSIX file descriptor (serial port or pty),
+ * so that TWiMODLRHCI / TComSlip can be used on Linux.
+ *
+ * - reads are buffered: fill() reads what the descriptor has (call it when
+ *   poll / epoll reports the descriptor readable), available() / read()
+ *   work on the buffer only and never block
+ * - writes are buffered as well; TComSlip writes byte by byte, flush()
+ *   hands the whole SLIP frame to the kernel with one write()
+ */
+
+#ifndef HCIMUXD_POSIX_STREAM_H_
+#define HCIMUXD_POSIX_STREAM_H_
+
+#include "Arduino.h"
+
+//-----------------------------------------------------------------------------
+// defines
+//-----------------------------------------------------------------------------
+
+#define POSIX_STREAM_RX_SIZE    1024
+#define POSIX_STREAM_TX_SIZE    1024
+
+//-----------------------------------------------------------------------------
+// PosixStream
+//-----------------------------------------------------------------------------
+
+class PosixStream : public Stream
+{
+    public:
+                    PosixStream();
+    virtual         ~PosixStream();
+
+    // open a serial device (raw, 8N1, no flow control)
+    bool            open(const char* device, unsigned long baudrate);
+
+    // use an already opened descriptor (e.g. a pty master)
+    void            attach(int fd);
+
+    void            close(void);
+
+    int             getFd(void) const { return fd; }
+
+    // read pending bytes into the rx buffer; returns the number of bytes,
+    // 0 if nothing was pending and -1 if the descriptor is closed / broken
+    int             fill(void);
+
+    // Stream
+    virtual int     available(void);
+    virtual int     read(void);
+    virtual int     peek(void);
+    virtual void    flush(void);
+
+    // Print
+    virtual size_t  write(uint8_t c);
+    using Print::write;
+
+    private:
+    int             fd;
+
+    uint8_t         rxBuf[POSIX_STREAM_RX_SIZE];
+    uint16_t        rxHead;
+    uint16_t        rxTail;
+
+    uint8_t         txBuf[POSIX_STREAM_TX_SIZE];
+    uint16_t        txLen;
+};
+
+#endif /* HCIMUXD_POSIX_STREAM_H_ */
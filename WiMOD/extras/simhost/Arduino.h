@@ -0,0 +1,67 @@
+/*
+ * Arduino.h (host)
+ *
+ * Minimal replacement of the Arduino core for running the simulation
+ * sketches (LrBaseLinkBenchSim, LrBaseTdmaSim) on Linux. Only what these
+ * sketches use is provided: Serial output, String, F() and the time
+ * functions.
+ */
+
+#ifndef SIMHOST_ARDUINO_H_
+#define SIMHOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define DEC             10
+#define HEX             16
+
+#define PROGMEM
+#define pgm_read_byte(p)    (*(const uint8_t*) (p))
+
+class __FlashStringHelper;
+#define F(s)            ((const __FlashStringHelper*) (s))
+
+//-----------------------------------------------------------------------------
+// String
+//-----------------------------------------------------------------------------
+
+class String
+{
+    public:
+    String(const char* s)                   : str(s) {}
+    String(const __FlashStringHelper* s)    : str((const char*) s) {}
+
+    const char*     c_str(void) const { return str; }
+
+    private:
+    const char*     str;
+};
+
+//-----------------------------------------------------------------------------
+// Serial (stdout)
+//-----------------------------------------------------------------------------
+
+class HostSerial
+{
+    public:
+    void            begin(unsigned long) {}
+    size_t          print(const String& s)                  { return (size_t) printf("%s", s.c_str()); }
+    size_t          print(const __FlashStringHelper* s)     { return (size_t) printf("%s", (const char*) s); }
+    size_t          print(int a, int base = DEC)            { return (size_t) printf(base == HEX ? "%X" : "%d", a); }
+    size_t          print(long a, int base = DEC)           { return (size_t) printf(base == HEX ? "%lX" : "%ld", a); }
+    size_t          print(unsigned long a, int base = DEC)  { return (size_t) printf(base == HEX ? "%lX" : "%lu", a); }
+};
+
+extern HostSerial Serial;
+
+//-----------------------------------------------------------------------------
+// time
+//-----------------------------------------------------------------------------
+
+unsigned long   millis(void);
+void            delay(unsigned long ms);
+
+#endif /* SIMHOST_ARDUINO_H_ */
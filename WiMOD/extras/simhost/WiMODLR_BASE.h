@@ -0,0 +1,16 @@
+/*
+ * WiMODLR_BASE.h (host)
+ *
+ * Takes the place of the driver header for the simulation sketches; they
+ * only use the helper classes, which do not need a module.
+ */
+
+#ifndef SIMHOST_WIMODLR_BASE_H_
+#define SIMHOST_WIMODLR_BASE_H_
+
+#include "Arduino.h"
+
+#include "LR-BASE/WiMOD_LRBASE_LinkBench.h"
+#include "LR-BASE/WiMOD_LRBASE_Tdma.h"
+
+#endif /* SIMHOST_WIMODLR_BASE_H_ */
@@ -0,0 +1,33 @@
+/*
+ * main.cpp (host)
+ *
+ * Runs setup() of a simulation sketch once; the sketches do all their
+ * work in setup().
+ */
+
+#include "Arduino.h"
+
+#include <time.h>
+
+HostSerial Serial;
+
+unsigned long millis(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long) (ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+void delay(unsigned long ms)
+{
+    (void) ms;
+}
+
+void setup(void);
+
+int main(void)
+{
+    setup();
+    return 0;
+}
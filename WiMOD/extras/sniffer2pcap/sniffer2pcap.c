@@ -0,0 +1,206 @@
+/*
+ * sniffer2pcap.c
+ *
+ * Converts a log of the LR-BASE raw frame sniffer (WiMODLRBASE::EnableSniffer)
+ * into a pcap file with the LoRaTap link type, e.g. for Wireshark.
+ *
+ * Build (Linux):
+ *   cc -O2 -Wall -o sniffer2pcap sniffer2pcap.c
+ *
+ * Usage:
+ *   sniffer2pcap [-t <unix time of the first frame>] <log file> <pcap file>
+ *
+ * The sniffer stamps the frames with the host time in ms since power up;
+ * -t moves the first frame to the given unix time, otherwise the
+ * timestamps start at 0. Log layout: see WiMOD_LRBASE_Sniffer.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+//-----------------------------------------------------------------------------
+// defines
+//-----------------------------------------------------------------------------
+
+#define LOG_HEADER_SIZE         16
+#define LOG_RECORD_HEADER_SIZE  13
+#define LOG_FORMAT_EXTENDED     0x01                /* RADIOLINK_FORMAT_EXTENDED_OUTPUT */
+
+#define PCAP_MAGIC              0xA1B2C3D4
+#define PCAP_LINKTYPE_LORATAP   270
+#define PCAP_SNAPLEN            65535
+
+#define LORATAP_HEADER_SIZE     15
+#define LORATAP_RSSI_OFFSET     139                 /* dBm = value - 139 */
+#define LORATAP_SYNC_WORD       0x12                /* private network */
+
+//-----------------------------------------------------------------------------
+// helpers
+//-----------------------------------------------------------------------------
+
+static uint32_t getLE32(const uint8_t* p)
+{
+    return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static void putLE16(uint8_t* p, uint16_t v)
+{
+    p[0] = (uint8_t) v;
+    p[1] = (uint8_t) (v >> 8);
+}
+
+static void putLE32(uint8_t* p, uint32_t v)
+{
+    p[0] = (uint8_t) v;
+    p[1] = (uint8_t) (v >> 8);
+    p[2] = (uint8_t) (v >> 16);
+    p[3] = (uint8_t) (v >> 24);
+}
+
+static void putBE16(uint8_t* p, uint16_t v)
+{
+    p[0] = (uint8_t) (v >> 8);
+    p[1] = (uint8_t) v;
+}
+
+static void putBE32(uint8_t* p, uint32_t v)
+{
+    p[0] = (uint8_t) (v >> 24);
+    p[1] = (uint8_t) (v >> 16);
+    p[2] = (uint8_t) (v >> 8);
+    p[3] = (uint8_t) v;
+}
+
+static uint8_t clampU8(int v)
+{
+    return (uint8_t) ((v < 0) ? 0 : ((v > 255) ? 255 : v));
+}
+
+//-----------------------------------------------------------------------------
+// LoRaTap v0 header
+//-----------------------------------------------------------------------------
+
+static void encodeLoRaTap(uint8_t* p, const uint8_t* logHdr, const uint8_t* rec)
+{
+    uint8_t bandwidth = 0;
+    uint8_t sf        = 0;
+
+    // LoRa only; TRadioCfg_LoRaBandwidth / TRadioCfg_LoRaSpreadingFactor
+    if (logHdr[12] == 0) {
+        bandwidth = (uint8_t) (1 << logHdr[13]);    // in steps of 125 kHz
+        sf        = (logHdr[14] < 7) ? 7 : logHdr[14];
+    }
+
+    memset(p, 0x00, LORATAP_HEADER_SIZE);
+    p[0] = 0;                                       // version
+    putBE16(&p[2], LORATAP_HEADER_SIZE);
+    putBE32(&p[4], getLE32(&logHdr[8]));
+    p[8] = bandwidth;
+    p[9] = sf;
+
+    if (rec[1] & LOG_FORMAT_EXTENDED) {
+        int16_t rssi = (int16_t) (rec[10] | (rec[11] << 8));
+        int     snr  = (int8_t) rec[12] * 4;
+
+        p[10] = clampU8(rssi + LORATAP_RSSI_OFFSET); // packet RSSI
+        p[11] = p[10];                              // max RSSI
+        p[12] = p[10];                              // current RSSI
+        p[13] = (uint8_t) (int8_t) ((snr < -128) ? -128 : ((snr > 127) ? 127 : snr));
+    }
+    p[14] = LORATAP_SYNC_WORD;
+}
+
+//-----------------------------------------------------------------------------
+// main
+//-----------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    uint8_t  logHdr[LOG_HEADER_SIZE];
+    uint8_t  rec[LOG_RECORD_HEADER_SIZE + 255];
+    uint8_t  pcapHdr[24];
+    uint8_t  pktHdr[16];
+    uint8_t  tap[LORATAP_HEADER_SIZE];
+    uint32_t epoch = 0;
+    uint32_t t0    = 0;
+    unsigned long frames = 0;
+    int      arg   = 1;
+    FILE*    in;
+    FILE*    out;
+
+    if ((argc > 2) && (strcmp(argv[1], "-t") == 0)) {
+        epoch = (uint32_t) strtoul(argv[2], NULL, 0);
+        arg   = 3;
+    }
+    if ((argc - arg) != 2) {
+        fprintf(stderr, "usage: %s [-t <unix time of the first frame>] <log file> <pcap file>\n", argv[0]);
+        return 1;
+    }
+
+    in = fopen(argv[arg], "rb");
+    if (in == NULL) {
+        perror(argv[arg]);
+        return 1;
+    }
+    if ((fread(logHdr, 1, LOG_HEADER_SIZE, in) != LOG_HEADER_SIZE)
+            || (memcmp(logHdr, "WMSN", 4) != 0) || (logHdr[5] < LOG_HEADER_SIZE)) {
+        fprintf(stderr, "%s: not a sniffer log\n", argv[arg]);
+        fclose(in);
+        return 1;
+    }
+    // skip header extensions of later versions
+    fseek(in, logHdr[5], SEEK_SET);
+
+    out = fopen(argv[arg + 1], "wb");
+    if (out == NULL) {
+        perror(argv[arg + 1]);
+        fclose(in);
+        return 1;
+    }
+
+    putLE32(&pcapHdr[0], PCAP_MAGIC);
+    putLE16(&pcapHdr[4], 2);
+    putLE16(&pcapHdr[6], 4);
+    putLE32(&pcapHdr[8], 0);
+    putLE32(&pcapHdr[12], 0);
+    putLE32(&pcapHdr[16], PCAP_SNAPLEN);
+    putLE32(&pcapHdr[20], PCAP_LINKTYPE_LORATAP);
+    fwrite(pcapHdr, 1, sizeof(pcapHdr), out);
+
+    while (fread(rec, 1, LOG_RECORD_HEADER_SIZE, in) == LOG_RECORD_HEADER_SIZE) {
+        uint32_t len = rec[0];
+        uint32_t ms;
+
+        if (fread(&rec[LOG_RECORD_HEADER_SIZE], 1, len, in) != len) {
+            fprintf(stderr, "truncated record after %lu frames\n", frames);
+            break;
+        }
+
+        ms = getLE32(&rec[2]);
+        if (frames == 0) {
+            t0 = ms;
+        }
+        ms -= t0;
+
+        putLE32(&pktHdr[0], epoch + ms / 1000);
+        putLE32(&pktHdr[4], (ms % 1000) * 1000);
+        putLE32(&pktHdr[8], LORATAP_HEADER_SIZE + len);
+        putLE32(&pktHdr[12], LORATAP_HEADER_SIZE + len);
+        encodeLoRaTap(tap, logHdr, rec);
+
+        fwrite(pktHdr, 1, sizeof(pktHdr), out);
+        fwrite(tap, 1, sizeof(tap), out);
+        fwrite(&rec[LOG_RECORD_HEADER_SIZE], 1, len, out);
+        frames++;
+    }
+
+    fclose(in);
+    if (fclose(out) != 0) {
+        perror(argv[arg + 1]);
+        return 1;
+    }
+    printf("%lu frames converted\n", frames);
+    return 0;
+}
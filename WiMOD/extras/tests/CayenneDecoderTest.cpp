@@ -0,0 +1,229 @@
+/*
+ * CayenneDecoderTest.cpp
+ *
+ * Host check of the Cayenne LPP decoder (CayenneLPPDecoder): payloads of
+ * the encoder are decoded again, malformed payloads stop the decoder with
+ * the matching error.
+ *
+ * Build and run (Linux), in this directory:
+ *   make test
+ */
+
+#include "Cayenne/CayenneLPP_constants.h"
+#include "Cayenne/CayenneLPP.h"
+#include "Cayenne/CayenneLPP_Decoder.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//-----------------------------------------------------------------------------
+// helpers
+//-----------------------------------------------------------------------------
+
+#define CHECK(cond)         check((cond), #cond, __LINE__)
+
+#define PAYLOAD_SIZE        51
+
+static int failures = 0;
+
+static void check(bool ok, const char* what, int line)
+{
+    if (!ok) {
+        printf("  FAILED (line %d): %s\n", line, what);
+        failures++;
+    }
+}
+
+// decode until the end; returns the number of records
+static uint8_t countRecords(const uint8_t* payload, uint8_t length, uint8_t* error)
+{
+    CayenneLPPDecoder decoder(payload, length);
+    CayenneLPPRecord  rec;
+    uint8_t           n = 0;
+
+    while (decoder.next(rec)) {
+        n++;
+    }
+    *error = decoder.getError();
+    return n;
+}
+
+//-----------------------------------------------------------------------------
+// tests
+//-----------------------------------------------------------------------------
+
+static void testValues(void)
+{
+    uint8_t           buf[PAYLOAD_SIZE];
+    CayenneLPP        lpp(buf, sizeof(buf));
+    CayenneLPPDecoder decoder(buf, 0);
+    CayenneLPPRecord  rec;
+
+    printf("values\n");
+    lpp.addTemperature(1, -12.5f);
+    lpp.addRelativeHumidity(2, 45.5f);
+    lpp.addDigitalInput(3, 200);
+    lpp.addBarometricPressure(4, 1013.2f);
+    lpp.addAccelerometer(5, -1.0f, 0.5f, 0.25f);
+    lpp.addGPS(6, 52.25f, -7.5f, 120.5f);
+
+    decoder = CayenneLPPDecoder(buf, lpp.getSize());
+
+    CHECK(decoder.next(rec));
+    CHECK(rec.getChannel() == 1);
+    CHECK(rec.getType() == LPP_TEMPERATURE);
+    CHECK(rec.getNumValues() == 1);
+    CHECK(rec.getFixed() == -125);
+    CHECK(rec.getDivisor() == 10);
+    CHECK(rec.getFloat() == -12.5f);
+
+    CHECK(decoder.next(rec));
+    CHECK(rec.getType() == LPP_RELATIVE_HUMIDITY);
+    CHECK(rec.getFixed() == 91);
+    CHECK(rec.getFloat() == 45.5f);
+
+    // unsigned types are not sign extended
+    CHECK(decoder.next(rec));
+    CHECK(rec.getType() == LPP_DIGITAL_INPUT);
+    CHECK(rec.getFixed() == 200);
+
+    CHECK(decoder.next(rec));
+    CHECK(rec.getType() == LPP_BAROMETRIC_PRESSURE);
+    CHECK(rec.getFixed() == 10132);
+
+    CHECK(decoder.next(rec));
+    CHECK(rec.getType() == LPP_ACCELEROMETER);
+    CHECK(rec.getNumValues() == 3);
+    CHECK(rec.getFixed(0) == -1000);
+    CHECK(rec.getFixed(1) == 500);
+    CHECK(rec.getFixed(2) == 250);
+    CHECK(rec.getFixed(3) == 0);
+
+    CHECK(decoder.next(rec));
+    CHECK(rec.getType() == LPP_GPS);
+    CHECK(rec.getFixed(0) == 522500);
+    CHECK(rec.getFixed(1) == -75000);
+    CHECK(rec.getFixed(2) == 12050);
+    CHECK(rec.getDivisor(1) == 10000);
+    CHECK(rec.getDivisor(2) == 100);
+
+    CHECK(!decoder.next(rec));
+    CHECK(decoder.getError() == LPP_DECODE_OK);
+    CHECK(decoder.getOffset() == lpp.getSize());
+}
+
+static void testTimeSeries(void)
+{
+    static const int32_t samples[] = { 215, 217, 216, 220, 190 };
+    const uint8_t        num       = sizeof(samples) / sizeof(samples[0]);
+    uint8_t              buf[PAYLOAD_SIZE];
+    CayenneLPP           lpp(buf, sizeof(buf));
+    CayenneLPPRecord     rec;
+    int32_t              values[num];
+    uint8_t              i;
+    uint8_t              pass;
+
+    printf("time series\n");
+    for (pass = 0; pass < 2; pass++) {
+        bool delta = (pass == 1);
+
+        lpp.reset();
+        CHECK(lpp.addTimeSeries(7, LPP_TEMPERATURE, 1000000, 60, samples, num, delta) != 0);
+
+        CayenneLPPDecoder decoder(buf, lpp.getSize());
+        CHECK(decoder.next(rec));
+        CHECK(rec.isTimeSeries());
+        CHECK(rec.getSeriesType() == LPP_TEMPERATURE);
+        CHECK(rec.getNumValues() == num);
+        CHECK(rec.getDivisor() == 10);
+        CHECK(rec.getSeriesTime(0) == 1000000);
+        CHECK(rec.getSeriesTime(4) == 1000000 + 4 * 60);
+
+        CHECK(rec.getSeries(values, num) == num);
+        for (i = 0; i < num; i++) {
+            CHECK(values[i] == samples[i]);
+            CHECK(rec.getFixed(i) == samples[i]);
+        }
+        CHECK(rec.getSeries(values, 2) == 2);
+        CHECK(!decoder.next(rec));
+        CHECK(decoder.getError() == LPP_DECODE_OK);
+    }
+}
+
+static void testMalformed(void)
+{
+    uint8_t buf[PAYLOAD_SIZE];
+    uint8_t size;
+    uint8_t error;
+    uint8_t i;
+
+    printf("malformed payloads\n");
+    {
+        CayenneLPP lpp(buf, sizeof(buf));
+
+        lpp.addTemperature(1, 20.0f);
+        lpp.addGPS(2, 1.0f, 2.0f, 3.0f);
+        size = lpp.getSize();
+    }
+
+    // every cut inside a record is detected, the records before it are kept
+    for (i = 1; i < size; i++) {
+        uint8_t records = countRecords(buf, i, &error);
+
+        if (i == LPP_TEMPERATURE_SIZE) {
+            CHECK(records == 1);
+            CHECK(error == LPP_DECODE_OK);
+        } else {
+            CHECK(records == ((i < LPP_TEMPERATURE_SIZE) ? 0 : 1));
+            CHECK(error == LPP_DECODE_TRUNCATED);
+        }
+    }
+    CHECK(countRecords(buf, size, &error) == 2);
+    CHECK(error == LPP_DECODE_OK);
+
+    // unknown type
+    buf[LPP_TEMPERATURE_SIZE + 1] = 0x55;
+    CHECK(countRecords(buf, size, &error) == 1);
+    CHECK(error == LPP_DECODE_UNKNOWN_TYPE);
+
+    // time series of a type with several values
+    {
+        uint8_t series[] = { 1, LPP_TIME_SERIES, LPP_GPS, 1, 0, 0, 0, 0, 0, 1 };
+
+        CHECK(countRecords(series, sizeof(series), &error) == 0);
+        CHECK(error == LPP_DECODE_INVALID);
+    }
+
+    // random payloads must not read beyond the buffer
+    srand(1);
+    for (i = 0; i < 200; i++) {
+        uint8_t n;
+
+        size = (uint8_t) (rand() % (PAYLOAD_SIZE + 1));
+        for (n = 0; n < size; n++) {
+            buf[n] = (uint8_t) rand();
+        }
+        CayenneLPPDecoder decoder(buf, size);
+        CayenneLPPRecord  rec;
+
+        while (decoder.next(rec)) {
+            CHECK(rec.getData() + rec.getDataSize() <= buf + size);
+        }
+        CHECK(decoder.getOffset() <= size);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// main
+//-----------------------------------------------------------------------------
+
+int main(void)
+{
+    testValues();
+    testTimeSeries();
+    testMalformed();
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
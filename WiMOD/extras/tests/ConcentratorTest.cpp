@@ -0,0 +1,164 @@
+/*
+ * ConcentratorTest.cpp
+ *
+ * Host check of the concentrator (WiMOD_LRBASE_Concentrator): sequence
+ * wrap, restart of a sender, full peer table and expiry of silent sources.
+ *
+ * Build and run (Linux), in this directory:
+ *   make test
+ */
+
+#include "LR-BASE/WiMOD_LRBASE_Concentrator.h"
+
+#include <stdio.h>
+#include <string.h>
+
+//-----------------------------------------------------------------------------
+// helpers
+//-----------------------------------------------------------------------------
+
+#define CHECK(cond)         check((cond), #cond, __LINE__)
+
+#define TABLE_SIZE          8
+#define GROUP_ADR           0x10
+
+static int failures = 0;
+
+static void check(bool ok, const char* what, int line)
+{
+    if (!ok) {
+        printf("  FAILED (line %d): %s\n", line, what);
+        failures++;
+    }
+}
+
+static TWiMODLR_ConcResult rx(WiMOD_LRBASE_Concentrator& conc, UINT16 deviceAddress, UINT8 seq, UINT32 now)
+{
+    TWiMODLR_RadioLink_Msg msg;
+    TWiMODLR_PeerInfo*     peer;
+
+    memset(&msg, 0x00, sizeof(msg));
+    msg.SourceGroupAddress  = GROUP_ADR;
+    msg.SourceDeviceAddress = deviceAddress;
+    msg.Payload[0]          = seq;
+    msg.Length              = 1;
+    return conc.OnFrame(msg, now, &peer);
+}
+
+//-----------------------------------------------------------------------------
+// tests
+//-----------------------------------------------------------------------------
+
+static void testWrap(void)
+{
+    WiMOD_LRBASE_Concentrator conc;
+    TWiMODLR_PeerInfo         table[TABLE_SIZE];
+    const TWiMODLR_PeerInfo*  peer;
+    UINT32                    i;
+
+    printf("sequence wrap\n");
+    CHECK(conc.Begin(table, TABLE_SIZE));
+
+    CHECK(rx(conc, 1, 250, 0) == LRBASE_CONC_NEW);
+    for (i = 251; i < 256 + 5; i++) {
+        CHECK(rx(conc, 1, (UINT8) i, i) == LRBASE_CONC_NEW);
+    }
+    // retransmissions and late frames across the wrap
+    CHECK(rx(conc, 1, 4, 300) == LRBASE_CONC_DUPLICATE);
+    CHECK(rx(conc, 1, 254, 300) == LRBASE_CONC_DUPLICATE);
+    CHECK(rx(conc, 1, 6, 300) == LRBASE_CONC_NEW);
+    CHECK(rx(conc, 1, 8, 300) == LRBASE_CONC_NEW);
+    CHECK(rx(conc, 1, 7, 300) == LRBASE_CONC_LATE);
+
+    peer = conc.Find(GROUP_ADR, 1);
+    CHECK(peer != NULL);
+    CHECK(peer->LastSequence == 8);
+    CHECK(peer->Lost == 2);
+    CHECK(peer->Resyncs == 0);
+}
+
+static void testRestart(void)
+{
+    WiMOD_LRBASE_Concentrator conc;
+    TWiMODLR_PeerInfo         table[TABLE_SIZE];
+    const TWiMODLR_PeerInfo*  peer;
+    UINT32                    t = 0;
+
+    printf("sender restart\n");
+    CHECK(conc.Begin(table, TABLE_SIZE));
+    conc.SetResyncAge(10000);
+
+    // large step back: restart at once
+    CHECK(rx(conc, 1, 100, t) == LRBASE_CONC_NEW);
+    CHECK(rx(conc, 1, 101, t += 1000) == LRBASE_CONC_NEW);
+    CHECK(rx(conc, 1, 0, t += 1000) == LRBASE_CONC_RESYNC);
+
+    // small step back within the resync age: taken as a retransmission
+    CHECK(rx(conc, 1, 1, t += 1000) == LRBASE_CONC_NEW);
+    CHECK(rx(conc, 1, 2, t += 1000) == LRBASE_CONC_NEW);
+    CHECK(rx(conc, 1, 0, t += 1000) == LRBASE_CONC_DUPLICATE);
+
+    // small step back and same sequence after a silence: restart
+    CHECK(rx(conc, 1, 0, t += 10001) == LRBASE_CONC_RESYNC);
+    CHECK(rx(conc, 1, 1, t += 1000) == LRBASE_CONC_NEW);
+    CHECK(rx(conc, 1, 1, t += 10001) == LRBASE_CONC_RESYNC);
+    CHECK(rx(conc, 1, 2, t += 1000) == LRBASE_CONC_NEW);
+
+    peer = conc.Find(GROUP_ADR, 1);
+    CHECK(peer != NULL);
+    CHECK(peer->Resyncs == 3);
+    CHECK(peer->Duplicates == 1);
+    CHECK(peer->Frames == 9);
+}
+
+static void testTableFull(void)
+{
+    WiMOD_LRBASE_Concentrator  conc;
+    TWiMODLR_PeerInfo          table[TABLE_SIZE];
+    TWiMODLR_ConcentratorStats stats;
+    UINT16                     adr;
+    UINT32                     capacity;
+
+    printf("table full / expire\n");
+    CHECK(conc.Begin(table, TABLE_SIZE));
+    conc.GetStats(&stats);
+    capacity = stats.Capacity;
+    CHECK(capacity == TABLE_SIZE * LRBASE_CONC_MAX_LOAD_PERCENT / 100);
+
+    for (adr = 1; adr <= capacity; adr++) {
+        CHECK(rx(conc, adr, 0, adr) == LRBASE_CONC_NEW);
+    }
+    // no duplicate check for further sources
+    CHECK(rx(conc, 100, 0, 100) == LRBASE_CONC_UNTRACKED);
+    CHECK(rx(conc, 100, 0, 100) == LRBASE_CONC_UNTRACKED);
+    CHECK(conc.Find(GROUP_ADR, 100) == NULL);
+
+    // the sources heard last stay; all of them are still found
+    CHECK(conc.Expire(1000, 1000 - 3) == 2);
+    conc.GetStats(&stats);
+    CHECK(stats.Peers == capacity - 2);
+    CHECK(stats.Expired == 2);
+    CHECK(conc.Find(GROUP_ADR, 1) == NULL);
+    CHECK(conc.Find(GROUP_ADR, 2) == NULL);
+    for (adr = 3; adr <= capacity; adr++) {
+        CHECK(conc.Find(GROUP_ADR, adr) != NULL);
+        CHECK(rx(conc, adr, 0, 1000) == LRBASE_CONC_DUPLICATE);
+    }
+
+    CHECK(rx(conc, 100, 0, 1000) == LRBASE_CONC_NEW);
+    CHECK(conc.Find(GROUP_ADR, 100) != NULL);
+}
+
+//-----------------------------------------------------------------------------
+// main
+//-----------------------------------------------------------------------------
+
+int main(void)
+{
+    testWrap();
+    testRestart();
+    testTableFull();
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
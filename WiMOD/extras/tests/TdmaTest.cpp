@@ -0,0 +1,262 @@
+/*
+ * TdmaTest.cpp
+ *
+ * Host check of the TDMA star network (WiMOD_LRBASE_Tdma): beacon timing
+ * of the collector, lost beacons, the guard time taken from the beacon and
+ * the detection of the control frames.
+ *
+ * Build and run (Linux), in this directory:
+ *   make test
+ */
+
+#include "LR-BASE/WiMOD_LRBASE_Tdma.h"
+
+#include <stdio.h>
+#include <string.h>
+
+//-----------------------------------------------------------------------------
+// helpers
+//-----------------------------------------------------------------------------
+
+#define CHECK(cond)         check((cond), #cond, __LINE__)
+
+#define COLLECTOR_ADR       0x0010
+#define NODE_ADR            0x0123
+#define BEACON_GROUP        0x20
+
+static int failures = 0;
+
+static void check(bool ok, const char* what, int line)
+{
+    if (!ok) {
+        printf("  FAILED (line %d): %s\n", line, what);
+        failures++;
+    }
+}
+
+static void initRadio(TWiMODLR_DevMgmt_RadioConfig& radioCfg)
+{
+    memset(&radioCfg, 0x00, sizeof(radioCfg));
+    radioCfg.Modulation          = Modulation_LoRa;
+    radioCfg.LoRaBandWidth       = LoRaBandwith_125kHz;
+    radioCfg.LoRaSpreadingFactor = LoRa9_SF9;
+    radioCfg.ErrorCoding         = ErrorCoding1_4_5;
+}
+
+static void startCollector(WiMOD_LRBASE_Tdma& collector, UINT16 guardMs)
+{
+    TWiMODLR_DevMgmt_RadioConfig radioCfg;
+    TWiMODLR_TdmaConfig          cfg;
+
+    initRadio(radioCfg);
+    cfg.NumSlots           = 4;
+    cfg.NumContentionSlots = 1;
+    cfg.MaxPayloadLen      = 20;
+    cfg.GuardMs            = guardMs;
+    cfg.SlotTimeout        = 5;
+
+    collector.SetConfig(cfg);
+    collector.SetRadioConfig(radioCfg);
+    collector.StartCollector(0x10, COLLECTOR_ADR, BEACON_GROUP);
+}
+
+static void startNode(WiMOD_LRBASE_Tdma& node)
+{
+    TWiMODLR_DevMgmt_RadioConfig radioCfg;
+
+    // the node keeps its default config (LRBASE_TDMA_DEFAULT_GUARD_MS)
+    initRadio(radioCfg);
+    node.SetRadioConfig(radioCfg);
+    node.StartNode(NODE_ADR, 0);
+}
+
+// RTC read and beacon as ServiceTdma() does it; returns the beacon length
+static UINT8 sendBeacon(WiMOD_LRBASE_Tdma& collector, UINT32 now, UINT8* beacon)
+{
+    UINT8 len;
+
+    CHECK(collector.IsBeaconTimeDue(now));
+    CHECK(!collector.IsBeaconDue(now));
+    collector.SetBeaconTime(0);
+    CHECK(collector.IsBeaconDue(now));
+
+    len = collector.EncodeBeacon(beacon, WIMOD_RADIOLINK_PAYLOAD_LEN);
+    collector.OnBeaconSent(now);
+    return len;
+}
+
+// node with slot 0; returns the time of the last beacon
+static UINT32 joinNode(WiMOD_LRBASE_Tdma& collector, WiMOD_LRBASE_Tdma& node, UINT32* periodMs)
+{
+    TWiMODLR_TdmaInfo info;
+    UINT8             beacon[WIMOD_RADIOLINK_PAYLOAD_LEN];
+    UINT8             req[LRBASE_TDMA_SLOT_REQ_SIZE];
+    UINT8             len;
+
+    len = sendBeacon(collector, 1, beacon);
+    CHECK(node.OnFrame(COLLECTOR_ADR, true, beacon, len, 1));
+
+    len = node.EncodeSlotRequest(req, sizeof(req));
+    CHECK(collector.OnFrame(NODE_ADR, true, req, len, 1));
+
+    collector.GetInfo(&info);
+    *periodMs = info.SuperframeMs;
+
+    len = sendBeacon(collector, 1 + *periodMs, beacon);
+    CHECK(node.OnFrame(COLLECTOR_ADR, true, beacon, len, 1 + *periodMs));
+
+    node.GetInfo(&info);
+    CHECK(info.Synchronised);
+    CHECK(info.OwnSlot == 0);
+    return 1 + *periodMs;
+}
+
+//-----------------------------------------------------------------------------
+// tests
+//-----------------------------------------------------------------------------
+
+static void testBeaconTime(void)
+{
+    WiMOD_LRBASE_Tdma collector;
+    TWiMODLR_TdmaInfo info;
+    UINT8             beacon[WIMOD_RADIOLINK_PAYLOAD_LEN];
+    UINT32            periodMs;
+
+    printf("beacon time\n");
+    startCollector(collector, LRBASE_TDMA_DEFAULT_GUARD_MS);
+    collector.GetInfo(&info);
+    periodMs = info.SuperframeMs;
+
+    CHECK(sendBeacon(collector, 0, beacon) == LRBASE_TDMA_BEACON_HEADER_SIZE + 2 * 4);
+    CHECK(beacon[0] == LRBASE_TDMA_TYPE_BEACON);
+    CHECK(beacon[1] == LRBASE_TDMA_MARKER);
+
+    // the RTC is read ahead of the beacon, by a request of its own
+    CHECK(!collector.IsBeaconTimeDue(periodMs - LRBASE_TDMA_HCI_MARGIN_MS - 1));
+    CHECK(collector.IsBeaconTimeDue(periodMs - LRBASE_TDMA_HCI_MARGIN_MS));
+    collector.SetBeaconTime(0);
+    CHECK(!collector.IsBeaconTimeDue(periodMs - LRBASE_TDMA_HCI_MARGIN_MS));
+    CHECK(!collector.IsBeaconDue(periodMs - 1));
+    CHECK(collector.IsBeaconDue(periodMs));
+
+    // RTC not readable: no beacon in this superframe
+    collector.SkipBeacon(periodMs);
+    CHECK(!collector.IsBeaconDue(periodMs));
+    CHECK(!collector.IsBeaconTimeDue(periodMs));
+    CHECK(collector.IsBeaconTimeDue(2 * periodMs - LRBASE_TDMA_HCI_MARGIN_MS));
+
+    collector.GetInfo(&info);
+    CHECK(info.Beacons == 1);
+    CHECK(info.MissedBeacons == 1);
+}
+
+static void testBeaconLoss(void)
+{
+    WiMOD_LRBASE_Tdma collector;
+    WiMOD_LRBASE_Tdma node;
+    TWiMODLR_TdmaInfo info;
+    UINT8             beacon[WIMOD_RADIOLINK_PAYLOAD_LEN];
+    UINT8             len;
+    UINT32            periodMs;
+    UINT32            t;
+    UINT32            slot;
+    UINT8             i;
+
+    printf("beacon loss\n");
+    startCollector(collector, LRBASE_TDMA_DEFAULT_GUARD_MS);
+    startNode(node);
+    t    = joinNode(collector, node, &periodMs);
+    slot = t + node.GetMsUntilSlot(t);
+
+    // lost beacons: the superframe is extrapolated
+    for (i = 1; i <= LRBASE_TDMA_MAX_MISSED_BEACONS; i++) {
+        node.Update(slot + i * periodMs);
+        CHECK(node.GetMsUntilSlot(slot + i * periodMs) == 0);
+        node.GetInfo(&info);
+        CHECK(info.Synchronised);
+        CHECK(info.MissedBeacons == i);
+    }
+
+    // too many: the node waits for the next beacon
+    t = slot + (LRBASE_TDMA_MAX_MISSED_BEACONS + 1) * periodMs;
+    node.Update(t);
+    node.GetInfo(&info);
+    CHECK(!info.Synchronised);
+    CHECK(node.GetMsUntilSlot(t) == LRBASE_TDMA_NOT_READY);
+
+    len = collector.EncodeBeacon(beacon, sizeof(beacon));
+    CHECK(node.OnFrame(COLLECTOR_ADR, true, beacon, len, t));
+    node.GetInfo(&info);
+    CHECK(info.Synchronised);
+    CHECK(info.OwnSlot == 0);
+}
+
+static void testGuardFromBeacon(void)
+{
+    WiMOD_LRBASE_Tdma collector;
+    WiMOD_LRBASE_Tdma node;
+    UINT32            periodMs;
+    UINT32            t;
+    UINT32            slot;
+
+    printf("guard time mismatch\n");
+    // collector guard larger than the default guard of the node
+    startCollector(collector, 3 * LRBASE_TDMA_DEFAULT_GUARD_MS);
+    startNode(node);
+    t    = joinNode(collector, node, &periodMs);
+    slot = t + node.GetMsUntilSlot(t);
+
+    CHECK(node.GetMsUntilSlot(slot) == 0);
+    CHECK(node.GetMsUntilSlot(slot + 2 * LRBASE_TDMA_DEFAULT_GUARD_MS) == 0);
+    CHECK(node.GetMsUntilSlot(slot + 3 * LRBASE_TDMA_DEFAULT_GUARD_MS) == periodMs - 3 * LRBASE_TDMA_DEFAULT_GUARD_MS);
+}
+
+static void testControlFrames(void)
+{
+    WiMOD_LRBASE_Tdma collector;
+    WiMOD_LRBASE_Tdma node;
+    TWiMODLR_TdmaInfo info;
+    UINT8             beacon[WIMOD_RADIOLINK_PAYLOAD_LEN];
+    UINT8             req[LRBASE_TDMA_SLOT_REQ_SIZE];
+    UINT8             data[] = { LRBASE_TDMA_TYPE_SLOT_REQ };
+    UINT8             len;
+
+    printf("control frames\n");
+    startCollector(collector, LRBASE_TDMA_DEFAULT_GUARD_MS);
+    startNode(node);
+
+    // application data is passed on, even with the frame type in front
+    len = sendBeacon(collector, 0, beacon);
+    CHECK(!node.OnFrame(COLLECTOR_ADR, false, beacon, len, 0));
+    CHECK(!node.OnFrame(COLLECTOR_ADR, true, beacon, len - 1, 0));
+    beacon[1] = 0x00;
+    CHECK(!node.OnFrame(COLLECTOR_ADR, true, beacon, len, 0));
+    node.GetInfo(&info);
+    CHECK(!info.Synchronised);
+
+    len = node.EncodeSlotRequest(req, sizeof(req));
+    CHECK(!collector.OnFrame(NODE_ADR, true, data, sizeof(data), 0));
+    CHECK(!collector.OnFrame(NODE_ADR, false, req, len, 0));
+    collector.GetInfo(&info);
+    CHECK(info.AssignedSlots == 0);
+    CHECK(info.SlotRequests == 0);
+
+    CHECK(collector.OnFrame(NODE_ADR, true, req, len, 0));
+    collector.GetInfo(&info);
+    CHECK(info.AssignedSlots == 1);
+}
+
+//-----------------------------------------------------------------------------
+// main
+//-----------------------------------------------------------------------------
+
+int main(void)
+{
+    testBeaconTime();
+    testBeaconLoss();
+    testGuardFromBeacon();
+    testControlFrames();
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
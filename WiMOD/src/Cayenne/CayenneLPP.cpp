@@ -31,6 +31,7 @@
 
 #include "CayenneLPP_constants.h"
 #include "CayenneLPP.h"
+#include "CayenneLPP_Decoder.h"
 
 #include <string.h>
 
@@ -129,7 +130,6 @@ uint8_t CayenneLPP::addAnalogOutput(uint8_t channel, float value)
     int16_t val = value * 100;
     buffer[cursor++] = channel;
     buffer[cursor++] = LPP_ANALOG_OUTPUT;
-    buffer[cursor++] = value;
     buffer[cursor++] = val >> 8;
     buffer[cursor++] = val;
 
@@ -287,6 +287,118 @@ uint8_t CayenneLPP::addCustomValue(uint8_t channel, uint8_t type, uint8_t valueS
     return cursor;
 }
 
+// Add count samples of one single-value type (e.g. LPP_TEMPERATURE) with
+// one header. The values are fixed-point in the unit of the type (e.g.
+// 0.1 degC); sample i was taken at baseTime + i * interval (in s).
+// With delta the samples after the first one are sent as 8 bit
+// differences, if all differences fit; otherwise at full width.
+uint8_t CayenneLPP::addTimeSeries(uint8_t channel, uint8_t type, uint32_t baseTime, uint16_t interval,
+                                  const int32_t* values, uint8_t count, bool delta)
+{
+    uint8_t valueSize = CayenneLPPDecoder::getSeriesValueSize(type);
+    uint8_t size;
+    uint8_t i;
+
+    if ((valueSize == 0) || (values == NULL) || (count == 0) || (count > LPP_TIME_SERIES_MAX_COUNT)) {
+        return 0;
+    }
+    if (delta && (deltaCount(values, count) < count)) {
+        delta = false;
+    }
+
+    if (delta) {
+        size = LPP_TIME_SERIES_HEADER_SIZE + valueSize + (count - 1);
+    } else if (count > (0xFF - LPP_TIME_SERIES_HEADER_SIZE) / valueSize) {
+        return 0;
+    } else {
+        size = LPP_TIME_SERIES_HEADER_SIZE + count * valueSize;
+    }
+    if ((cursor + size) > maxsize) {
+        return 0;
+    }
+
+    buffer[cursor++] = channel;
+    buffer[cursor++] = LPP_TIME_SERIES;
+    buffer[cursor++] = type;
+    buffer[cursor++] = count | (delta ? LPP_TIME_SERIES_DELTA : 0);
+    buffer[cursor++] = baseTime >> 24;
+    buffer[cursor++] = baseTime >> 16;
+    buffer[cursor++] = baseTime >> 8;
+    buffer[cursor++] = baseTime;
+    buffer[cursor++] = interval >> 8;
+    buffer[cursor++] = interval;
+
+    for (i = 0; i < count; i++) {
+        if (delta && (i > 0)) {
+            buffer[cursor++] = (int8_t) (values[i] - values[i - 1]);
+        } else {
+            if (valueSize == 2) {
+                buffer[cursor++] = values[i] >> 8;
+            }
+            buffer[cursor++] = values[i];
+        }
+    }
+
+    return cursor;
+}
+
+// Add as many of the samples as fit into the frame, limited by the buffer
+// and by maxPayload (e.g. the max. payload of the current data rate).
+// Returns the number of added samples; the rest can be sent in the next
+// frame with baseTime + n * interval.
+uint8_t CayenneLPP::fillTimeSeries(uint8_t channel, uint8_t type, uint32_t baseTime, uint16_t interval,
+                                   const int32_t* values, uint8_t count, bool delta, uint8_t maxPayload)
+{
+    uint8_t valueSize = CayenneLPPDecoder::getSeriesValueSize(type);
+    uint8_t limit     = (maxPayload < maxsize) ? maxPayload : maxsize;
+    uint8_t space;
+    uint8_t nRaw;
+    uint8_t nDelta = 0;
+
+    if ((valueSize == 0) || (values == NULL) || (cursor + LPP_TIME_SERIES_HEADER_SIZE + valueSize > limit)) {
+        return 0;
+    }
+    if (count > LPP_TIME_SERIES_MAX_COUNT) {
+        count = LPP_TIME_SERIES_MAX_COUNT;
+    }
+
+    space = limit - cursor - LPP_TIME_SERIES_HEADER_SIZE;
+    nRaw  = space / valueSize;
+    if (nRaw > count) {
+        nRaw = count;
+    }
+
+    if (delta) {
+        // first value at full width, then one byte per sample
+        nDelta = deltaCount(values, count);
+        if (nDelta > 1 + (space - valueSize)) {
+            nDelta = 1 + (space - valueSize);
+        }
+    }
+
+    if (nDelta >= nRaw) {
+        addTimeSeries(channel, type, baseTime, interval, values, nDelta, true);
+        return nDelta;
+    }
+    addTimeSeries(channel, type, baseTime, interval, values, nRaw, false);
+    return nRaw;
+}
+
+// Reserve size bytes at the end of the payload, e.g. for a LppSchema;
+// returns NULL if they do not fit
+uint8_t* CayenneLPP::reserve(uint8_t size)
+{
+    uint8_t* p;
+
+    if ((cursor + size) > maxsize) {
+        return NULL;
+    }
+    p = buffer + cursor;
+    cursor += size;
+
+    return p;
+}
+
 
 //------------------------------------------------------------------------------
 //
@@ -301,4 +413,20 @@ uint8_t CayenneLPP::addCustomValue(uint8_t channel, uint8_t type, uint8_t valueS
 //
 //------------------------------------------------------------------------------
 
+// Number of leading samples that can be delta encoded: the first one and
+// all following ones with a difference in the int8 range
+uint8_t CayenneLPP::deltaCount(const int32_t* values, uint8_t count)
+{
+    uint8_t i;
+
+    for (i = 1; i < count; i++) {
+        int32_t d = values[i] - values[i - 1];
+
+        if ((d < -128) || (d > 127)) {
+            break;
+        }
+    }
+    return (count > 0) ? i : 0;
+}
+
 
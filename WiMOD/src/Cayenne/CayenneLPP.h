@@ -64,7 +64,16 @@ class CayenneLPP {
         uint8_t addGPS(uint8_t channel, float latitude, float longitude, float meters);
 
         uint8_t addCustomValue(uint8_t channel, uint8_t type, uint8_t valueSize, uint8_t* value);
+
+        uint8_t addTimeSeries(uint8_t channel, uint8_t type, uint32_t baseTime, uint16_t interval,
+                              const int32_t* values, uint8_t count, bool delta = false);
+        uint8_t fillTimeSeries(uint8_t channel, uint8_t type, uint32_t baseTime, uint16_t interval,
+                               const int32_t* values, uint8_t count, bool delta = false, uint8_t maxPayload = 0xFF);
+
+        uint8_t* reserve(uint8_t size);
     private:
+        static uint8_t deltaCount(const int32_t* values, uint8_t count);
+
         uint8_t *buffer;
         uint8_t maxsize;
         uint8_t cursor;
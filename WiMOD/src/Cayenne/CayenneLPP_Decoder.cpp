@@ -0,0 +1,343 @@
+/*
+ * CayenneLPP_Decoder.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: RS485-XYMD-02 contributors
+ */
+
+
+//------------------------------------------------------------------------------
+//! @file CayenneLPP_Decoder.cpp
+//! @ingroup
+//! <!------------------------------------------------------------------------->
+//! @brief Decoder / iterator for Cayenne LPP payloads
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//!
+//! see https://mdswp-staging.mydevices.com/cayenne/docs/#lora
+//!
+//!
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "CayenneLPP_Decoder.h"
+
+//------------------------------------------------------------------------------
+//
+// Section public functions
+//
+//------------------------------------------------------------------------------
+
+CayenneLPPRecord::CayenneLPPRecord(void)
+    : channel(0), type(0), size(0), data(NULL)
+{
+}
+
+// Number of values in the record: 3 for the axes of accelerometer,
+// gyrometer and GPS, the number of samples of a time series, 1 for all
+// other known types
+uint8_t CayenneLPPRecord::getNumValues(void) const
+{
+    switch (type) {
+    case LPP_ACCELEROMETER:
+    case LPP_GYROMETER:
+    case LPP_GPS:
+        return 3;
+    case LPP_TIME_SERIES:
+        return (data != NULL) ? (data[1] & LPP_TIME_SERIES_MAX_COUNT) : 0;
+    default:
+        return (CayenneLPPDecoder::getDataSize(type) != 0) ? 1 : 0;
+    }
+}
+
+// Resolution of the fixed-point value: float value = fixed / divisor
+int32_t CayenneLPPRecord::getDivisor(uint8_t index) const
+{
+    if (type == LPP_TIME_SERIES) {
+        return valueDivisor(getSeriesType(), 0);
+    }
+    return valueDivisor(type, index);
+}
+
+// Value as transmitted, sign extended according to the data type;
+// 0 for unknown types or an invalid index
+int32_t CayenneLPPRecord::getFixed(uint8_t index) const
+{
+    int32_t value;
+    uint8_t valueSize;
+    uint8_t i;
+
+    if ((data == NULL) || (index >= getNumValues())) {
+        return 0;
+    }
+
+    switch (type) {
+    case LPP_ACCELEROMETER:
+    case LPP_GYROMETER:
+        return (int16_t) ((data[2 * index] << 8) | data[2 * index + 1]);
+
+    case LPP_GPS:
+        // 24 bit two's complement
+        return ((int32_t) (((uint32_t) data[3 * index] << 24) | ((uint32_t) data[3 * index + 1] << 16)
+                           | ((uint32_t) data[3 * index + 2] << 8))) >> 8;
+
+    case LPP_TIME_SERIES:
+        valueSize = CayenneLPPDecoder::getSeriesValueSize(data[0]);
+        if (!(data[1] & LPP_TIME_SERIES_DELTA)) {
+            return readValue(data[0], data + 8 + index * valueSize);
+        }
+        value = readValue(data[0], data + 8);
+        for (i = 0; i < index; i++) {
+            value += (int8_t) data[8 + valueSize + i];
+        }
+        return value;
+
+    default:
+        return readValue(type, data);
+    }
+}
+
+float CayenneLPPRecord::getFloat(uint8_t index) const
+{
+    return (float) getFixed(index) / (float) getDivisor(index);
+}
+
+// LPP type of the samples of a time series
+uint8_t CayenneLPPRecord::getSeriesType(void) const
+{
+    return isTimeSeries() ? data[0] : 0;
+}
+
+// time of the first sample of a time series in s
+uint32_t CayenneLPPRecord::getSeriesBaseTime(void) const
+{
+    if (!isTimeSeries()) {
+        return 0;
+    }
+    return ((uint32_t) data[2] << 24) | ((uint32_t) data[3] << 16) | ((uint32_t) data[4] << 8) | data[5];
+}
+
+// time between two samples of a time series in s
+uint16_t CayenneLPPRecord::getSeriesInterval(void) const
+{
+    if (!isTimeSeries()) {
+        return 0;
+    }
+    return (uint16_t) ((data[6] << 8) | data[7]);
+}
+
+uint32_t CayenneLPPRecord::getSeriesTime(uint8_t index) const
+{
+    return getSeriesBaseTime() + (uint32_t) index * getSeriesInterval();
+}
+
+// Copy up to max samples of a time series (in one pass, also for delta
+// encoded series); returns the number of copied samples
+uint8_t CayenneLPPRecord::getSeries(int32_t* values, uint8_t max) const
+{
+    uint8_t count = getNumValues();
+    uint8_t valueSize;
+    uint8_t i;
+
+    if (!isTimeSeries() || (values == NULL)) {
+        return 0;
+    }
+    if (count > max) {
+        count = max;
+    }
+
+    valueSize = CayenneLPPDecoder::getSeriesValueSize(data[0]);
+    for (i = 0; i < count; i++) {
+        if (!(data[1] & LPP_TIME_SERIES_DELTA)) {
+            values[i] = readValue(data[0], data + 8 + i * valueSize);
+        } else if (i == 0) {
+            values[i] = readValue(data[0], data + 8);
+        } else {
+            values[i] = values[i - 1] + (int8_t) data[8 + valueSize + i - 1];
+        }
+    }
+    return count;
+}
+
+
+//Initialize the decoder for the given payload
+CayenneLPPDecoder::CayenneLPPDecoder(const uint8_t* buf, uint8_t size)
+    : buffer(buf), length(size)
+{
+    if (buf == NULL) {
+        length = 0x00;
+    }
+    reset();
+}
+
+//Restart at the first record
+void CayenneLPPDecoder::reset(void)
+{
+    cursor = 0;
+    error  = LPP_DECODE_OK;
+}
+
+// Get the next record; returns false at the end of the payload or if the
+// payload is malformed (see getError() / getOffset())
+bool CayenneLPPDecoder::next(CayenneLPPRecord& record)
+{
+    uint16_t dataSize;
+
+    if ((error != LPP_DECODE_OK) || (cursor >= length)) {
+        return false;
+    }
+    if ((length - cursor) < 2) {
+        error = LPP_DECODE_TRUNCATED;
+        return false;
+    }
+
+    if (buffer[cursor + 1] == LPP_TIME_SERIES) {
+        dataSize = getSeriesDataSize();
+    } else {
+        dataSize = getDataSize(buffer[cursor + 1]);
+        if (dataSize == 0) {
+            error = LPP_DECODE_UNKNOWN_TYPE;
+        }
+    }
+    if (error != LPP_DECODE_OK) {
+        return false;
+    }
+    if ((length - cursor - 2) < dataSize) {
+        error = LPP_DECODE_TRUNCATED;
+        return false;
+    }
+
+    record.channel = buffer[cursor];
+    record.type    = buffer[cursor + 1];
+    record.size    = (uint8_t) dataSize;
+    record.data    = buffer + cursor + 2;
+
+    cursor += 2 + dataSize;
+    return true;
+}
+
+// Size of the data of a type (without channel and type byte);
+// 0 for unknown types
+uint8_t CayenneLPPDecoder::getDataSize(uint8_t type)
+{
+    switch (type) {
+    case LPP_DIGITAL_INPUT:         return LPP_DIGITAL_INPUT_SIZE - 2;
+    case LPP_DIGITAL_OUTPUT:        return LPP_DIGITAL_OUTPUT_SIZE - 2;
+    case LPP_ANALOG_INPUT:          return LPP_ANALOG_INPUT_SIZE - 2;
+    case LPP_ANALOG_OUTPUT:         return LPP_ANALOG_OUTPUT_SIZE - 2;
+    case LPP_LUMINOSITY:            return LPP_LUMINOSITY_SIZE - 2;
+    case LPP_PRESENCE:              return LPP_PRESENCE_SIZE - 2;
+    case LPP_TEMPERATURE:           return LPP_TEMPERATURE_SIZE - 2;
+    case LPP_RELATIVE_HUMIDITY:     return LPP_RELATIVE_HUMIDITY_SIZE - 2;
+    case LPP_ACCELEROMETER:         return LPP_ACCELEROMETER_SIZE - 2;
+    case LPP_BAROMETRIC_PRESSURE:   return LPP_BAROMETRIC_PRESSURE_SIZE - 2;
+    case LPP_GYROMETER:             return LPP_GYROMETER_SIZE - 2;
+    case LPP_GPS:                   return LPP_GPS_SIZE - 2;
+    default:                        return 0;
+    }
+}
+
+// Size of one sample of a time series of the given type; 0 if the type
+// can not be used in a time series (unknown or more than one value)
+uint8_t CayenneLPPDecoder::getSeriesValueSize(uint8_t type)
+{
+    switch (type) {
+    case LPP_ACCELEROMETER:
+    case LPP_GYROMETER:
+    case LPP_GPS:
+        return 0;
+    default:
+        return getDataSize(type);
+    }
+}
+
+
+//------------------------------------------------------------------------------
+//
+// Section protected functions
+//
+//------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------
+//
+// Section private functions
+//
+//------------------------------------------------------------------------------
+
+// Fixed-point value of a single-value type at p
+int32_t CayenneLPPRecord::readValue(uint8_t type, const uint8_t* p)
+{
+    switch (type) {
+    case LPP_DIGITAL_INPUT:
+    case LPP_DIGITAL_OUTPUT:
+    case LPP_PRESENCE:
+    case LPP_RELATIVE_HUMIDITY:
+        return p[0];
+
+    case LPP_LUMINOSITY:
+    case LPP_BAROMETRIC_PRESSURE:
+        return (uint16_t) ((p[0] << 8) | p[1]);
+
+    case LPP_ANALOG_INPUT:
+    case LPP_ANALOG_OUTPUT:
+    case LPP_TEMPERATURE:
+        return (int16_t) ((p[0] << 8) | p[1]);
+
+    default:
+        return 0;
+    }
+}
+
+int32_t CayenneLPPRecord::valueDivisor(uint8_t type, uint8_t index)
+{
+    switch (type) {
+    case LPP_ANALOG_INPUT:
+    case LPP_ANALOG_OUTPUT:
+    case LPP_GYROMETER:
+        return 100;
+    case LPP_TEMPERATURE:
+    case LPP_BAROMETRIC_PRESSURE:
+        return 10;
+    case LPP_RELATIVE_HUMIDITY:
+        return 2;
+    case LPP_ACCELEROMETER:
+        return 1000;
+    case LPP_GPS:
+        return (index < 2) ? 10000 : 100;
+    default:
+        return 1;
+    }
+}
+
+// Data size of the time series at the cursor; sets error if the header
+// is truncated or invalid
+uint16_t CayenneLPPDecoder::getSeriesDataSize(void)
+{
+    const uint8_t* p = buffer + cursor + 2;
+    uint8_t        valueSize;
+    uint8_t        count;
+
+    if ((length - cursor - 2) < (LPP_TIME_SERIES_HEADER_SIZE - 2)) {
+        error = LPP_DECODE_TRUNCATED;
+        return 0;
+    }
+
+    valueSize = getSeriesValueSize(p[0]);
+    count     = p[1] & LPP_TIME_SERIES_MAX_COUNT;
+    if ((valueSize == 0) || (count == 0)) {
+        error = LPP_DECODE_INVALID;
+        return 0;
+    }
+
+    if (p[1] & LPP_TIME_SERIES_DELTA) {
+        return (LPP_TIME_SERIES_HEADER_SIZE - 2) + valueSize + (count - 1);
+    }
+    return (LPP_TIME_SERIES_HEADER_SIZE - 2) + (uint16_t) count * valueSize;
+}
@@ -0,0 +1,145 @@
+/*
+ * CayenneLPP_Decoder.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: RS485-XYMD-02 contributors
+ */
+
+//------------------------------------------------------------------------------
+//! @file CayenneLPP_Decoder.h
+//! @ingroup
+//! <!------------------------------------------------------------------------->
+//! @brief Decoder / iterator for Cayenne LPP payloads
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//! The decoder walks over a received payload and yields one record per
+//! value (channel, type, data). Nothing is allocated or copied: a record
+//! points into the payload buffer and converts the value on access.
+//!
+//! see https://mdswp-staging.mydevices.com/cayenne/docs/#lora
+//!
+//!
+//------------------------------------------------------------------------------
+
+
+#ifndef ARDUINO_CAYENNE_CAYENNELPP_DECODER_H_
+#define ARDUINO_CAYENNE_CAYENNELPP_DECODER_H_
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "CayenneLPP_constants.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+//------------------------------------------------------------------------------
+//
+// Section defines
+//
+//------------------------------------------------------------------------------
+
+// result of CayenneLPPDecoder::getError()
+#define LPP_DECODE_OK                0       // no error (so far)
+#define LPP_DECODE_UNKNOWN_TYPE      1       // data type without known size
+#define LPP_DECODE_TRUNCATED         2       // record exceeds the payload
+#define LPP_DECODE_INVALID           3       // malformed time series header
+
+// max. number of values in one record (accelerometer, gyrometer, GPS);
+// a time series (LPP_TIME_SERIES) has up to LPP_TIME_SERIES_MAX_COUNT
+#define LPP_MAX_VALUES               3
+
+
+//------------------------------------------------------------------------------
+//
+// Section class
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief One decoded value of a LPP payload
+ *
+ * The record is only valid as long as the decoded buffer is. Values are
+ * available as fixed-point integers in the unit of the data type (e.g.
+ * 0.1 degC for LPP_TEMPERATURE; see getDivisor()) or as float.
+ *
+ * For a time series (LPP_TIME_SERIES) the values are the samples in the
+ * unit of getSeriesType(); sample i was taken at getSeriesTime(i).
+ */
+class CayenneLPPRecord {
+    public:
+        CayenneLPPRecord(void);
+
+        uint8_t getChannel(void) const { return channel; }
+        uint8_t getType(void) const { return type; }
+        uint8_t getDataSize(void) const { return size; }
+        const uint8_t* getData(void) const { return data; }
+
+        uint8_t getNumValues(void) const;
+        int32_t getDivisor(uint8_t index = 0) const;
+        int32_t getFixed(uint8_t index = 0) const;
+        float getFloat(uint8_t index = 0) const;
+
+        bool isTimeSeries(void) const { return (type == LPP_TIME_SERIES); }
+        uint8_t getSeriesType(void) const;
+        uint32_t getSeriesBaseTime(void) const;
+        uint16_t getSeriesInterval(void) const;
+        uint32_t getSeriesTime(uint8_t index) const;
+        uint8_t getSeries(int32_t* values, uint8_t max) const;
+
+    private:
+        friend class CayenneLPPDecoder;
+
+        static int32_t readValue(uint8_t type, const uint8_t* p);
+        static int32_t valueDivisor(uint8_t type, uint8_t index);
+
+        uint8_t        channel;
+        uint8_t        type;
+        uint8_t        size;
+        const uint8_t* data;
+};
+
+/**
+ * @brief Iterator over the records of a LPP payload
+ *
+ * @code
+ * CayenneLPPDecoder decoder(payload, length);
+ * CayenneLPPRecord  rec;
+ *
+ * while (decoder.next(rec)) {
+ *     if (rec.getType() == LPP_TEMPERATURE) {
+ *         int16_t deciCelsius = rec.getFixed();
+ *     }
+ * }
+ * if (decoder.getError() != LPP_DECODE_OK) {
+ *     // payload malformed at decoder.getOffset()
+ * }
+ * @endcode
+ */
+class CayenneLPPDecoder {
+    public:
+        CayenneLPPDecoder(const uint8_t* buf, uint8_t size);
+
+        void reset(void);
+        bool next(CayenneLPPRecord& record);
+
+        uint8_t getError(void) const { return error; }
+        uint8_t getOffset(void) const { return cursor; }
+
+        static uint8_t getDataSize(uint8_t type);
+        static uint8_t getSeriesValueSize(uint8_t type);
+
+    private:
+        uint16_t getSeriesDataSize(void);
+
+        const uint8_t* buffer;
+        uint8_t        length;
+        uint8_t        cursor;
+        uint8_t        error;
+};
+
+#endif /* ARDUINO_CAYENNE_CAYENNELPP_DECODER_H_ */
@@ -0,0 +1,251 @@
+/*
+ * CayenneLPP_Schema.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: RS485-XYMD-02 contributors
+ */
+
+//------------------------------------------------------------------------------
+//! @file CayenneLPP_Schema.h
+//! @ingroup
+//! <!------------------------------------------------------------------------->
+//! @brief Compile time layouts (schemas) for Cayenne LPP frames
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//! A schema lists the channel / type layout of a frame at compile time:
+//!
+//! @code
+//! typedef LppSchema<LppTemperature<1>, LppRelativeHumidity<2>,
+//!                   LppTemperature<3>, LppRelativeHumidity<4> > TClimate;
+//!
+//! uint8_t buf[TClimate::size()];
+//!
+//! // 21.5 degC, 40.5 %, -4.0 degC, 91.0 %
+//! TClimate::encode(buf, sizeof(buf), 215, 81, -40, 182);
+//! @endcode
+//!
+//! The values are given as integers in the resolution of the LPP type
+//! (e.g. 0.1 degC, 0.5 %); no float math is involved. There is one size
+//! check per frame, channel and type bytes are constants.
+//!
+//! Needs C++11 (variadic templates); the runtime API of CayenneLPP is not
+//! affected and can be used for ad-hoc frames.
+//!
+//! see https://mdswp-staging.mydevices.com/cayenne/docs/#lora
+//!
+//!
+//------------------------------------------------------------------------------
+
+
+#ifndef ARDUINO_CAYENNE_CAYENNELPP_SCHEMA_H_
+#define ARDUINO_CAYENNE_CAYENNELPP_SCHEMA_H_
+
+#if (__cplusplus >= 201103L)
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "CayenneLPP_constants.h"
+#include "CayenneLPP.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+//------------------------------------------------------------------------------
+//
+// Section field types
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+/*
+ * A field writes [channel] [type] [value(s), big endian] and hands the
+ * remaining values over to the rest of the schema (NEXT).
+ */
+template <uint8_t CHANNEL, uint8_t TYPE, uint8_t SIZE, typename T>
+struct LppField8
+{
+    static constexpr uint16_t size(void) { return SIZE; }
+    static constexpr uint8_t  numValues(void) { return 1; }
+
+    template <typename NEXT, typename... ARGS>
+    static inline void put(uint8_t* p, T v, ARGS... rest)
+    {
+        p[0] = CHANNEL;
+        p[1] = TYPE;
+        p[2] = (uint8_t) v;
+        NEXT::write(p + SIZE, rest...);
+    }
+};
+
+template <uint8_t CHANNEL, uint8_t TYPE, uint8_t SIZE, typename T>
+struct LppField16
+{
+    static constexpr uint16_t size(void) { return SIZE; }
+    static constexpr uint8_t  numValues(void) { return 1; }
+
+    template <typename NEXT, typename... ARGS>
+    static inline void put(uint8_t* p, T v, ARGS... rest)
+    {
+        p[0] = CHANNEL;
+        p[1] = TYPE;
+        p[2] = (uint8_t) (v >> 8);
+        p[3] = (uint8_t) v;
+        NEXT::write(p + SIZE, rest...);
+    }
+};
+
+template <uint8_t CHANNEL, uint8_t TYPE, uint8_t SIZE>
+struct LppField3x16
+{
+    static constexpr uint16_t size(void) { return SIZE; }
+    static constexpr uint8_t  numValues(void) { return 3; }
+
+    template <typename NEXT, typename... ARGS>
+    static inline void put(uint8_t* p, int16_t x, int16_t y, int16_t z, ARGS... rest)
+    {
+        p[0] = CHANNEL;
+        p[1] = TYPE;
+        p[2] = (uint8_t) (x >> 8);
+        p[3] = (uint8_t) x;
+        p[4] = (uint8_t) (y >> 8);
+        p[5] = (uint8_t) y;
+        p[6] = (uint8_t) (z >> 8);
+        p[7] = (uint8_t) z;
+        NEXT::write(p + SIZE, rest...);
+    }
+};
+
+template <uint8_t CHANNEL, uint8_t TYPE, uint8_t SIZE>
+struct LppField3x24
+{
+    static constexpr uint16_t size(void) { return SIZE; }
+    static constexpr uint8_t  numValues(void) { return 3; }
+
+    template <typename NEXT, typename... ARGS>
+    static inline void put(uint8_t* p, int32_t x, int32_t y, int32_t z, ARGS... rest)
+    {
+        p[0] = CHANNEL;
+        p[1] = TYPE;
+        p[2] = (uint8_t) (x >> 16);
+        p[3] = (uint8_t) (x >> 8);
+        p[4] = (uint8_t) x;
+        p[5] = (uint8_t) (y >> 16);
+        p[6] = (uint8_t) (y >> 8);
+        p[7] = (uint8_t) y;
+        p[8] = (uint8_t) (z >> 16);
+        p[9] = (uint8_t) (z >> 8);
+        p[10] = (uint8_t) z;
+        NEXT::write(p + SIZE, rest...);
+    }
+};
+//! @endcond
+
+// value: 0 / 1
+template <uint8_t CH> struct LppDigitalInput       : LppField8<CH, LPP_DIGITAL_INPUT, LPP_DIGITAL_INPUT_SIZE, uint8_t> {};
+// value: 0 / 1
+template <uint8_t CH> struct LppDigitalOutput      : LppField8<CH, LPP_DIGITAL_OUTPUT, LPP_DIGITAL_OUTPUT_SIZE, uint8_t> {};
+// value: 0.01 signed
+template <uint8_t CH> struct LppAnalogInput        : LppField16<CH, LPP_ANALOG_INPUT, LPP_ANALOG_INPUT_SIZE, int16_t> {};
+// value: 0.01 signed
+template <uint8_t CH> struct LppAnalogOutput       : LppField16<CH, LPP_ANALOG_OUTPUT, LPP_ANALOG_OUTPUT_SIZE, int16_t> {};
+// value: 1 lux
+template <uint8_t CH> struct LppLuminosity         : LppField16<CH, LPP_LUMINOSITY, LPP_LUMINOSITY_SIZE, uint16_t> {};
+// value: 1
+template <uint8_t CH> struct LppPresence           : LppField8<CH, LPP_PRESENCE, LPP_PRESENCE_SIZE, uint8_t> {};
+// value: 0.1 degC signed
+template <uint8_t CH> struct LppTemperature        : LppField16<CH, LPP_TEMPERATURE, LPP_TEMPERATURE_SIZE, int16_t> {};
+// value: 0.5 %
+template <uint8_t CH> struct LppRelativeHumidity   : LppField8<CH, LPP_RELATIVE_HUMIDITY, LPP_RELATIVE_HUMIDITY_SIZE, uint8_t> {};
+// values: x, y, z in 0.001 G
+template <uint8_t CH> struct LppAccelerometer      : LppField3x16<CH, LPP_ACCELEROMETER, LPP_ACCELEROMETER_SIZE> {};
+// value: 0.1 hPa
+template <uint8_t CH> struct LppBarometricPressure : LppField16<CH, LPP_BAROMETRIC_PRESSURE, LPP_BAROMETRIC_PRESSURE_SIZE, uint16_t> {};
+// values: x, y, z in 0.01 deg/s
+template <uint8_t CH> struct LppGyrometer          : LppField3x16<CH, LPP_GYROMETER, LPP_GYROMETER_SIZE> {};
+// values: latitude, longitude in 0.0001 deg, altitude in 0.01 m
+template <uint8_t CH> struct LppGPS                : LppField3x24<CH, LPP_GPS, LPP_GPS_SIZE> {};
+
+
+//------------------------------------------------------------------------------
+//
+// Section schema
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Compile time layout of a LPP frame
+ *
+ * encode() / append() take the values of all fields in the order of the
+ * schema; fields with three axes take three values.
+ */
+template <typename... FIELDS>
+struct LppSchema;
+
+//! @cond Doxygen_Suppress
+template <>
+struct LppSchema<>
+{
+    static constexpr uint16_t size(void) { return 0; }
+    static constexpr uint8_t  numValues(void) { return 0; }
+
+    static inline void write(uint8_t*) {}
+};
+//! @endcond
+
+template <typename FIRST, typename... REST>
+struct LppSchema<FIRST, REST...>
+{
+    // total frame size in bytes
+    static constexpr uint16_t size(void) { return FIRST::size() + LppSchema<REST...>::size(); }
+
+    // number of values expected by encode() / append()
+    static constexpr uint8_t  numValues(void) { return FIRST::numValues() + LppSchema<REST...>::numValues(); }
+
+    // encode the frame into buf; returns size() or 0 if buf is too small
+    template <typename... ARGS>
+    static uint8_t encode(uint8_t* buf, uint8_t bufSize, ARGS... values)
+    {
+        static_assert(sizeof...(ARGS) == numValues(), "LppSchema: number of values does not match the fields");
+        static_assert(size() <= 0xFF, "LppSchema: frame too large");
+
+        if ((buf == NULL) || (bufSize < size())) {
+            return 0;
+        }
+        write(buf, values...);
+        return size();
+    }
+
+    // append the fields to a CayenneLPP frame; returns the new size of
+    // the frame or 0 if the fields do not fit (like the add* functions)
+    template <typename... ARGS>
+    static uint8_t append(CayenneLPP& lpp, ARGS... values)
+    {
+        static_assert(sizeof...(ARGS) == numValues(), "LppSchema: number of values does not match the fields");
+        static_assert(size() <= 0xFF, "LppSchema: frame too large");
+
+        uint8_t* p = lpp.reserve(size());
+
+        if (p == NULL) {
+            return 0;
+        }
+        write(p, values...);
+        return lpp.getSize();
+    }
+
+    //! @cond Doxygen_Suppress
+    template <typename... ARGS>
+    static inline void write(uint8_t* p, ARGS... values)
+    {
+        FIRST::template put<LppSchema<REST...> >(p, values...);
+    }
+    //! @endcond
+};
+
+#endif /* __cplusplus >= 201103L */
+
+#endif /* ARDUINO_CAYENNE_CAYENNELPP_SCHEMA_H_ */
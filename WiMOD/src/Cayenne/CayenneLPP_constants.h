@@ -63,4 +63,18 @@
 #define LPP_GPS_SIZE                 11
 
 
+// Extension of this library, not part of the Cayenne LPP specification:
+// several samples of one single-value type with one header per channel
+//
+// [channel] [LPP_TIME_SERIES] [value type] [flags | count]
+// [base time u32] [interval u16] [first value] [next values or deltas]
+//
+// base time and interval in s; with LPP_TIME_SERIES_DELTA every value
+// after the first one is a signed 8 bit difference to its predecessor
+#define LPP_TIME_SERIES              240
+#define LPP_TIME_SERIES_HEADER_SIZE  10
+#define LPP_TIME_SERIES_DELTA        0x80
+#define LPP_TIME_SERIES_MAX_COUNT    0x7F
+
+
 #endif /* ARDUINO_CAYENNE_CAYENNELPP_CONSTANTS_H_ */
@@ -78,6 +78,13 @@ WiMODLRBASE::WiMODLRBASE(Stream& s) :
     localHciRes     = WiMODLR_RESULT_TRANMIT_ERROR;
     lastHciRes      = WiMODLR_RESULT_TRANMIT_ERROR;
     lastStatusRsp   = 0;
+#if WIMOD_LR_BASE_USE_SNIFFER
+    snifferPrevRadioMode   = RadioMode_Standard;
+    snifferPrevMiscOptions = 0;
+#endif
+#if WIMOD_LR_BASE_USE_CONCENTRATOR
+    concentratorRxCB       = NULL;
+#endif
     memset(txBuffer, 0x00, WiMOD_LR_BASE_TX_BUFFER_SIZE);
 }
 
@@ -473,7 +480,13 @@ bool WiMODLRBASE::GetRadioConfig(TWiMODLR_DevMgmt_RadioConfig* radioCfg,
                          UINT8*                      rspStatus)
 {
     localHciRes = SapDevMgmt.GetRadioConfig(radioCfg, &localStatusRsp);
-    return copyResultInfos(hciResult, rspStatus, DEVMGMT_STATUS_OK);
+    cmdResult   = copyResultInfos(hciResult, rspStatus, DEVMGMT_STATUS_OK);
+#if WIMOD_LR_BASE_USE_CHANNEL_PLAN
+    if (cmdResult) {
+        ChannelPlan.OnConfig(*radioCfg, true);
+    }
+#endif
+    return cmdResult;
 }
 
 //-----------------------------------------------------------------------------
@@ -523,7 +536,15 @@ bool WiMODLRBASE::SetRadioConfig(const TWiMODLR_DevMgmt_RadioConfig* radioCfg,
                          UINT8*                      rspStatus)
 {
     localHciRes = SapDevMgmt.SetRadioConfig(radioCfg, &localStatusRsp);
-    return copyResultInfos(hciResult, rspStatus, DEVMGMT_STATUS_OK);
+    cmdResult   = copyResultInfos(hciResult, rspStatus, DEVMGMT_STATUS_OK);
+#if WIMOD_LR_BASE_USE_CHANNEL_PLAN
+    if (cmdResult) {
+        ChannelPlan.OnConfig(*radioCfg, false);
+    } else {
+        ChannelPlan.InvalidateConfig();
+    }
+#endif
+    return cmdResult;
 }
 
 //-----------------------------------------------------------------------------
@@ -557,6 +578,9 @@ bool WiMODLRBASE::ResetRadioConfig(TWiMDLRResultCodes*         hciResult,
                                    UINT8*                      rspStatus)
 {
     localHciRes = SapDevMgmt.ResetRadioConfig(&localStatusRsp);
+#if WIMOD_LR_BASE_USE_CHANNEL_PLAN
+    ChannelPlan.InvalidateConfig();
+#endif
     return copyResultInfos(hciResult, rspStatus, DEVMGMT_STATUS_OK);
 }
 
@@ -1037,7 +1061,14 @@ bool WiMODLRBASE::SendCData(const TWiMODLR_RadioLink_Msg* txMsg,
                             UINT8*                      rspStatus)
 {
     localHciRes = SapRadioLink.SendCData(txMsg, &localStatusRsp);
-    return copyResultInfos(hciResult, rspStatus, RADIOLINK_STATUS_OK);
+    cmdResult   = copyResultInfos(hciResult, rspStatus, RADIOLINK_STATUS_OK);
+#if WIMOD_LR_BASE_USE_TDMA
+    if (cmdResult) {
+        // the TDMA slot of this superframe is used
+        Tdma.OnDataSent(millis());
+    }
+#endif
+    return cmdResult;
 }
 
 //-----------------------------------------------------------------------------
@@ -1672,234 +1703,1473 @@ void WiMODLRBASE::RegisterAckTxCallback(TRadioLinkAckTxIndicationCallback cb)
     SapRadioLink.RegisterAckTxCallback(cb);
 }
 
-
+#if WIMOD_LR_BASE_USE_BULK_TRANSFER
+//-----------------------------------------------------------------------------
 /**
- * @brief Convert a frequency in Hz to the corresponding low level register values
+ * @brief Set window size, fragment size and timeouts of the bulk transfer
  *
- *
- * @param freq      Target frequencey in Hz
- *
- * @param msb       Pointer to register value for MSB-Part
- * @param mid       Pointer to register value for MID-Part
- * @param lsb       Pointer to register value for LSB-Part
+ * @param config    bulk transfer parameters; used by the next transfer
  */
-void WiMODLRBASE::calcFreqToRegister(uint32_t freq, uint8_t* msb, uint8_t* mid, uint8_t* lsb)
+void WiMODLRBASE::SetBulkTransferConfig(const TWiMODLR_BulkConfig& config)
 {
-	if (msb && mid && lsb) {
-		FreqCalc_calcFreqToRegister(freq, msb, mid, lsb);
-	}
+    Bulk.SetConfig(config);
 }
 
+//-----------------------------------------------------------------------------
 /**
- * @brief Convert a frequency registers to frequency in Hz
+ * @brief Set the session of the bulk transfers sent by this node
  *
- * @param msb       register value for MSB-Part
- * @param mid       register value for MID-Part
- * @param lsb       register value for LSB-Part
+ * Every transfer carries the session, so a receiver does not take the
+ * first transfer after a restart for the last one before it (the transfer
+ * ids start at 0 again). Without this call the session is taken from the
+ * micros() counter at the first BulkSend(); pass a random number if the
+ * platform has one (e.g. esp_random() on ESP32).
  *
- * return Frequency in Hz
+ * @param session   new session; must be called before the first BulkSend()
  */
-uint32_t WiMODLRBASE::calcRegisterToFreq(uint8_t msb, uint8_t mid, uint8_t lsb)
+void WiMODLRBASE::SetBulkTransferSession(UINT16 session)
 {
-	return FreqCalc_calcRegisterToFreq(msb, mid, lsb);
+    Bulk.SetSession(session);
 }
 
-
 //-----------------------------------------------------------------------------
 /**
- * @brief Gets the value of the last local HCI TX status
+ * @brief Start sending a buffer larger than a single radio frame
  *
- * If the optional parameters have been left out (for the normal commands),
- * the user can get the last value back by using this function
+ * The buffer is split into fragments that are sent as U-Data by
+ * ServiceBulkTransfer(). The receiver acknowledges a window of fragments
+ * with one selective ack; only lost fragments are sent again.
  *
- * @retval the last value of the last command issued
+ * The TX indication (DEVMGMT_RADIO_CFG_MISC_HCI_TX_IND_ENABLED) should be
+ * enabled in the radio config; otherwise each fragment waits for the
+ * TxTimeoutMs of the config.
  *
- * \msc
- * UserApp,WiMOD;
- * UserApp=>WIMOD	[label="Ping()"];
- * UserApp<<WiMOD   [label="(false)"];
- * UserApp=>WiMOD	[label="GetGetLastHciResult()"];
- * UserApp<<WiMOD	[label=(result of last HCI TX operation)]
- * ...;
- * \mscend
+ * @param groupAddress  destination group address
+ * @param deviceAddress destination device address
+ * @param data          buffer to send; must stay valid until the transfer has finished
+ * @param length        number of bytes
+ *
+ * @retval true     if the transfer has been started
+ * @retval false    if another transfer is running or the buffer is too large
  *
  * @code
- * ...
- * if (wimod.Ping() == false) {
- * 	TWiMDLRResultCodes hciResult;
+ * UINT8 logDump[2048];
  *
- * 	// get (local) result of HCI command transmission
- * 	hciResult = wimod.GetLastHciResult();
+ * wimod.BulkSend(0x10, 0x1234, logDump, sizeof(logDump));
  *
- * 	// check result code
- * 	switch (hciResult):
- * 	case WiMODLR_RESULT_OK:                   // OK, no error
- * 	case WiMODLR_RESULT_PAYLOAD_LENGTH_ERROR: // given payload is too big
- * 	case WiMODLR_RESULT_PAYLOAD_PTR_ERROR:    // wrong pointer to payload (NULL?)
- * 	case WiMODLR_RESULT_TRANMIT_ERROR,        // Error sending data to WiMOD via serial interface
- * 	case WiMODLR_RESULT_SLIP_ENCODER_ERROR,   // Error during SLIP encoding
- * 	case WiMODLR_RESULT_NO_RESPONSE           // The WiMOD did not respond to a request command
- *  ...
+ * void loop() {
+ *     wimod.Process();
+ *     wimod.ServiceBulkTransfer();
  * }
- *
- * ...
  * @endcode
  */
-TWiMDLRResultCodes WiMODLRBASE::GetLastHciResult(void)
+bool WiMODLRBASE::BulkSend(UINT8 groupAddress, UINT16 deviceAddress, const UINT8* data, UINT32 length)
 {
-    return lastHciRes;
+    if (!Bulk.IsSessionSet()) {
+        UINT32 t = micros();
+        Bulk.SetSession((UINT16) (t ^ (t >> 16)));
+    }
+    return Bulk.StartSend(groupAddress, deviceAddress, data, length, millis());
 }
 
 //-----------------------------------------------------------------------------
 /**
- * @brief Gets the value of the last status response value of the WiMOD
+ * @brief Receive a bulk transfer into a buffer
  *
- * If the optional parameters have been left out (for the normal commands),
- * the user can get the last value back by using this function
- *
- * @retval the last value of the last command issued
- *
- *
- *  * @code
- * ...
- * if (wimod.Ping() == false) {
- * 	uint8_t rsp;
- *
- * 	// get (remote) response code
- * 	rsp = wimod.GetLastResponseStatus();
- *
- * 	// check result code
- * 	switch (rsp):
- * 	case LoRaWAN_Status_Ok:                   // OK; No error;
- * 	        // --> check "remote" ResponseStatus
- * 	case LoRaWAN_Status_Error:                // general (un-specific) error
- * 	case LoRaWAN_Status_Cmd_Not_Supported:    // Command is not supported (or unknown)
- * 	case LoRaWAN_Status_Wrong_parameter:      // Wrong parameter applied
- * 	case LoRaWAN_Status_Wrong_DeviceMode:     // Device is in wong device mode for specific command
- * 	case LoRaWAN_Status_Device_Not_Activated: // Device has NOT been activated; command has not been executed
- * 	case LoRaWAN_Status_Device_Busy:          // There is another operation pending; and or duty cycle restriction is active
- * 	case LoRaWAN_Status_Queue_Full:           // internal command queue is full
- * 	case LoRaWAN_Status_Length_Error:         // some error related to the given length information
- * 	case LoRaWAN_Status_No_Factory_Settings:  // Factory settings are not available
- * 	case LoRaWAN_Status_Channel_Blocked:      // Selected channel is blocked (duty cycle?)
- * 	case LoRaWAN_Status_Channel_Not_Available: // Selected channel is not available
- * 	...
- * }
+ * The first fragment of a new transfer starts the reception. While the
+ * reception is armed, bulk frames are not passed to the U-Data RX client.
  *
- * ...
- * @endcode
+ * @param buffer    receive buffer; must stay valid until the transfer has finished
+ * @param size      size of the buffer
  *
+ * @retval true     if the reception has been armed
+ * @retval false    if another transfer is running
  */
-UINT8 WiMODLRBASE::GetLastResponseStatus(void)
+bool WiMODLRBASE::BulkReceive(UINT8* buffer, UINT32 size)
 {
-    return lastStatusRsp;
+    return Bulk.StartReceive(buffer, size, millis());
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * @brief Stop the current bulk transfer
+ */
+void WiMODLRBASE::BulkAbort(void)
+{
+    Bulk.Abort();
+}
 
-//===============================================================================
-//
-// Hardware Tests
-//
-//===============================================================================
-//bool WiMODLRBASE::StartRadioTest(const TWiMODLR_HWTestParameter* testParams,
-//		 	 	 	 	 	 	  TWiMDLRResultCodes*         hciResult,
-//                                  UINT8*                      rspStatus) {
-//
-//	localHciRes = SapHwTest.StartRadioTest(testParams, &localStatusRsp);
-//    return copyResultInfos(hciResult, rspStatus, DEVMGMT_STATUS_OK);
-//}
-//
-//bool WiMODLRBASE::StopRadioTest(TWiMDLRResultCodes*         hciResult,
-//                                  UINT8*                      rspStatus) {
-//	localHciRes = SapHwTest.StopRadioTest(&localStatusRsp);
-//    return copyResultInfos(hciResult, rspStatus, DEVMGMT_STATUS_OK);
-//
-//}
-
-//------------------------------------------------------------------------------
-//
-// Section protected functions
-//
-//------------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
 /**
- * @internal
+ * @brief Send the next fragment or selective ack of the bulk transfer
  *
- * @brief dispatches an received indication message from the module
+ * Sends at most one frame per call. Must not be called from a callback
+ * function; call it from the main loop.
  *
- * @param rxMsg     reference to the received messasge
+ * @param hciResult Result of the local command transmission to module
+ *                  This is an optional parameter.
  *
- * @endinternal
+ * @param rspStatus Status byte contained in the local response of the module
+ *                  This is an optional parameter.
+ *
+ * @retval true     if nothing was due or the frame has been accepted
+ * @retval false    if something went wrong; see hciResult & rspStatus for details
  */
-void WiMODLRBASE::ProcessUnexpectedRxMessage(TWiMODLR_HCIMessage& rxMsg) {
-    switch(rxMsg.SapID)
-    {
-        case    DEVMGMT_SAP_ID:
-                SapDevMgmt.DispatchDeviceMgmtMessage(rxMsg);
-                break;
+bool WiMODLRBASE::ServiceBulkTransfer(TWiMDLRResultCodes* hciResult, UINT8* rspStatus)
+{
+    TWiMODLR_RadioLink_Msg txMsg;
+    UINT32                 now = millis();
 
-        case RADIOLINK_SAP_ID:
-                SapRadioLink.DispatchRadioLinkMessage(rxMsg);
-                break;
+    if (!Bulk.GetFrame(now, txMsg.Payload, &txMsg.Length)) {
+        localHciRes    = WiMODLR_RESULT_OK;
+        localStatusRsp = RADIOLINK_STATUS_OK;
+        return copyResultInfos(hciResult, rspStatus, RADIOLINK_STATUS_OK);
+    }
 
-        default:
-                if (StackErrorClientCB) {
-                    StackErrorClientCB(WIMOD_STACK_ERR_UNKNOWN_RX_SAP_ID);
-                }
-                break;
+    txMsg.DestinationGroupAddress  = Bulk.GetPeerGroupAddress();
+    txMsg.DestinationDeviceAddress = Bulk.GetPeerDeviceAddress();
+
+    // a busy module is tried again by the next call
+    if (SendUData(&txMsg, hciResult, rspStatus)) {
+        Bulk.OnFrameSent(now);
     }
-    return;
+    return cmdResult;
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the state, retransmissions and goodput of the bulk transfer
+ *
+ * @param stats     pointer where to store the statistics
+ */
+void WiMODLRBASE::GetBulkTransferStats(TWiMODLR_BulkStats* stats)
+{
+    if (stats) {
+        Bulk.GetStats(millis(), stats);
+    }
+}
+#endif
 
-//------------------------------------------------------------------------------
-//
-// Section private functions
-//
-//------------------------------------------------------------------------------
-
+#if WIMOD_LR_BASE_USE_SNIFFER
+//-----------------------------------------------------------------------------
 /**
- * @internal
+ * @brief Switch the module to sniffer mode and capture raw frames
  *
- * @brief stores the status and response code of the last executed (user) command
+ * The radio mode is set to RadioMode_Sniffer with extended HCI output
+ * (RSSI, SNR, RX time) in RAM only; the config in NVM is not changed.
+ * Every raw frame indication is copied into the ring buffer, together with
+ * the host time of reception, and is not passed to the RAW data RX client.
+ * Frames that do not fit into the ring are dropped and counted.
  *
- * @param   hciResult   pointer to the result of the last HCI communication
+ * The ring has to be drained by DrainSniffer() from the main loop, e.g.
+ * into a log file; GetSnifferLogHeader() gives the header of that log.
+ * The tool in extras/sniffer2pcap converts such a log into a pcap file.
  *
- * @param   rspStatus   pointer to the status code of the last HCI response
+ * @param ringBuffer    ring memory; must stay valid until DisableSniffer()
+ * @param size          size of the ring
  *
- * @param   successValue expected value if last command was OK
+ * @param hciResult Result of the local command transmission to module
+ *                  This is an optional parameter.
  *
- * @return  true if actual results are equal to the expected value
+ * @param rspStatus Status byte contained in the local response of the module
+ *                  This is an optional parameter.
  *
- * @endinternal
+ * @retval true     if everything is ok
+ * @retval false    if something went wrong; see hciResult & rspStatus for details
  *
+ * @code
+ * UINT8 captureRing[4096];
+ * UINT8 block[512];
+ *
+ * wimod.EnableSniffer(captureRing, sizeof(captureRing));
+ * UINT8 len = wimod.GetSnifferLogHeader(block, sizeof(block));
+ * logFile.write(block, len);
+ *
+ * void loop() {
+ *     wimod.Process();
+ *     UINT32 n = wimod.DrainSniffer(block, sizeof(block));
+ *     if (n) {
+ *         logFile.write(block, n);
+ *     }
+ * }
+ * @endcode
  */
-bool WiMODLRBASE::copyResultInfos(TWiMDLRResultCodes* hciResult,
-                                  UINT8*              rspStatus,
-                                  UINT8               successValue)
+bool WiMODLRBASE::EnableSniffer(UINT8* ringBuffer, UINT32 size, TWiMDLRResultCodes* hciResult, UINT8* rspStatus)
 {
-    cmdResult = false;
-
-    //check if the transmisstion of the HCI frame was successful
-    if ((WiMODLR_RESULT_OK == localHciRes)
-            && (localStatusRsp == successValue)) {
-        // -> yes
-        cmdResult = true;
+    if (!Sniffer.Begin(ringBuffer, size)) {
+        localHciRes    = WiMODLR_RESULT_OK;
+        localStatusRsp = DEVMGMT_STATUS_WRONG_PARAMETER;
+        return copyResultInfos(hciResult, rspStatus, DEVMGMT_STATUS_OK);
     }
-    // if pointers are valid copy the values for external processing
-    if (hciResult) {
-        *hciResult = localHciRes;
+    if (!setSnifferRadioMode(true)) {
+        Sniffer.End();
     }
-    if (rspStatus) {
-        *rspStatus = localStatusRsp;
+    return copyResultInfos(hciResult, rspStatus, DEVMGMT_STATUS_OK);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Stop capturing and restore the previous radio mode
+ *
+ * Frames still in the ring are discarded; drain them before.
+ *
+ * @param hciResult Result of the local command transmission to module
+ *                  This is an optional parameter.
+ *
+ * @param rspStatus Status byte contained in the local response of the module
+ *                  This is an optional parameter.
+ *
+ * @retval true     if everything is ok
+ * @retval false    if something went wrong; see hciResult & rspStatus for details
+ */
+bool WiMODLRBASE::DisableSniffer(TWiMDLRResultCodes* hciResult, UINT8* rspStatus)
+{
+    if (!Sniffer.IsEnabled()) {
+        localHciRes    = WiMODLR_RESULT_OK;
+        localStatusRsp = DEVMGMT_STATUS_OK;
+        return copyResultInfos(hciResult, rspStatus, DEVMGMT_STATUS_OK);
     }
+    Sniffer.End();
+    setSnifferRadioMode(false);
+    return copyResultInfos(hciResult, rspStatus, DEVMGMT_STATUS_OK);
+}
 
-    // backup last status data
-    lastHciRes = localHciRes;
-    lastStatusRsp = localStatusRsp;
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the header of a sniffer log
+ *
+ * Contains the frequency, modulation, bandwidth and spreading factor of the
+ * radio config that was active when the sniffer has been enabled.
+ *
+ * @param buffer    destination
+ * @param size      size of the destination; at least LRBASE_SNIFFER_LOG_HEADER_SIZE
+ *
+ * @return number of bytes written; 0 if the buffer is too small
+ */
+UINT8 WiMODLRBASE::GetSnifferLogHeader(UINT8* buffer, UINT32 size)
+{
+    return Sniffer.EncodeLogHeader(buffer, size);
+}
 
-    // return true if HCI TX operation and command execution status are OK
-    return cmdResult;
+//-----------------------------------------------------------------------------
+/**
+ * @brief Take the captured frames out of the ring
+ *
+ * Only whole records are copied; a record that does not fit into the
+ * remaining space stays in the ring for the next call.
+ *
+ * @param buffer    destination
+ * @param size      size of the destination
+ *
+ * @return number of bytes copied; 0 if nothing is pending
+ */
+UINT32 WiMODLRBASE::DrainSniffer(UINT8* buffer, UINT32 size)
+{
+    return Sniffer.Drain(buffer, size);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the capture and drop counters of the sniffer
+ *
+ * @param stats     pointer where to store the counters
+ */
+void WiMODLRBASE::GetSnifferStats(TWiMODLR_SnifferStats* stats)
+{
+    if (stats) {
+        Sniffer.GetStats(stats);
+    }
+}
+#endif
+
+#if WIMOD_LR_BASE_USE_CHANNEL_PLAN
+//-----------------------------------------------------------------------------
+/**
+ * @brief Set the channel plan used by Retune()
+ *
+ * Use LRBASE_CHANNEL() for the entries; the frequency registers are then
+ * calculated by the compiler instead of at each retune.
+ *
+ * @param channels      channel table; must stay valid while it is used
+ * @param numChannels   number of entries
+ *
+ * @code
+ * static const TWiMODLR_Channel plan[] = {
+ *     LRBASE_CHANNEL(868100000),
+ *     LRBASE_CHANNEL(868300000),
+ *     LRBASE_CHANNEL(868500000),
+ * };
+ *
+ * wimod.SetChannelPlan(plan, 3);
+ * wimod.Retune(1);
+ * @endcode
+ */
+void WiMODLRBASE::SetChannelPlan(const TWiMODLR_Channel* channels, UINT8 numChannels)
+{
+    ChannelPlan.SetPlan(channels, numChannels);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Switch the radio to a channel of the channel plan
+ *
+ * The last radio config read from or written to the module is kept; a
+ * retune only replaces its frequency registers and sends it with
+ * StoreNwmFlag = 0, so the NVM of the module is not written. The config is
+ * only read from the module if none is known yet (e.g. after
+ * ResetRadioConfig()). A retune to the current channel is skipped.
+ *
+ * The latency of each retune is available via GetRetuneStats().
+ *
+ * @param channel   index into the channel plan
+ *
+ * @param hciResult Result of the local command transmission to module
+ *                  This is an optional parameter.
+ *
+ * @param rspStatus Status byte contained in the local response of the module
+ *                  This is an optional parameter.
+ *
+ * @retval true     if everything is ok
+ * @retval false    if something went wrong; see hciResult & rspStatus for details
+ */
+bool WiMODLRBASE::Retune(UINT8 channel, TWiMDLRResultCodes* hciResult, UINT8* rspStatus)
+{
+    TWiMODLR_DevMgmt_RadioConfig radioCfg;
+    UINT32                       start;
+
+    if (channel >= ChannelPlan.GetNumChannels()) {
+        localHciRes    = WiMODLR_RESULT_OK;
+        localStatusRsp = DEVMGMT_STATUS_WRONG_PARAMETER;
+        return copyResultInfos(hciResult, rspStatus, DEVMGMT_STATUS_OK);
+    }
+    if (!ChannelPlan.HasConfig() && !GetRadioConfig(&radioCfg, hciResult, rspStatus)) {
+        return cmdResult;
+    }
+    if (ChannelPlan.GetChannel() == channel) {
+        ChannelPlan.OnSkipped();
+        localHciRes    = WiMODLR_RESULT_OK;
+        localStatusRsp = DEVMGMT_STATUS_OK;
+        return copyResultInfos(hciResult, rspStatus, DEVMGMT_STATUS_OK);
+    }
+
+    ChannelPlan.Prepare(channel, &radioCfg);
+
+    start       = micros();
+    localHciRes = SapDevMgmt.SetRadioConfig(&radioCfg, &localStatusRsp);
+    ChannelPlan.OnRetuneDone(channel, copyResultInfos(hciResult, rspStatus, DEVMGMT_STATUS_OK), micros() - start);
+    return cmdResult;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the current channel, retune counters and latency
+ *
+ * @param stats     pointer where to store the statistics
+ */
+void WiMODLRBASE::GetRetuneStats(TWiMODLR_RetuneStats* stats)
+{
+    if (stats) {
+        ChannelPlan.GetStats(stats);
+    }
+}
+#endif
+
+#if WIMOD_LR_BASE_USE_TDMA
+//-----------------------------------------------------------------------------
+/**
+ * @brief Set the superframe of the TDMA network (collector only)
+ *
+ * @param config    number of slots, largest payload, guard time, ...
+ */
+void WiMODLRBASE::SetTdmaConfig(const TWiMODLR_TdmaConfig& config)
+{
+    Tdma.SetConfig(config);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Start the TDMA network as collector
+ *
+ * The collector sends a beacon with the slot map to its TxGroupAddress at
+ * the start of each superframe; the nodes must use this group address as
+ * their GroupAddress. The slot width is calculated from the time on air of
+ * the largest C-Data message and its ack with the current radio config.
+ * Nodes without a slot request one in a contention slot; a slot is freed
+ * if its node has not sent anything for SlotTimeout superframes. The
+ * beacon carries the RTC time and the guard time of the collector; the RTC
+ * has to be enabled in the radio config (DEVMGMT_RADIO_CFG_MISC_RTC_ENABLED).
+ *
+ * ServiceTdma() sends the beacons and must be called from the main loop.
+ *
+ * @param hciResult Result of the local command transmission to module
+ *                  This is an optional parameter.
+ *
+ * @param rspStatus Status byte contained in the local response of the module
+ *                  This is an optional parameter.
+ *
+ * @retval true     if everything is ok
+ * @retval false    if something went wrong; see hciResult & rspStatus for details
+ */
+bool WiMODLRBASE::StartTdmaCollector(TWiMDLRResultCodes* hciResult, UINT8* rspStatus)
+{
+    TWiMODLR_DevMgmt_RadioConfig radioCfg;
+
+    if (GetRadioConfig(&radioCfg, hciResult, rspStatus)) {
+        Tdma.SetRadioConfig(radioCfg);
+        Tdma.StartCollector(radioCfg.GroupAddress, radioCfg.DeviceAddress, radioCfg.TxGroupAddress);
+    }
+    return cmdResult;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Start the TDMA network as node
+ *
+ * The node is identified in the slot map by the DeviceAddress of its radio
+ * config. The reception of a beacon is the time reference of the slots;
+ * the RTC of the module is set to the time of the collector and an RTC
+ * alarm is set one second ahead of the next beacon, so a host sleeping
+ * between the superframes can be woken by the RTC alarm indication
+ * (RegisterRtcAlarmIndicationClient). The RTC has to be enabled in the
+ * radio config (DEVMGMT_RADIO_CFG_MISC_RTC_ENABLED).
+ *
+ * Send the C-Data message to the collector (GetTdmaCollector()) when
+ * GetMsUntilTdmaSlot() returns 0.
+ *
+ * @param hciResult Result of the local command transmission to module
+ *                  This is an optional parameter.
+ *
+ * @param rspStatus Status byte contained in the local response of the module
+ *                  This is an optional parameter.
+ *
+ * @retval true     if everything is ok
+ * @retval false    if something went wrong; see hciResult & rspStatus for details
+ *
+ * @code
+ * wimod.StartTdmaNode();
+ *
+ * void loop() {
+ *     wimod.Process();
+ *     wimod.ServiceTdma();
+ *
+ *     if (dataPending && (wimod.GetMsUntilTdmaSlot() == 0)) {
+ *         wimod.GetTdmaCollector(&msg.DestinationGroupAddress, &msg.DestinationDeviceAddress);
+ *         wimod.SendCData(&msg);
+ *     }
+ * }
+ * @endcode
+ */
+bool WiMODLRBASE::StartTdmaNode(TWiMDLRResultCodes* hciResult, UINT8* rspStatus)
+{
+    TWiMODLR_DevMgmt_RadioConfig radioCfg;
+
+    if (GetRadioConfig(&radioCfg, hciResult, rspStatus)) {
+        Tdma.SetRadioConfig(radioCfg);
+        Tdma.StartNode(radioCfg.DeviceAddress, millis());
+    }
+    return cmdResult;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Leave the TDMA network
+ */
+void WiMODLRBASE::StopTdma(void)
+{
+    Tdma.Stop();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Send the beacon / slot request and update the RTC of a node
+ *
+ * Issues at most one HCI request per call. Must not be called from a
+ * callback function; call it from the main loop.
+ *
+ * The collector reads its RTC with a call of its own shortly before the
+ * beacon; if the RTC cannot be read, the beacon of this superframe is
+ * skipped and the nodes extrapolate the superframe.
+ *
+ * @param hciResult Result of the local command transmission to module
+ *                  This is an optional parameter.
+ *
+ * @param rspStatus Status byte contained in the local response of the module
+ *                  This is an optional parameter.
+ *
+ * @retval true     if nothing was due or the request has been accepted
+ * @retval false    if something went wrong; see hciResult & rspStatus for details
+ */
+bool WiMODLRBASE::ServiceTdma(TWiMDLRResultCodes* hciResult, UINT8* rspStatus)
+{
+    TWiMODLR_RadioLink_Msg    txMsg;
+    TWiMODLR_DevMgmt_RtcAlarm alarm;
+    UINT32                    rtcTime = 0;
+    UINT32                    now     = millis();
+
+    Tdma.Update(now);
+
+    if (Tdma.IsBeaconTimeDue(now)) {
+        // the beacon follows with a later call
+        if (GetRtc(&rtcTime, hciResult, rspStatus)) {
+            Tdma.SetBeaconTime(rtcTime);
+        } else {
+            Tdma.SkipBeacon(now);
+        }
+        return cmdResult;
+    }
+    if (Tdma.IsBeaconDue(now)) {
+        txMsg.DestinationGroupAddress  = Tdma.GetBeaconGroupAddress();
+        txMsg.DestinationDeviceAddress = RADIOLINK_BROADCAST_DEVICE_ADR;
+        txMsg.Length = Tdma.EncodeBeacon(txMsg.Payload, WIMOD_RADIOLINK_PAYLOAD_LEN);
+        if (SendUData(&txMsg, hciResult, rspStatus)) {
+            Tdma.OnBeaconSent(millis());
+        }
+        return cmdResult;
+    }
+    if (Tdma.IsSlotRequestDue(now)) {
+        txMsg.DestinationGroupAddress  = Tdma.GetCollectorGroupAddress();
+        txMsg.DestinationDeviceAddress = Tdma.GetCollectorDeviceAddress();
+        txMsg.Length = Tdma.EncodeSlotRequest(txMsg.Payload, WIMOD_RADIOLINK_PAYLOAD_LEN);
+        if (SendUData(&txMsg, hciResult, rspStatus)) {
+            Tdma.OnSlotRequestSent();
+        }
+        return cmdResult;
+    }
+    if (Tdma.TakeRtcSync(now, &rtcTime)) {
+        return SetRtc(rtcTime, hciResult, rspStatus);
+    }
+    if (Tdma.TakeRtcAlarm(now, &alarm)) {
+        return SetRtcAlarm(&alarm, hciResult, rspStatus);
+    }
+
+    localHciRes    = WiMODLR_RESULT_OK;
+    localStatusRsp = RADIOLINK_STATUS_OK;
+    return copyResultInfos(hciResult, rspStatus, RADIOLINK_STATUS_OK);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Time until the own TDMA slot of a node opens
+ *
+ * @return 0 if the C-Data message can be sent now;
+ *         LRBASE_TDMA_NOT_READY if no beacon has been received or the
+ *         node has no slot yet
+ */
+UINT32 WiMODLRBASE::GetMsUntilTdmaSlot(void)
+{
+    return Tdma.GetMsUntilSlot(millis());
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Address of the collector taken from the last beacon
+ *
+ * @param groupAddress  pointer where to store the group address
+ * @param deviceAddress pointer where to store the device address
+ *
+ * @retval false    if no beacon has been received yet
+ */
+bool WiMODLRBASE::GetTdmaCollector(UINT8* groupAddress, UINT16* deviceAddress)
+{
+    TWiMODLR_TdmaInfo info;
+
+    Tdma.GetInfo(&info);
+    if (!info.Synchronised || !groupAddress || !deviceAddress) {
+        return false;
+    }
+    *groupAddress  = Tdma.GetCollectorGroupAddress();
+    *deviceAddress = Tdma.GetCollectorDeviceAddress();
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the slot assignment and the beacon counters
+ *
+ * @param info      pointer where to store the state
+ */
+void WiMODLRBASE::GetTdmaInfo(TWiMODLR_TdmaInfo* info)
+{
+    if (info) {
+        Tdma.GetInfo(info);
+    }
+}
+#endif
+
+#if WIMOD_LR_BASE_USE_CONCENTRATOR
+//-----------------------------------------------------------------------------
+/**
+ * @brief Enable the concentrator receive path
+ *
+ * Received U-Data and C-Data frames are no longer passed to the U-Data /
+ * C-Data RX clients but to the concentrator client. The first payload
+ * byte of each frame is a sequence number of the sender; retransmitted
+ * and out of order frames are dropped, so every source is delivered as an
+ * in-order stream. The sequence byte is removed before delivery.
+ *
+ * The per-source state lives in the given table (open addressing, no heap);
+ * with 2^n entries up to 75% of them are tracked. Frames of further
+ * sources are delivered without duplicate check.
+ *
+ * @param peerTable table memory; must stay valid until DisableConcentrator()
+ * @param entries   number of entries; a power of two
+ *
+ * @retval true     if the concentrator has been enabled
+ * @retval false    if the table size is invalid
+ *
+ * @code
+ * static TWiMODLR_PeerInfo peerTable[64];   // e.g. 4096 on a Linux host
+ *
+ * void myConcentratorRxInd(const TWiMODLR_RadioLink_Msg& rxMsg, const TWiMODLR_PeerInfo* peer) {
+ *     // rxMsg.Payload holds the application data of the next frame of this source
+ * }
+ *
+ * void setup() {
+ *     ...
+ *     wimod.EnableConcentrator(peerTable, 64);
+ *     wimod.RegisterConcentratorRxClient(myConcentratorRxInd);
+ * }
+ * @endcode
+ */
+bool WiMODLRBASE::EnableConcentrator(TWiMODLR_PeerInfo* peerTable, UINT32 entries)
+{
+    return Concentrator.Begin(peerTable, entries);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Disable the concentrator; received frames go to the RX clients again
+ */
+void WiMODLRBASE::DisableConcentrator(void)
+{
+    Concentrator.End();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Register a callback for the frames delivered by the concentrator
+ *
+ * The callback is invoked from Process(); do not send HCI requests from it.
+ *
+ * @param cb        callback; peer is NULL if the source is not tracked
+ */
+void WiMODLRBASE::RegisterConcentratorRxClient(TConcentratorRxCallback cb)
+{
+    concentratorRxCB = cb;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the state of a single source
+ *
+ * @param groupAddress  source group address
+ * @param deviceAddress source device address
+ *
+ * @return entry of the source; NULL if the source is not tracked
+ */
+const TWiMODLR_PeerInfo* WiMODLRBASE::GetConcentratorPeer(UINT8 groupAddress, UINT16 deviceAddress)
+{
+    return Concentrator.Find(groupAddress, deviceAddress);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Iterate over all tracked sources
+ *
+ * @param iterator  position; set to 0 for the first call
+ *
+ * @return next entry; NULL if there are no more entries
+ *
+ * @code
+ * UINT32 it = 0;
+ * const TWiMODLR_PeerInfo* peer;
+ *
+ * while ((peer = wimod.GetNextConcentratorPeer(&it)) != NULL) {
+ *     ...
+ * }
+ * @endcode
+ */
+const TWiMODLR_PeerInfo* WiMODLRBASE::GetNextConcentratorPeer(UINT32* iterator)
+{
+    return Concentrator.GetNext(iterator);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Remove sources that have not been heard for a while
+ *
+ * Walks over the whole table; call it from the main loop, e.g. once a
+ * minute. Pointers to table entries are invalid afterwards.
+ *
+ * @param maxAgeMs  max. time since the last frame of a source (ms)
+ *
+ * @return number of removed sources
+ */
+UINT32 WiMODLRBASE::ExpireConcentratorPeers(UINT32 maxAgeMs)
+{
+    return Concentrator.Expire(millis(), maxAgeMs);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Set the silence after which a sender is taken as restarted
+ *
+ * After this time any step back of the sequence of a source starts a new
+ * stream (LRBASE_CONC_RESYNC) instead of being dropped as late / duplicate.
+ * Must be longer than the retransmissions of a frame take.
+ * Default: LRBASE_CONC_DEFAULT_RESYNC_AGE_MS
+ *
+ * @param ageMs     silence of a source (ms)
+ */
+void WiMODLRBASE::SetConcentratorResyncAge(UINT32 ageMs)
+{
+    Concentrator.SetResyncAge(ageMs);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the counters of the concentrator
+ *
+ * @param stats     pointer where to store the counters
+ */
+void WiMODLRBASE::GetConcentratorStats(TWiMODLR_ConcentratorStats* stats)
+{
+    if (stats) {
+        Concentrator.GetStats(stats);
+    }
+}
+#endif
+
+#if WIMOD_LR_BASE_USE_LINK_BENCH
+//-----------------------------------------------------------------------------
+/**
+ * @brief Start a link benchmark as sender
+ *
+ * The sender tests every point of the config against a receiver node
+ * (StartLinkBenchReceiver()): both nodes switch to the radio settings of
+ * the point (RAM only), the sender sends FramesPerPoint numbered frames
+ * and the receiver reports what it got. Outside of a point both nodes use
+ * the radio config that is active now ("home" settings); it must be the
+ * same on both nodes.
+ *
+ * ServiceLinkBench() has to be called from the main loop until
+ * IsLinkBenchDone() returns true.
+ *
+ * @param config    points to test and frame settings
+ * @param results   one entry per point; filled during the run
+ *
+ * @param hciResult Result of the local command transmission to module
+ *                  This is an optional parameter.
+ *
+ * @param rspStatus Status byte contained in the local response of the module
+ *                  This is an optional parameter.
+ *
+ * @retval true     if the benchmark has been started
+ * @retval false    if something went wrong; see hciResult & rspStatus for details
+ *
+ * @code
+ * static const TWiMODLR_BenchPoint points[] = {
+ *     { Modulation_LoRa, LoRaBandwith_125kHz, LoRa7_SF7,   ErrorCoding1_4_5, FskDatarate_50kbps },
+ *     { Modulation_LoRa, LoRaBandwith_125kHz, LoRa10_SF10, ErrorCoding1_4_5, FskDatarate_50kbps },
+ * };
+ * static TWiMODLR_BenchResult results[2];
+ *
+ * TWiMODLR_BenchConfig cfg;
+ * cfg.Points            = points;
+ * cfg.NumPoints         = 2;
+ * cfg.FramesPerPoint    = 100;
+ * cfg.PayloadSize       = 20;
+ * cfg.Confirmed         = false;
+ * cfg.GapMs             = 0;
+ * cfg.PeerGroupAddress  = 0x10;
+ * cfg.PeerDeviceAddress = 0x1234;
+ *
+ * wimod.StartLinkBenchSender(cfg, results);
+ *
+ * void loop() {
+ *     wimod.Process();
+ *     wimod.ServiceLinkBench();
+ *     if (wimod.IsLinkBenchDone()) {
+ *         // print results[]
+ *     }
+ * }
+ * @endcode
+ */
+bool WiMODLRBASE::StartLinkBenchSender(const TWiMODLR_BenchConfig& config, TWiMODLR_BenchResult* results,
+                                       TWiMDLRResultCodes* hciResult, UINT8* rspStatus)
+{
+    TWiMODLR_DevMgmt_RadioConfig radioCfg;
+    TWiMODLR_BenchPoint          homePoint;
+
+    if (!GetRadioConfig(&radioCfg, hciResult, rspStatus)) {
+        return cmdResult;
+    }
+    getBenchPoint(radioCfg, &homePoint);
+    if (!Bench.StartSender(config, results, homePoint, millis())) {
+        localHciRes    = WiMODLR_RESULT_OK;
+        localStatusRsp = DEVMGMT_STATUS_WRONG_PARAMETER;
+    }
+    return copyResultInfos(hciResult, rspStatus, DEVMGMT_STATUS_OK);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Start a link benchmark as receiver
+ *
+ * The receiver follows the SETUP frames of a sender; frames of the
+ * benchmark are not passed to the RX clients. ServiceLinkBench() has to
+ * be called from the main loop.
+ *
+ * @param hciResult Result of the local command transmission to module
+ *                  This is an optional parameter.
+ *
+ * @param rspStatus Status byte contained in the local response of the module
+ *                  This is an optional parameter.
+ *
+ * @retval true     if the benchmark has been started
+ * @retval false    if something went wrong; see hciResult & rspStatus for details
+ */
+bool WiMODLRBASE::StartLinkBenchReceiver(TWiMDLRResultCodes* hciResult, UINT8* rspStatus)
+{
+    TWiMODLR_DevMgmt_RadioConfig radioCfg;
+    TWiMODLR_BenchPoint          homePoint;
+
+    if (GetRadioConfig(&radioCfg, hciResult, rspStatus)) {
+        getBenchPoint(radioCfg, &homePoint);
+        Bench.StartReceiver(homePoint, millis());
+    }
+    return cmdResult;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Stop the link benchmark and restore the home settings
+ *
+ * @param hciResult Result of the local command transmission to module
+ *                  This is an optional parameter.
+ *
+ * @param rspStatus Status byte contained in the local response of the module
+ *                  This is an optional parameter.
+ *
+ * @retval true     if everything is ok
+ * @retval false    if something went wrong; see hciResult & rspStatus for details
+ */
+bool WiMODLRBASE::StopLinkBench(TWiMDLRResultCodes* hciResult, UINT8* rspStatus)
+{
+    TWiMODLR_BenchPoint homePoint = Bench.GetHomePoint();
+    bool                restore   = !Bench.IsAtHome();
+
+    Bench.Stop();
+    if (restore) {
+        return setBenchRadio(homePoint, hciResult, rspStatus);
+    }
+    localHciRes    = WiMODLR_RESULT_OK;
+    localStatusRsp = DEVMGMT_STATUS_OK;
+    return copyResultInfos(hciResult, rspStatus, DEVMGMT_STATUS_OK);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Execute the next step of the link benchmark
+ *
+ * Sends at most one HCI request (radio config or frame) per call; call it
+ * from the main loop, not from a callback.
+ *
+ * @param hciResult Result of the local command transmission to module
+ *                  This is an optional parameter.
+ *
+ * @param rspStatus Status byte contained in the local response of the module
+ *                  This is an optional parameter.
+ *
+ * @retval true     if nothing was to do or the request has been accepted
+ * @retval false    if something went wrong; see hciResult & rspStatus for details
+ */
+bool WiMODLRBASE::ServiceLinkBench(TWiMDLRResultCodes* hciResult, UINT8* rspStatus)
+{
+    TWiMODLR_RadioLink_Msg txMsg;
+    bool                   confirmed;
+
+    switch (Bench.GetAction(millis()))
+    {
+        case LRBASE_BENCH_ACTION_SET_POINT:
+        case LRBASE_BENCH_ACTION_SET_HOME:
+            setBenchRadio(Bench.GetActionPoint(), hciResult, rspStatus);
+            break;
+
+        case LRBASE_BENCH_ACTION_SEND:
+            txMsg.Length = Bench.EncodeFrame(txMsg.Payload, WIMOD_RADIOLINK_PAYLOAD_LEN, &confirmed,
+                                             &txMsg.DestinationGroupAddress, &txMsg.DestinationDeviceAddress);
+            if (txMsg.Length == 0) {
+                localHciRes    = WiMODLR_RESULT_OK;
+                localStatusRsp = RADIOLINK_STATUS_LENGTH_ERROR;
+                copyResultInfos(hciResult, rspStatus, RADIOLINK_STATUS_OK);
+            } else if (confirmed) {
+                SendCData(&txMsg, hciResult, rspStatus);
+            } else {
+                SendUData(&txMsg, hciResult, rspStatus);
+            }
+            break;
+
+        default:
+            localHciRes    = WiMODLR_RESULT_OK;
+            localStatusRsp = DEVMGMT_STATUS_OK;
+            return copyResultInfos(hciResult, rspStatus, DEVMGMT_STATUS_OK);
+    }
+    Bench.OnActionDone(cmdResult, millis());
+    return cmdResult;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Check if the sweep of the sender is complete
+ *
+ * @retval true     if all points have been tested; the results are final
+ */
+bool WiMODLRBASE::IsLinkBenchDone(void)
+{
+    return Bench.IsDone();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the number of points with final results
+ */
+UINT8 WiMODLRBASE::GetLinkBenchPointsDone(void)
+{
+    return Bench.GetPointsDone();
+}
+#endif
+
+
+/**
+ * @brief Convert a frequency in Hz to the corresponding low level register values
+ *
+ *
+ * @param freq      Target frequencey in Hz
+ *
+ * @param msb       Pointer to register value for MSB-Part
+ * @param mid       Pointer to register value for MID-Part
+ * @param lsb       Pointer to register value for LSB-Part
+ */
+void WiMODLRBASE::calcFreqToRegister(uint32_t freq, uint8_t* msb, uint8_t* mid, uint8_t* lsb)
+{
+	if (msb && mid && lsb) {
+		FreqCalc_calcFreqToRegister(freq, msb, mid, lsb);
+	}
+}
+
+/**
+ * @brief Convert a frequency registers to frequency in Hz
+ *
+ * @param msb       register value for MSB-Part
+ * @param mid       register value for MID-Part
+ * @param lsb       register value for LSB-Part
+ *
+ * return Frequency in Hz
+ */
+uint32_t WiMODLRBASE::calcRegisterToFreq(uint8_t msb, uint8_t mid, uint8_t lsb)
+{
+	return FreqCalc_calcRegisterToFreq(msb, mid, lsb);
+}
+
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Gets the value of the last local HCI TX status
+ *
+ * If the optional parameters have been left out (for the normal commands),
+ * the user can get the last value back by using this function
+ *
+ * @retval the last value of the last command issued
+ *
+ * \msc
+ * UserApp,WiMOD;
+ * UserApp=>WIMOD	[label="Ping()"];
+ * UserApp<<WiMOD   [label="(false)"];
+ * UserApp=>WiMOD	[label="GetGetLastHciResult()"];
+ * UserApp<<WiMOD	[label=(result of last HCI TX operation)]
+ * ...;
+ * \mscend
+ *
+ * @code
+ * ...
+ * if (wimod.Ping() == false) {
+ * 	TWiMDLRResultCodes hciResult;
+ *
+ * 	// get (local) result of HCI command transmission
+ * 	hciResult = wimod.GetLastHciResult();
+ *
+ * 	// check result code
+ * 	switch (hciResult):
+ * 	case WiMODLR_RESULT_OK:                   // OK, no error
+ * 	case WiMODLR_RESULT_PAYLOAD_LENGTH_ERROR: // given payload is too big
+ * 	case WiMODLR_RESULT_PAYLOAD_PTR_ERROR:    // wrong pointer to payload (NULL?)
+ * 	case WiMODLR_RESULT_TRANMIT_ERROR,        // Error sending data to WiMOD via serial interface
+ * 	case WiMODLR_RESULT_SLIP_ENCODER_ERROR,   // Error during SLIP encoding
+ * 	case WiMODLR_RESULT_NO_RESPONSE           // The WiMOD did not respond to a request command
+ *  ...
+ * }
+ *
+ * ...
+ * @endcode
+ */
+TWiMDLRResultCodes WiMODLRBASE::GetLastHciResult(void)
+{
+    return lastHciRes;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Gets the value of the last status response value of the WiMOD
+ *
+ * If the optional parameters have been left out (for the normal commands),
+ * the user can get the last value back by using this function
+ *
+ * @retval the last value of the last command issued
+ *
+ *
+ *  * @code
+ * ...
+ * if (wimod.Ping() == false) {
+ * 	uint8_t rsp;
+ *
+ * 	// get (remote) response code
+ * 	rsp = wimod.GetLastResponseStatus();
+ *
+ * 	// check result code
+ * 	switch (rsp):
+ * 	case LoRaWAN_Status_Ok:                   // OK; No error;
+ * 	        // --> check "remote" ResponseStatus
+ * 	case LoRaWAN_Status_Error:                // general (un-specific) error
+ * 	case LoRaWAN_Status_Cmd_Not_Supported:    // Command is not supported (or unknown)
+ * 	case LoRaWAN_Status_Wrong_parameter:      // Wrong parameter applied
+ * 	case LoRaWAN_Status_Wrong_DeviceMode:     // Device is in wong device mode for specific command
+ * 	case LoRaWAN_Status_Device_Not_Activated: // Device has NOT been activated; command has not been executed
+ * 	case LoRaWAN_Status_Device_Busy:          // There is another operation pending; and or duty cycle restriction is active
+ * 	case LoRaWAN_Status_Queue_Full:           // internal command queue is full
+ * 	case LoRaWAN_Status_Length_Error:         // some error related to the given length information
+ * 	case LoRaWAN_Status_No_Factory_Settings:  // Factory settings are not available
+ * 	case LoRaWAN_Status_Channel_Blocked:      // Selected channel is blocked (duty cycle?)
+ * 	case LoRaWAN_Status_Channel_Not_Available: // Selected channel is not available
+ * 	...
+ * }
+ *
+ * ...
+ * @endcode
+ *
+ */
+UINT8 WiMODLRBASE::GetLastResponseStatus(void)
+{
+    return lastStatusRsp;
+}
+
+
+//===============================================================================
+//
+// Hardware Tests
+//
+//===============================================================================
+//bool WiMODLRBASE::StartRadioTest(const TWiMODLR_HWTestParameter* testParams,
+//		 	 	 	 	 	 	  TWiMDLRResultCodes*         hciResult,
+//                                  UINT8*                      rspStatus) {
+//
+//	localHciRes = SapHwTest.StartRadioTest(testParams, &localStatusRsp);
+//    return copyResultInfos(hciResult, rspStatus, DEVMGMT_STATUS_OK);
+//}
+//
+//bool WiMODLRBASE::StopRadioTest(TWiMDLRResultCodes*         hciResult,
+//                                  UINT8*                      rspStatus) {
+//	localHciRes = SapHwTest.StopRadioTest(&localStatusRsp);
+//    return copyResultInfos(hciResult, rspStatus, DEVMGMT_STATUS_OK);
+//
+//}
+
+//------------------------------------------------------------------------------
+//
+// Section protected functions
+//
+//------------------------------------------------------------------------------
+/**
+ * @internal
+ *
+ * @brief dispatches an received indication message from the module
+ *
+ * @param rxMsg     reference to the received messasge
+ *
+ * @endinternal
+ */
+void WiMODLRBASE::ProcessUnexpectedRxMessage(TWiMODLR_HCIMessage& rxMsg) {
+    switch(rxMsg.SapID)
+    {
+        case    DEVMGMT_SAP_ID:
+                SapDevMgmt.DispatchDeviceMgmtMessage(rxMsg);
+                break;
+
+        case RADIOLINK_SAP_ID:
+                // bulk transfer frames, captured frames, TDMA control and benchmark frames are not passed to the clients;
+                // with the concentrator enabled, received data goes to the concentrator client only
+#if WIMOD_LR_BASE_USE_BULK_TRANSFER
+                if (trackBulkTransfer(rxMsg)) {
+                    break;
+                }
+#endif
+#if WIMOD_LR_BASE_USE_SNIFFER
+                if (captureRawFrame(rxMsg)) {
+                    break;
+                }
+#endif
+#if WIMOD_LR_BASE_USE_TDMA
+                if (trackTdma(rxMsg)) {
+                    break;
+                }
+#endif
+#if WIMOD_LR_BASE_USE_LINK_BENCH
+                if (trackLinkBench(rxMsg)) {
+                    break;
+                }
+#endif
+#if WIMOD_LR_BASE_USE_CONCENTRATOR
+                if (trackConcentrator(rxMsg)) {
+                    break;
+                }
+#endif
+                SapRadioLink.DispatchRadioLinkMessage(rxMsg);
+                break;
+
+        default:
+                if (StackErrorClientCB) {
+                    StackErrorClientCB(WIMOD_STACK_ERR_UNKNOWN_RX_SAP_ID);
+                }
+                break;
+    }
+    return;
+}
+
+
+//------------------------------------------------------------------------------
+//
+// Section private functions
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @internal
+ *
+ * @brief stores the status and response code of the last executed (user) command
+ *
+ * @param   hciResult   pointer to the result of the last HCI communication
+ *
+ * @param   rspStatus   pointer to the status code of the last HCI response
+ *
+ * @param   successValue expected value if last command was OK
+ *
+ * @return  true if actual results are equal to the expected value
+ *
+ * @endinternal
+ *
+ */
+bool WiMODLRBASE::copyResultInfos(TWiMDLRResultCodes* hciResult,
+                                  UINT8*              rspStatus,
+                                  UINT8               successValue)
+{
+    cmdResult = false;
+
+    //check if the transmisstion of the HCI frame was successful
+    if ((WiMODLR_RESULT_OK == localHciRes)
+            && (localStatusRsp == successValue)) {
+        // -> yes
+        cmdResult = true;
+    }
+    // if pointers are valid copy the values for external processing
+    if (hciResult) {
+        *hciResult = localHciRes;
+    }
+    if (rspStatus) {
+        *rspStatus = localStatusRsp;
+    }
+
+    // backup last status data
+    lastHciRes = localHciRes;
+    lastStatusRsp = localStatusRsp;
+
+    // return true if HCI TX operation and command execution status are OK
+    return cmdResult;
+}
+
+#if WIMOD_LR_BASE_USE_BULK_TRANSFER
+/**
+ * @internal
+ *
+ * @brief passes U-Data indications to the bulk transfer
+ *
+ * @param   rxMsg       received HCI message
+ *
+ * @return  true if the message belongs to the bulk transfer
+ *
+ * @endinternal
+ */
+bool WiMODLRBASE::trackBulkTransfer(TWiMODLR_HCIMessage& rxMsg)
+{
+    TWiMODLR_RadioLink_Msg radioMsg;
+
+    switch (rxMsg.MsgID)
+    {
+        case RADIOLINK_MSG_U_DATA_RX_IND:
+            if ((Bulk.GetState() != LRBASE_BULK_STATE_IDLE) && SapRadioLink.convert(rxMsg, &radioMsg)) {
+                return Bulk.OnFrame(radioMsg.SourceGroupAddress, radioMsg.SourceDeviceAddress,
+                                    radioMsg.Payload, radioMsg.Length, millis());
+            }
+            break;
+        case RADIOLINK_MSG_U_DATA_TX_IND:
+            Bulk.OnTxDone(millis());
+            break;
+        default:
+            break;
+    }
+    return false;
+}
+#endif
+
+#if WIMOD_LR_BASE_USE_SNIFFER
+/**
+ * @internal
+ *
+ * @brief copies raw frame indications into the sniffer ring
+ *
+ * @param   rxMsg       received HCI message
+ *
+ * @return  true if the message has been taken by the sniffer
+ *
+ * @endinternal
+ */
+bool WiMODLRBASE::captureRawFrame(TWiMODLR_HCIMessage& rxMsg)
+{
+    if (rxMsg.MsgID != RADIOLINK_MSG_RAW_DATA_RX_IND) {
+        return false;
+    }
+    return Sniffer.OnRawFrame(rxMsg.Payload, rxMsg.Length, millis());
+}
+
+/**
+ * @internal
+ *
+ * @brief switches the radio mode for the sniffer (RAM only)
+ *
+ * @param   enable      true: sniffer mode; false: restore the previous mode
+ *
+ * @return  true if the radio config has been written
+ *
+ * @endinternal
+ */
+bool WiMODLRBASE::setSnifferRadioMode(bool enable)
+{
+    TWiMODLR_DevMgmt_RadioConfig radioCfg;
+
+    if (!GetRadioConfig(&radioCfg)) {
+        return false;
+    }
+    if (enable) {
+        snifferPrevRadioMode   = radioCfg.RadioMode;
+        snifferPrevMiscOptions = radioCfg.MiscOptions;
+        radioCfg.RadioMode     = RadioMode_Sniffer;
+        radioCfg.MiscOptions  |= DEVMGMT_RADIO_CFG_MISC_EXTENDED_HCI_OUTPUT_FORMAT;
+
+        Sniffer.SetRadioInfo(calcRegisterToFreq(radioCfg.RfFreq_MSB, radioCfg.RfFreq_MID, radioCfg.RfFreq_LSB),
+                             radioCfg.Modulation, radioCfg.LoRaBandWidth, radioCfg.LoRaSpreadingFactor);
+    } else {
+        radioCfg.RadioMode     = snifferPrevRadioMode;
+        radioCfg.MiscOptions   = snifferPrevMiscOptions;
+    }
+    radioCfg.StoreNwmFlag = 0;
+    return SetRadioConfig(&radioCfg);
+}
+#endif
+
+#if WIMOD_LR_BASE_USE_TDMA
+/**
+ * @internal
+ *
+ * @brief passes U-Data / C-Data indications to the TDMA network
+ *
+ * @param   rxMsg       received HCI message
+ *
+ * @return  true if the message is a beacon or slot request
+ *
+ * @endinternal
+ */
+bool WiMODLRBASE::trackTdma(TWiMODLR_HCIMessage& rxMsg)
+{
+    TWiMODLR_RadioLink_Msg radioMsg;
+
+    if (Tdma.GetRole() == LRBASE_TDMA_ROLE_OFF) {
+        return false;
+    }
+    if ((rxMsg.MsgID != RADIOLINK_MSG_U_DATA_RX_IND) && (rxMsg.MsgID != RADIOLINK_MSG_C_DATA_RX_IND)) {
+        return false;
+    }
+    if (!SapRadioLink.convert(rxMsg, &radioMsg)) {
+        return false;
+    }
+    return Tdma.OnFrame(radioMsg.SourceDeviceAddress, rxMsg.MsgID == RADIOLINK_MSG_U_DATA_RX_IND,
+                        radioMsg.Payload, (UINT8) radioMsg.Length, millis());
+}
+#endif
+
+#if WIMOD_LR_BASE_USE_CONCENTRATOR
+/**
+ * @internal
+ *
+ * @brief passes U-Data / C-Data indications to the concentrator
+ *
+ * @param   rxMsg       received HCI message
+ *
+ * @return  true if the message has been taken by the concentrator
+ *
+ * @endinternal
+ */
+bool WiMODLRBASE::trackConcentrator(TWiMODLR_HCIMessage& rxMsg)
+{
+    TWiMODLR_RadioLink_Msg radioMsg;
+    TWiMODLR_PeerInfo*     peer;
+
+    if (!Concentrator.IsEnabled()) {
+        return false;
+    }
+    if ((rxMsg.MsgID != RADIOLINK_MSG_U_DATA_RX_IND) && (rxMsg.MsgID != RADIOLINK_MSG_C_DATA_RX_IND)) {
+        return false;
+    }
+    if (!SapRadioLink.convert(rxMsg, &radioMsg)) {
+        return false;
+    }
+    switch (Concentrator.OnFrame(radioMsg, millis(), &peer))
+    {
+        case LRBASE_CONC_NEW:
+        case LRBASE_CONC_RESYNC:
+        case LRBASE_CONC_UNTRACKED:
+            // strip the sequence
+            radioMsg.Length -= LRBASE_CONC_HEADER_SIZE;
+            memmove(radioMsg.Payload, &radioMsg.Payload[LRBASE_CONC_HEADER_SIZE], radioMsg.Length);
+            if (concentratorRxCB) {
+                concentratorRxCB(radioMsg, peer);
+            }
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+#endif
+
+#if WIMOD_LR_BASE_USE_LINK_BENCH
+/**
+ * @internal
+ *
+ * @brief passes RadioLink indications to the link benchmark
+ *
+ * @param   rxMsg       received HCI message
+ *
+ * @return  true if the message is a benchmark frame
+ *
+ * @endinternal
+ */
+bool WiMODLRBASE::trackLinkBench(TWiMODLR_HCIMessage& rxMsg)
+{
+    TWiMODLR_RadioLink_Msg      radioMsg;
+    TWiMODLR_RadioLink_UdataInd uDataInd;
+    TWiMODLR_RadioLink_CdataInd cDataInd;
+
+    if (Bench.GetRole() == LRBASE_BENCH_ROLE_OFF) {
+        return false;
+    }
+    switch (rxMsg.MsgID)
+    {
+        case RADIOLINK_MSG_U_DATA_RX_IND:
+        case RADIOLINK_MSG_C_DATA_RX_IND:
+            if (SapRadioLink.convert(rxMsg, &radioMsg)) {
+                return Bench.OnFrame(radioMsg.SourceGroupAddress, radioMsg.SourceDeviceAddress,
+                                     radioMsg.Payload, (UINT8) radioMsg.Length,
+                                     radioMsg.OptionalInfoAvaiable, radioMsg.RSSI, radioMsg.SNR, millis());
+            }
+            break;
+        case RADIOLINK_MSG_U_DATA_TX_IND:
+            if (SapRadioLink.convert(rxMsg, &uDataInd)) {
+                Bench.OnTxInd(uDataInd.TxEventCounter, uDataInd.AirTime, millis());
+            }
+            break;
+        case RADIOLINK_MSG_C_DATA_TX_IND:
+            if (SapRadioLink.convert(rxMsg, &cDataInd)) {
+                Bench.OnTxInd(cDataInd.TxEventCounter, cDataInd.AirTime, millis());
+            }
+            break;
+        case RADIOLINK_MSG_ACK_RX_IND:
+            Bench.OnAck(true, millis());
+            break;
+        case RADIOLINK_MSG_ACK_TIMEOUT_IND:
+            Bench.OnAck(false, millis());
+            break;
+        default:
+            break;
+    }
+    return false;
+}
+
+/**
+ * @internal
+ *
+ * @brief writes the radio settings of a benchmark point (RAM only)
+ *
+ * @param   point       radio settings
+ *
+ * @param   hciResult   Result of the local command transmission to module
+ *
+ * @param   rspStatus   Status byte contained in the local response of the module
+ *
+ * @return  true if the radio config has been written
+ *
+ * @endinternal
+ */
+bool WiMODLRBASE::setBenchRadio(const TWiMODLR_BenchPoint& point, TWiMDLRResultCodes* hciResult, UINT8* rspStatus)
+{
+    TWiMODLR_DevMgmt_RadioConfig radioCfg;
+
+#if WIMOD_LR_BASE_USE_CHANNEL_PLAN
+    if (!ChannelPlan.GetConfig(&radioCfg) && !GetRadioConfig(&radioCfg, hciResult, rspStatus)) {
+        return cmdResult;
+    }
+#else
+    if (!GetRadioConfig(&radioCfg, hciResult, rspStatus)) {
+        return cmdResult;
+    }
+#endif
+    radioCfg.Modulation          = point.Modulation;
+    radioCfg.LoRaBandWidth       = point.LoRaBandWidth;
+    radioCfg.LoRaSpreadingFactor = point.LoRaSpreadingFactor;
+    radioCfg.ErrorCoding         = point.ErrorCoding;
+    radioCfg.FskDatarate         = point.FskDatarate;
+    radioCfg.StoreNwmFlag        = 0;
+    return SetRadioConfig(&radioCfg, hciResult, rspStatus);
+}
+
+/**
+ * @internal
+ *
+ * @brief extracts the benchmark settings of a radio config
+ *
+ * @param   radioCfg    radio config of the module
+ *
+ * @param   point       destination
+ *
+ * @endinternal
+ */
+void WiMODLRBASE::getBenchPoint(const TWiMODLR_DevMgmt_RadioConfig& radioCfg, TWiMODLR_BenchPoint* point)
+{
+    point->Modulation          = radioCfg.Modulation;
+    point->LoRaBandWidth       = radioCfg.LoRaBandWidth;
+    point->LoRaSpreadingFactor = radioCfg.LoRaSpreadingFactor;
+    point->ErrorCoding         = radioCfg.ErrorCoding;
+    point->FskDatarate         = radioCfg.FskDatarate;
 }
+#endif
 
 //-----------------------------------------------------------------------------
 // EOF
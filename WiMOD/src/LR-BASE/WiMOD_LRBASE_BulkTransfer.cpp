@@ -0,0 +1,595 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LRBASE_BulkTransfer.cpp
+//! @ingroup WiMODLR_BASE
+//! <!------------------------------------------------------------------------->
+//! @brief Implementation of the RadioLink bulk transfer
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//!
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "WiMOD_LRBASE_BulkTransfer.h"
+
+#include <string.h>
+
+//------------------------------------------------------------------------------
+//
+// Section local functions
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+static UINT16 getBE16(const UINT8* p)
+{
+    return (UINT16) (((UINT16) p[0] << 8) | p[1]);
+}
+
+static UINT32 getBE32(const UINT8* p)
+{
+    return ((UINT32) p[0] << 24) | ((UINT32) p[1] << 16) | ((UINT32) p[2] << 8) | p[3];
+}
+
+static void putBE16(UINT8* p, UINT16 v)
+{
+    p[0] = (UINT8) (v >> 8);
+    p[1] = (UINT8) v;
+}
+
+static void putBE32(UINT8* p, UINT32 v)
+{
+    p[0] = (UINT8) (v >> 24);
+    p[1] = (UINT8) (v >> 16);
+    p[2] = (UINT8) (v >> 8);
+    p[3] = (UINT8) v;
+}
+//! @endcond
+
+//------------------------------------------------------------------------------
+//
+// Section public functions
+//
+//------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Constructor; default window and timeouts, largest fragment size
+ */
+WiMOD_LRBASE_BulkTransfer::WiMOD_LRBASE_BulkTransfer(void)
+{
+    config.WindowSize    = LRBASE_BULK_DEFAULT_WINDOW;
+    config.FragmentSize  = LRBASE_BULK_MAX_FRAGMENT_SIZE;
+    config.SackTimeoutMs = LRBASE_BULK_DEFAULT_SACK_TIMEOUT_MS;
+    config.TxTimeoutMs   = LRBASE_BULK_DEFAULT_TX_TIMEOUT_MS;
+    config.MaxRetries    = LRBASE_BULK_DEFAULT_MAX_RETRIES;
+
+    nextId      = 0;
+    txSession   = 0;
+    sessionSet  = false;
+    lastId      = 0;
+    lastSession = 0;
+    lastIdValid = false;
+    Abort();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Set window size, fragment size and timeouts
+ *
+ * Out of range values are limited. The new values are used by the next
+ * transfer; the receiver takes the fragment size from the sender.
+ */
+void WiMOD_LRBASE_BulkTransfer::SetConfig(const TWiMODLR_BulkConfig& cfg)
+{
+    config = cfg;
+    if ((config.WindowSize == 0) || (config.WindowSize > LRBASE_BULK_MAX_WINDOW)) {
+        config.WindowSize = LRBASE_BULK_MAX_WINDOW;
+    }
+    if ((config.FragmentSize == 0) || (config.FragmentSize > LRBASE_BULK_MAX_FRAGMENT_SIZE)) {
+        config.FragmentSize = LRBASE_BULK_MAX_FRAGMENT_SIZE;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Set the session of the transfers sent by this node
+ *
+ * The session tells the receiver that the sender has been restarted and
+ * its transfer ids start again; it must differ from the one used before
+ * the restart, e.g. a random number of the platform. If it is not set,
+ * StartSend() derives it from the time of the first transfer.
+ *
+ * @param session   session; used from the next transfer on
+ */
+void WiMOD_LRBASE_BulkTransfer::SetSession(UINT16 session)
+{
+    txSession  = session;
+    sessionSet = true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Start sending a buffer
+ *
+ * The buffer must stay valid until the transfer is done, has failed or
+ * has been aborted.
+ *
+ * @param groupAddress      destination group address
+ * @param deviceAddress     destination device address
+ * @param data              buffer to send
+ * @param length            number of bytes
+ * @param now               current time stamp (ms)
+ *
+ * @retval false    if another transfer is running or the buffer is too large
+ */
+bool WiMOD_LRBASE_BulkTransfer::StartSend(UINT8 groupAddress, UINT16 deviceAddress,
+                                          const UINT8* data, UINT32 length, UINT32 now)
+{
+    UINT32 numFragments = (length + config.FragmentSize - 1) / config.FragmentSize;
+
+    if ((data == NULL) || (length == 0) || (numFragments > 0xFFFF)
+            || (stats.State == LRBASE_BULK_STATE_SENDING)
+            || (stats.State == LRBASE_BULK_STATE_RECEIVING)) {
+        return false;
+    }
+
+    if (!sessionSet) {
+        SetSession((UINT16) (now ^ (now >> 16)));
+    }
+
+    Abort();
+    txData             = data;
+    peerGroup          = groupAddress;
+    peerDevice         = deviceAddress;
+    fragSize           = config.FragmentSize;
+    startTime          = now;
+    stats.State        = LRBASE_BULK_STATE_SENDING;
+    stats.TransferId   = nextId++;
+    stats.NumFragments = (UINT16) numFragments;
+    stats.Length       = length;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Wait for a transfer and reassemble it into a buffer
+ *
+ * The first data frame of an unknown transfer starts the reception.
+ *
+ * @param buffer    receive buffer; must stay valid until the transfer is done
+ * @param size      size of the buffer; a larger transfer fails
+ * @param now       current time stamp (ms)
+ *
+ * @retval false    if another transfer is running
+ */
+bool WiMOD_LRBASE_BulkTransfer::StartReceive(UINT8* buffer, UINT32 size, UINT32 now)
+{
+    if ((buffer == NULL)
+            || (stats.State == LRBASE_BULK_STATE_SENDING)
+            || (stats.State == LRBASE_BULK_STATE_RECEIVING)) {
+        return false;
+    }
+
+    Abort();
+    rxBuffer    = buffer;
+    rxSize      = size;
+    startTime   = now;
+    stats.State = LRBASE_BULK_STATE_RECEIVING;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Stop the current transfer; frames of it are no longer consumed
+ */
+void WiMOD_LRBASE_BulkTransfer::Abort(void)
+{
+    memset(&stats, 0x00, sizeof(stats));
+    stats.State = LRBASE_BULK_STATE_IDLE;
+
+    startTime   = 0;
+    peerGroup   = 0;
+    peerDevice  = 0;
+    fragSize    = config.FragmentSize;
+    txData      = NULL;
+    base        = 0;
+    nextNew     = 0;
+    retxMask    = 0;
+    waitSack    = false;
+    pollTime    = 0;
+    retries     = 0;
+    txBusy      = false;
+    txTime      = 0;
+    rxBuffer    = NULL;
+    rxSize      = 0;
+    rxMask      = 0;
+    rxSession   = 0;
+    idValid     = false;
+    sackPending = false;
+    sackId      = 0;
+    sackSession = 0;
+    sackBase    = 0;
+    sackMask    = 0;
+    frameSeq    = 0;
+    frameType   = 0;
+    frameRetx   = false;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the next frame to send
+ *
+ * The frame must be sent as U-Data to the peer address; OnFrameSent()
+ * must be called if the module has accepted it. Otherwise the same frame
+ * is returned again by the next call.
+ *
+ * @param now       current time stamp (ms)
+ * @param payload   buffer of at least WIMOD_RADIOLINK_PAYLOAD_LEN bytes
+ * @param length    receives the frame length
+ *
+ * @retval true     if a frame is due
+ */
+bool WiMOD_LRBASE_BulkTransfer::GetFrame(UINT32 now, UINT8* payload, UINT8* length)
+{
+    UINT16 seq;
+    bool   retx;
+
+    if (txBusy) {
+        if ((now - txTime) < config.TxTimeoutMs) {
+            return false;
+        }
+        txBusy = false;
+    }
+
+    if (sackPending) {
+        payload[0] = LRBASE_BULK_TYPE_SACK;
+        payload[1] = sackId;
+        putBE16(&payload[2], sackSession);
+        putBE16(&payload[4], sackBase);
+        putBE32(&payload[6], sackMask);
+        *length    = LRBASE_BULK_SACK_SIZE;
+        frameType  = LRBASE_BULK_TYPE_SACK;
+        return true;
+    }
+
+    if (stats.State != LRBASE_BULK_STATE_SENDING) {
+        return false;
+    }
+
+    if (waitSack) {
+        if ((now - pollTime) < config.SackTimeoutMs) {
+            return false;
+        }
+        // poll or SACK lost; ask again with the first missing fragment
+        stats.Timeouts++;
+        if (++retries > config.MaxRetries) {
+            finish(LRBASE_BULK_STATE_FAILED, now);
+            return false;
+        }
+        waitSack  = false;
+        retxMask |= 0x01;
+    }
+
+    if (!nextFragment(&seq, &retx)) {
+        return false;
+    }
+
+    // the last fragment of a burst requests the SACK
+    UINT32 rest   = retxMask & ~(retx ? (1UL << (seq - base)) : 0);
+    UINT32 window = (UINT32) base + config.WindowSize;
+    UINT32 next   = retx ? nextNew : (UINT32) nextNew + 1;
+    bool   poll   = (rest == 0) && ((next >= stats.NumFragments) || (next >= window));
+
+    UINT32 offset = (UINT32) seq * fragSize;
+    UINT32 len    = stats.Length - offset;
+    if (len > fragSize) {
+        len = fragSize;
+    }
+
+    payload[0] = poll ? LRBASE_BULK_TYPE_DATA_POLL : LRBASE_BULK_TYPE_DATA;
+    payload[1] = stats.TransferId;
+    putBE16(&payload[2], txSession);
+    putBE16(&payload[4], seq);
+    payload[6] = fragSize;
+    putBE16(&payload[7], stats.NumFragments);
+    memcpy(&payload[LRBASE_BULK_DATA_HEADER_SIZE], &txData[offset], len);
+    *length    = (UINT8) (LRBASE_BULK_DATA_HEADER_SIZE + len);
+
+    frameType  = payload[0];
+    frameSeq   = seq;
+    frameRetx  = retx;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief The frame returned by GetFrame() has been accepted by the module
+ *
+ * @param now       current time stamp (ms)
+ */
+void WiMOD_LRBASE_BulkTransfer::OnFrameSent(UINT32 now)
+{
+    txBusy = true;
+    txTime = now;
+
+    if (frameType == LRBASE_BULK_TYPE_SACK) {
+        sackPending = false;
+        stats.Sacks++;
+        return;
+    }
+
+    stats.FramesSent++;
+    if (frameRetx) {
+        retxMask &= ~(1UL << (frameSeq - base));
+        stats.Retransmissions++;
+    } else {
+        nextNew++;
+    }
+    if (frameType == LRBASE_BULK_TYPE_DATA_POLL) {
+        waitSack = true;
+        pollTime = now;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief The module has finished a transmission (U-Data TX indication)
+ *
+ * Without TX indications the next frame is sent after TxTimeoutMs.
+ *
+ * @param now       current time stamp (ms)
+ */
+void WiMOD_LRBASE_BulkTransfer::OnTxDone(UINT32 now)
+{
+    txBusy = false;
+    if (waitSack) {
+        // the SACK timeout starts at the end of the poll
+        pollTime = now;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Evaluate a received U-Data frame
+ *
+ * @param srcGroupAddress   source group address of the frame
+ * @param srcDeviceAddress  source device address of the frame
+ * @param payload           payload of the frame
+ * @param length            payload length
+ * @param now               current time stamp (ms)
+ *
+ * @retval true     if the frame belongs to the current transfer
+ */
+bool WiMOD_LRBASE_BulkTransfer::OnFrame(UINT8 srcGroupAddress, UINT16 srcDeviceAddress,
+                                        const UINT8* payload, UINT8 length, UINT32 now)
+{
+    if ((payload == NULL) || (length == 0)) {
+        return false;
+    }
+
+    switch (payload[0])
+    {
+        case LRBASE_BULK_TYPE_DATA:
+        case LRBASE_BULK_TYPE_DATA_POLL:
+            if ((rxBuffer == NULL) || !onData(payload, length, now)) {
+                return false;
+            }
+            // SACKs are sent back to the sender
+            peerGroup  = srcGroupAddress;
+            peerDevice = srcDeviceAddress;
+            return true;
+        case LRBASE_BULK_TYPE_SACK:
+            return (txData != NULL) && onSack(payload, length, now);
+        default:
+            return false;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get state and statistics of the current / last transfer
+ *
+ * @param now       current time stamp (ms)
+ * @param info      pointer where to store the statistics
+ */
+void WiMOD_LRBASE_BulkTransfer::GetStats(UINT32 now, TWiMODLR_BulkStats* info)
+{
+    *info = stats;
+
+    if (((stats.State == LRBASE_BULK_STATE_SENDING) || (stats.State == LRBASE_BULK_STATE_RECEIVING))
+            && (txData || idValid)) {
+        info->DurationMs = now - startTime;
+    }
+
+    if ((stats.NumFragments != 0) && (base >= stats.NumFragments)) {
+        info->BytesDone = stats.Length;
+    } else {
+        info->BytesDone = (UINT32) base * fragSize;
+    }
+
+    info->GoodputBps = 0;
+    if (info->DurationMs) {
+        info->GoodputBps = (UINT32) (((UINT64) info->BytesDone * 8000) / info->DurationMs);
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+// Section private functions
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+bool WiMOD_LRBASE_BulkTransfer::onData(const UINT8* payload, UINT8 length, UINT32 now)
+{
+    if (length < LRBASE_BULK_DATA_HEADER_SIZE) {
+        return false;
+    }
+
+    UINT8  id       = payload[1];
+    UINT16 session  = getBE16(&payload[2]);
+    UINT16 seq      = getBE16(&payload[4]);
+    UINT8  size     = payload[6];
+    UINT16 num      = getBE16(&payload[7]);
+    UINT8  dataLen  = length - LRBASE_BULK_DATA_HEADER_SIZE;
+    bool   poll     = (payload[0] == LRBASE_BULK_TYPE_DATA_POLL);
+
+    if ((stats.State == LRBASE_BULK_STATE_RECEIVING) && !idValid) {
+        if (lastIdValid && (id == lastId) && (session == lastSession) && (num == lastNumFragments)) {
+            // sender has missed the final SACK of the last transfer
+            if (poll) {
+                requestSack(lastId, lastSession, lastNumFragments, 0);
+            }
+            return true;
+        }
+        if ((size == 0) || (num == 0)) {
+            return false;
+        }
+        idValid            = true;
+        rxSession          = session;
+        startTime          = now;
+        fragSize           = size;
+        stats.TransferId   = id;
+        stats.NumFragments = num;
+    } else if (!idValid || (id != stats.TransferId) || (session != rxSession)
+               || ((stats.State != LRBASE_BULK_STATE_RECEIVING) && (stats.State != LRBASE_BULK_STATE_DONE))) {
+        return false;
+    }
+
+    if ((size != fragSize) || (num != stats.NumFragments) || (seq >= num)
+            || ((seq != num - 1) && (dataLen != fragSize))) {
+        // malformed; dropped
+        return true;
+    }
+
+    UINT32 ahead = (UINT32) seq - base;
+    if ((seq < base) || ((ahead > 0) && (ahead <= LRBASE_BULK_MAX_WINDOW) && (rxMask & (1UL << (ahead - 1))))) {
+        stats.Duplicates++;
+    } else if (ahead <= LRBASE_BULK_MAX_WINDOW) {
+        UINT32 offset = (UINT32) seq * fragSize;
+        if ((offset + dataLen) > rxSize) {
+            finish(LRBASE_BULK_STATE_FAILED, now);
+            return true;
+        }
+        memcpy(&rxBuffer[offset], &payload[LRBASE_BULK_DATA_HEADER_SIZE], dataLen);
+        if (seq == num - 1) {
+            stats.Length = offset + dataLen;
+        }
+
+        if (ahead == 0) {
+            // in order; skip all fragments already received behind it
+            base++;
+            while (rxMask & 0x01) {
+                rxMask >>= 1;
+                base++;
+            }
+            rxMask >>= 1;
+        } else {
+            rxMask |= 1UL << (ahead - 1);
+        }
+
+        if (base >= num) {
+            finish(LRBASE_BULK_STATE_DONE, now);
+            lastId           = id;
+            lastSession      = session;
+            lastNumFragments = num;
+            lastIdValid      = true;
+            requestSack(id, session, base, 0);
+        }
+    }
+
+    if (poll) {
+        requestSack(id, session, base, rxMask);
+    }
+    return true;
+}
+
+bool WiMOD_LRBASE_BulkTransfer::onSack(const UINT8* payload, UINT8 length, UINT32 now)
+{
+    if ((length < LRBASE_BULK_SACK_SIZE) || (payload[1] != stats.TransferId)
+            || (getBE16(&payload[2]) != txSession)) {
+        return false;
+    }
+    if (stats.State != LRBASE_BULK_STATE_SENDING) {
+        // duplicate SACK of a finished transfer
+        return true;
+    }
+
+    UINT16 newBase = getBE16(&payload[4]);
+    UINT32 mask    = getBE32(&payload[6]);
+
+    if ((newBase < base) || (newBase > nextNew)) {
+        // outdated
+        return true;
+    }
+
+    stats.Sacks++;
+    base     = newBase;
+    retries  = 0;
+    waitSack = false;
+
+    if (base >= stats.NumFragments) {
+        finish(LRBASE_BULK_STATE_DONE, now);
+        return true;
+    }
+
+    // everything sent before the poll and not in the bitmap is lost
+    retxMask = 0;
+    for (UINT16 seq = base; seq < nextNew; seq++) {
+        UINT16 n = seq - base;
+        if ((n == 0) || !(mask & (1UL << (n - 1)))) {
+            retxMask |= 1UL << n;
+        }
+    }
+    return true;
+}
+
+void WiMOD_LRBASE_BulkTransfer::finish(TWiMODLR_BulkState state, UINT32 now)
+{
+    stats.State      = state;
+    stats.DurationMs = now - startTime;
+    waitSack         = false;
+}
+
+void WiMOD_LRBASE_BulkTransfer::requestSack(UINT8 id, UINT16 ackSession, UINT16 ackBase, UINT32 ackMask)
+{
+    sackPending = true;
+    sackId      = id;
+    sackSession = ackSession;
+    sackBase    = ackBase;
+    sackMask    = ackMask;
+}
+
+bool WiMOD_LRBASE_BulkTransfer::nextFragment(UINT16* seq, bool* retx) const
+{
+    if (retxMask) {
+        UINT8 n = 0;
+        while (!(retxMask & (1UL << n))) {
+            n++;
+        }
+        *seq  = base + n;
+        *retx = true;
+        return true;
+    }
+    if ((nextNew < stats.NumFragments) && ((UINT32) nextNew < (UINT32) base + config.WindowSize)) {
+        *seq  = nextNew;
+        *retx = false;
+        return true;
+    }
+    return false;
+}
+//! @endcond
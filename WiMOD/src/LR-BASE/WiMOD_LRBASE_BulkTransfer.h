@@ -0,0 +1,218 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LRBASE_BulkTransfer.h
+//! @ingroup WiMODLR_BASE
+//! <!------------------------------------------------------------------------->
+//! @brief Declarations for the RadioLink bulk transfer
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//! Moves a buffer larger than one radio frame between two LR-BASE nodes
+//! using fragments, a sliding window and selective acknowledgements.
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+
+#ifndef ARDUINO_WIMOD_LRBASE_BULKTRANSFER_H_
+#define ARDUINO_WIMOD_LRBASE_BULKTRANSFER_H_
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "../SAP/WiMOD_SAP_RadioLink_IDs.h"
+
+//------------------------------------------------------------------------------
+//
+// Section defines
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+/*
+ * Frame layout (first payload byte = frame type):
+ *
+ *  DATA / DATA_POLL : [type] [id] [session u16] [seq u16] [fragment size] [num fragments u16] [data]
+ *  SACK             : [type] [id] [session u16] [base u16] [bitmap u32]
+ *
+ *  big endian; base = first fragment not yet received; bit n of the bitmap
+ *  is set if fragment base + 1 + n has been received. DATA_POLL asks the
+ *  receiver for a SACK. The session is chosen by the sender once per boot,
+ *  so the ids of a restarted sender do not match the transfers before.
+ */
+#define LRBASE_BULK_TYPE_DATA                       0xB1
+#define LRBASE_BULK_TYPE_DATA_POLL                  0xB2
+#define LRBASE_BULK_TYPE_SACK                       0xB3
+
+#define LRBASE_BULK_DATA_HEADER_SIZE                9
+#define LRBASE_BULK_SACK_SIZE                       10
+
+#define LRBASE_BULK_MAX_FRAGMENT_SIZE               (WIMOD_RADIOLINK_PAYLOAD_LEN - LRBASE_BULK_DATA_HEADER_SIZE)
+#define LRBASE_BULK_MAX_WINDOW                      32
+
+#define LRBASE_BULK_DEFAULT_WINDOW                  8
+#define LRBASE_BULK_DEFAULT_SACK_TIMEOUT_MS         4000
+#define LRBASE_BULK_DEFAULT_TX_TIMEOUT_MS           3000
+#define LRBASE_BULK_DEFAULT_MAX_RETRIES             5
+//! @endcond
+
+//------------------------------------------------------------------------------
+//
+// Section types
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief State of the bulk transfer
+ */
+typedef enum TWiMODLR_BulkState
+{
+    LRBASE_BULK_STATE_IDLE = 0,                                                 /*!< no transfer */
+    LRBASE_BULK_STATE_SENDING,                                                  /*!< fragments are sent */
+    LRBASE_BULK_STATE_RECEIVING,                                                /*!< waiting for / receiving fragments */
+    LRBASE_BULK_STATE_DONE,                                                     /*!< buffer completely sent / received */
+    LRBASE_BULK_STATE_FAILED,                                                   /*!< no SACK after MaxRetries polls or buffer too small */
+} TWiMODLR_BulkState;
+
+/**
+ * @brief Configuration of the bulk transfer
+ */
+typedef struct TWiMODLR_BulkConfig
+{
+    UINT8       WindowSize;                                                     /*!< fragments sent before a SACK is requested (max. 32) */
+    UINT8       FragmentSize;                                                   /*!< data bytes per fragment (max. LRBASE_BULK_MAX_FRAGMENT_SIZE) */
+    UINT16      SackTimeoutMs;                                                  /*!< time to wait for a SACK after the poll has been sent */
+    UINT16      TxTimeoutMs;                                                    /*!< max. time to wait for a TX indication */
+    UINT8       MaxRetries;                                                     /*!< polls without answer before the transfer fails */
+} TWiMODLR_BulkConfig;
+
+/**
+ * @brief Status and statistics of the current / last transfer
+ */
+typedef struct TWiMODLR_BulkStats
+{
+    TWiMODLR_BulkState  State;                                                  /*!< transfer state */
+    UINT8               TransferId;                                             /*!< id of the transfer */
+    UINT16              NumFragments;                                           /*!< fragments of the buffer */
+    UINT32              Length;                                                 /*!< bytes of the buffer; receiver: known with the last fragment */
+    UINT32              BytesDone;                                              /*!< bytes acked (sender) / received in order (receiver) */
+    UINT32              FramesSent;                                             /*!< data frames incl. retransmissions */
+    UINT32              Retransmissions;                                        /*!< retransmitted data frames */
+    UINT32              Duplicates;                                             /*!< data frames received twice */
+    UINT32              Sacks;                                                  /*!< SACKs sent / received */
+    UINT32              Timeouts;                                               /*!< polls without SACK */
+    UINT32              DurationMs;                                             /*!< start until done / now */
+    UINT32              GoodputBps;                                             /*!< BytesDone * 8 / DurationMs in bit/s */
+} TWiMODLR_BulkStats;
+
+//------------------------------------------------------------------------------
+//
+// Section class
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Fragmentation, sliding window and selective acknowledgements
+ *
+ * The sender streams up to WindowSize fragments as U-Data; the last one
+ * of each burst is a DATA_POLL. The receiver answers a poll with a SACK
+ * that holds the first missing fragment and a bitmap of the following 32
+ * fragments. Only the fragments missing in the SACK are sent again; a poll
+ * without answer is repeated with the first missing fragment.
+ *
+ * The receiver writes each fragment directly to its position in the
+ * buffer given by the caller; fragments may arrive in any order.
+ *
+ * The class only builds and evaluates the frames; the frames are sent
+ * and received by the WiMODLRBASE class.
+ */
+class WiMOD_LRBASE_BulkTransfer
+{
+public:
+    WiMOD_LRBASE_BulkTransfer(void);
+
+    void                SetConfig(const TWiMODLR_BulkConfig& config);
+    const TWiMODLR_BulkConfig& GetConfig(void) const { return config; }
+
+    void                SetSession(UINT16 session);
+    bool                IsSessionSet(void) const { return sessionSet; }
+
+    bool                StartSend(UINT8 groupAddress, UINT16 deviceAddress,
+                                  const UINT8* data, UINT32 length, UINT32 now);
+    bool                StartReceive(UINT8* buffer, UINT32 size, UINT32 now);
+    void                Abort(void);
+
+    bool                GetFrame(UINT32 now, UINT8* payload, UINT8* length);
+    void                OnFrameSent(UINT32 now);
+    void                OnTxDone(UINT32 now);
+    bool                OnFrame(UINT8 srcGroupAddress, UINT16 srcDeviceAddress,
+                                const UINT8* payload, UINT8 length, UINT32 now);
+
+    UINT8               GetPeerGroupAddress(void) const { return peerGroup; }
+    UINT16              GetPeerDeviceAddress(void) const { return peerDevice; }
+    TWiMODLR_BulkState  GetState(void) const { return stats.State; }
+
+    void                GetStats(UINT32 now, TWiMODLR_BulkStats* stats);
+
+private:
+    //! @cond Doxygen_Suppress
+    bool                onData(const UINT8* payload, UINT8 length, UINT32 now);
+    bool                onSack(const UINT8* payload, UINT8 length, UINT32 now);
+    void                finish(TWiMODLR_BulkState state, UINT32 now);
+    void                requestSack(UINT8 id, UINT16 ackSession, UINT16 ackBase, UINT32 ackMask);
+    bool                nextFragment(UINT16* seq, bool* retx) const;
+
+    TWiMODLR_BulkConfig config;
+    TWiMODLR_BulkStats  stats;
+    UINT32              startTime;
+
+    UINT8               peerGroup;
+    UINT16              peerDevice;
+    UINT8               nextId;
+    UINT16              txSession;                                              // own session; chosen once per boot
+    bool                sessionSet;
+    UINT8               fragSize;
+
+    // sender
+    const UINT8*        txData;
+    UINT16              base;                                                   // first fragment not acked / not received
+    UINT16              nextNew;                                                // next fragment never sent
+    UINT32              retxMask;                                               // bit n: fragment base + n to be sent again
+    bool                waitSack;
+    UINT32              pollTime;
+    UINT8               retries;
+    bool                txBusy;
+    UINT32              txTime;
+
+    // receiver
+    UINT8*              rxBuffer;
+    UINT32              rxSize;
+    UINT32              rxMask;                                                 // bit n: fragment base + 1 + n received
+    UINT16              rxSession;                                              // session of the sender
+    bool                idValid;
+    UINT8               lastId;                                                 // id of the last completed transfer
+    UINT16              lastSession;
+    UINT16              lastNumFragments;
+    bool                lastIdValid;
+
+    // SACK to send; snapshot taken when the poll has been received
+    bool                sackPending;
+    UINT8               sackId;
+    UINT16              sackSession;
+    UINT16              sackBase;
+    UINT32              sackMask;
+
+    // frame handed out by GetFrame() until OnFrameSent()
+    UINT16              frameSeq;
+    UINT8               frameType;
+    bool                frameRetx;
+    //! @endcond
+};
+
+#endif /* ARDUINO_WIMOD_LRBASE_BULKTRANSFER_H_ */
@@ -0,0 +1,217 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LRBASE_ChannelPlan.cpp
+//! @ingroup WiMODLR_BASE
+//! <!------------------------------------------------------------------------->
+//! @brief Implementation of the channel plan / fast retune
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//!
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "WiMOD_LRBASE_ChannelPlan.h"
+
+#include <string.h>
+
+//------------------------------------------------------------------------------
+//
+// Section public functions
+//
+//------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Constructor; empty plan, no cached config
+ */
+WiMOD_LRBASE_ChannelPlan::WiMOD_LRBASE_ChannelPlan(void)
+{
+    plan        = NULL;
+    numChannels = 0;
+    channel     = LRBASE_CHANNEL_NONE;
+    configValid = false;
+    memset(&config, 0x00, sizeof(config));
+    ResetStats();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Set the channel plan
+ *
+ * @param channels      channel table; must stay valid while it is used
+ * @param numChannels   number of entries
+ */
+void WiMOD_LRBASE_ChannelPlan::SetPlan(const TWiMODLR_Channel* channels, UINT8 numChannels)
+{
+    plan              = channels;
+    this->numChannels = (channels != NULL) ? numChannels : 0;
+    channel           = configValid ? lookup(config.RfFreq_MSB, config.RfFreq_MID, config.RfFreq_LSB)
+                                    : LRBASE_CHANNEL_NONE;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief A radio config has been read from or written to the module
+ *
+ * @param radioCfg      the config now active in the module
+ * @param read          true if the config has been read to fill the cache
+ */
+void WiMOD_LRBASE_ChannelPlan::OnConfig(const TWiMODLR_DevMgmt_RadioConfig& radioCfg, bool read)
+{
+    config      = radioCfg;
+    configValid = true;
+    channel     = lookup(config.RfFreq_MSB, config.RfFreq_MID, config.RfFreq_LSB);
+    if (read) {
+        stats.ConfigReads++;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief The radio config of the module is unknown (e.g. after a reset)
+ */
+void WiMOD_LRBASE_ChannelPlan::InvalidateConfig(void)
+{
+    configValid = false;
+    channel     = LRBASE_CHANNEL_NONE;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get a copy of the cached radio config
+ *
+ * @param radioCfg  destination
+ *
+ * @retval false    if no valid config is cached
+ */
+bool WiMOD_LRBASE_ChannelPlan::GetConfig(TWiMODLR_DevMgmt_RadioConfig* radioCfg) const
+{
+    if (!configValid || (radioCfg == NULL)) {
+        return false;
+    }
+    *radioCfg = config;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Build the RAM-only radio config for a channel
+ *
+ * @param index     channel of the plan
+ * @param radioCfg  receives the cached config with the registers of the channel
+ *
+ * @retval false    if the channel does not exist or no config is cached
+ */
+bool WiMOD_LRBASE_ChannelPlan::Prepare(UINT8 index, TWiMODLR_DevMgmt_RadioConfig* radioCfg)
+{
+    if ((index >= numChannels) || !configValid || (radioCfg == NULL)) {
+        return false;
+    }
+    *radioCfg              = config;
+    radioCfg->StoreNwmFlag = 0;
+    radioCfg->RfFreq_MSB   = plan[index].RfFreq_MSB;
+    radioCfg->RfFreq_MID   = plan[index].RfFreq_MID;
+    radioCfg->RfFreq_LSB   = plan[index].RfFreq_LSB;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief A retune has been requested for the current channel
+ */
+void WiMOD_LRBASE_ChannelPlan::OnSkipped(void)
+{
+    stats.Skipped++;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief The RAM-only config of Prepare() has been sent
+ *
+ * @param index         channel of the plan
+ * @param ok            true if the module has accepted the config
+ * @param latencyUs     time from request to response
+ */
+void WiMOD_LRBASE_ChannelPlan::OnRetuneDone(UINT8 index, bool ok, UINT32 latencyUs)
+{
+    if (!ok || (index >= numChannels)) {
+        // the module may or may not have taken the config
+        stats.Failures++;
+        InvalidateConfig();
+        return;
+    }
+
+    config.RfFreq_MSB = plan[index].RfFreq_MSB;
+    config.RfFreq_MID = plan[index].RfFreq_MID;
+    config.RfFreq_LSB = plan[index].RfFreq_LSB;
+    channel           = index;
+
+    stats.Retunes++;
+    stats.LastUs = latencyUs;
+    if (latencyUs < stats.MinUs) {
+        stats.MinUs = latencyUs;
+    }
+    if (latencyUs > stats.MaxUs) {
+        stats.MaxUs = latencyUs;
+    }
+    // running mean; no sum that could overflow
+    stats.AvgUs += (INT32) (latencyUs - stats.AvgUs) / (INT32) stats.Retunes;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the counters and the retune latency
+ *
+ * @param info      pointer where to store the statistics
+ */
+void WiMOD_LRBASE_ChannelPlan::GetStats(TWiMODLR_RetuneStats* info) const
+{
+    *info         = stats;
+    info->Channel = channel;
+    if (stats.Retunes == 0) {
+        info->MinUs = 0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Clear the counters and the latency values
+ */
+void WiMOD_LRBASE_ChannelPlan::ResetStats(void)
+{
+    memset(&stats, 0x00, sizeof(stats));
+    stats.MinUs = 0xFFFFFFFF;
+}
+
+//------------------------------------------------------------------------------
+//
+// Section private functions
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+UINT8 WiMOD_LRBASE_ChannelPlan::lookup(UINT8 msb, UINT8 mid, UINT8 lsb) const
+{
+    UINT8 i;
+
+    for (i = 0; i < numChannels; i++) {
+        if ((plan[i].RfFreq_MSB == msb) && (plan[i].RfFreq_MID == mid) && (plan[i].RfFreq_LSB == lsb)) {
+            return i;
+        }
+    }
+    return LRBASE_CHANNEL_NONE;
+}
+//! @endcond
@@ -0,0 +1,155 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LRBASE_ChannelPlan.h
+//! @ingroup WiMODLR_BASE
+//! <!------------------------------------------------------------------------->
+//! @brief Declarations for the channel plan / fast retune
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//! Channel plan with precalculated frequency registers and the cached
+//! radio config used for fast RAM-only retuning.
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+
+#ifndef ARDUINO_WIMOD_LRBASE_CHANNELPLAN_H_
+#define ARDUINO_WIMOD_LRBASE_CHANNELPLAN_H_
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "../SAP/WiMOD_SAP_DEVMGMT_IDs.h"
+#include "../utils/FreqCalc.h"
+
+#include <stddef.h>
+
+//------------------------------------------------------------------------------
+//
+// Section defines
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Channel plan entry; the registers are calculated by the compiler
+ *
+ * @code
+ * static const TWiMODLR_Channel plan[] = {
+ *     LRBASE_CHANNEL(868100000),
+ *     LRBASE_CHANNEL(868300000),
+ *     LRBASE_CHANNEL(868500000),
+ * };
+ * @endcode
+ */
+#define LRBASE_CHANNEL(freq)        { (UINT32) (freq), FREQCALC_FRF_MSB(freq), FREQCALC_FRF_MID(freq), FREQCALC_FRF_LSB(freq) }
+
+//! @cond Doxygen_Suppress
+#define LRBASE_CHANNEL_NONE         0xFF
+//! @endcond
+
+//------------------------------------------------------------------------------
+//
+// Section types
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Frequency and transceiver registers of a channel
+ */
+typedef struct TWiMODLR_Channel
+{
+    UINT32      Frequency;                                                      /*!< RF frequency in Hz */
+    UINT8       RfFreq_MSB;                                                     /*!< high part of the frequency register */
+    UINT8       RfFreq_MID;                                                     /*!< mid part of the frequency register */
+    UINT8       RfFreq_LSB;                                                     /*!< lower part of the frequency register */
+} TWiMODLR_Channel;
+
+#ifdef WIMOD_USE_CPP11
+/**
+ * @brief Channel plan entry as constexpr function (C++11 only)
+ *
+ * @param freq  RF frequency in Hz
+ */
+constexpr TWiMODLR_Channel LRBASE_Channel(UINT32 freq)
+{
+    return TWiMODLR_Channel LRBASE_CHANNEL(freq);
+}
+#endif
+
+/**
+ * @brief Retune counters and latency
+ *
+ * The latency is the time of the RAM-only SetRadioConfig request until the
+ * response of the module.
+ */
+typedef struct TWiMODLR_RetuneStats
+{
+    UINT8       Channel;                                                        /*!< current channel; LRBASE_CHANNEL_NONE if unknown */
+    UINT32      Retunes;                                                        /*!< successful retunes */
+    UINT32      Skipped;                                                        /*!< requests for the current channel */
+    UINT32      Failures;                                                       /*!< failed retunes */
+    UINT32      ConfigReads;                                                    /*!< radio config requests to fill the cache */
+    UINT32      LastUs;                                                         /*!< latency of the last retune */
+    UINT32      MinUs;                                                          /*!< min. latency */
+    UINT32      MaxUs;                                                          /*!< max. latency */
+    UINT32      AvgUs;                                                          /*!< mean latency */
+} TWiMODLR_RetuneStats;
+
+//------------------------------------------------------------------------------
+//
+// Section class
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Channel plan and cache of the applied radio config
+ *
+ * A retune only replaces the frequency registers of the cached config; the
+ * config has not to be read from the module again and is never stored in
+ * NVM. The cache is updated by every radio config that is read from or
+ * written to the module.
+ */
+class WiMOD_LRBASE_ChannelPlan
+{
+public:
+    WiMOD_LRBASE_ChannelPlan(void);
+
+    void                SetPlan(const TWiMODLR_Channel* channels, UINT8 numChannels);
+    UINT8               GetNumChannels(void) const { return numChannels; }
+    UINT8               GetChannel(void) const { return channel; }
+
+    bool                HasConfig(void) const { return configValid; }
+    bool                GetConfig(TWiMODLR_DevMgmt_RadioConfig* radioCfg) const;
+    void                OnConfig(const TWiMODLR_DevMgmt_RadioConfig& radioCfg, bool read);
+    void                InvalidateConfig(void);
+
+    bool                Prepare(UINT8 index, TWiMODLR_DevMgmt_RadioConfig* radioCfg);
+    void                OnSkipped(void);
+    void                OnRetuneDone(UINT8 index, bool ok, UINT32 latencyUs);
+
+    void                GetStats(TWiMODLR_RetuneStats* stats) const;
+    void                ResetStats(void);
+
+private:
+    //! @cond Doxygen_Suppress
+    UINT8               lookup(UINT8 msb, UINT8 mid, UINT8 lsb) const;
+
+    const TWiMODLR_Channel* plan;
+    UINT8               numChannels;
+    UINT8               channel;
+
+    TWiMODLR_DevMgmt_RadioConfig config;
+    bool                configValid;
+
+    TWiMODLR_RetuneStats stats;
+    //! @endcond
+};
+
+#endif /* ARDUINO_WIMOD_LRBASE_CHANNELPLAN_H_ */
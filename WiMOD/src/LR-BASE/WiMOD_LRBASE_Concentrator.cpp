@@ -0,0 +1,375 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LRBASE_Concentrator.cpp
+//! @ingroup WiMODLR_BASE
+//! <!------------------------------------------------------------------------->
+//! @brief Implementation of the concentrator receive path
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//!
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "WiMOD_LRBASE_Concentrator.h"
+
+#include <string.h>
+
+//------------------------------------------------------------------------------
+//
+// Section local functions
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+static UINT32 makeKey(UINT8 groupAddress, UINT16 deviceAddress)
+{
+    // bit 24 keeps the key of address 0/0 different from a free entry
+    return ((UINT32) 1 << 24) | ((UINT32) groupAddress << 16) | deviceAddress;
+}
+
+static INT16 average(INT16 avg, INT16 value)
+{
+    // exponential average in 1/16 units
+    return (INT16) (avg + ((((INT16) (value * 16)) - avg) >> LRBASE_CONC_AVG_SHIFT));
+}
+//! @endcond
+
+//------------------------------------------------------------------------------
+//
+// Section public functions
+//
+//------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Constructor; concentrator disabled
+ */
+WiMOD_LRBASE_Concentrator::WiMOD_LRBASE_Concentrator(void)
+{
+    resyncAgeMs = LRBASE_CONC_DEFAULT_RESYNC_AGE_MS;
+    End();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Start tracking sources in a peer table
+ *
+ * @param table     table memory; must stay valid until End()
+ * @param entries   number of entries; a power of two, at least 2
+ *
+ * @retval false    if the table is missing or its size is invalid
+ */
+bool WiMOD_LRBASE_Concentrator::Begin(TWiMODLR_PeerInfo* table, UINT32 entries)
+{
+    if ((table == NULL) || (entries < 2) || ((entries & (entries - 1)) != 0)) {
+        return false;
+    }
+    memset(table, 0x00, entries * sizeof(TWiMODLR_PeerInfo));
+
+    peers     = table;
+    mask      = entries - 1;
+    hashShift = 32;
+    while (entries > 1) {
+        entries >>= 1;
+        hashShift--;
+    }
+    maxPeers  = (UINT32) (((UINT64) (mask + 1) * LRBASE_CONC_MAX_LOAD_PERCENT) / 100);
+    if (maxPeers == 0) {
+        maxPeers = 1;
+    }
+    memset(&stats, 0x00, sizeof(stats));
+    stats.Capacity = maxPeers;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Stop tracking; the table is no longer used
+ */
+void WiMOD_LRBASE_Concentrator::End(void)
+{
+    peers     = NULL;
+    mask      = 0;
+    hashShift = 32;
+    maxPeers  = 0;
+    memset(&stats, 0x00, sizeof(stats));
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Check a received U-Data / C-Data frame
+ *
+ * The first payload byte is the sequence of the sender. A frame is
+ * delivered if it is newer than the last delivered frame of its source;
+ * a step back of more than LRBASE_CONC_HISTORY frames, or any step back
+ * after a silence longer than the resync age, is taken as a restart of
+ * the sender.
+ *
+ * @param msg       received frame
+ * @param now       host time of reception (ms)
+ * @param peer      set to the entry of the source; NULL if untracked
+ *
+ * @return LRBASE_CONC_NEW, _RESYNC or _UNTRACKED if the frame is to be delivered
+ */
+TWiMODLR_ConcResult WiMOD_LRBASE_Concentrator::OnFrame(const TWiMODLR_RadioLink_Msg& msg, UINT32 now, TWiMODLR_PeerInfo** peer)
+{
+    TWiMODLR_PeerInfo*  p;
+    TWiMODLR_ConcResult result;
+    UINT8               seq;
+    UINT8               diff;
+    bool                stale;
+
+    if (peer) {
+        *peer = NULL;
+    }
+    stats.Frames++;
+    if (msg.Length < LRBASE_CONC_HEADER_SIZE) {
+        stats.Invalid++;
+        return LRBASE_CONC_INVALID;
+    }
+    seq = msg.Payload[0];
+
+    p = lookup(makeKey(msg.SourceGroupAddress, msg.SourceDeviceAddress), true);
+    if (p == NULL) {
+        stats.Untracked++;
+        stats.Delivered++;
+        return LRBASE_CONC_UNTRACKED;
+    }
+    if (peer) {
+        *peer = p;
+    }
+
+    if (p->Frames == 0) {
+        // first frame of this source
+        p->GroupAddress  = msg.SourceGroupAddress;
+        p->DeviceAddress = msg.SourceDeviceAddress;
+        p->History       = 0;
+        result           = LRBASE_CONC_NEW;
+    } else {
+        diff  = (UINT8) (seq - p->LastSequence);
+        stale = ((UINT32) (now - p->LastSeen) > resyncAgeMs);
+        if ((diff == 0) && !stale) {
+            p->Duplicates++;
+            stats.Duplicates++;
+            return LRBASE_CONC_DUPLICATE;
+        }
+        if ((diff != 0) && (diff <= LRBASE_CONC_MAX_GAP)) {
+            // newer frame; shift the history and count the gap
+            p->History = (diff >= LRBASE_CONC_HISTORY)
+                            ? 0
+                            : (UINT16) ((p->History << diff) | (1 << (diff - 1)));
+            p->Lost   += (UINT16) (diff - 1);
+            result     = LRBASE_CONC_NEW;
+        } else {
+            // a step back after a long silence is a restart as well
+            diff = (UINT8) (p->LastSequence - seq);
+            if ((diff <= LRBASE_CONC_HISTORY) && !stale) {
+                if (p->History & (1 << (diff - 1))) {
+                    p->Duplicates++;
+                    stats.Duplicates++;
+                    return LRBASE_CONC_DUPLICATE;
+                }
+                p->Late++;
+                stats.Late++;
+                return LRBASE_CONC_LATE;
+            }
+            p->History = 0;
+            p->Resyncs++;
+            result     = LRBASE_CONC_RESYNC;
+        }
+    }
+
+    p->LastSequence = seq;
+    p->LastSeen     = now;
+    if (msg.OptionalInfoAvaiable) {
+        if (p->Frames == 0) {
+            p->AvgRSSI = (INT16) (msg.RSSI * 16);
+            p->AvgSNR  = (INT16) (msg.SNR * 16);
+        } else {
+            p->AvgRSSI = average(p->AvgRSSI, msg.RSSI);
+            p->AvgSNR  = average(p->AvgSNR, msg.SNR);
+        }
+        p->LastRSSI = msg.RSSI;
+        p->LastSNR  = msg.SNR;
+    }
+    p->Frames++;
+    stats.Delivered++;
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the state of a source
+ *
+ * @param groupAddress  source group address
+ * @param deviceAddress source device address
+ *
+ * @return entry of the source; NULL if the source is not tracked
+ */
+const TWiMODLR_PeerInfo* WiMOD_LRBASE_Concentrator::Find(UINT8 groupAddress, UINT16 deviceAddress) const
+{
+    return const_cast<WiMOD_LRBASE_Concentrator*>(this)->lookup(makeKey(groupAddress, deviceAddress), false);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Iterate over all tracked sources
+ *
+ * @param iterator  position; set to 0 for the first call
+ *
+ * @return next entry; NULL at the end of the table
+ */
+const TWiMODLR_PeerInfo* WiMOD_LRBASE_Concentrator::GetNext(UINT32* iterator) const
+{
+    if ((peers == NULL) || (iterator == NULL)) {
+        return NULL;
+    }
+    while (*iterator <= mask) {
+        const TWiMODLR_PeerInfo* p = &peers[(*iterator)++];
+        if (p->Key != 0) {
+            return p;
+        }
+    }
+    return NULL;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Remove sources that have not been heard for a while
+ *
+ * Walks over the whole table; call it from time to time from the main
+ * loop, not from a callback.
+ *
+ * @param now       current host time (ms)
+ * @param maxAgeMs  max. time since the last frame of a source
+ *
+ * @return number of removed entries
+ */
+UINT32 WiMOD_LRBASE_Concentrator::Expire(UINT32 now, UINT32 maxAgeMs)
+{
+    UINT32 removed = 0;
+    UINT32 i;
+
+    if (peers == NULL) {
+        return 0;
+    }
+    for (i = 0; i <= mask; i++) {
+        // remove() may move another entry into this slot; check it again
+        while ((peers[i].Key != 0) && ((UINT32) (now - peers[i].LastSeen) > maxAgeMs)) {
+            remove(i);
+            removed++;
+        }
+    }
+    stats.Expired += removed;
+    return removed;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the counters of the concentrator
+ *
+ * @param stats     pointer where to store the counters
+ */
+void WiMOD_LRBASE_Concentrator::GetStats(TWiMODLR_ConcentratorStats* stats) const
+{
+    if (stats) {
+        *stats = this->stats;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Reset the counters; the peer table is kept
+ */
+void WiMOD_LRBASE_Concentrator::ResetStats(void)
+{
+    UINT32 used = stats.Peers;
+
+    memset(&stats, 0x00, sizeof(stats));
+    stats.Peers    = used;
+    stats.Capacity = maxPeers;
+}
+
+//------------------------------------------------------------------------------
+//
+// Section private functions
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+UINT32 WiMOD_LRBASE_Concentrator::home(UINT32 key) const
+{
+    // multiplicative hashing; the upper bits are the best mixed
+    return (UINT32) (key * 2654435761UL) >> hashShift;
+}
+
+TWiMODLR_PeerInfo* WiMOD_LRBASE_Concentrator::lookup(UINT32 key, bool insert)
+{
+    UINT32 i;
+    UINT32 probe;
+
+    if (peers == NULL) {
+        return NULL;
+    }
+    i = home(key) & mask;
+    for (probe = 1; ; probe++) {
+        if (peers[i].Key == key) {
+            break;
+        }
+        if (peers[i].Key == 0) {
+            // not found; the load limit guarantees a free entry
+            if (!insert || (stats.Peers >= maxPeers)) {
+                return NULL;
+            }
+            memset(&peers[i], 0x00, sizeof(TWiMODLR_PeerInfo));
+            peers[i].Key = key;
+            stats.Peers++;
+            break;
+        }
+        i = (i + 1) & mask;
+    }
+    if (probe > stats.MaxProbe) {
+        stats.MaxProbe = probe;
+    }
+    return &peers[i];
+}
+
+void WiMOD_LRBASE_Concentrator::remove(UINT32 index)
+{
+    UINT32 next = index;
+    UINT32 h;
+
+    // backward shift deletion: no tombstones, probe sequences stay short
+    for (;;) {
+        next = (next + 1) & mask;
+        if (peers[next].Key == 0) {
+            break;
+        }
+        h = home(peers[next].Key) & mask;
+        // move the entry if its home is not within (index, next]
+        if (((next - h) & mask) >= ((next - index) & mask)) {
+            peers[index] = peers[next];
+            index        = next;
+        }
+    }
+    peers[index].Key = 0;
+    stats.Peers--;
+}
+//! @endcond
+
+//-----------------------------------------------------------------------------
+// EOF
+//-----------------------------------------------------------------------------
@@ -0,0 +1,201 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LRBASE_Concentrator.h
+//! @ingroup WiMODLR_BASE
+//! <!------------------------------------------------------------------------->
+//! @brief Declarations for the concentrator receive path
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//! Per-source sequence tracking and de-duplication of received RadioLink
+//! frames in a fixed size open-addressing table.
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+
+#ifndef ARDUINO_WIMOD_LRBASE_CONCENTRATOR_H_
+#define ARDUINO_WIMOD_LRBASE_CONCENTRATOR_H_
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "../SAP/WiMOD_SAP_RadioLink_IDs.h"
+
+#include <stddef.h>
+
+/*
+ * C++11 supports a better way for function pointers / function objects
+ * But C++11 mode is not supported by all platforms.
+ */
+#ifdef WIMOD_USE_CPP11
+#include <functional>
+#endif
+
+//------------------------------------------------------------------------------
+//
+// Section defines
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+/*
+ * Frame layout (U-Data and C-Data):
+ *
+ *  [sequence] [application payload]
+ *
+ *  The sender increments the sequence for every new frame; the module
+ *  repeats the same payload for its own C-Data retransmissions, so a
+ *  retransmission whose ack got lost arrives with the previous sequence.
+ */
+#define LRBASE_CONC_HEADER_SIZE                     1
+
+#define LRBASE_CONC_HISTORY                         16                          // bits of TWiMODLR_PeerInfo::History
+#define LRBASE_CONC_MAX_GAP                         127                         // larger steps are a restart of the sender
+#define LRBASE_CONC_DEFAULT_RESYNC_AGE_MS           60000                       // any step back after this silence is a restart
+#define LRBASE_CONC_MAX_LOAD_PERCENT                75
+#define LRBASE_CONC_AVG_SHIFT                       3                           // RSSI/SNR average: 1/8 of the new value
+//! @endcond
+
+//------------------------------------------------------------------------------
+//
+// Section types
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Result of the concentrator for a received frame
+ */
+typedef enum TWiMODLR_ConcResult
+{
+    LRBASE_CONC_NEW = 0,                                                        /*!< next frame of the source; delivered */
+    LRBASE_CONC_RESYNC,                                                         /*!< sender restarted its sequence; delivered */
+    LRBASE_CONC_UNTRACKED,                                                      /*!< table full; delivered without duplicate check */
+    LRBASE_CONC_DUPLICATE,                                                      /*!< already delivered; dropped */
+    LRBASE_CONC_LATE,                                                           /*!< older than the last delivered frame; dropped */
+    LRBASE_CONC_INVALID,                                                        /*!< no sequence field; dropped */
+} TWiMODLR_ConcResult;
+
+/**
+ * @brief State of a single source (one entry of the peer table)
+ */
+typedef struct TWiMODLR_PeerInfo
+{
+    UINT32      Key;                                                            /*!< internal: 0 = free entry */
+    UINT32      LastSeen;                                                       /*!< host time of the last frame (ms) */
+    UINT32      Frames;                                                         /*!< delivered frames */
+    UINT16      DeviceAddress;                                                  /*!< source device address */
+    UINT8       GroupAddress;                                                   /*!< source group address */
+    UINT8       LastSequence;                                                   /*!< sequence of the last delivered frame */
+    UINT16      History;                                                        /*!< bit n: LastSequence - 1 - n has been received */
+    UINT16      Duplicates;                                                     /*!< dropped duplicates */
+    UINT16      Late;                                                           /*!< dropped out of order frames */
+    UINT16      Lost;                                                           /*!< sequence gaps */
+    INT16       LastRSSI;                                                       /*!< RSSI of the last frame (dBm) */
+    INT16       AvgRSSI;                                                        /*!< average RSSI (1/16 dBm) */
+    INT8        LastSNR;                                                        /*!< SNR of the last frame (dB) */
+    UINT8       Resyncs;                                                        /*!< restarts of the sender sequence */
+    INT16       AvgSNR;                                                         /*!< average SNR (1/16 dB) */
+} TWiMODLR_PeerInfo;
+
+/**
+ * @brief Counters of the concentrator
+ */
+typedef struct TWiMODLR_ConcentratorStats
+{
+    UINT32      Frames;                                                         /*!< received U-Data / C-Data frames */
+    UINT32      Delivered;                                                      /*!< frames passed to the client */
+    UINT32      Duplicates;                                                     /*!< dropped duplicates */
+    UINT32      Late;                                                           /*!< dropped out of order frames */
+    UINT32      Invalid;                                                        /*!< dropped frames without sequence */
+    UINT32      Untracked;                                                      /*!< frames of new sources while the table was full */
+    UINT32      Peers;                                                          /*!< used table entries */
+    UINT32      Capacity;                                                       /*!< max. number of tracked sources */
+    UINT32      Expired;                                                        /*!< entries removed by Expire() */
+    UINT32      MaxProbe;                                                       /*!< longest probe sequence seen */
+} TWiMODLR_ConcentratorStats;
+
+//-----------------------------------------------------------------------------
+//
+// types for callback functions
+//
+//-----------------------------------------------------------------------------
+
+// C++11 check
+#ifdef WIMOD_USE_CPP11
+    /** Type definition for a 'concentrator RX' callback; peer is NULL for untracked sources */
+    typedef std::function<void (const TWiMODLR_RadioLink_Msg& rxMsg, const TWiMODLR_PeerInfo* peer)> TConcentratorRxCallback;
+#else
+    /** Type definition for a 'concentrator RX' callback function; peer is NULL for untracked sources */
+    typedef void (*TConcentratorRxCallback)(const TWiMODLR_RadioLink_Msg& rxMsg, const TWiMODLR_PeerInfo* peer);
+#endif
+
+//------------------------------------------------------------------------------
+//
+// Section class
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Per-source de-duplication of received RadioLink frames
+ *
+ * The state of each source (group + device address) is kept in a table
+ * provided by the caller. The table uses open addressing with linear
+ * probing, so a lookup costs a hash and a few compares and the memory
+ * use is fixed: sizeof(TWiMODLR_PeerInfo) per entry. The number of
+ * entries must be a power of two; at most LRBASE_CONC_MAX_LOAD_PERCENT of
+ * it is used to keep the probe sequences short.
+ *
+ * Only frames newer than the last delivered one are passed on, so every
+ * source is seen as an in-order stream; gaps are counted as lost.
+ *
+ * A restart of the sender is detected by its sequence: a step back of more
+ * than LRBASE_CONC_HISTORY, or any step back after the source has been
+ * silent for the resync age (SetResyncAge()). A sender that restarts
+ * within the resync age with a sequence up to LRBASE_CONC_HISTORY behind
+ * its last one is dropped as late / duplicate until it has caught up, so
+ * senders should start with a random sequence after a reset. Retransmitted
+ * frames must arrive within the resync age.
+ */
+class WiMOD_LRBASE_Concentrator
+{
+public:
+    WiMOD_LRBASE_Concentrator(void);
+
+    bool                Begin(TWiMODLR_PeerInfo* table, UINT32 entries);
+    void                End(void);
+    bool                IsEnabled(void) const { return (peers != NULL); }
+    void                SetResyncAge(UINT32 ageMs) { resyncAgeMs = ageMs; }
+
+    TWiMODLR_ConcResult OnFrame(const TWiMODLR_RadioLink_Msg& msg, UINT32 now, TWiMODLR_PeerInfo** peer);
+
+    const TWiMODLR_PeerInfo* Find(UINT8 groupAddress, UINT16 deviceAddress) const;
+    const TWiMODLR_PeerInfo* GetNext(UINT32* iterator) const;
+    UINT32              Expire(UINT32 now, UINT32 maxAgeMs);
+
+    void                GetStats(TWiMODLR_ConcentratorStats* stats) const;
+    void                ResetStats(void);
+
+private:
+    //! @cond Doxygen_Suppress
+    UINT32              home(UINT32 key) const;
+    TWiMODLR_PeerInfo*  lookup(UINT32 key, bool insert);
+    void                remove(UINT32 index);
+
+    TWiMODLR_PeerInfo*  peers;
+    UINT32              mask;
+    UINT8               hashShift;
+    UINT32              maxPeers;
+    UINT32              resyncAgeMs;
+
+    TWiMODLR_ConcentratorStats stats;
+    //! @endcond
+};
+
+#endif /* ARDUINO_WIMOD_LRBASE_CONCENTRATOR_H_ */
@@ -0,0 +1,774 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LRBASE_LinkBench.cpp
+//! @ingroup WiMODLR_BASE
+//! <!------------------------------------------------------------------------->
+//! @brief Implementation of the link benchmark
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//!
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "WiMOD_LRBASE_LinkBench.h"
+#include "WiMOD_LRBASE_Tdma.h"
+
+#include <string.h>
+
+//------------------------------------------------------------------------------
+//
+// Section defines
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+enum
+{
+    BENCH_IDLE = 0,
+
+    // sender
+    BENCH_SETUP,                                                                // send SETUP
+    BENCH_SETUP_SENT,                                                           // wait for the ack of the SETUP
+    BENCH_TO_POINT,                                                             // switch to the point settings
+    BENCH_DATA,                                                                 // send the next DATA frame
+    BENCH_DATA_SENT,                                                            // wait for the TX indication / ack
+    BENCH_DATA_END,                                                             // wait for the end of the window
+    BENCH_TO_HOME,                                                              // switch to the home settings
+    BENCH_REQ,                                                                  // send REPORT_REQ
+    BENCH_REQ_SENT,                                                             // wait for the REPORT
+    BENCH_DONE,
+
+    // receiver
+    BENCH_LISTEN,                                                               // home settings; wait for SETUP / REPORT_REQ
+    BENCH_RX_TO_POINT,                                                          // switch to the point settings after the ack
+    BENCH_RX_COUNT,                                                             // count DATA frames until the window ends
+    BENCH_RX_TO_HOME,                                                           // switch to the home settings
+    BENCH_RX_REPORT,                                                            // send REPORT
+};
+//! @endcond
+
+//------------------------------------------------------------------------------
+//
+// Section local functions
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+static void putLE16(UINT8* p, UINT16 v)
+{
+    p[0] = (UINT8) v;
+    p[1] = (UINT8) (v >> 8);
+}
+
+static UINT16 getLE16(const UINT8* p)
+{
+    return (UINT16) (p[0] | (p[1] << 8));
+}
+
+static UINT32 toMs(UINT32 us)
+{
+    return (us + 999) / 1000;
+}
+
+// true if time a is reached at time now
+static bool isDue(UINT32 now, UINT32 a)
+{
+    return ((INT32) (now - a) >= 0);
+}
+//! @endcond
+
+//------------------------------------------------------------------------------
+//
+// Section public functions
+//
+//------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Constructor; benchmark stopped
+ */
+WiMOD_LRBASE_LinkBench::WiMOD_LRBASE_LinkBench(void)
+{
+    memset(&cfg, 0x00, sizeof(cfg));
+    memset(&home, 0x00, sizeof(home));
+    memset(&pointCfg, 0x00, sizeof(pointCfg));
+    results = NULL;
+    atHome  = true;
+    Stop();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Start the sweep
+ *
+ * @param config    points and frame settings; config.Points must stay valid
+ * @param results   one entry per point; must stay valid until the end
+ * @param home      radio settings both nodes use outside of a point
+ * @param now       current time (ms)
+ *
+ * @retval false    if the config is invalid
+ */
+bool WiMOD_LRBASE_LinkBench::StartSender(const TWiMODLR_BenchConfig& config, TWiMODLR_BenchResult* results,
+                                         const TWiMODLR_BenchPoint& home, UINT32 now)
+{
+    if ((config.Points == NULL) || (config.NumPoints == 0) || (config.FramesPerPoint == 0) || (results == NULL)
+            || (config.PayloadSize < LRBASE_BENCH_DATA_HEADER_SIZE)
+            || (config.PayloadSize > WIMOD_RADIOLINK_PAYLOAD_LEN)) {
+        return false;
+    }
+    Stop();
+    cfg           = config;
+    this->results = results;
+    this->home    = home;
+    atHome        = true;
+    role          = LRBASE_BENCH_ROLE_SENDER;
+    point         = 0;
+    startPoint(now);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Start as receiver; waits for the SETUP of a sender
+ *
+ * @param home      radio settings both nodes use outside of a point
+ * @param now       current time (ms)
+ */
+void WiMOD_LRBASE_LinkBench::StartReceiver(const TWiMODLR_BenchPoint& home, UINT32 now)
+{
+    Stop();
+    this->home = home;
+    atHome     = true;
+    role       = LRBASE_BENCH_ROLE_RECEIVER;
+    setState(BENCH_LISTEN, now);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Stop the benchmark
+ *
+ * If IsAtHome() is false afterwards the owner has to restore the home
+ * settings.
+ */
+void WiMOD_LRBASE_LinkBench::Stop(void)
+{
+    role           = LRBASE_BENCH_ROLE_OFF;
+    state          = BENCH_IDLE;
+    stateTime      = 0;
+    dueTime        = 0;
+    retries        = 0;
+    pointsDone     = 0;
+    point          = 0;
+    frames         = 0;
+    payloadSize    = 0;
+    intervalMs     = 0;
+    windowEnd      = 0;
+    seq            = 0;
+    txCounterValid = false;
+    firstTxCounter = 0;
+    lastTxCounter  = 0;
+    firstTxTime    = 0;
+    lastTxTime     = 0;
+    nextFrameTime  = 0;
+    peerGroupAddress  = 0;
+    peerDeviceAddress = 0;
+    rxFrames       = 0;
+    rxUnique       = 0;
+    rxLastSeq      = 0;
+    rxInfoCount    = 0;
+    rxRssiSum      = 0;
+    rxSnrSum       = 0;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Check if the sweep is complete
+ */
+bool WiMOD_LRBASE_LinkBench::IsDone(void) const
+{
+    return (role == LRBASE_BENCH_ROLE_SENDER) && (state == BENCH_DONE);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the next step; handles the timeouts
+ *
+ * Execute the returned action and report its result via OnActionDone().
+ *
+ * @param now       current time (ms)
+ *
+ * @return action to execute; LRBASE_BENCH_ACTION_NONE if nothing is due
+ */
+TWiMODLR_BenchAction WiMOD_LRBASE_LinkBench::GetAction(UINT32 now)
+{
+    switch (state)
+    {
+        case BENCH_SETUP:
+        case BENCH_REQ:
+        case BENCH_RX_REPORT:
+            if (isDue(now, dueTime)) {
+                return LRBASE_BENCH_ACTION_SEND;
+            }
+            break;
+
+        case BENCH_SETUP_SENT:
+            if (isDue(now, dueTime)) {
+                if (++retries < LRBASE_BENCH_CTRL_RETRIES) {
+                    setState(BENCH_SETUP, now);
+                } else {
+                    // receiver not reachable; skip the point
+                    finishPoint();
+                    nextPoint(now);
+                }
+            }
+            break;
+
+        case BENCH_TO_POINT:
+        case BENCH_RX_TO_POINT:
+            if (isDue(now, dueTime)) {
+                return LRBASE_BENCH_ACTION_SET_POINT;
+            }
+            break;
+
+        case BENCH_DATA:
+            if ((seq >= frames) || ((INT32) (windowEnd - now) < (INT32) (intervalMs + LRBASE_BENCH_WINDOW_MARGIN_MS / 2))) {
+                setState(BENCH_DATA_END, now);
+            } else if (isDue(now, dueTime)) {
+                return LRBASE_BENCH_ACTION_SEND;
+            }
+            break;
+
+        case BENCH_DATA_SENT:
+            if (isDue(now, dueTime)) {
+                // indication missing; go on
+                setState(BENCH_DATA, now);
+            }
+            break;
+
+        case BENCH_DATA_END:
+            if (isDue(now, windowEnd)) {
+                setState(BENCH_TO_HOME, now);
+                return LRBASE_BENCH_ACTION_SET_HOME;
+            }
+            break;
+
+        case BENCH_RX_COUNT:
+            if (isDue(now, windowEnd)) {
+                setState(BENCH_RX_TO_HOME, now);
+                return LRBASE_BENCH_ACTION_SET_HOME;
+            }
+            break;
+
+        case BENCH_TO_HOME:
+        case BENCH_RX_TO_HOME:
+            if (isDue(now, dueTime)) {
+                return LRBASE_BENCH_ACTION_SET_HOME;
+            }
+            break;
+
+        case BENCH_REQ_SENT:
+            if (isDue(now, dueTime)) {
+                if (++retries < LRBASE_BENCH_CTRL_RETRIES) {
+                    setState(BENCH_REQ, now);
+                } else {
+                    // no report; keep the sender side counters
+                    finishPoint();
+                    nextPoint(now);
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+    return LRBASE_BENCH_ACTION_NONE;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the frame for LRBASE_BENCH_ACTION_SEND
+ *
+ * @param buffer        destination of the radio payload
+ * @param size          size of the destination
+ * @param confirmed     set to true if the frame has to be sent as C-Data
+ * @param groupAddress  set to the destination group address
+ * @param deviceAddress set to the destination device address
+ *
+ * @return length of the payload; 0 if nothing is to be sent
+ */
+UINT8 WiMOD_LRBASE_LinkBench::EncodeFrame(UINT8* buffer, UINT8 size, bool* confirmed,
+                                          UINT8* groupAddress, UINT16* deviceAddress)
+{
+    UINT8  len = 0;
+    UINT16 avg;
+
+    if ((buffer == NULL) || (confirmed == NULL) || (groupAddress == NULL) || (deviceAddress == NULL)) {
+        return 0;
+    }
+    *confirmed     = false;
+    *groupAddress  = cfg.PeerGroupAddress;
+    *deviceAddress = cfg.PeerDeviceAddress;
+
+    switch (state)
+    {
+        case BENCH_SETUP:
+            if (size < LRBASE_BENCH_SETUP_SIZE) {
+                return 0;
+            }
+            buffer[len++] = LRBASE_BENCH_SETUP;
+            buffer[len++] = point;
+            buffer[len++] = (UINT8) pointCfg.Modulation;
+            buffer[len++] = (UINT8) pointCfg.LoRaBandWidth;
+            buffer[len++] = (UINT8) pointCfg.LoRaSpreadingFactor;
+            buffer[len++] = (UINT8) pointCfg.ErrorCoding;
+            buffer[len++] = (UINT8) pointCfg.FskDatarate;
+            putLE16(&buffer[len], frames);
+            len += 2;
+            buffer[len++] = payloadSize;
+            putLE16(&buffer[len], intervalMs);
+            len += 2;
+            *confirmed = true;
+            break;
+
+        case BENCH_DATA:
+            if (size < payloadSize) {
+                return 0;
+            }
+            buffer[len++] = LRBASE_BENCH_DATA;
+            buffer[len++] = point;
+            putLE16(&buffer[len], seq);
+            len += 2;
+            while (len < payloadSize) {
+                buffer[len] = (UINT8) (seq + len);
+                len++;
+            }
+            *confirmed = cfg.Confirmed;
+            break;
+
+        case BENCH_REQ:
+            if (size < LRBASE_BENCH_REPORT_REQ_SIZE) {
+                return 0;
+            }
+            buffer[len++] = LRBASE_BENCH_REPORT_REQ;
+            buffer[len++] = point;
+            break;
+
+        case BENCH_RX_REPORT:
+            if (size < LRBASE_BENCH_REPORT_SIZE) {
+                return 0;
+            }
+            *groupAddress  = peerGroupAddress;
+            *deviceAddress = peerDeviceAddress;
+            buffer[len++] = LRBASE_BENCH_REPORT;
+            buffer[len++] = point;
+            putLE16(&buffer[len], rxFrames);
+            len += 2;
+            putLE16(&buffer[len], rxUnique);
+            len += 2;
+            putLE16(&buffer[len], rxInfoCount);
+            len += 2;
+            avg = (UINT16) (rxInfoCount ? (INT16) (rxRssiSum / rxInfoCount) : 0);
+            putLE16(&buffer[len], avg);
+            len += 2;
+            buffer[len++] = (UINT8) (rxInfoCount ? (INT8) (rxSnrSum / rxInfoCount) : 0);
+            break;
+
+        default:
+            break;
+    }
+    return len;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Result of the last action
+ *
+ * @param ok        true if the module accepted the request
+ * @param now       current time (ms)
+ */
+void WiMOD_LRBASE_LinkBench::OnActionDone(bool ok, UINT32 now)
+{
+    switch (state)
+    {
+        case BENCH_SETUP:
+            // a rejected request is repeated after the timeout as well
+            setState(BENCH_SETUP_SENT, now);
+            dueTime = now + LRBASE_BENCH_CTRL_TIMEOUT_MS;
+            break;
+
+        case BENCH_TO_POINT:
+            if (ok) {
+                atHome = false;
+                // give the receiver time to switch as well
+                setState(BENCH_DATA, now);
+                dueTime = now + 2 * LRBASE_BENCH_SETTLE_MS;
+            } else {
+                setState(BENCH_DATA_END, now);
+            }
+            break;
+
+        case BENCH_DATA:
+            // fixed frame rate from the planned send time, so all frames fit into the window
+            if ((now - dueTime) > intervalMs) {
+                dueTime = now;
+            }
+            nextFrameTime = dueTime + intervalMs;
+            if (ok) {
+                results[point].Sent++;
+                if (results[point].Sent == 1) {
+                    firstTxTime = now;
+                }
+                lastTxTime = now;
+                setState(BENCH_DATA_SENT, now);
+                dueTime = now + 2 * (UINT32) intervalMs;
+            } else {
+                dueTime = nextFrameTime;
+            }
+            seq++;
+            break;
+
+        case BENCH_TO_HOME:
+        case BENCH_RX_TO_HOME:
+            if (ok) {
+                atHome = true;
+                if (state == BENCH_TO_HOME) {
+                    setState(BENCH_REQ, now);
+                    dueTime = now + 2 * LRBASE_BENCH_SETTLE_MS;
+                } else {
+                    setState(BENCH_LISTEN, now);
+                }
+            } else {
+                dueTime = now + LRBASE_BENCH_SETTLE_MS;
+            }
+            break;
+
+        case BENCH_REQ:
+            setState(BENCH_REQ_SENT, now);
+            dueTime = now + LRBASE_BENCH_CTRL_TIMEOUT_MS;
+            break;
+
+        case BENCH_RX_TO_POINT:
+            if (ok) {
+                atHome = false;
+                setState(BENCH_RX_COUNT, now);
+            } else {
+                setState(BENCH_LISTEN, now);
+            }
+            break;
+
+        case BENCH_RX_REPORT:
+            setState(BENCH_LISTEN, now);
+            break;
+
+        default:
+            break;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief U-Data / C-Data TX indication of the module
+ *
+ * @param txEventCounter    TxEventCounter of the indication
+ * @param airTimeMs         AirTime of the indication; 0 if not supported
+ * @param now               current time (ms)
+ */
+void WiMOD_LRBASE_LinkBench::OnTxInd(UINT16 txEventCounter, UINT32 airTimeMs, UINT32 now)
+{
+    if (state != BENCH_DATA_SENT) {
+        return;
+    }
+    if (!txCounterValid) {
+        firstTxCounter = txEventCounter;
+        txCounterValid = true;
+    }
+    lastTxCounter          = txEventCounter;
+    results[point].TxEvents = (UINT16) (lastTxCounter - firstTxCounter + 1);
+
+    if (airTimeMs == 0) {
+        // older firmware; use the calculated value
+        airTimeMs = toMs(CalcAirtimeUs(pointCfg, payloadSize));
+    }
+    results[point].AirTimeMs += airTimeMs;
+    lastTxTime = now;
+
+    if (!cfg.Confirmed) {
+        setState(BENCH_DATA, now);
+        dueTime = nextFrameTime;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Ack RX / ack timeout indication of the module
+ *
+ * @param acked     true: RADIOLINK_MSG_ACK_RX_IND; false: RADIOLINK_MSG_ACK_TIMEOUT_IND
+ * @param now       current time (ms)
+ */
+void WiMOD_LRBASE_LinkBench::OnAck(bool acked, UINT32 now)
+{
+    switch (state)
+    {
+        case BENCH_SETUP_SENT:
+            if (acked) {
+                windowEnd = now + calcWindowMs();
+                setState(BENCH_TO_POINT, now);
+            } else {
+                // let the timeout handle the retry
+                dueTime = now;
+            }
+            break;
+
+        case BENCH_DATA_SENT:
+            if (acked) {
+                results[point].Acked++;
+            }
+            lastTxTime = now;
+            setState(BENCH_DATA, now);
+            dueTime = nextFrameTime;
+            break;
+
+        default:
+            break;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Received U-Data / C-Data frame
+ *
+ * @param srcGroupAddress   source group address
+ * @param srcDeviceAddress  source device address
+ * @param payload           radio payload
+ * @param length            payload length
+ * @param rxInfo            true if rssi and snr are valid
+ * @param rssi              RSSI (dBm)
+ * @param snr               SNR (dB)
+ * @param now               current time (ms)
+ *
+ * @retval true     if the frame belongs to the benchmark
+ */
+bool WiMOD_LRBASE_LinkBench::OnFrame(UINT8 srcGroupAddress, UINT16 srcDeviceAddress, const UINT8* payload, UINT8 length,
+                                     bool rxInfo, INT16 rssi, INT8 snr, UINT32 now)
+{
+    if ((role == LRBASE_BENCH_ROLE_OFF) || (payload == NULL) || (length < 2)
+            || (payload[0] < LRBASE_BENCH_SETUP) || (payload[0] > LRBASE_BENCH_REPORT)) {
+        return false;
+    }
+
+    switch (payload[0])
+    {
+        case LRBASE_BENCH_SETUP:
+            if ((role == LRBASE_BENCH_ROLE_RECEIVER) && (state == BENCH_LISTEN)) {
+                peerGroupAddress  = srcGroupAddress;
+                peerDeviceAddress = srcDeviceAddress;
+                onSetup(payload, length, now);
+            }
+            break;
+
+        case LRBASE_BENCH_DATA:
+            if ((state == BENCH_RX_COUNT) && (payload[1] == point)) {
+                onData(payload, length, rxInfo, rssi, snr);
+            }
+            break;
+
+        case LRBASE_BENCH_REPORT_REQ:
+            if ((state == BENCH_LISTEN) && (payload[1] == point)
+                    && (srcGroupAddress == peerGroupAddress) && (srcDeviceAddress == peerDeviceAddress)) {
+                setState(BENCH_RX_REPORT, now);
+            }
+            break;
+
+        case LRBASE_BENCH_REPORT:
+            if ((state == BENCH_REQ_SENT) && (payload[1] == point)) {
+                onReport(payload, length, now);
+            }
+            break;
+
+        default:
+            break;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Calculate the airtime of a frame
+ *
+ * @param point         radio settings
+ * @param payloadLen    radio payload length
+ *
+ * @return airtime in us
+ */
+UINT32 WiMOD_LRBASE_LinkBench::CalcAirtimeUs(const TWiMODLR_BenchPoint& point, UINT8 payloadLen)
+{
+    TWiMODLR_DevMgmt_RadioConfig radioCfg;
+
+    memset(&radioCfg, 0x00, sizeof(radioCfg));
+    radioCfg.Modulation          = point.Modulation;
+    radioCfg.LoRaBandWidth       = point.LoRaBandWidth;
+    radioCfg.LoRaSpreadingFactor = point.LoRaSpreadingFactor;
+    radioCfg.ErrorCoding         = point.ErrorCoding;
+    radioCfg.FskDatarate         = point.FskDatarate;
+
+    return WiMOD_LRBASE_Tdma::CalcAirtimeUs(radioCfg, payloadLen);
+}
+
+//------------------------------------------------------------------------------
+//
+// Section private functions
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+void WiMOD_LRBASE_LinkBench::setState(UINT8 newState, UINT32 now)
+{
+    state     = newState;
+    stateTime = now;
+    dueTime   = now;
+}
+
+void WiMOD_LRBASE_LinkBench::startPoint(UINT32 now)
+{
+    UINT32 interval;
+
+    memset(&results[point], 0x00, sizeof(TWiMODLR_BenchResult));
+    pointCfg              = cfg.Points[point];
+    results[point].Point  = pointCfg;
+    frames                = cfg.FramesPerPoint;
+    payloadSize           = cfg.PayloadSize;
+    seq                   = 0;
+    retries               = 0;
+    txCounterValid        = false;
+
+    interval = toMs(CalcAirtimeUs(pointCfg, payloadSize)) + LRBASE_BENCH_TX_GAP_MS + cfg.GapMs;
+    if (cfg.Confirmed) {
+        interval += toMs(CalcAirtimeUs(pointCfg, 0)) + 2 * LRBASE_BENCH_ACK_TURNAROUND_MS;
+    }
+    intervalMs = (interval > 0xFFFF) ? 0xFFFF : (UINT16) interval;
+
+    setState(BENCH_SETUP, now);
+}
+
+void WiMOD_LRBASE_LinkBench::nextPoint(UINT32 now)
+{
+    pointsDone++;
+    point++;
+    if (point >= cfg.NumPoints) {
+        setState(BENCH_DONE, now);
+    } else {
+        startPoint(now);
+    }
+}
+
+void WiMOD_LRBASE_LinkBench::finishPoint(void)
+{
+    TWiMODLR_BenchResult* r = &results[point];
+    UINT32                bytes;
+
+    r->DurationMs = (r->Sent > 1) ? (lastTxTime - firstTxTime) : intervalMs;
+    if (r->DurationMs == 0) {
+        r->DurationMs = 1;
+    }
+    if (r->Sent > 0) {
+        UINT16 ok = (r->Unique < r->Sent) ? r->Unique : r->Sent;
+        r->PerPermille = (UINT16) (((UINT32) (r->Sent - ok) * 1000) / r->Sent);
+    } else {
+        r->PerPermille = 1000;
+    }
+    bytes                 = (UINT32) r->Unique * payloadSize;
+    r->GoodputBps         = (UINT32) (((UINT64) bytes * 8 * 1000) / r->DurationMs);
+    r->AirTimeUsPerByte   = bytes ? (UINT32) (((UINT64) r->AirTimeMs * 1000) / bytes) : 0;
+}
+
+void WiMOD_LRBASE_LinkBench::onSetup(const UINT8* payload, UINT8 length, UINT32 now)
+{
+    UINT32 ackMs;
+
+    if (length < LRBASE_BENCH_SETUP_SIZE) {
+        return;
+    }
+    point                        = payload[1];
+    pointCfg.Modulation          = (TRadioCfg_Modulation) payload[2];
+    pointCfg.LoRaBandWidth       = (TRadioCfg_LoRaBandwidth) payload[3];
+    pointCfg.LoRaSpreadingFactor = (TRadioCfg_LoRaSpreadingFactor) payload[4];
+    pointCfg.ErrorCoding         = (TRadioCfg_ErrorCoding) payload[5];
+    pointCfg.FskDatarate         = (TRadioCfg_FskDatarate) payload[6];
+    frames                       = getLE16(&payload[7]);
+    payloadSize                  = payload[9];
+    intervalMs                   = getLE16(&payload[10]);
+
+    rxFrames    = 0;
+    rxUnique    = 0;
+    rxLastSeq   = 0xFFFF;
+    rxInfoCount = 0;
+    rxRssiSum   = 0;
+    rxSnrSum    = 0;
+
+    // the module sends the ack first; the window starts when the sender gets it
+    ackMs     = toMs(CalcAirtimeUs(home, 0)) + LRBASE_BENCH_ACK_TURNAROUND_MS;
+    setState(BENCH_RX_TO_POINT, now);
+    dueTime   = now + ackMs + LRBASE_BENCH_SETTLE_MS;
+    windowEnd = now + ackMs + calcWindowMs();
+}
+
+void WiMOD_LRBASE_LinkBench::onData(const UINT8* payload, UINT8 length, bool rxInfo, INT16 rssi, INT8 snr)
+{
+    UINT16 rxSeq;
+
+    if (length < LRBASE_BENCH_DATA_HEADER_SIZE) {
+        return;
+    }
+    rxSeq = getLE16(&payload[2]);
+    rxFrames++;
+    if (rxSeq != rxLastSeq) {
+        // C-Data retransmissions repeat the sequence
+        rxUnique++;
+        rxLastSeq = rxSeq;
+    }
+    if (rxInfo) {
+        rxInfoCount++;
+        rxRssiSum += rssi;
+        rxSnrSum  += snr;
+    }
+}
+
+void WiMOD_LRBASE_LinkBench::onReport(const UINT8* payload, UINT8 length, UINT32 now)
+{
+    TWiMODLR_BenchResult* r = &results[point];
+
+    if (length < LRBASE_BENCH_REPORT_SIZE) {
+        return;
+    }
+    r->Received = getLE16(&payload[2]);
+    r->Unique   = getLE16(&payload[4]);
+    r->AvgRSSI  = (INT16) getLE16(&payload[8]);
+    r->AvgSNR   = (INT8) payload[10];
+    r->Valid    = true;
+
+    finishPoint();
+    nextPoint(now);
+}
+
+UINT32 WiMOD_LRBASE_LinkBench::calcWindowMs(void) const
+{
+    return 3 * LRBASE_BENCH_SETTLE_MS + (UINT32) frames * intervalMs + LRBASE_BENCH_WINDOW_MARGIN_MS;
+}
+//! @endcond
+
+//-----------------------------------------------------------------------------
+// EOF
+//-----------------------------------------------------------------------------
@@ -0,0 +1,250 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LRBASE_LinkBench.h
+//! @ingroup WiMODLR_BASE
+//! <!------------------------------------------------------------------------->
+//! @brief Declarations for the link benchmark
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//! Sweep over radio settings between two nodes; packet error rate,
+//! goodput and airtime per byte of each setting.
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+
+#ifndef ARDUINO_WIMOD_LRBASE_LINKBENCH_H_
+#define ARDUINO_WIMOD_LRBASE_LINKBENCH_H_
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "../SAP/WiMOD_SAP_DEVMGMT_IDs.h"
+#include "../SAP/WiMOD_SAP_RadioLink_IDs.h"
+
+#include <stddef.h>
+
+//------------------------------------------------------------------------------
+//
+// Section defines
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+/*
+ * Frames (first payload byte = type, multi byte fields little endian):
+ *
+ *  SETUP      (C-Data, home settings)
+ *             [0xB1] [point] [modulation] [bandwidth] [SF] [error coding]
+ *             [FSK datarate] [frames u16] [payload size] [interval ms u16]
+ *  DATA       (U-/C-Data, point settings)
+ *             [0xB2] [point] [sequence u16] [filler ...]
+ *  REPORT_REQ (U-Data, home settings)
+ *             [0xB3] [point]
+ *  REPORT     (U-Data, home settings)
+ *             [0xB4] [point] [received u16] [unique u16] [rx info count u16]
+ *             [avg RSSI i16] [avg SNR i8]
+ *
+ * Both nodes leave the home settings after the SETUP has been acked and
+ * return to them after a window that is long enough for all frames.
+ */
+#define LRBASE_BENCH_SETUP                          0xB1
+#define LRBASE_BENCH_DATA                           0xB2
+#define LRBASE_BENCH_REPORT_REQ                     0xB3
+#define LRBASE_BENCH_REPORT                         0xB4
+
+#define LRBASE_BENCH_SETUP_SIZE                     12
+#define LRBASE_BENCH_DATA_HEADER_SIZE               4
+#define LRBASE_BENCH_REPORT_REQ_SIZE                2
+#define LRBASE_BENCH_REPORT_SIZE                    11
+
+#define LRBASE_BENCH_SETTLE_MS                      50                          // after a radio config change
+#define LRBASE_BENCH_TX_GAP_MS                      30                          // host / HCI processing between frames
+#define LRBASE_BENCH_ACK_TURNAROUND_MS              10
+#define LRBASE_BENCH_WINDOW_MARGIN_MS               500
+#define LRBASE_BENCH_CTRL_TIMEOUT_MS                3000
+#define LRBASE_BENCH_CTRL_RETRIES                   8
+//! @endcond
+
+//------------------------------------------------------------------------------
+//
+// Section types
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Radio settings of one benchmark point
+ */
+typedef struct TWiMODLR_BenchPoint
+{
+    TRadioCfg_Modulation            Modulation;                                 /*!< LoRa or FSK */
+    TRadioCfg_LoRaBandwidth         LoRaBandWidth;                              /*!< LoRa bandwidth */
+    TRadioCfg_LoRaSpreadingFactor   LoRaSpreadingFactor;                        /*!< LoRa spreading factor */
+    TRadioCfg_ErrorCoding           ErrorCoding;                                /*!< LoRa error coding */
+    TRadioCfg_FskDatarate           FskDatarate;                                /*!< FSK datarate */
+} TWiMODLR_BenchPoint;
+
+/**
+ * @brief Settings of a benchmark run (sender side)
+ */
+typedef struct TWiMODLR_BenchConfig
+{
+    const TWiMODLR_BenchPoint* Points;                                          /*!< radio settings to test */
+    UINT8       NumPoints;                                                      /*!< number of entries in Points */
+    UINT16      FramesPerPoint;                                                 /*!< numbered frames per point */
+    UINT8       PayloadSize;                                                    /*!< radio payload per frame (incl. 4 byte header) */
+    bool        Confirmed;                                                      /*!< true: C-Data; false: U-Data */
+    UINT16      GapMs;                                                          /*!< extra pause between two frames */
+    UINT8       PeerGroupAddress;                                               /*!< group address of the receiver */
+    UINT16      PeerDeviceAddress;                                              /*!< device address of the receiver */
+} TWiMODLR_BenchConfig;
+
+/**
+ * @brief Result of one benchmark point
+ */
+typedef struct TWiMODLR_BenchResult
+{
+    TWiMODLR_BenchPoint Point;                                                  /*!< tested radio settings */
+    bool        Valid;                                                          /*!< setup acked and report received */
+    UINT16      Sent;                                                           /*!< frames accepted by the module */
+    UINT16      TxEvents;                                                       /*!< radio transmissions (TxEventCounter) */
+    UINT16      Acked;                                                          /*!< acked C-Data frames */
+    UINT16      Received;                                                       /*!< frames seen by the receiver */
+    UINT16      Unique;                                                         /*!< different frames seen by the receiver */
+    INT16       AvgRSSI;                                                        /*!< average RSSI at the receiver (dBm) */
+    INT8        AvgSNR;                                                         /*!< average SNR at the receiver (dB) */
+    UINT32      AirTimeMs;                                                      /*!< sum of the AirTime of all transmissions */
+    UINT32      DurationMs;                                                     /*!< first frame until the last TX indication */
+    UINT16      PerPermille;                                                    /*!< packet error rate: 1 - Unique / Sent */
+    UINT32      GoodputBps;                                                     /*!< delivered payload bits per second */
+    UINT32      AirTimeUsPerByte;                                               /*!< airtime per delivered payload byte; 0 if nothing was delivered */
+} TWiMODLR_BenchResult;
+
+/**
+ * @brief Role of a benchmark node
+ */
+typedef enum TWiMODLR_BenchRole
+{
+    LRBASE_BENCH_ROLE_OFF = 0,                                                  /*!< not running */
+    LRBASE_BENCH_ROLE_SENDER,                                                   /*!< runs the sweep */
+    LRBASE_BENCH_ROLE_RECEIVER,                                                 /*!< follows the sender */
+} TWiMODLR_BenchRole;
+
+/**
+ * @brief Next step the owner of the benchmark has to execute
+ */
+typedef enum TWiMODLR_BenchAction
+{
+    LRBASE_BENCH_ACTION_NONE = 0,                                               /*!< nothing to do */
+    LRBASE_BENCH_ACTION_SET_POINT,                                              /*!< switch to GetActionPoint() (RAM only) */
+    LRBASE_BENCH_ACTION_SET_HOME,                                               /*!< switch back to GetActionPoint() (home settings) */
+    LRBASE_BENCH_ACTION_SEND,                                                   /*!< send EncodeFrame() */
+} TWiMODLR_BenchAction;
+
+//------------------------------------------------------------------------------
+//
+// Section class
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Two node throughput / packet error rate benchmark
+ *
+ * The class holds the protocol and the statistics only; it does not talk
+ * to a module. The owner polls GetAction() and executes it on its
+ * transport, e.g. the HCI of a real module (WiMODLRBASE::ServiceLinkBench)
+ * or a simulated radio link, and feeds back the result, the TX / ack
+ * indications and the received frames.
+ *
+ * The sender runs SETUP, DATA and REPORT_REQ for every point; the receiver
+ * counts the DATA frames and answers with a REPORT.
+ */
+class WiMOD_LRBASE_LinkBench
+{
+public:
+    WiMOD_LRBASE_LinkBench(void);
+
+    bool                StartSender(const TWiMODLR_BenchConfig& config, TWiMODLR_BenchResult* results,
+                                    const TWiMODLR_BenchPoint& home, UINT32 now);
+    void                StartReceiver(const TWiMODLR_BenchPoint& home, UINT32 now);
+    void                Stop(void);
+
+    TWiMODLR_BenchRole  GetRole(void) const { return role; }
+    bool                IsDone(void) const;
+    bool                IsAtHome(void) const { return atHome; }
+    const TWiMODLR_BenchPoint& GetHomePoint(void) const { return home; }
+    UINT8               GetPointsDone(void) const { return pointsDone; }
+
+    TWiMODLR_BenchAction GetAction(UINT32 now);
+    const TWiMODLR_BenchPoint& GetActionPoint(void) const { return atHome ? pointCfg : home; }
+    UINT8               EncodeFrame(UINT8* buffer, UINT8 size, bool* confirmed,
+                                    UINT8* groupAddress, UINT16* deviceAddress);
+    void                OnActionDone(bool ok, UINT32 now);
+
+    void                OnTxInd(UINT16 txEventCounter, UINT32 airTimeMs, UINT32 now);
+    void                OnAck(bool acked, UINT32 now);
+    bool                OnFrame(UINT8 srcGroupAddress, UINT16 srcDeviceAddress, const UINT8* payload, UINT8 length,
+                                bool rxInfo, INT16 rssi, INT8 snr, UINT32 now);
+
+    static UINT32       CalcAirtimeUs(const TWiMODLR_BenchPoint& point, UINT8 payloadLen);
+
+private:
+    //! @cond Doxygen_Suppress
+    void                setState(UINT8 newState, UINT32 now);
+    void                startPoint(UINT32 now);
+    void                nextPoint(UINT32 now);
+    void                finishPoint(void);
+    void                onSetup(const UINT8* payload, UINT8 length, UINT32 now);
+    void                onData(const UINT8* payload, UINT8 length, bool rxInfo, INT16 rssi, INT8 snr);
+    void                onReport(const UINT8* payload, UINT8 length, UINT32 now);
+    UINT32              calcWindowMs(void) const;
+
+    TWiMODLR_BenchRole  role;
+    UINT8               state;
+    UINT32              stateTime;                                              // time of the last state change
+    UINT32              dueTime;                                                // next action / timeout
+    UINT8               retries;
+    bool                atHome;
+
+    TWiMODLR_BenchConfig cfg;
+    TWiMODLR_BenchResult* results;
+    TWiMODLR_BenchPoint home;
+    UINT8               pointsDone;
+
+    // current point (both roles)
+    UINT8               point;
+    TWiMODLR_BenchPoint pointCfg;
+    UINT16              frames;
+    UINT8               payloadSize;
+    UINT16              intervalMs;
+    UINT32              windowEnd;
+
+    // sender
+    UINT16              seq;
+    bool                txCounterValid;
+    UINT16              firstTxCounter;
+    UINT16              lastTxCounter;
+    UINT32              firstTxTime;
+    UINT32              lastTxTime;
+    UINT32              nextFrameTime;
+
+    // receiver
+    UINT8               peerGroupAddress;
+    UINT16              peerDeviceAddress;
+    UINT16              rxFrames;
+    UINT16              rxUnique;
+    UINT16              rxLastSeq;
+    UINT16              rxInfoCount;
+    INT32               rxRssiSum;
+    INT32               rxSnrSum;
+    //! @endcond
+};
+
+#endif /* ARDUINO_WIMOD_LRBASE_LINKBENCH_H_ */
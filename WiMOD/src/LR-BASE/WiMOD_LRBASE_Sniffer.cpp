@@ -0,0 +1,304 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LRBASE_Sniffer.cpp
+//! @ingroup WiMODLR_BASE
+//! <!------------------------------------------------------------------------->
+//! @brief Implementation of the raw frame sniffer
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//!
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "WiMOD_LRBASE_Sniffer.h"
+
+#include <string.h>
+
+//------------------------------------------------------------------------------
+//
+// Section local functions
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+static void putLE16(UINT8* p, UINT16 v)
+{
+    p[0] = (UINT8) v;
+    p[1] = (UINT8) (v >> 8);
+}
+
+static void putLE32(UINT8* p, UINT32 v)
+{
+    p[0] = (UINT8) v;
+    p[1] = (UINT8) (v >> 8);
+    p[2] = (UINT8) (v >> 16);
+    p[3] = (UINT8) (v >> 24);
+}
+//! @endcond
+
+//------------------------------------------------------------------------------
+//
+// Section public functions
+//
+//------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Constructor; sniffer disabled
+ */
+WiMOD_LRBASE_Sniffer::WiMOD_LRBASE_Sniffer(void)
+{
+    ring     = NULL;
+    ringSize = 0;
+    head     = 0;
+    tail     = 0;
+    used     = 0;
+    ResetStats();
+    SetRadioInfo(0, 0, 0, 0);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Start capturing into a ring buffer
+ *
+ * @param buffer    ring memory; must stay valid until End()
+ * @param size      size of the ring; should hold several records of
+ *                  LRBASE_SNIFFER_RECORD_HEADER_SIZE + frame length
+ *
+ * @retval false    if the buffer is too small for a single record
+ */
+bool WiMOD_LRBASE_Sniffer::Begin(UINT8* buffer, UINT32 size)
+{
+    if ((buffer == NULL) || (size <= LRBASE_SNIFFER_RECORD_HEADER_SIZE)) {
+        return false;
+    }
+    ring     = buffer;
+    ringSize = size;
+    head     = 0;
+    tail     = 0;
+    used     = 0;
+    ResetStats();
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Stop capturing; frames still in the ring are discarded
+ */
+void WiMOD_LRBASE_Sniffer::End(void)
+{
+    ring     = NULL;
+    ringSize = 0;
+    head     = 0;
+    tail     = 0;
+    used     = 0;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Store a raw frame indication
+ *
+ * @param hciPayload    payload of the RADIOLINK_MSG_RAW_DATA_RX_IND message
+ * @param length        payload length
+ * @param now           host time of reception (ms)
+ *
+ * @retval true     if the sniffer is enabled; the frame is stored or counted as dropped
+ */
+bool WiMOD_LRBASE_Sniffer::OnRawFrame(const UINT8* hciPayload, UINT16 length, UINT32 now)
+{
+    UINT8  hdr[LRBASE_SNIFFER_RECORD_HEADER_SIZE];
+    UINT16 frameLen;
+
+    if (ring == NULL) {
+        return false;
+    }
+    if (length < 1) {
+        return true;
+    }
+
+    memset(hdr, 0x00, sizeof(hdr));
+    hdr[1]   = hciPayload[0];
+    frameLen = length - 1;
+
+    if ((hdr[1] & RADIOLINK_FORMAT_EXTENDED_OUTPUT) && (frameLen >= LRBASE_SNIFFER_RX_INFO_SIZE)) {
+        // RSSI, SNR and rx time follow the frame; the order within the record differs
+        const UINT8* info = &hciPayload[length - LRBASE_SNIFFER_RX_INFO_SIZE];
+
+        frameLen -= LRBASE_SNIFFER_RX_INFO_SIZE;
+        memcpy(&hdr[6], &info[3], 4);
+        memcpy(&hdr[10], &info[0], 2);
+        hdr[12] = info[2];
+    } else {
+        hdr[1] &= ~RADIOLINK_FORMAT_EXTENDED_OUTPUT;
+    }
+    if (frameLen > 0xFF) {
+        frameLen = 0xFF;
+    }
+    hdr[0] = (UINT8) frameLen;
+    putLE32(&hdr[2], now);
+
+    UINT32 recLen = LRBASE_SNIFFER_RECORD_HEADER_SIZE + frameLen;
+    if ((ringSize - used) < recLen) {
+        stats.Dropped++;
+        stats.DroppedBytes += recLen;
+        return true;
+    }
+
+    write(hdr, sizeof(hdr));
+    write(&hciPayload[1], frameLen);
+    stats.Captured++;
+    stats.PendingFrames++;
+    if (used > stats.HighWaterBytes) {
+        stats.HighWaterBytes = used;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Take whole records out of the ring
+ *
+ * @param out       destination buffer, e.g. a block of the log file
+ * @param size      size of the destination buffer
+ *
+ * @return number of bytes copied; 0 if the ring is empty
+ */
+UINT32 WiMOD_LRBASE_Sniffer::Drain(UINT8* out, UINT32 size)
+{
+    UINT32 copied = 0;
+
+    if ((ring == NULL) || (out == NULL)) {
+        return 0;
+    }
+
+    while (used) {
+        UINT32 recLen = LRBASE_SNIFFER_RECORD_HEADER_SIZE + ring[tail];
+        if ((size - copied) < recLen) {
+            break;
+        }
+        read(&out[copied], recLen);
+        copied += recLen;
+        stats.Drained++;
+        stats.PendingFrames--;
+    }
+    return copied;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the counters and the fill level of the ring
+ *
+ * @param info      pointer where to store the counters
+ */
+void WiMOD_LRBASE_Sniffer::GetStats(TWiMODLR_SnifferStats* info) const
+{
+    *info              = stats;
+    info->PendingBytes = used;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Clear all counters except the number of pending frames
+ */
+void WiMOD_LRBASE_Sniffer::ResetStats(void)
+{
+    UINT32 pending = (ring != NULL) ? stats.PendingFrames : 0;
+
+    memset(&stats, 0x00, sizeof(stats));
+    stats.PendingFrames  = pending;
+    stats.HighWaterBytes = used;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Set the radio parameters written to the log header
+ *
+ * @param frequency         RF frequency in Hz
+ * @param modulation        TRadioCfg_Modulation of the radio config
+ * @param bandwidth         TRadioCfg_LoRaBandwidth of the radio config
+ * @param spreadingFactor   TRadioCfg_LoRaSpreadingFactor of the radio config
+ */
+void WiMOD_LRBASE_Sniffer::SetRadioInfo(UINT32 frequency, UINT8 modulation, UINT8 bandwidth, UINT8 spreadingFactor)
+{
+    rfFrequency       = frequency;
+    rfModulation      = modulation;
+    rfBandwidth       = bandwidth;
+    rfSpreadingFactor = spreadingFactor;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Encode the header of a sniffer log
+ *
+ * The header has to be written once in front of the drained records.
+ *
+ * @param buffer    destination
+ * @param size      size of the destination
+ *
+ * @return LRBASE_SNIFFER_LOG_HEADER_SIZE; 0 if the buffer is too small
+ */
+UINT8 WiMOD_LRBASE_Sniffer::EncodeLogHeader(UINT8* buffer, UINT32 size) const
+{
+    if ((buffer == NULL) || (size < LRBASE_SNIFFER_LOG_HEADER_SIZE)) {
+        return 0;
+    }
+    memset(buffer, 0x00, LRBASE_SNIFFER_LOG_HEADER_SIZE);
+    memcpy(buffer, "WMSN", 4);
+    buffer[4] = LRBASE_SNIFFER_LOG_VERSION;
+    buffer[5] = LRBASE_SNIFFER_LOG_HEADER_SIZE;
+    putLE16(&buffer[6], 0);
+    putLE32(&buffer[8], rfFrequency);
+    buffer[12] = rfModulation;
+    buffer[13] = rfBandwidth;
+    buffer[14] = rfSpreadingFactor;
+    return LRBASE_SNIFFER_LOG_HEADER_SIZE;
+}
+
+//------------------------------------------------------------------------------
+//
+// Section private functions
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+void WiMOD_LRBASE_Sniffer::write(const UINT8* data, UINT32 length)
+{
+    UINT32 first = ringSize - head;
+
+    if (first > length) {
+        first = length;
+    }
+    memcpy(&ring[head], data, first);
+    memcpy(ring, &data[first], length - first);
+
+    head  = (head + length) % ringSize;
+    used += length;
+}
+
+void WiMOD_LRBASE_Sniffer::read(UINT8* data, UINT32 length)
+{
+    UINT32 first = ringSize - tail;
+
+    if (first > length) {
+        first = length;
+    }
+    memcpy(data, &ring[tail], first);
+    memcpy(&data[first], ring, length - first);
+
+    tail  = (tail + length) % ringSize;
+    used -= length;
+}
+//! @endcond
@@ -0,0 +1,133 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LRBASE_Sniffer.h
+//! @ingroup WiMODLR_BASE
+//! <!------------------------------------------------------------------------->
+//! @brief Declarations for the raw frame sniffer
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//! Captures raw radio frames into a ring buffer that is drained in batches
+//! to a compact binary log.
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+
+#ifndef ARDUINO_WIMOD_LRBASE_SNIFFER_H_
+#define ARDUINO_WIMOD_LRBASE_SNIFFER_H_
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "../SAP/WiMOD_SAP_RadioLink_IDs.h"
+
+#include <stddef.h>
+
+//------------------------------------------------------------------------------
+//
+// Section defines
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+/*
+ * Log layout (little endian, same as the HCI):
+ *
+ *  header : "WMSN" [version] [header size] [reserved u16] [frequency Hz u32]
+ *           [modulation] [LoRa bandwidth] [LoRa SF] [reserved]
+ *
+ *  record : [payload length] [status/format] [host time ms u32]
+ *           [module rx time u32] [RSSI i16] [SNR i8] [payload]
+ *
+ *  RSSI, SNR and rx time are only valid if the status/format field
+ *  contains RADIOLINK_FORMAT_EXTENDED_OUTPUT.
+ */
+#define LRBASE_SNIFFER_LOG_VERSION                  1
+#define LRBASE_SNIFFER_LOG_HEADER_SIZE              16
+#define LRBASE_SNIFFER_RECORD_HEADER_SIZE           13
+#define LRBASE_SNIFFER_RX_INFO_SIZE                 7
+//! @endcond
+
+//------------------------------------------------------------------------------
+//
+// Section types
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Counters of the sniffer
+ */
+typedef struct TWiMODLR_SnifferStats
+{
+    UINT32      Captured;                                                       /*!< frames stored in the ring */
+    UINT32      Dropped;                                                        /*!< frames dropped because the ring was full */
+    UINT32      DroppedBytes;                                                   /*!< log bytes of the dropped frames */
+    UINT32      Drained;                                                        /*!< frames taken out of the ring */
+    UINT32      PendingFrames;                                                  /*!< frames in the ring */
+    UINT32      PendingBytes;                                                   /*!< log bytes in the ring */
+    UINT32      HighWaterBytes;                                                 /*!< max. fill level of the ring */
+} TWiMODLR_SnifferStats;
+
+//------------------------------------------------------------------------------
+//
+// Section class
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Ring buffer for raw radio frames
+ *
+ * Each raw frame indication is copied once into the ring, already in the
+ * record format of the log, together with the host time of reception and
+ * the radio info of the module. The ring is drained in batches of whole
+ * records. If a frame does not fit into the ring it is dropped and counted;
+ * the HCI decoder is never blocked.
+ *
+ * The ring memory is provided by the caller.
+ */
+class WiMOD_LRBASE_Sniffer
+{
+public:
+    WiMOD_LRBASE_Sniffer(void);
+
+    bool                Begin(UINT8* buffer, UINT32 size);
+    void                End(void);
+    bool                IsEnabled(void) const { return (ring != NULL); }
+
+    bool                OnRawFrame(const UINT8* hciPayload, UINT16 length, UINT32 now);
+    UINT32              Drain(UINT8* out, UINT32 size);
+
+    void                GetStats(TWiMODLR_SnifferStats* stats) const;
+    void                ResetStats(void);
+
+    void                SetRadioInfo(UINT32 frequency, UINT8 modulation, UINT8 bandwidth, UINT8 spreadingFactor);
+    UINT8               EncodeLogHeader(UINT8* buffer, UINT32 size) const;
+
+private:
+    //! @cond Doxygen_Suppress
+    void                write(const UINT8* data, UINT32 length);
+    void                read(UINT8* data, UINT32 length);
+
+    UINT8*              ring;
+    UINT32              ringSize;
+    UINT32              head;                                                   // write index
+    UINT32              tail;                                                   // read index
+    UINT32              used;
+
+    TWiMODLR_SnifferStats stats;
+
+    UINT32              rfFrequency;
+    UINT8               rfModulation;
+    UINT8               rfBandwidth;
+    UINT8               rfSpreadingFactor;
+    //! @endcond
+};
+
+#endif /* ARDUINO_WIMOD_LRBASE_SNIFFER_H_ */
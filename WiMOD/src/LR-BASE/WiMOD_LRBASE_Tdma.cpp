@@ -0,0 +1,763 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LRBASE_Tdma.cpp
+//! @ingroup WiMODLR_BASE
+//! <!------------------------------------------------------------------------->
+//! @brief Implementation of the TDMA star network
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//!
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "WiMOD_LRBASE_Tdma.h"
+#include "../utils/AirTimeCalc.h"
+
+#include <string.h>
+
+//------------------------------------------------------------------------------
+//
+// Section local functions
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+static UINT32 toMs(UINT32 us)
+{
+    return (us + 999) / 1000;
+}
+//! @endcond
+
+//------------------------------------------------------------------------------
+//
+// Section public functions
+//
+//------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Constructor; default superframe, role off
+ */
+WiMOD_LRBASE_Tdma::WiMOD_LRBASE_Tdma(void)
+{
+    TWiMODLR_TdmaConfig config;
+
+    memset(&radio, 0x00, sizeof(radio));
+    role            = LRBASE_TDMA_ROLE_OFF;
+    ownAddress      = 0;
+    collectorGroup  = 0;
+    collectorDevice = 0;
+    beaconGroup     = 0;
+    rndState        = 0;
+    Stop();
+
+    config.NumSlots           = LRBASE_TDMA_DEFAULT_NUM_SLOTS;
+    config.NumContentionSlots = LRBASE_TDMA_DEFAULT_NUM_CONTENTION;
+    config.MaxPayloadLen      = LRBASE_TDMA_DEFAULT_MAX_PAYLOAD;
+    config.GuardMs            = LRBASE_TDMA_DEFAULT_GUARD_MS;
+    config.SlotTimeout        = LRBASE_TDMA_DEFAULT_SLOT_TIMEOUT;
+    SetConfig(config);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Set the superframe parameters
+ *
+ * Values out of range are limited. A running collector uses the new
+ * superframe from the next beacon on.
+ *
+ * @param config    superframe parameters
+ */
+void WiMOD_LRBASE_Tdma::SetConfig(const TWiMODLR_TdmaConfig& config)
+{
+    cfg = config;
+
+    if (cfg.NumSlots < 1) {
+        cfg.NumSlots = 1;
+    }
+    if (cfg.NumSlots > LRBASE_TDMA_MAX_SLOTS) {
+        cfg.NumSlots = LRBASE_TDMA_MAX_SLOTS;
+    }
+    if (cfg.NumContentionSlots < 1) {
+        cfg.NumContentionSlots = 1;
+    }
+    if (cfg.NumContentionSlots > LRBASE_TDMA_MAX_CONTENTION_SLOTS) {
+        cfg.NumContentionSlots = LRBASE_TDMA_MAX_CONTENTION_SLOTS;
+    }
+    if (cfg.MaxPayloadLen > WIMOD_RADIOLINK_PAYLOAD_LEN) {
+        cfg.MaxPayloadLen = WIMOD_RADIOLINK_PAYLOAD_LEN;
+    }
+    if (cfg.SlotTimeout < 2) {
+        cfg.SlotTimeout = 2;
+    }
+    if (role == LRBASE_TDMA_ROLE_COLLECTOR) {
+        updateFrame();
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Set the radio config used for the time on air
+ *
+ * @param radioCfg  current radio config of the module
+ */
+void WiMOD_LRBASE_Tdma::SetRadioConfig(const TWiMODLR_DevMgmt_RadioConfig& radioCfg)
+{
+    radio = radioCfg;
+    if (role == LRBASE_TDMA_ROLE_COLLECTOR) {
+        updateFrame();
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Time on air of a radio frame
+ *
+ * @param radioCfg      radio config (modulation, SF, bandwidth, coding rate)
+ * @param payloadLen    payload of the RadioLink message
+ *
+ * @return time on air in us
+ */
+UINT32 WiMOD_LRBASE_Tdma::CalcAirtimeUs(const TWiMODLR_DevMgmt_RadioConfig& radioCfg, UINT8 payloadLen)
+{
+    UINT8 len = (UINT8) (payloadLen + LRBASE_TDMA_AIR_OVERHEAD);
+
+    if (radioCfg.Modulation == Modulation_FSK) {
+        switch (radioCfg.FskDatarate) {
+            case FskDatarate_100kbps:
+                return AirTimeCalc_FskUs(100000, len);
+            case FskDatarate_250kbps:
+                return AirTimeCalc_FskUs(250000, len);
+            default:
+                return AirTimeCalc_FskUs(50000, len);
+        }
+    }
+
+    UINT8  sf = (radioCfg.LoRaSpreadingFactor <= LoRa7_SF7) ? 7 : (UINT8) radioCfg.LoRaSpreadingFactor;
+    UINT8  bw = (radioCfg.LoRaBandWidth <= LoRaBandwith_500kHz) ? (UINT8) radioCfg.LoRaBandWidth : 0;
+    UINT8  cr = (radioCfg.ErrorCoding == ErrorCoding0_4_5) ? 1 : (UINT8) radioCfg.ErrorCoding;
+
+    return AirTimeCalc_LoRaUs(sf, 125000UL << bw, cr, LRBASE_TDMA_PREAMBLE_LEN, len, 1, 1);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Start as collector; the first beacon is due immediately
+ *
+ * @param groupAddress        group address of the collector
+ * @param deviceAddress       device address of the collector
+ * @param beaconGroupAddress  group address of the nodes; the beacon is sent to it
+ */
+void WiMOD_LRBASE_Tdma::StartCollector(UINT8 groupAddress, UINT16 deviceAddress, UINT8 beaconGroupAddress)
+{
+    UINT8 i;
+
+    Stop();
+    role            = LRBASE_TDMA_ROLE_COLLECTOR;
+    collectorGroup  = groupAddress;
+    collectorDevice = deviceAddress;
+    beaconGroup     = beaconGroupAddress;
+    ownAddress      = deviceAddress;
+    for (i = 0; i < LRBASE_TDMA_MAX_SLOTS; i++) {
+        slotMap[i]  = LRBASE_TDMA_FREE_SLOT;
+        slotIdle[i] = 0;
+    }
+    updateFrame();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Start as node; waits for the first beacon
+ *
+ * @param deviceAddress own device address; identifies the node in the slot map
+ * @param now           current time (ms)
+ */
+void WiMOD_LRBASE_Tdma::StartNode(UINT16 deviceAddress, UINT32 now)
+{
+    Stop();
+    role       = LRBASE_TDMA_ROLE_NODE;
+    ownAddress = deviceAddress;
+    // the address must change the low bits of the seed as well
+    rndState   = (UINT32) deviceAddress * 2654435761UL + now;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Leave the TDMA network
+ */
+void WiMOD_LRBASE_Tdma::Stop(void)
+{
+    role                = LRBASE_TDMA_ROLE_OFF;
+    frameValid          = false;
+    frameStart          = 0;
+    seq                 = 0;
+    ownSlot             = LRBASE_TDMA_NO_SLOT;
+    freeSlots           = 0;
+    requestOffset       = 0;
+    requestFailures     = 0;
+    requestSkip         = 0;
+    dataSentFrame       = LRBASE_TDMA_NOT_READY;
+    requestSent         = false;
+    missedInRow         = 0;
+    beaconRtc           = 0;
+    beaconTimeSet       = false;
+    beaconsSinceRtcSync = 0;
+    rtcSyncPending      = false;
+    alarmPending        = false;
+    numSlots            = 0;
+    numContention       = 0;
+    slotWidthMs         = 0;
+    firstSlotMs         = 0;
+    guardMs             = 0;
+    periodMs            = 1000;
+    memset(&stats, 0x00, sizeof(stats));
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Pass a received U-Data / C-Data message
+ *
+ * Control frames are U-Data messages starting with the frame type and
+ * LRBASE_TDMA_MARKER and of the exact length of their layout.
+ *
+ * @param srcDeviceAddress  source device address of the message
+ * @param uData             true for U-Data, false for C-Data
+ * @param payload           payload of the message
+ * @param length            payload length
+ * @param now               time of reception (ms)
+ *
+ * @retval true     if the message is a TDMA control frame (beacon, slot request)
+ */
+bool WiMOD_LRBASE_Tdma::OnFrame(UINT16 srcDeviceAddress, bool uData, const UINT8* payload, UINT8 length, UINT32 now)
+{
+    UINT8 i;
+
+    if (payload == NULL) {
+        return false;
+    }
+    bool control = uData && (length >= 2) && (payload[1] == LRBASE_TDMA_MARKER);
+
+    if (role == LRBASE_TDMA_ROLE_NODE) {
+        if (control && (payload[0] == LRBASE_TDMA_TYPE_BEACON)) {
+            return onBeacon(payload, length, now);
+        }
+    } else if (role == LRBASE_TDMA_ROLE_COLLECTOR) {
+        if (control && (payload[0] == LRBASE_TDMA_TYPE_SLOT_REQ) && (length == LRBASE_TDMA_SLOT_REQ_SIZE)) {
+            return onSlotRequest(srcDeviceAddress);
+        }
+        // data of a node keeps its slot
+        for (i = 0; i < numSlots; i++) {
+            if (slotMap[i] == srcDeviceAddress) {
+                slotIdle[i] = 0;
+            }
+        }
+    }
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Count missed beacons; a node loses the sync after too many
+ *
+ * @param now       current time (ms)
+ */
+void WiMOD_LRBASE_Tdma::Update(UINT32 now)
+{
+    if ((role != LRBASE_TDMA_ROLE_NODE) || !frameValid) {
+        return;
+    }
+
+    // the next beacon must have been received before the first slot
+    UINT32 elapsed = now - frameStart;
+    UINT32 late    = (elapsed > firstSlotMs) ? (elapsed - firstSlotMs) / periodMs : 0;
+
+    if (late > missedInRow) {
+        stats.MissedBeacons += late - missedInRow;
+        missedInRow          = late;
+    }
+    if (missedInRow > LRBASE_TDMA_MAX_MISSED_BEACONS) {
+        frameValid          = false;
+        beaconsSinceRtcSync = 0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Collector: check if the RTC has to be read for the next beacon
+ *
+ * The RTC is read by a request of its own up to LRBASE_TDMA_HCI_MARGIN_MS
+ * before the beacon is due; pass the time to SetBeaconTime() or call
+ * SkipBeacon() if it could not be read.
+ *
+ * @param now       current time (ms)
+ */
+bool WiMOD_LRBASE_Tdma::IsBeaconTimeDue(UINT32 now) const
+{
+    if ((role != LRBASE_TDMA_ROLE_COLLECTOR) || beaconTimeSet) {
+        return false;
+    }
+    return !frameValid || ((now - frameStart + LRBASE_TDMA_HCI_MARGIN_MS) >= periodMs);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Collector: RTC time for the next beacon
+ *
+ * @param rtcTime   RTC time of the collector; aligns the RTC of the nodes
+ */
+void WiMOD_LRBASE_Tdma::SetBeaconTime(UINT32 rtcTime)
+{
+    beaconRtc     = rtcTime;
+    beaconTimeSet = true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Collector: no beacon for this superframe
+ *
+ * The nodes extrapolate the superframe as for a lost beacon; the next
+ * beacon is due one period later.
+ *
+ * @param now       current time (ms)
+ */
+void WiMOD_LRBASE_Tdma::SkipBeacon(UINT32 now)
+{
+    if (role != LRBASE_TDMA_ROLE_COLLECTOR) {
+        return;
+    }
+    frameStart    = frameValid ? frameStart + periodMs : now;
+    frameValid    = true;
+    beaconTimeSet = false;
+    stats.MissedBeacons++;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Collector: check if the next beacon has to be sent
+ *
+ * @param now       current time (ms)
+ */
+bool WiMOD_LRBASE_Tdma::IsBeaconDue(UINT32 now) const
+{
+    if ((role != LRBASE_TDMA_ROLE_COLLECTOR) || !beaconTimeSet) {
+        return false;
+    }
+    return !frameValid || ((now - frameStart) >= periodMs);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Collector: encode the beacon of the next superframe
+ *
+ * @param buffer    destination (payload of a U-Data message)
+ * @param size      size of the destination
+ *
+ * @return length of the beacon; 0 if the buffer is too small
+ */
+UINT8 WiMOD_LRBASE_Tdma::EncodeBeacon(UINT8* buffer, UINT8 size) const
+{
+    UINT8 len = LRBASE_TDMA_BEACON_HEADER_SIZE + 2 * numSlots;
+    UINT8 i;
+
+    if ((role != LRBASE_TDMA_ROLE_COLLECTOR) || (buffer == NULL) || (size < len)) {
+        return 0;
+    }
+
+    buffer[0]  = LRBASE_TDMA_TYPE_BEACON;
+    buffer[1]  = LRBASE_TDMA_MARKER;
+    buffer[2]  = seq;
+    buffer[3]  = (UINT8) (beaconRtc >> 24);
+    buffer[4]  = (UINT8) (beaconRtc >> 16);
+    buffer[5]  = (UINT8) (beaconRtc >> 8);
+    buffer[6]  = (UINT8) beaconRtc;
+    buffer[7]  = (UINT8) (periodMs / 1000);
+    buffer[8]  = (UINT8) (slotWidthMs >> 8);
+    buffer[9]  = (UINT8) slotWidthMs;
+    buffer[10] = (UINT8) (firstSlotMs >> 8);
+    buffer[11] = (UINT8) firstSlotMs;
+    buffer[12] = (UINT8) (guardMs >> 8);
+    buffer[13] = (UINT8) guardMs;
+    buffer[14] = numSlots;
+    buffer[15] = numContention;
+    buffer[16] = collectorGroup;
+    buffer[17] = (UINT8) (collectorDevice >> 8);
+    buffer[18] = (UINT8) collectorDevice;
+
+    for (i = 0; i < numSlots; i++) {
+        buffer[LRBASE_TDMA_BEACON_HEADER_SIZE + 2 * i]     = (UINT8) (slotMap[i] >> 8);
+        buffer[LRBASE_TDMA_BEACON_HEADER_SIZE + 2 * i + 1] = (UINT8) slotMap[i];
+    }
+    return len;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Collector: the beacon has been accepted by the module
+ *
+ * Starts the superframe and frees the slots of silent nodes.
+ *
+ * @param now       time of the beacon (ms)
+ */
+void WiMOD_LRBASE_Tdma::OnBeaconSent(UINT32 now)
+{
+    UINT8 i;
+
+    if (frameValid) {
+        for (i = 0; i < numSlots; i++) {
+            if ((slotMap[i] != LRBASE_TDMA_FREE_SLOT) && (++slotIdle[i] > cfg.SlotTimeout)) {
+                slotMap[i] = LRBASE_TDMA_FREE_SLOT;
+            }
+        }
+    }
+    // a changed config takes effect with this beacon
+    updateFrame();
+
+    frameStart    = now;
+    frameValid    = true;
+    beaconTimeSet = false;
+    seq++;
+    stats.Beacons++;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Node: time until the own slot opens
+ *
+ * @param now       current time (ms)
+ *
+ * @return 0 if the C-Data message can be sent now;
+ *         LRBASE_TDMA_NOT_READY if there is no beacon or no own slot
+ */
+UINT32 WiMOD_LRBASE_Tdma::GetMsUntilSlot(UINT32 now) const
+{
+    if ((role != LRBASE_TDMA_ROLE_NODE) || (ownSlot >= numSlots)) {
+        return LRBASE_TDMA_NOT_READY;
+    }
+    return getMsUntil(now, firstSlotMs + (UINT32) ownSlot * slotWidthMs, dataSentFrame);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Node: a C-Data message has been sent; the slot is used
+ *
+ * @param now       time of the request (ms)
+ */
+void WiMOD_LRBASE_Tdma::OnDataSent(UINT32 now)
+{
+    if ((role == LRBASE_TDMA_ROLE_NODE) && frameValid) {
+        dataSentFrame = (now - frameStart) / periodMs;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Node: check if a slot request has to be sent now
+ *
+ * A node without slot sends at most one request per beacon in a random
+ * mini slot of the contention slots, as long as the slot map has free
+ * slots. A request that is not granted by the next beacon is repeated
+ * after a random number of beacons.
+ *
+ * @param now       current time (ms)
+ */
+bool WiMOD_LRBASE_Tdma::IsSlotRequestDue(UINT32 now) const
+{
+    if ((role != LRBASE_TDMA_ROLE_NODE) || (ownSlot != LRBASE_TDMA_NO_SLOT) || requestSent
+            || (requestSkip > 0) || (freeSlots == 0) || (numContention == 0)) {
+        return false;
+    }
+    return (getMsUntil(now, requestOffset, LRBASE_TDMA_NOT_READY) == 0);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Node: encode a slot request
+ *
+ * @param buffer    destination (payload of a U-Data message to the collector)
+ * @param size      size of the destination
+ *
+ * @return length of the request; 0 if the buffer is too small
+ */
+UINT8 WiMOD_LRBASE_Tdma::EncodeSlotRequest(UINT8* buffer, UINT8 size) const
+{
+    if ((buffer == NULL) || (size < LRBASE_TDMA_SLOT_REQ_SIZE)) {
+        return 0;
+    }
+    buffer[0] = LRBASE_TDMA_TYPE_SLOT_REQ;
+    buffer[1] = LRBASE_TDMA_MARKER;
+    return LRBASE_TDMA_SLOT_REQ_SIZE;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Node: the slot request has been sent
+ */
+void WiMOD_LRBASE_Tdma::OnSlotRequestSent(void)
+{
+    requestSent = true;
+    stats.SlotRequests++;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Node: RTC time to set after a beacon
+ *
+ * The RTC is set by the first beacon and then every
+ * LRBASE_TDMA_RTC_SYNC_BEACONS beacons; not shortly before an own slot.
+ *
+ * @param now       current time (ms)
+ * @param rtcTime   receives the RTC time of the beacon
+ *
+ * @retval true     if the RTC has to be set
+ */
+bool WiMOD_LRBASE_Tdma::TakeRtcSync(UINT32 now, UINT32* rtcTime)
+{
+    if (!rtcSyncPending || (rtcTime == NULL) || isSlotNear(now)) {
+        return false;
+    }
+    *rtcTime       = beaconRtc;
+    rtcSyncPending = false;
+    stats.RtcSyncs++;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Node: RTC alarm for the next beacon
+ *
+ * The alarm is one second ahead of the next beacon (RTC resolution).
+ *
+ * @param now       current time (ms)
+ * @param alarm     receives the alarm
+ *
+ * @retval true     if the alarm has to be set
+ */
+bool WiMOD_LRBASE_Tdma::TakeRtcAlarm(UINT32 now, TWiMODLR_DevMgmt_RtcAlarm* alarm)
+{
+    if (!alarmPending || (alarm == NULL) || isSlotNear(now)) {
+        return false;
+    }
+
+    UINT32 sec = (UINT32) WIMOD_RTC_GET_HOURS(beaconRtc) * 3600
+               + (UINT32) WIMOD_RTC_GET_MINUTES(beaconRtc) * 60
+               + (UINT32) WIMOD_RTC_GET_SECONDS(beaconRtc);
+
+    sec = (sec + periodMs / 1000 - 1) % 86400UL;
+
+    alarm->Options = RTC_Alarm_Single;
+    alarm->Hour    = (UINT8) (sec / 3600);
+    alarm->Minutes = (UINT8) ((sec / 60) % 60);
+    alarm->Seconds = (UINT8) (sec % 60);
+    alarmPending   = false;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the state of the TDMA network
+ *
+ * @param info      pointer where to store the state
+ */
+void WiMOD_LRBASE_Tdma::GetInfo(TWiMODLR_TdmaInfo* info) const
+{
+    UINT8 i;
+
+    *info              = stats;
+    info->Role         = role;
+    info->Synchronised = frameValid;
+    info->OwnSlot      = (role == LRBASE_TDMA_ROLE_NODE) ? ownSlot : LRBASE_TDMA_NO_SLOT;
+    info->NumSlots     = numSlots;
+    info->SlotWidthMs  = slotWidthMs;
+    info->SuperframeMs = periodMs;
+
+    if (role == LRBASE_TDMA_ROLE_COLLECTOR) {
+        info->AssignedSlots = 0;
+        for (i = 0; i < numSlots; i++) {
+            if (slotMap[i] != LRBASE_TDMA_FREE_SLOT) {
+                info->AssignedSlots++;
+            }
+        }
+    } else {
+        info->AssignedSlots = numSlots - freeSlots;
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+// Section private functions
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+bool WiMOD_LRBASE_Tdma::onBeacon(const UINT8* p, UINT8 length, UINT32 now)
+{
+    UINT8 n;
+    UINT8 i;
+
+    // anything else than a complete beacon goes to the application
+    if (length < LRBASE_TDMA_BEACON_HEADER_SIZE) {
+        return false;
+    }
+    n = p[14];
+    if ((n > LRBASE_TDMA_MAX_SLOTS) || (p[7] == 0) || (length != (LRBASE_TDMA_BEACON_HEADER_SIZE + 2 * n))) {
+        return false;
+    }
+
+    beaconRtc       = (UINT32) p[3] << 24 | (UINT32) p[4] << 16 | (UINT32) p[5] << 8 | p[6];
+    periodMs        = (UINT32) p[7] * 1000;
+    slotWidthMs     = (UINT16) p[8] << 8 | p[9];
+    firstSlotMs     = (UINT16) p[10] << 8 | p[11];
+    guardMs         = (UINT16) p[12] << 8 | p[13];
+    numSlots        = n;
+    numContention   = p[15];
+    collectorGroup  = p[16];
+    collectorDevice = (UINT16) p[17] << 8 | p[18];
+
+    ownSlot   = LRBASE_TDMA_NO_SLOT;
+    freeSlots = 0;
+    for (i = 0; i < n; i++) {
+        UINT16 adr = (UINT16) p[LRBASE_TDMA_BEACON_HEADER_SIZE + 2 * i] << 8
+                   | p[LRBASE_TDMA_BEACON_HEADER_SIZE + 2 * i + 1];
+        if (adr == ownAddress) {
+            ownSlot = i;
+        } else if (adr == LRBASE_TDMA_FREE_SLOT) {
+            freeSlots++;
+        }
+    }
+
+    // the beacon has started one time on air before its reception
+    frameStart    = now - toMs(CalcAirtimeUs(radio, length));
+    frameValid    = true;
+    missedInRow   = 0;
+    dataSentFrame = LRBASE_TDMA_NOT_READY;
+
+    if (ownSlot != LRBASE_TDMA_NO_SLOT) {
+        requestFailures = 0;
+        requestSkip     = 0;
+    } else if (requestSent) {
+        // no grant; back off
+        if (requestFailures < LRBASE_TDMA_MAX_BACKOFF_EXP) {
+            requestFailures++;
+        }
+        requestSkip = (UINT8) nextRandom((UINT32) 1 << requestFailures);
+    } else if (requestSkip > 0) {
+        requestSkip--;
+    }
+    requestSent = false;
+
+    if ((ownSlot == LRBASE_TDMA_NO_SLOT) && (numContention > 0)) {
+        // several requests fit into one contention slot
+        UINT32 miniMs   = toMs(CalcAirtimeUs(radio, LRBASE_TDMA_SLOT_REQ_SIZE)) + guardMs;
+        UINT32 perSlot  = (slotWidthMs > miniMs) ? slotWidthMs / miniMs : 1;
+        UINT32 mini     = nextRandom(numContention * perSlot);
+
+        requestOffset = firstSlotMs + ((UINT32) numSlots + mini / perSlot) * slotWidthMs + (mini % perSlot) * miniMs;
+    }
+    stats.Beacons++;
+
+    if (beaconsSinceRtcSync == 0) {
+        rtcSyncPending = true;
+    }
+    beaconsSinceRtcSync = (beaconsSinceRtcSync + 1) % LRBASE_TDMA_RTC_SYNC_BEACONS;
+    alarmPending        = true;
+    return true;
+}
+
+bool WiMOD_LRBASE_Tdma::onSlotRequest(UINT16 srcDeviceAddress)
+{
+    UINT8 i;
+    UINT8 freeSlot = LRBASE_TDMA_NO_SLOT;
+
+    stats.SlotRequests++;
+    for (i = 0; i < numSlots; i++) {
+        if (slotMap[i] == srcDeviceAddress) {
+            // granted already; the beacon has been lost
+            slotIdle[i] = 0;
+            return true;
+        }
+        if ((slotMap[i] == LRBASE_TDMA_FREE_SLOT) && (freeSlot == LRBASE_TDMA_NO_SLOT)) {
+            freeSlot = i;
+        }
+    }
+    if (freeSlot != LRBASE_TDMA_NO_SLOT) {
+        slotMap[freeSlot]  = srcDeviceAddress;
+        slotIdle[freeSlot] = 0;
+    }
+    return true;
+}
+
+void WiMOD_LRBASE_Tdma::updateFrame(void)
+{
+    UINT32 dataMs   = toMs(CalcAirtimeUs(radio, cfg.MaxPayloadLen));
+    UINT32 ackMs    = toMs(CalcAirtimeUs(radio, 0));
+    UINT32 beaconMs = toMs(CalcAirtimeUs(radio, LRBASE_TDMA_BEACON_HEADER_SIZE + 2 * cfg.NumSlots));
+    UINT8  i;
+
+    // slots beyond a reduced number of slots are released
+    for (i = cfg.NumSlots; i < LRBASE_TDMA_MAX_SLOTS; i++) {
+        slotMap[i] = LRBASE_TDMA_FREE_SLOT;
+    }
+
+    numSlots      = cfg.NumSlots;
+    numContention = cfg.NumContentionSlots;
+    guardMs       = cfg.GuardMs;
+    slotWidthMs   = (UINT16) (dataMs + LRBASE_TDMA_ACK_TURNAROUND_MS + ackMs + guardMs);
+    firstSlotMs   = (UINT16) (beaconMs + guardMs);
+
+    // whole seconds; the beacon carries the period in s and nodes wake by the RTC
+    periodMs = firstSlotMs + ((UINT32) numSlots + numContention) * slotWidthMs;
+    periodMs = ((periodMs + 999) / 1000) * 1000;
+    if (periodMs > 255000UL) {
+        periodMs = 255000UL;
+    }
+}
+
+bool WiMOD_LRBASE_Tdma::isSlotNear(UINT32 now) const
+{
+    UINT32 ms = GetMsUntilSlot(now);
+
+    if ((ownSlot == LRBASE_TDMA_NO_SLOT) && !requestSent && (requestSkip == 0) && (freeSlots > 0) && (numContention > 0)) {
+        ms = getMsUntil(now, requestOffset, LRBASE_TDMA_NOT_READY);
+    }
+    return (ms < LRBASE_TDMA_HCI_MARGIN_MS);
+}
+
+UINT32 WiMOD_LRBASE_Tdma::getMsUntil(UINT32 now, UINT32 offset, UINT32 usedFrame) const
+{
+    if (!frameValid) {
+        return LRBASE_TDMA_NOT_READY;
+    }
+
+    // superframes after a missed beacon are extrapolated
+    UINT32 elapsed = now - frameStart;
+    UINT32 frame   = elapsed / periodMs;
+    UINT32 phase   = elapsed % periodMs;
+
+    if ((frame == usedFrame) || (phase >= (offset + guardMs))) {
+        return periodMs - phase + offset;
+    }
+    if (phase < offset) {
+        return offset - phase;
+    }
+    return 0;
+}
+
+UINT32 WiMOD_LRBASE_Tdma::nextRandom(UINT32 range)
+{
+    rndState = rndState * 1103515245UL + 12345UL;
+    return (rndState >> 16) % range;
+}
+//! @endcond
@@ -0,0 +1,250 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LRBASE_Tdma.h
+//! @ingroup WiMODLR_BASE
+//! <!------------------------------------------------------------------------->
+//! @brief Declarations for the TDMA star network
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//! Beacon based time slots for many LR-BASE nodes sending to one collector.
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+
+#ifndef ARDUINO_WIMOD_LRBASE_TDMA_H_
+#define ARDUINO_WIMOD_LRBASE_TDMA_H_
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "../SAP/WiMOD_SAP_DEVMGMT_IDs.h"
+#include "../SAP/WiMOD_SAP_RadioLink_IDs.h"
+
+//------------------------------------------------------------------------------
+//
+// Section defines
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+/*
+ * Frame layout (U-Data; type and marker first, big endian):
+ *
+ *  BEACON   : [type] [marker] [seq] [rtc time u32] [period s]
+ *             [slot width ms u16] [first slot ms u16] [guard ms u16]
+ *             [num slots] [num contention slots]
+ *             [collector group adr] [collector device adr u16]
+ *             [device adr u16] * num slots      (LRBASE_TDMA_FREE_SLOT = free)
+ *  SLOT_REQ : [type] [marker]
+ *
+ *  superframe (starts with the beacon, length = period s):
+ *
+ *  | beacon | guard | slot 0 | slot 1 | ... | slot n-1 | contention 0 | ... |
+ *
+ *  A node sends its C-Data at the start of its own slot; the slot is wide
+ *  enough for the data, the ack and a guard time. Nodes without a slot send
+ *  a SLOT_REQ (U-Data) in a random mini slot of the contention slots; after
+ *  a request without grant a node skips a random number of beacons
+ *  (binary exponential backoff).
+ *
+ *  Only U-Data frames of exactly this layout are taken as control frames;
+ *  C-Data always goes to the application. U-Data payloads of the
+ *  application must not start with [type] [marker].
+ */
+#define LRBASE_TDMA_TYPE_BEACON                     0xC1
+#define LRBASE_TDMA_TYPE_SLOT_REQ                   0xC2
+#define LRBASE_TDMA_MARKER                          0x7D
+
+#define LRBASE_TDMA_BEACON_HEADER_SIZE              19
+#define LRBASE_TDMA_SLOT_REQ_SIZE                   2
+#define LRBASE_TDMA_MAX_SLOTS                       32
+#define LRBASE_TDMA_MAX_CONTENTION_SLOTS            8
+
+#define LRBASE_TDMA_FREE_SLOT                       0xFFFF
+#define LRBASE_TDMA_NO_SLOT                         0xFF
+#define LRBASE_TDMA_NOT_READY                       0xFFFFFFFF
+
+// addressing and control fields of a radio frame (approximation)
+#define LRBASE_TDMA_AIR_OVERHEAD                    8
+#define LRBASE_TDMA_PREAMBLE_LEN                    8
+#define LRBASE_TDMA_ACK_TURNAROUND_MS               10
+
+#define LRBASE_TDMA_MAX_MISSED_BEACONS              3
+#define LRBASE_TDMA_RTC_SYNC_BEACONS                16
+#define LRBASE_TDMA_MAX_BACKOFF_EXP                 5
+// no RTC requests this close before an own slot; collector: RTC read ahead of the beacon
+#define LRBASE_TDMA_HCI_MARGIN_MS                   100
+
+#define LRBASE_TDMA_DEFAULT_NUM_SLOTS               16
+#define LRBASE_TDMA_DEFAULT_NUM_CONTENTION          2
+#define LRBASE_TDMA_DEFAULT_MAX_PAYLOAD             20
+#define LRBASE_TDMA_DEFAULT_GUARD_MS                20
+#define LRBASE_TDMA_DEFAULT_SLOT_TIMEOUT            10
+//! @endcond
+
+//------------------------------------------------------------------------------
+//
+// Section types
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Role of the device in the TDMA network
+ */
+typedef enum TWiMODLR_TdmaRole
+{
+    LRBASE_TDMA_ROLE_OFF = 0,                                                   /*!< TDMA not used */
+    LRBASE_TDMA_ROLE_COLLECTOR,                                                 /*!< sends the beacon, assigns the slots */
+    LRBASE_TDMA_ROLE_NODE,                                                      /*!< sends in its own slot */
+} TWiMODLR_TdmaRole;
+
+/**
+ * @brief Superframe parameters; only used by the collector
+ */
+typedef struct TWiMODLR_TdmaConfig
+{
+    UINT8       NumSlots;                                                       /*!< data slots per superframe */
+    UINT8       NumContentionSlots;                                             /*!< slots for slot requests */
+    UINT8       MaxPayloadLen;                                                  /*!< largest C-Data payload of a node */
+    UINT16      GuardMs;                                                        /*!< guard time per slot; max. timing error of a node; sent with the beacon */
+    UINT8       SlotTimeout;                                                    /*!< superframes without data before a slot is freed */
+} TWiMODLR_TdmaConfig;
+
+/**
+ * @brief State of the TDMA network
+ */
+typedef struct TWiMODLR_TdmaInfo
+{
+    TWiMODLR_TdmaRole Role;                                                     /*!< role of this device */
+    bool        Synchronised;                                                   /*!< node: beacons are received */
+    UINT8       OwnSlot;                                                        /*!< node: own slot; LRBASE_TDMA_NO_SLOT if none */
+    UINT8       NumSlots;                                                       /*!< data slots per superframe */
+    UINT8       AssignedSlots;                                                  /*!< slots in use */
+    UINT16      SlotWidthMs;                                                    /*!< width of a slot */
+    UINT32      SuperframeMs;                                                   /*!< beacon period */
+    UINT32      Beacons;                                                        /*!< beacons sent / received */
+    UINT32      MissedBeacons;                                                  /*!< node: beacons not received; collector: beacons skipped */
+    UINT32      SlotRequests;                                                   /*!< slot requests sent / received */
+    UINT32      RtcSyncs;                                                       /*!< node: RTC updates by the beacon */
+} TWiMODLR_TdmaInfo;
+
+//------------------------------------------------------------------------------
+//
+// Section class
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Beacon, slot map and slot timing of a TDMA star network
+ *
+ * The collector broadcasts a beacon with the slot map at the start of each
+ * superframe. The slot width is derived from the time on air of the
+ * largest data frame and its ack. Nodes take the reception time of the
+ * beacon as time reference for their slot and the guard time of the
+ * collector from the beacon; the RTC time of the beacon aligns the RTC of
+ * the node for alarms (one second resolution). The collector reads its RTC
+ * up to LRBASE_TDMA_HCI_MARGIN_MS ahead of the beacon (SetBeaconTime).
+ *
+ * The class does not send anything itself; the caller polls it and issues
+ * the HCI requests.
+ */
+class WiMOD_LRBASE_Tdma
+{
+public:
+    WiMOD_LRBASE_Tdma(void);
+
+    void                SetConfig(const TWiMODLR_TdmaConfig& config);
+    void                SetRadioConfig(const TWiMODLR_DevMgmt_RadioConfig& radioCfg);
+
+    static UINT32       CalcAirtimeUs(const TWiMODLR_DevMgmt_RadioConfig& radioCfg, UINT8 payloadLen);
+
+    void                StartCollector(UINT8 groupAddress, UINT16 deviceAddress, UINT8 beaconGroupAddress);
+    void                StartNode(UINT16 deviceAddress, UINT32 now);
+    void                Stop(void);
+    TWiMODLR_TdmaRole   GetRole(void) const { return role; }
+
+    bool                OnFrame(UINT16 srcDeviceAddress, bool uData, const UINT8* payload, UINT8 length, UINT32 now);
+    void                Update(UINT32 now);
+
+    // collector
+    bool                IsBeaconTimeDue(UINT32 now) const;
+    void                SetBeaconTime(UINT32 rtcTime);
+    void                SkipBeacon(UINT32 now);
+    bool                IsBeaconDue(UINT32 now) const;
+    UINT8               EncodeBeacon(UINT8* buffer, UINT8 size) const;
+    void                OnBeaconSent(UINT32 now);
+    UINT8               GetBeaconGroupAddress(void) const { return beaconGroup; }
+
+    // node
+    UINT32              GetMsUntilSlot(UINT32 now) const;
+    void                OnDataSent(UINT32 now);
+    bool                IsSlotRequestDue(UINT32 now) const;
+    UINT8               EncodeSlotRequest(UINT8* buffer, UINT8 size) const;
+    void                OnSlotRequestSent(void);
+    bool                TakeRtcSync(UINT32 now, UINT32* rtcTime);
+    bool                TakeRtcAlarm(UINT32 now, TWiMODLR_DevMgmt_RtcAlarm* alarm);
+    UINT8               GetCollectorGroupAddress(void) const { return collectorGroup; }
+    UINT16              GetCollectorDeviceAddress(void) const { return collectorDevice; }
+
+    void                GetInfo(TWiMODLR_TdmaInfo* info) const;
+
+private:
+    //! @cond Doxygen_Suppress
+    bool                onBeacon(const UINT8* payload, UINT8 length, UINT32 now);
+    bool                onSlotRequest(UINT16 srcDeviceAddress);
+    void                updateFrame(void);
+    bool                isSlotNear(UINT32 now) const;
+    UINT32              getMsUntil(UINT32 now, UINT32 offset, UINT32 usedFrame) const;
+    UINT32              nextRandom(UINT32 range);
+
+    TWiMODLR_TdmaConfig cfg;
+    TWiMODLR_DevMgmt_RadioConfig radio;
+    TWiMODLR_TdmaRole   role;
+
+    // superframe, from the config (collector) or the beacon (node)
+    UINT8               numSlots;
+    UINT8               numContention;
+    UINT16              slotWidthMs;
+    UINT16              firstSlotMs;
+    UINT16              guardMs;
+    UINT32              periodMs;
+    UINT32              frameStart;                                             // start of the last beacon
+    bool                frameValid;
+
+    UINT16              slotMap[LRBASE_TDMA_MAX_SLOTS];
+    UINT8               slotIdle[LRBASE_TDMA_MAX_SLOTS];
+    UINT8               seq;
+
+    UINT16              ownAddress;
+    UINT8               ownSlot;
+    UINT8               freeSlots;
+    UINT32              requestOffset;                                          // start of the chosen request mini slot
+    UINT8               requestFailures;
+    UINT8               requestSkip;
+    UINT32              dataSentFrame;
+    bool                requestSent;
+    UINT8               collectorGroup;
+    UINT16              collectorDevice;
+    UINT8               beaconGroup;
+    UINT32              missedInRow;
+
+    UINT32              beaconRtc;                                              // collector: RTC time of the next beacon
+    bool                beaconTimeSet;
+    UINT8               beaconsSinceRtcSync;
+    bool                rtcSyncPending;
+    bool                alarmPending;
+
+    UINT32              rndState;
+    TWiMODLR_TdmaInfo   stats;
+    //! @endcond
+};
+
+#endif /* ARDUINO_WIMOD_LRBASE_TDMA_H_ */
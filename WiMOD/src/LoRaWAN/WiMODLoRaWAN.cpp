@@ -71,11 +71,14 @@ WiMODLoRaWAN::WiMODLoRaWAN(Stream& s) :
     SapLoRaWan(this, txBuffer, WiMOD_LORAWAN_TX_BUFFER_SIZE)
 {
 
-    localStatusRsp = 0;
-    cmdResult      = false;
-    localHciRes    = WiMODLR_RESULT_TRANMIT_ERROR;
-    lastHciRes     = WiMODLR_RESULT_TRANMIT_ERROR;
-    lastStatusRsp  = 0;
+    localStatusRsp   = 0;
+    cmdResult        = false;
+#if WIMOD_LORAWAN_USE_UPLINK_SCHEDULER
+    schedulerSeedSet = false;
+#endif
+    localHciRes      = WiMODLR_RESULT_TRANMIT_ERROR;
+    lastHciRes       = WiMODLR_RESULT_TRANMIT_ERROR;
+    lastStatusRsp    = 0;
     memset(txBuffer, 0x00, WiMOD_LORAWAN_TX_BUFFER_SIZE);
 }
 
@@ -270,6 +273,9 @@ bool WiMODLoRaWAN::Ping(TWiMDLRResultCodes*         hciResult,
 bool WiMODLoRaWAN::Reset(TWiMDLRResultCodes*         hciResult,
                          UINT8*                      rspStatus)
 {
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+    ConfigCache.Invalidate();
+#endif
     localHciRes = SapDevMgmt.Reset(&localStatusRsp);
     return copyDevMgmtResultInfos(hciResult, rspStatus);
 }
@@ -836,7 +842,14 @@ bool WiMODLoRaWAN::ActivateDevice(TWiMODLORAWAN_ActivateDeviceData& activationDa
 {
 
     localHciRes = SapLoRaWan.ActivateDevice(activationData, &localStatusRsp);
-    return copyLoRaWanResultInfos(hciResult, rspStatus);
+    cmdResult   = copyLoRaWanResultInfos(hciResult, rspStatus);
+
+#if WIMOD_LORAWAN_USE_UPLINK_SCHEDULER
+    if (cmdResult && !schedulerSeedSet) {
+        Scheduler.SetSeed(activationData.DeviceAddress);
+    }
+#endif
+    return cmdResult;
 }
 
 
@@ -903,7 +916,14 @@ bool WiMODLoRaWAN::ReactivateDevice(UINT32* devAdr,
 {
 
     localHciRes = SapLoRaWan.ReactivateDevice(devAdr, &localStatusRsp);
-    return copyLoRaWanResultInfos(hciResult, rspStatus);
+    cmdResult   = copyLoRaWanResultInfos(hciResult, rspStatus);
+
+#if WIMOD_LORAWAN_USE_UPLINK_SCHEDULER
+    if (cmdResult && devAdr && !schedulerSeedSet) {
+        Scheduler.SetSeed(*devAdr);
+    }
+#endif
+    return cmdResult;
 }
 
 //-----------------------------------------------------------------------------
@@ -1107,6 +1127,37 @@ bool WiMODLoRaWAN::convert(TWiMODLR_HCIMessage& RxMsg,
     return SapLoRaWan.convert(RxMsg, loraWanRxData);
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * @brief Reference the payload of a received Rx Data message without copying
+ *
+ * Alternative to convert(RxMsg, TWiMODLORAWAN_RX_Data*) for callbacks that
+ * only parse the payload: no copy into a WiMODLORAWAN_APP_PAYLOAD_LEN buffer
+ * is made. The view must not be used after the callback has returned.
+ *
+ * @param   RxMsg       Reference to low-level HCI message.
+ *                      @warning DO NOT MANIPULATE THESE VALUES !!!
+ *
+ * @param   rxDataView  Pointer to the view to fill
+ *
+ * @retval true     if the conversion was successful
+ *
+ * @code
+ * void onRxData(TWiMODLR_HCIMessage& rxMsg) {
+ * 	TWiMODLORAWAN_RX_DataView view;
+ *
+ * 	if (wimod.convert(rxMsg, &view) && (view.Port == MY_PORT)) {
+ * 		parse(view.Payload, view.Length);
+ * 	}
+ * }
+ * @endcode
+ */
+bool WiMODLoRaWAN::convert(const TWiMODLR_HCIMessage& RxMsg,
+        TWiMODLORAWAN_RX_DataView* rxDataView)
+{
+    return SapLoRaWan.convert(RxMsg, rxDataView);
+}
+
 //-----------------------------------------------------------------------------
 /**
  * @brief Convert a received low level HCI-Msg to a high-level tx ind structure
@@ -1216,6 +1267,70 @@ bool WiMODLoRaWAN::convert(TWiMODLR_HCIMessage& RxMsg,
     return SapLoRaWan.convert(RxMsg, loraWanMacCmdData);
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * @brief Reference the MAC commands of a RxMacCmd indication without copying
+ *
+ * Alternative to convert(RxMsg, TWiMODLORAWAN_RX_MacCmdData*); the view
+ * must not be used after the callback has returned. Known answers can be
+ * decoded from the view by the typed convert() functions.
+ *
+ * @param   RxMsg       Reference to low-level HCI message.
+ *                      @warning DO NOT MANIPULATE THESE VALUES !!!
+ *
+ * @param   macCmdView  Pointer to the view to fill
+ *
+ * @retval true     if the conversion was successful
+ *
+ * @code
+ * void onRxMacCmd(TWiMODLR_HCIMessage& rxMsg) {
+ * 	TWiMODLORAWAN_RX_MacCmdView view;
+ * 	TWiMODLORAWAN_LinkCheckAns  linkCheck;
+ *
+ * 	if (wimod.convert(rxMsg, &view) && wimod.convert(view, &linkCheck)) {
+ * 		// linkCheck.Margin, linkCheck.GwCnt
+ * 	}
+ * }
+ * @endcode
+ */
+bool WiMODLoRaWAN::convert(const TWiMODLR_HCIMessage& RxMsg,
+        TWiMODLORAWAN_RX_MacCmdView* macCmdView)
+{
+    return SapLoRaWan.convert(RxMsg, macCmdView);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Decode a LinkCheckAns from received MAC commands
+ *
+ * @param   macCmdView      MAC commands referenced by convert()
+ *
+ * @param   linkCheckAns    Pointer to the decoded answer
+ *
+ * @retval true     if the MAC commands contain a LinkCheckAns
+ */
+bool WiMODLoRaWAN::convert(const TWiMODLORAWAN_RX_MacCmdView& macCmdView,
+        TWiMODLORAWAN_LinkCheckAns* linkCheckAns)
+{
+    return SapLoRaWan.convert(macCmdView, linkCheckAns);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Decode a DeviceTimeAns from received MAC commands
+ *
+ * @param   macCmdView      MAC commands referenced by convert()
+ *
+ * @param   deviceTimeAns   Pointer to the decoded answer
+ *
+ * @retval true     if the MAC commands contain a DeviceTimeAns
+ */
+bool WiMODLoRaWAN::convert(const TWiMODLORAWAN_RX_MacCmdView& macCmdView,
+        TWiMODLORAWAN_DeviceTimeAns* deviceTimeAns)
+{
+    return SapLoRaWan.convert(macCmdView, deviceTimeAns);
+}
+
 //-----------------------------------------------------------------------------
 /**
  * @brief Convert a received low level HCI-Msg to a high-level NwkJoined structure
@@ -1660,6 +1775,9 @@ bool WiMODLoRaWAN::SendUData(const TWiMODLORAWAN_TX_Data* data,
                              TWiMDLRResultCodes*         hciResult,
                              UINT8*                      rspStatus)
 {
+#if WIMOD_LORAWAN_USE_MAC_CMD_QUEUE
+    flushMacCmdQueue();
+#endif
     localHciRes = SapLoRaWan.SendUData(data, &localStatusRsp);
     return copyLoRaWanResultInfos(hciResult, rspStatus);
 }
@@ -1718,10 +1836,318 @@ bool WiMODLoRaWAN::SendCData(const TWiMODLORAWAN_TX_Data* data,
                              TWiMDLRResultCodes*         hciResult,
                              UINT8*                      rspStatus)
 {
+#if WIMOD_LORAWAN_USE_MAC_CMD_QUEUE
+    flushMacCmdQueue();
+#endif
     localHciRes = SapLoRaWan.SendCData(data, &localStatusRsp);
     return copyLoRaWanResultInfos(hciResult, rspStatus);
 }
 
+#if WIMOD_LORAWAN_USE_CONFIRMED_UPLINK
+//-----------------------------------------------------------------------------
+/**
+ * @brief Sends C-Data and tracks the uplink until its final state
+ *
+ * The uplink is tracked through SEND_CDATA_RSP, SEND_CDATA_TX_IND and
+ * RECV_ACK_IND / RECV_NO_DATA_IND. Number of radio packets and airtime are
+ * recorded for every uplink. If a policy has been set, the data rate may be
+ * raised or the uplink may be sent as U-Data in order to keep the airtime
+ * per delivered byte bounded. A raised data rate is written to the module
+ * and lowered again step by step once the airtime per byte has recovered.
+ *
+ * Only one tracked uplink can be in flight; further requests are rejected
+ * with status LORAWAN_STATUS_DEVICE_BUSY.
+ *
+ * @param data       pointer to data structure containing the TX-data and options.
+ *                   @see TWiMODLORAWAN_TX_Data for details
+ *
+ * @param seqID      sequence ID assigned to this uplink (optional)
+ *
+ * @param hciResult Result of the local command transmission to module
+ *                  This is an optional parameter.
+ *
+ * @param rspStatus Status byte contained in the local response of the module
+ *                  This is an optional parameter.
+ *
+ * @retval true     if the request has been accepted by the module
+ * @retval false    if something went wrong; see hciResult & rspStatus for details
+ *
+ * @code
+ * void myUplinkDone(const TWiMODLORAWAN_CUplinkInfo& info) {
+ *     if (info.State == LORAWAN_CUPLINK_STATE_ACKED) {
+ *         // uplink info.SeqID has been delivered
+ *     }
+ * }
+ *
+ * void setup() {
+ *     ...
+ *     wimod.RegisterConfirmedUplinkClient(myUplinkDone);
+ * }
+ *
+ * void loop() {
+ *     ...
+ *     wimod.SendConfirmedUplink(&txData, &seqID);
+ *     ...
+ *     wimod.Process();
+ * }
+ * @endcode
+ */
+bool WiMODLoRaWAN::SendConfirmedUplink(const TWiMODLORAWAN_TX_Data* data,
+                                       UINT16*                     seqID,
+                                       TWiMDLRResultCodes*         hciResult,
+                                       UINT8*                      rspStatus)
+{
+    TWiMODLORAWAN_RadioStackConfig radioCfg;
+    bool                           confirmed;
+
+    CUplink.CheckTimeout(millis());
+    if (CUplink.IsBusy()) {
+        localHciRes    = WiMODLR_RESULT_OK;
+        localStatusRsp = LORAWAN_STATUS_DEVICE_BUSY;
+        return copyLoRaWanResultInfos(hciResult, rspStatus);
+    }
+
+    // policy: raise / restore data rate (only possible if ADR is off); if
+    // the module refuses, the uplink goes out on the current data rate
+    if (GetRadioStackConfig(&radioCfg) && !(radioCfg.Options & LORAWAN_STK_OPTION_ADR)) {
+        UINT8 dr = CUplink.GetDataRateAdvice(radioCfg.DataRateIndex);
+        if (dr != radioCfg.DataRateIndex) {
+            UINT8 oldDr = radioCfg.DataRateIndex;
+
+            radioCfg.DataRateIndex = dr;
+            if (SetRadioStackConfig(&radioCfg)) {
+                CUplink.OnDataRateApplied(oldDr, dr);
+            }
+        }
+    }
+
+#if WIMOD_LORAWAN_USE_MAC_CMD_QUEUE
+    flushMacCmdQueue();
+#endif
+
+    // policy: fall back to unconfirmed uplinks
+    confirmed = CUplink.UseConfirmed();
+    if (confirmed) {
+        localHciRes = SapLoRaWan.SendCData(data, &localStatusRsp);
+    } else {
+        localHciRes = SapLoRaWan.SendUData(data, &localStatusRsp);
+    }
+
+    cmdResult = copyLoRaWanResultInfos(hciResult, rspStatus);
+
+    UINT16 id = CUplink.OnRequest(data, confirmed, cmdResult, localStatusRsp, millis());
+    if (seqID) {
+        *seqID = id;
+    }
+    return cmdResult;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Sets the host side policy for SendConfirmedUplink()
+ *
+ * @param policy    policy parameters; MaxAirtimePerByteUs = 0 disables the policy
+ *
+ * @code
+ * TWiMODLORAWAN_CUplinkPolicy policy;
+ *
+ * policy.MaxAirtimePerByteUs = 20000;     // 20 ms per delivered byte
+ * policy.Actions             = LORAWAN_CUPLINK_ACTION_RAISE_DR
+ *                              | LORAWAN_CUPLINK_ACTION_UNCONFIRMED;
+ * policy.MaxDataRateIndex    = 5;
+ * policy.ProbeInterval       = 10;        // every 10th uplink confirmed
+ * policy.AckTimeoutMs        = 30000;
+ *
+ * wimod.SetConfirmedUplinkPolicy(policy);
+ * @endcode
+ */
+void WiMODLoRaWAN::SetConfirmedUplinkPolicy(const TWiMODLORAWAN_CUplinkPolicy& policy)
+{
+    CUplink.SetPolicy(policy);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Register a callback that is called when a tracked uplink is finished
+ *
+ * @param cb        pointer to a callback function
+ */
+void WiMODLoRaWAN::RegisterConfirmedUplinkClient(TConfirmedUplinkCallback cb)
+{
+    CUplink.RegisterClient(cb);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the state of the last tracked uplink
+ *
+ * @param info      pointer where to store the information
+ *
+ * @retval true     if the uplink is still in flight
+ */
+bool WiMODLoRaWAN::GetConfirmedUplinkInfo(TWiMODLORAWAN_CUplinkInfo* info)
+{
+    CUplink.CheckTimeout(millis());
+    if (info) {
+        *info = CUplink.GetInfo();
+    }
+    return CUplink.IsBusy();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the statistics of all tracked uplinks
+ *
+ * @param stats     pointer where to store the statistics
+ */
+void WiMODLoRaWAN::GetConfirmedUplinkStats(TWiMODLORAWAN_CUplinkStats* stats)
+{
+    if (stats) {
+        *stats = CUplink.GetStats();
+    }
+}
+#endif
+
+#if WIMOD_LORAWAN_USE_LINK_ADAPTATION
+//-----------------------------------------------------------------------------
+/**
+ * @brief Sets the configuration of the host side link adaptation
+ *
+ * The link metrics are collected all the time: RSSI/SNR of received
+ * downlinks (only if the module reports the optional RX info) and the
+ * result of uplinks sent by SendConfirmedUplink().
+ *
+ * @param config    configuration; the collected metrics are cleared
+ *
+ * @code
+ * TWiMODLORAWAN_LinkAdaptConfig cfg;
+ *
+ * cfg.MinDataRateIndex       = 0;
+ * cfg.MaxDataRateIndex       = 5;
+ * cfg.MinTxPower             = 2;
+ * cfg.MaxTxPower             = 16;
+ * cfg.TxPowerStep            = 2;
+ * cfg.TargetDeliveryPermille = 900;     // 90 % per radio packet
+ * cfg.InstallMarginDb        = 5;
+ * cfg.HysteresisDb           = 3;
+ * cfg.MinSamples             = 6;
+ *
+ * wimod.SetLinkAdaptationConfig(cfg);
+ * @endcode
+ */
+void WiMODLoRaWAN::SetLinkAdaptationConfig(const TWiMODLORAWAN_LinkAdaptConfig& config)
+{
+    LinkAdapt.SetConfig(config);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Applies the advice of the link adaptation to the radio stack config
+ *
+ * Reads the radio stack config and writes it back with the advised data rate
+ * and TX power level, if they differ. Nothing is changed while ADR is enabled
+ * because the network server owns these settings then.
+ *
+ * Must not be called from within a callback function; call it e.g. from the
+ * main loop after a confirmed uplink has finished.
+ *
+ * @param changed   set to true if a new setting has been written (optional)
+ *
+ * @param hciResult Result of the local command transmission to module
+ *                  This is an optional parameter.
+ *
+ * @param rspStatus Status byte contained in the local response of the module
+ *                  This is an optional parameter.
+ *
+ * @retval true     if the radio stack config could be read (and written)
+ * @retval false    if something went wrong; see hciResult & rspStatus for details
+ */
+bool WiMODLoRaWAN::ApplyLinkAdaptation(bool*               changed,
+                                       TWiMDLRResultCodes* hciResult,
+                                       UINT8*              rspStatus)
+{
+    TWiMODLORAWAN_RadioStackConfig radioCfg;
+    UINT8                          dr;
+    UINT8                          pwr;
+
+    if (changed) {
+        *changed = false;
+    }
+
+    if (!GetRadioStackConfig(&radioCfg, hciResult, rspStatus)) {
+        return false;
+    }
+
+    if ((radioCfg.Options & LORAWAN_STK_OPTION_ADR)
+            || !LinkAdapt.Evaluate(radioCfg.DataRateIndex, radioCfg.TXPowerLevel, &dr, &pwr)) {
+        return true;
+    }
+
+    radioCfg.DataRateIndex = dr;
+    radioCfg.TXPowerLevel  = pwr;
+    if (SetRadioStackConfig(&radioCfg, hciResult, rspStatus) && changed) {
+        *changed = true;
+    }
+    return cmdResult;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the link metrics collected since the last change
+ *
+ * @param metrics   pointer where to store the metrics
+ */
+void WiMODLoRaWAN::GetLinkMetrics(TWiMODLORAWAN_LinkMetrics* metrics)
+{
+    LinkAdapt.GetMetrics(metrics);
+}
+#endif
+
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+//-----------------------------------------------------------------------------
+/**
+ * @brief Enable or disable the configuration cache
+ *
+ * The cache is enabled by default. The first successful Get/Set call of
+ * the radio stack config, DeviceEUI, supported bands, TX power limits,
+ * LinkAdrReq config and custom config fills the cache; further Get calls
+ * are served locally and Set calls are only sent to the module if a value
+ * differs from the cached one. The cache is cleared by Reset(),
+ * FactoryReset() and by a power up indication of the module.
+ *
+ * @param enable    false: every call is sent to the module (cache cleared)
+ */
+void WiMODLoRaWAN::EnableConfigCache(bool enable)
+{
+    ConfigCache.Enable(enable);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Clear the configuration cache
+ *
+ * Must be called if the module configuration is changed by other means
+ * than this class (e.g. by a PC tool via a bridge).
+ */
+void WiMODLoRaWAN::InvalidateConfigCache(void)
+{
+    ConfigCache.Invalidate();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the statistics of the configuration cache
+ *
+ * @param stats     pointer where to store the statistics
+ */
+void WiMODLoRaWAN::GetConfigCacheStats(TWiMODLORAWAN_ConfigCacheStats* stats)
+{
+    if (stats) {
+        *stats = ConfigCache.GetStats();
+    }
+}
+#endif
+
 //-----------------------------------------------------------------------------
 /**
  * @brief Sets a new radio config parameter set of the WiMOD
@@ -1765,9 +2191,37 @@ bool WiMODLoRaWAN::SetRadioStackConfig(TWiMODLORAWAN_RadioStackConfig* data,
                                        TWiMDLRResultCodes*         hciResult,
                                        UINT8*                      rspStatus)
 {
-    localHciRes = SapLoRaWan.SetRadioStackConfig(data, &localStatusRsp);
-    return copyLoRaWanResultInfos(hciResult, rspStatus);
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+    TWiMODLORAWAN_RadioStackConfig current;
+
+    // fill the cache once, so that an unchanged config is not written again
+    if (data && !(data->Options & LORAWAN_STK_OPTION_ADR)
+            && ConfigCache.IsEnabled() && !ConfigCache.IsValid(LORAWAN_CFG_CACHE_RADIO_STACK)) {
+        if ((SapLoRaWan.GetRadioStackConfig(&current, &localStatusRsp) == WiMODLR_RESULT_OK)
+                && (localStatusRsp == LORAWAN_STATUS_OK)) {
+            ConfigCache.PutRadioStackConfig(current, true);
+        }
+    }
+
+    if (data && ConfigCache.SkipWrite(ConfigCache.IsRadioStackConfigEqual(*data,
+            SapLoRaWan.getRegion() == LoRaWAN_Region_US915))) {
+        data->WrongParamErrCode = 0x00;
+        localHciRes    = WiMODLR_RESULT_OK;
+        localStatusRsp = LORAWAN_STATUS_OK;
+        return copyLoRaWanResultInfos(hciResult, rspStatus);
+    }
+#endif
 
+    localHciRes = SapLoRaWan.SetRadioStackConfig(data, &localStatusRsp);
+    cmdResult   = copyLoRaWanResultInfos(hciResult, rspStatus);
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+    if (cmdResult) {
+        ConfigCache.PutRadioStackConfig(*data, false);
+    } else {
+        ConfigCache.Invalidate(LORAWAN_CFG_CACHE_RADIO_STACK);
+    }
+#endif
+    return cmdResult;
 }
 
 //-----------------------------------------------------------------------------
@@ -1804,8 +2258,22 @@ bool WiMODLoRaWAN::GetRadioStackConfig(TWiMODLORAWAN_RadioStackConfig* data,
                                        TWiMDLRResultCodes*         hciResult,
                                        UINT8*                      rspStatus)
 {
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+    if (data && ConfigCache.GetRadioStackConfig(data)) {
+        localHciRes    = WiMODLR_RESULT_OK;
+        localStatusRsp = LORAWAN_STATUS_OK;
+        return copyLoRaWanResultInfos(hciResult, rspStatus);
+    }
+#endif
+
     localHciRes = SapLoRaWan.GetRadioStackConfig(data, &localStatusRsp);
-    return copyLoRaWanResultInfos(hciResult, rspStatus);
+    cmdResult   = copyLoRaWanResultInfos(hciResult, rspStatus);
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+    if (cmdResult) {
+        ConfigCache.PutRadioStackConfig(*data, true);
+    }
+#endif
+    return cmdResult;
 }
 
 //-----------------------------------------------------------------------------
@@ -1869,6 +2337,9 @@ bool WiMODLoRaWAN::FactoryReset(TWiMDLRResultCodes*         hciResult,
                                 UINT8*                      rspStatus)
 {
 
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+    ConfigCache.Invalidate();
+#endif
     localHciRes = SapLoRaWan.FactoryReset(&localStatusRsp);
     return copyLoRaWanResultInfos(hciResult, rspStatus);
 
@@ -1912,9 +2383,24 @@ bool WiMODLoRaWAN::SetDeviceEUI(const UINT8*                deviceEUI,
                                 TWiMDLRResultCodes*         hciResult,
                                 UINT8*                      rspStatus)
 {
-    localHciRes = SapLoRaWan.SetDeviceEUI(deviceEUI, &localStatusRsp);
-    return copyLoRaWanResultInfos(hciResult, rspStatus);
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+    if (ConfigCache.SkipWrite(ConfigCache.IsDeviceEUIEqual(deviceEUI))) {
+        localHciRes    = WiMODLR_RESULT_OK;
+        localStatusRsp = LORAWAN_STATUS_OK;
+        return copyLoRaWanResultInfos(hciResult, rspStatus);
+    }
+#endif
 
+    localHciRes = SapLoRaWan.SetDeviceEUI(deviceEUI, &localStatusRsp);
+    cmdResult   = copyLoRaWanResultInfos(hciResult, rspStatus);
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+    if (cmdResult) {
+        ConfigCache.PutDeviceEUI(deviceEUI);
+    } else {
+        ConfigCache.Invalidate(LORAWAN_CFG_CACHE_DEVICE_EUI);
+    }
+#endif
+    return cmdResult;
 }
 
 //-----------------------------------------------------------------------------
@@ -1949,9 +2435,22 @@ bool WiMODLoRaWAN::GetDeviceEUI(UINT8*                      deviceEUI,
                                 TWiMDLRResultCodes*         hciResult,
                                 UINT8*                      rspStatus)
 {
-    localHciRes = SapLoRaWan.GetDeviceEUI(deviceEUI, &localStatusRsp);
-    return copyLoRaWanResultInfos(hciResult, rspStatus);
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+    if (deviceEUI && ConfigCache.GetDeviceEUI(deviceEUI)) {
+        localHciRes    = WiMODLR_RESULT_OK;
+        localStatusRsp = LORAWAN_STATUS_OK;
+        return copyLoRaWanResultInfos(hciResult, rspStatus);
+    }
+#endif
 
+    localHciRes = SapLoRaWan.GetDeviceEUI(deviceEUI, &localStatusRsp);
+    cmdResult   = copyLoRaWanResultInfos(hciResult, rspStatus);
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+    if (cmdResult) {
+        ConfigCache.PutDeviceEUI(deviceEUI);
+    }
+#endif
+    return cmdResult;
 }
 
 //-----------------------------------------------------------------------------
@@ -1997,7 +2496,18 @@ bool WiMODLoRaWAN::GetNwkStatus(TWiMODLORAWAN_NwkStatus_Data*	nwkStatus,
                                 UINT8*                      	rspStatus)
 {
     localHciRes = SapLoRaWan.GetNwkStatus(nwkStatus, &localStatusRsp);
-    return copyLoRaWanResultInfos(hciResult, rspStatus);
+    cmdResult   = copyLoRaWanResultInfos(hciResult, rspStatus);
+#if WIMOD_LORAWAN_USE_UPLINK_SCHEDULER
+    if (cmdResult && !schedulerSeedSet) {
+        // a resumed session is not activated again; take the address
+        // of the active session as slot seed
+        if ((nwkStatus->NetworkStatus == LORAWAN_NWK_STATUS_ACTIVE_ABP)
+                || (nwkStatus->NetworkStatus == LORAWAN_NWK_STATUS_ACTIVE_OTAA)) {
+            Scheduler.SetSeed(nwkStatus->DeviceAddress);
+        }
+    }
+#endif
+    return cmdResult;
 }
 
 //-----------------------------------------------------------------------------
@@ -2041,27 +2551,711 @@ bool WiMODLoRaWAN::SendMacCmd(const TWiMODLORAWAN_MacCmd* cmd,
     return copyLoRaWanResultInfos(hciResult, rspStatus);
 }
 
+#if WIMOD_LORAWAN_USE_MAC_CMD_QUEUE
 //-----------------------------------------------------------------------------
 /**
- * @brief Setup a custom config for tx power settings; expert level only
+ * @brief Queue a MAC command for the next application uplink
  *
- * @param rfGain     new rfGain value for tx power settings; see HCI Spec.
+ * In contrast to SendMacCmd() the command is not handed to the module
+ * immediately. All queued commands are handed to the module right before
+ * the next SendUData(), SendCData() or SendConfirmedUplink(), so the stack
+ * can put them into the frame header (FOpts) of that uplink instead of
+ * spending a radio packet of its own. Per uplink only as many commands are
+ * handed over as fit the HeaderMacCmdCapacity of the radio stack config;
+ * the rest waits for the following uplink. A command with the same ID as a
+ * pending one replaces the pending one.
  *
- * @param hciResult Result of the local command transmission to module
- *                  This is an optional parameter.
+ * @param cmd      pointer containing the MAC command and parameters
  *
- * @param rspStatus Status byte contained in the local response of the module
- *                  This is an optional parameter.
+ * @retval true     if the command is pending
+ * @retval false    if the command is invalid or the queue is full
  *
- * @retval true     if everything is ok
- * @retval false    if something went wrong; see hciResult & rspStatus for details
+ * @code
+ * TWiMODLORAWAN_MacCmd macCmd;
+ *
+ * macCmd.DataServiceType = LORAWAN_MAC_DATA_SERVICE_TYPE_U_DATA;
+ * macCmd.MacCmdID        = LORAWAN_MAC_CMD_LINK_CHECK;
+ * macCmd.Length          = 0;
+ *
+ * wimod.QueueMacCmd(&macCmd);
+ * ...
+ * wimod.SendUData(&txData);   // carries the LinkCheckReq
+ * @endcode
  */
-bool WiMODLoRaWAN::SetCustomConfig(const INT8                  rfGain,
-                                   TWiMDLRResultCodes*         hciResult,
+bool WiMODLoRaWAN::QueueMacCmd(const TWiMODLORAWAN_MacCmd* cmd)
+{
+    if (cmd == NULL) {
+        return false;
+    }
+    return MacCmdQueue.Add(*cmd);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Number of MAC commands waiting for the next uplink
+ */
+UINT8 WiMODLoRaWAN::GetQueuedMacCmdCount(void)
+{
+    return MacCmdQueue.GetCount();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Drop all queued MAC commands
+ */
+void WiMODLoRaWAN::ClearMacCmdQueue(void)
+{
+    MacCmdQueue.Clear();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the statistics of the MAC command queue
+ *
+ * @param stats     pointer where to store the statistics
+ */
+void WiMODLoRaWAN::GetMacCmdQueueStats(TWiMODLORAWAN_MacCmdQueueStats* stats)
+{
+    if (stats) {
+        *stats = MacCmdQueue.GetStats();
+    }
+}
+#endif
+
+#if WIMOD_LORAWAN_USE_TIME_SYNC
+//-----------------------------------------------------------------------------
+/**
+ * @brief Request the network time with the next uplink
+ *
+ * A DeviceTimeReq is queued (@see QueueMacCmd; without the queue it is
+ * handed to the module by SendMacCmd()); the DeviceTimeAns of the server
+ * synchronises the clock returned by GetNetworkTimeMs(). The
+ * network server must support LoRaWAN 1.0.3 or later and the radio stack
+ * must forward MAC commands (LORAWAN_STK_OPTION_MAC_CMD).
+ *
+ * @retval true     if the request is pending
+ *
+ * @code
+ * void setup() {
+ *     ...
+ *     wimod.LoadTimeFromRtc();      // coarse time until the network answers
+ *     wimod.RequestDeviceTime();
+ * }
+ *
+ * void loop() {
+ *     ...
+ *     wimod.Process();
+ *     wimod.UpdateRtc();            // keep the module RTC on network time
+ * }
+ * @endcode
+ */
+bool WiMODLoRaWAN::RequestDeviceTime(void)
+{
+    TWiMODLORAWAN_MacCmd macCmd;
+
+    macCmd.DataServiceType = LORAWAN_MAC_DATA_SERVICE_TYPE_U_DATA;
+    macCmd.MacCmdID        = LORAWAN_MAC_CMD_DEVICE_TIME;
+    macCmd.Length          = 0;
+
+#if WIMOD_LORAWAN_USE_MAC_CMD_QUEUE
+    return MacCmdQueue.Add(macCmd);
+#else
+    return SendMacCmd(&macCmd);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Seed the host clock from the module RTC
+ *
+ * Useful after a host restart if the module has kept running: the clock
+ * is available with 1 s resolution before the next DeviceTimeAns. Ignored
+ * once the clock has been synchronised by the network.
+ *
+ * @param hciResult Result of the local command transmission to module
+ *                  This is an optional parameter.
+ *
+ * @param rspStatus Status byte contained in the local response of the module
+ *                  This is an optional parameter.
+ *
+ * @retval true     if everything is ok
+ * @retval false    if something went wrong; see hciResult & rspStatus for details
+ */
+bool WiMODLoRaWAN::LoadTimeFromRtc(TWiMDLRResultCodes* hciResult,
+                                   UINT8*              rspStatus)
+{
+    UINT32 rtcTime;
+
+    localHciRes = SapDevMgmt.GetRtc(&rtcTime, &localStatusRsp);
+    cmdResult   = copyDevMgmtResultInfos(hciResult, rspStatus);
+
+    // an RTC that has never been set starts in the year 2000
+    if (cmdResult && (WIMOD_RTC_GET_YEARS(rtcTime) > WiMOD_RTC_YEAR_OFFSET)) {
+        TimeSync.OnRtc(rtcTime, millis());
+    }
+    return cmdResult;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Set the module RTC to the network time after a sync
+ *
+ * Does nothing if no DeviceTimeAns has been received since the last call.
+ * The RTC is read first and only written if it is off by 1 s or more; the
+ * deviation is reported in TWiMODLORAWAN_TimeSyncInfo::LastRtcErrorS.
+ *
+ * Must not be called from a callback function.
+ *
+ * @param hciResult Result of the local command transmission to module
+ *                  This is an optional parameter.
+ *
+ * @param rspStatus Status byte contained in the local response of the module
+ *                  This is an optional parameter.
+ *
+ * @retval true     if everything is ok
+ * @retval false    if something went wrong; see hciResult & rspStatus for details
+ */
+bool WiMODLoRaWAN::UpdateRtc(TWiMDLRResultCodes* hciResult,
+                             UINT8*              rspStatus)
+{
+    UINT32 rtcTime;
+    UINT32 gpsSeconds;
+    INT32  rtcError;
+
+    if (!TimeSync.GetInfo().RtcUpdatePending) {
+        localHciRes    = WiMODLR_RESULT_OK;
+        localStatusRsp = DEVMGMT_STATUS_OK;
+        return copyDevMgmtResultInfos(hciResult, rspStatus);
+    }
+
+    localHciRes = SapDevMgmt.GetRtc(&rtcTime, &localStatusRsp);
+    if (!copyDevMgmtResultInfos(hciResult, rspStatus)) {
+        return false;
+    }
+
+    gpsSeconds = (UINT32)(TimeSync.GetTimeMs(millis()) / 1000);
+    rtcError   = (INT32)(WiMOD_LoRaWAN_TimeSync::RtcToGps(rtcTime) - gpsSeconds);
+
+    if (rtcError != 0) {
+        localHciRes = SapDevMgmt.SetRtc(WiMOD_LoRaWAN_TimeSync::GpsToRtc(gpsSeconds), &localStatusRsp);
+        if (!copyDevMgmtResultInfos(hciResult, rspStatus)) {
+            return false;
+        }
+    }
+    TimeSync.OnRtcUpdated(rtcError);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Current time of the network aligned host clock
+ *
+ * The clock never runs backwards.
+ *
+ * @return ms since the GPS epoch (1980-01-06); before the first sync the
+ *         time seeded from the RTC or the ms since start-up
+ *         (@see GetTimeSyncInfo)
+ */
+UINT64 WiMODLoRaWAN::GetNetworkTimeMs(void)
+{
+    return TimeSync.GetTimeMs(millis());
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Time until the next slot of a periodic schedule
+ *
+ * Slots are computed from the network aligned clock instead of being
+ * counted loop by loop, so they neither drift with the processing time
+ * nor differ between synchronised nodes.
+ *
+ * @param periodMs  period of the schedule (e.g. the uplink interval)
+ * @param offsetMs  offset of the slots within the period
+ *
+ * @return ms until the next slot; periodMs if a slot starts right now
+ *
+ * @code
+ * if ((INT32)(millis() - nextUplink) >= 0) {
+ *     sendData();
+ *     nextUplink = millis() + wimod.GetMsUntilSlot(UPLINK_PERIOD_MS, myOffset);
+ * }
+ * @endcode
+ */
+UINT32 WiMODLoRaWAN::GetMsUntilSlot(UINT32 periodMs, UINT32 offsetMs)
+{
+    return TimeSync.GetMsUntilSlot(millis(), periodMs, offsetMs);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the status of the time synchronisation
+ *
+ * @param info      pointer where to store the status
+ */
+void WiMODLoRaWAN::GetTimeSyncInfo(TWiMODLORAWAN_TimeSyncInfo* info)
+{
+    if (info) {
+        *info = TimeSync.GetInfo();
+    }
+}
+#endif
+
+#if WIMOD_LORAWAN_USE_UPLINK_SCHEDULER
+//-----------------------------------------------------------------------------
+/**
+ * @brief Configure the slotted uplink scheduler
+ *
+ * The reporting period is divided into slots of the time on air of an
+ * uplink with MaxPayloadLen bytes (at the data rate of the last uplink)
+ * plus GuardMs. Each node uses the slot given by a hash of its DevAddr;
+ * @see GetMsUntilUplinkSlot().
+ *
+ * @param config    scheduler parameters
+ *
+ * @code
+ * TWiMODLORAWAN_SchedulerConfig sched;
+ *
+ * sched.PeriodMs           = 15UL * 60UL * 1000UL;
+ * sched.MaxPayloadLen      = 24;
+ * sched.GuardMs            = 100;      // clock error between the nodes
+ * sched.CollisionThreshold = 2;
+ * wimod.SetUplinkSchedulerConfig(sched);
+ * @endcode
+ */
+void WiMODLoRaWAN::SetUplinkSchedulerConfig(const TWiMODLORAWAN_SchedulerConfig& config)
+{
+    Scheduler.SetConfig(config);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Set the hash seed of the uplink scheduler
+ *
+ * By default the DevAddr of the last successful ActivateDevice(),
+ * ReactivateDevice() or join is used, or the DevAddr of an active session
+ * reported by GetNwkStatus() (e.g. a session resumed after a reset of the
+ * host). Call GetMsUntilUplinkSlot() again after the seed has been set.
+ * An explicit seed (e.g. the
+ * DeviceEUI hashed by WiMOD_LoRaWAN_UplinkScheduler::MakeSeed()) replaces
+ * this default.
+ *
+ * @param seed      hash seed
+ */
+void WiMODLoRaWAN::SetUplinkSchedulerSeed(UINT32 seed)
+{
+    schedulerSeedSet = true;
+    Scheduler.SetSeed(seed);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Time until the own uplink slot starts
+ *
+ * The slot is computed from the network aligned clock
+ * (@see RequestDeviceTime); nodes without time sync still keep their own
+ * period but are not aligned to each other.
+ *
+ * @return ms until the own slot; the period if the slot starts right now
+ *
+ * @code
+ * if ((INT32)(millis() - nextUplink) >= 0) {
+ *     wimod.SendUData(&txData);
+ *     nextUplink = millis() + wimod.GetMsUntilUplinkSlot();
+ * }
+ * @endcode
+ */
+UINT32 WiMODLoRaWAN::GetMsUntilUplinkSlot(void)
+{
+    return TimeSync.GetMsUntilSlot(millis(), Scheduler.GetPeriodMs(), Scheduler.GetOffsetMs());
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the status of the uplink scheduler
+ *
+ * @param info      pointer where to store the status
+ */
+void WiMODLoRaWAN::GetUplinkSchedulerInfo(TWiMODLORAWAN_SchedulerInfo* info)
+{
+    if (info) {
+        *info = Scheduler.GetInfo();
+    }
+}
+#endif
+
+#if WIMOD_LORAWAN_USE_POWER_POLICY
+//-----------------------------------------------------------------------------
+/**
+ * @brief Set the Class C window and the currents of the power policy
+ *
+ * @see ApplyPowerPolicy().
+ *
+ * @param config    policy parameters
+ */
+void WiMODLoRaWAN::SetPowerPolicyConfig(const TWiMODLORAWAN_PowerPolicyConfig& config)
+{
+    PowerPolicy.SetConfig(config);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Enable or disable the power policy
+ *
+ * The policy is disabled by default; the device class and the power saving
+ * mode are then only changed by SetRadioStackConfig().
+ *
+ * @param enable    true = ApplyPowerPolicy() switches the device class
+ */
+void WiMODLoRaWAN::EnablePowerPolicy(bool enable)
+{
+    PowerPolicy.Enable(enable);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Request Class C for a maintenance session
+ *
+ * The module is switched to Class C by the next call of ApplyPowerPolicy()
+ * and back to Class A once the time has expired or ReleaseClassC() has
+ * been called. Each received downlink extends the window by the configured
+ * ClassCWindowMs.
+ *
+ * @param durationMs    length of the session
+ */
+void WiMODLoRaWAN::RequestClassC(UINT32 durationMs)
+{
+    PowerPolicy.RequestClassC(durationMs, millis());
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief End a Class C window before its time has expired
+ */
+void WiMODLoRaWAN::ReleaseClassC(void)
+{
+    PowerPolicy.ReleaseClassC();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Switch the device class according to the power policy
+ *
+ * Class A uses automatic power saving; the module sleeps in between and
+ * every HCI request is preceded by the wakeup sequence. Class C turns
+ * power saving off and the wakeup sequence is no longer sent.
+ *
+ * After a failed attempt the change is not retried before the next uplink
+ * or a retry time (LORAWAN_POWER_RETRY_MIN_MS, doubled per failure up to
+ * LORAWAN_POWER_RETRY_MAX_MS); until then the call returns true.
+ *
+ * Must not be called from a callback function; call it from the main loop.
+ *
+ * @param changed   optional; set to true if the device class has been changed
+ *
+ * @param hciResult Result of the local command transmission to module
+ *                  This is an optional parameter.
+ *
+ * @param rspStatus Status byte contained in the local response of the module
+ *                  This is an optional parameter.
+ *
+ * @retval true     if everything is ok
+ * @retval false    if something went wrong; see hciResult & rspStatus for details
+ *
+ * @code
+ * void setup() {
+ *     ...
+ *     wimod.EnablePowerPolicy(true);
+ * }
+ *
+ * void loop() {
+ *     wimod.Process();
+ *     wimod.ApplyPowerPolicy();
+ *     ...
+ * }
+ * @endcode
+ */
+bool WiMODLoRaWAN::ApplyPowerPolicy(bool*               changed,
+                                    TWiMDLRResultCodes* hciResult,
+                                    UINT8*              rspStatus)
+{
+    TWiMODLORAWAN_RadioStackConfig radioCfg;
+    TWiMODLORAWAN_PowerMode        mode;
+    UINT32                         now = millis();
+
+    if (changed) {
+        *changed = false;
+    }
+
+    if (!PowerPolicy.IsEnabled() || !PowerPolicy.Evaluate(now, &mode)) {
+        localHciRes    = WiMODLR_RESULT_OK;
+        localStatusRsp = LORAWAN_STATUS_OK;
+        return copyLoRaWanResultInfos(hciResult, rspStatus);
+    }
+
+    if (!GetRadioStackConfig(&radioCfg, hciResult, rspStatus)) {
+        PowerPolicy.OnModeFailed(now);
+        return false;
+    }
+
+    if (mode == LORAWAN_POWER_MODE_CLASS_C) {
+        radioCfg.Options         |= LORAWAN_STK_OPTION_DEV_CLASS_C;
+        radioCfg.PowerSavingMode  = LORAWAN_POWER_SAVING_MODE_OFF;
+    } else {
+        radioCfg.Options         &= ~LORAWAN_STK_OPTION_DEV_CLASS_C;
+        radioCfg.PowerSavingMode  = LORAWAN_POWER_SAVING_MODE_AUTO;
+    }
+
+    if (SetRadioStackConfig(&radioCfg, hciResult, rspStatus)) {
+        // the request itself still used the setting of the old mode
+        EnableWakeupSequence(mode == LORAWAN_POWER_MODE_CLASS_A);
+        PowerPolicy.OnModeApplied(mode, now);
+        if (changed) {
+            *changed = true;
+        }
+    } else {
+        // do not repeat the request on every call
+        PowerPolicy.OnModeFailed(now);
+    }
+    return cmdResult;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the time spent in each mode and the estimated energy
+ *
+ * @param report    pointer where to store the report
+ */
+void WiMODLoRaWAN::GetPowerReport(TWiMODLORAWAN_PowerReport* report)
+{
+    if (report) {
+        PowerPolicy.GetReport(millis(), report);
+    }
+}
+#endif
+
+#if WIMOD_LORAWAN_USE_PAYLOAD_PLANNER
+//-----------------------------------------------------------------------------
+/**
+ * @brief Set port, uplink type and record header size of planned uplinks
+ *
+ * @param config    new settings of the payload planner
+ */
+void WiMODLoRaWAN::SetPayloadPlannerConfig(const TWiMODLORAWAN_PlannerConfig& config)
+{
+    Planner.SetConfig(config);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Add a record to the next planned uplinks; the data is copied
+ *
+ * Records are never split; a record is e.g. one Cayenne LPP value.
+ *
+ * @param data      record as it shall appear in the payload
+ * @param length    length of the record
+ * @param priority  records with a higher priority are sent first
+ *
+ * @retval true     if the record is pending now
+ * @retval false    if the record is too long or the planner is full
+ */
+bool WiMODLoRaWAN::AddPlannedRecord(const UINT8* data, UINT8 length, UINT8 priority)
+{
+    return Planner.Add(data, length, priority);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Plan the pending records for the current data rate
+ *
+ * The max. payload of the current data rate is read from the module
+ * (network status); if the firmware does not report it, the
+ * DefaultPayloadLen of the planner config is used. The records are packed
+ * with first-fit-decreasing into the minimum number of uplinks.
+ *
+ * @param numFrames optional; number of uplinks needed
+ *
+ * @param hciResult Result of the local command transmission to module
+ *                  This is an optional parameter.
+ *
+ * @param rspStatus Status byte contained in the local response of the module
+ *                  This is an optional parameter.
+ *
+ * @retval true     if everything is ok
+ * @retval false    if something went wrong; see hciResult & rspStatus for details
+ */
+bool WiMODLoRaWAN::PlanUplinks(UINT8* numFrames, TWiMDLRResultCodes* hciResult, UINT8* rspStatus)
+{
+    TWiMODLORAWAN_NwkStatus_Data nwkStatus;
+    UINT8                        limit;
+
+    if (!GetNwkStatus(&nwkStatus, hciResult, rspStatus)) {
+        return false;
+    }
+
+    limit = nwkStatus.MaxPayloadSize;
+    if (limit == 0) {
+        limit = Planner.GetConfig().DefaultPayloadLen;
+    }
+    Planner.Plan(limit);
+
+    if (numFrames) {
+        *numFrames = Planner.GetNumFrames();
+    }
+    return cmdResult;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Content and fill ratio of a planned uplink
+ *
+ * FillPermille is the used part of the max. payload; HeaderPermille is
+ * the part of the radio frame spent on the LoRaWAN header and the
+ * record headers.
+ *
+ * @param index     0 = next uplink
+ * @param info      pointer where to store the infos
+ *
+ * @retval true     if the uplink is planned
+ */
+bool WiMODLoRaWAN::GetPlannedFrameInfo(UINT8 index, TWiMODLORAWAN_PlannedFrame* info)
+{
+    return Planner.GetFrameInfo(index, info);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Plan the pending records and send the first planned uplink
+ *
+ * The plan is renewed for every uplink, so a data rate change (e.g. by
+ * ADR) is taken into account. The uplink carries the records with the
+ * highest priority; they are removed once the module has accepted the
+ * request. Nothing is sent if no record is pending.
+ *
+ * Records larger than the max. payload of the current data rate are
+ * dropped and counted in the planner statistics (Dropped). If no other
+ * record is pending, the call fails with WiMODLR_RESULT_PAYLOAD_LENGTH_ERROR.
+ *
+ * Confirmed uplinks are sent via SendConfirmedUplink(), so the policy and
+ * the result callback of the confirmed uplink tracker apply; nothing is
+ * sent while a confirmed uplink is still pending.
+ *
+ * Must not be called from a callback function; call it from the main
+ * loop, e.g. when GetMsUntilUplinkSlot() returns 0.
+ *
+ * @param hciResult Result of the local command transmission to module
+ *                  This is an optional parameter.
+ *
+ * @param rspStatus Status byte contained in the local response of the module
+ *                  This is an optional parameter.
+ *
+ * @retval true     if everything is ok
+ * @retval false    if something went wrong; see hciResult & rspStatus for details
+ *
+ * @code
+ * CayenneLPP lpp(buf, sizeof(buf));
+ *
+ * lpp.addTemperature(1, 21.5);
+ * wimod.AddPlannedRecord(lpp.getBuffer(), lpp.getSize(), 1);
+ * ...
+ * if (wimod.GetPlannedRecordCount() && (wimod.GetMsUntilUplinkSlot() == 0)) {
+ *     wimod.SendNextPlannedUplink();
+ * }
+ * @endcode
+ */
+bool WiMODLoRaWAN::SendNextPlannedUplink(TWiMDLRResultCodes* hciResult, UINT8* rspStatus)
+{
+    TWiMODLORAWAN_TX_Data txData;
+    UINT8                 numFrames = 0;
+    UINT8                 dropped;
+
+    if (!PlanUplinks(&numFrames, hciResult, rspStatus)) {
+        return false;
+    }
+    dropped = Planner.DropOversized();
+    if (numFrames == 0) {
+        localHciRes    = dropped ? WiMODLR_RESULT_PAYLOAD_LENGTH_ERROR : WiMODLR_RESULT_OK;
+        localStatusRsp = LORAWAN_STATUS_OK;
+        return copyLoRaWanResultInfos(hciResult, rspStatus);
+    }
+
+    txData.Port   = Planner.GetConfig().Port;
+    txData.Length = Planner.BuildFrame(txData.Payload, sizeof(txData.Payload));
+
+    if (Planner.GetConfig().Confirmed) {
+#if WIMOD_LORAWAN_USE_CONFIRMED_UPLINK
+        SendConfirmedUplink(&txData, NULL, hciResult, rspStatus);
+#else
+        SendCData(&txData, hciResult, rspStatus);
+#endif
+    } else {
+        SendUData(&txData, hciResult, rspStatus);
+    }
+    if (cmdResult) {
+        Planner.OnFrameSent();
+    }
+    return cmdResult;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Number of records waiting for an uplink
+ */
+UINT8 WiMODLoRaWAN::GetPlannedRecordCount(void)
+{
+    return Planner.GetCount();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the statistics of the payload planner
+ *
+ * @param stats     pointer where to store the statistics
+ */
+void WiMODLoRaWAN::GetPayloadPlannerStats(TWiMODLORAWAN_PlannerStats* stats)
+{
+    if (stats) {
+        *stats = Planner.GetStats();
+    }
+}
+#endif
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Setup a custom config for tx power settings; expert level only
+ *
+ * @param rfGain     new rfGain value for tx power settings; see HCI Spec.
+ *
+ * @param hciResult Result of the local command transmission to module
+ *                  This is an optional parameter.
+ *
+ * @param rspStatus Status byte contained in the local response of the module
+ *                  This is an optional parameter.
+ *
+ * @retval true     if everything is ok
+ * @retval false    if something went wrong; see hciResult & rspStatus for details
+ */
+bool WiMODLoRaWAN::SetCustomConfig(const INT8                  rfGain,
+                                   TWiMDLRResultCodes*         hciResult,
                                    UINT8*                      rspStatus)
 {
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+    if (ConfigCache.SkipWrite(ConfigCache.IsCustomConfigEqual(rfGain))) {
+        localHciRes    = WiMODLR_RESULT_OK;
+        localStatusRsp = LORAWAN_STATUS_OK;
+        return copyLoRaWanResultInfos(hciResult, rspStatus);
+    }
+#endif
+
     localHciRes = SapLoRaWan.SetCustomConfig(rfGain, &localStatusRsp);
-    return copyLoRaWanResultInfos(hciResult, rspStatus);
+    cmdResult   = copyLoRaWanResultInfos(hciResult, rspStatus);
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+    if (cmdResult) {
+        ConfigCache.PutCustomConfig(rfGain);
+    } else {
+        ConfigCache.Invalidate(LORAWAN_CFG_CACHE_CUSTOM_CONFIG);
+    }
+#endif
+    return cmdResult;
 }
 
 //-----------------------------------------------------------------------------
@@ -2083,8 +3277,22 @@ bool WiMODLoRaWAN::GetCustomConfig(INT8*                rfGain,
                                    TWiMDLRResultCodes*  hciResult,
                                    UINT8*               rspStatus)
 {
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+    if (rfGain && ConfigCache.GetCustomConfig(rfGain)) {
+        localHciRes    = WiMODLR_RESULT_OK;
+        localStatusRsp = LORAWAN_STATUS_OK;
+        return copyLoRaWanResultInfos(hciResult, rspStatus);
+    }
+#endif
+
     localHciRes = SapLoRaWan.GetCustomConfig(rfGain, &localStatusRsp);
-    return copyLoRaWanResultInfos(hciResult, rspStatus);
+    cmdResult   = copyLoRaWanResultInfos(hciResult, rspStatus);
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+    if (cmdResult) {
+        ConfigCache.PutCustomConfig(*rfGain);
+    }
+#endif
+    return cmdResult;
 }
 
 
@@ -2108,8 +3316,22 @@ bool WiMODLoRaWAN::GetSupportedBands(TWiMODLORAWAN_SupportedBands* supportedBand
                                    TWiMDLRResultCodes*  hciResult,
                                    UINT8*               rspStatus)
 {
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+    if (supportedBands && ConfigCache.GetSupportedBands(supportedBands)) {
+        localHciRes    = WiMODLR_RESULT_OK;
+        localStatusRsp = LORAWAN_STATUS_OK;
+        return copyLoRaWanResultInfos(hciResult, rspStatus);
+    }
+#endif
+
     localHciRes = SapLoRaWan.GetSupportedBands(supportedBands, &localStatusRsp);
-    return copyLoRaWanResultInfos(hciResult, rspStatus);
+    cmdResult   = copyLoRaWanResultInfos(hciResult, rspStatus);
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+    if (cmdResult) {
+        ConfigCache.PutSupportedBands(*supportedBands);
+    }
+#endif
+    return cmdResult;
 }
 
 //-----------------------------------------------------------------------------
@@ -2131,8 +3353,22 @@ bool WiMODLoRaWAN::GetTxPowerLimitConfig(TWiMODLORAWAN_TxPwrLimitConfig* txPwrLi
                                    TWiMDLRResultCodes*  hciResult,
                                    UINT8*               rspStatus)
 {
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+    if (txPwrLimitCfg && ConfigCache.GetTxPowerLimitConfig(txPwrLimitCfg)) {
+        localHciRes    = WiMODLR_RESULT_OK;
+        localStatusRsp = LORAWAN_STATUS_OK;
+        return copyLoRaWanResultInfos(hciResult, rspStatus);
+    }
+#endif
+
     localHciRes = SapLoRaWan.GetTxPowerLimitConfig(txPwrLimitCfg, &localStatusRsp);
-    return copyLoRaWanResultInfos(hciResult, rspStatus);
+    cmdResult   = copyLoRaWanResultInfos(hciResult, rspStatus);
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+    if (cmdResult) {
+        ConfigCache.PutTxPowerLimitConfig(*txPwrLimitCfg);
+    }
+#endif
+    return cmdResult;
 }
 
 //-----------------------------------------------------------------------------
@@ -2154,8 +3390,25 @@ bool WiMODLoRaWAN::SetTxPowerLimitConfig(TWiMODLORAWAN_TxPwrLimitConfig& txPwrLi
                                    TWiMDLRResultCodes*  hciResult,
                                    UINT8*               rspStatus)
 {
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+    if (ConfigCache.SkipWrite(ConfigCache.IsTxPowerLimitEqual(txPwrLimitCfg))) {
+        txPwrLimitCfg.WrongParamErrCode = 0x00;
+        localHciRes    = WiMODLR_RESULT_OK;
+        localStatusRsp = LORAWAN_STATUS_OK;
+        return copyLoRaWanResultInfos(hciResult, rspStatus);
+    }
+#endif
+
     localHciRes = SapLoRaWan.SetTxPowerLimitConfig(txPwrLimitCfg, &localStatusRsp);
-    return copyLoRaWanResultInfos(hciResult, rspStatus);
+    cmdResult   = copyLoRaWanResultInfos(hciResult, rspStatus);
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+    if (cmdResult) {
+        ConfigCache.UpdateTxPowerLimit(txPwrLimitCfg);
+    } else {
+        ConfigCache.Invalidate(LORAWAN_CFG_CACHE_TX_PWR_LIMIT);
+    }
+#endif
+    return cmdResult;
 }
 
 
@@ -2179,8 +3432,22 @@ bool WiMODLoRaWAN::GetLinkAdrReqConfig(TWiMODLORAWAN_LinkAdrReqConfig* linkAdrRe
                                    TWiMDLRResultCodes*  hciResult,
                                    UINT8*               rspStatus)
 {
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+    if (linkAdrReqCfg && ConfigCache.GetLinkAdrReqConfig(linkAdrReqCfg)) {
+        localHciRes    = WiMODLR_RESULT_OK;
+        localStatusRsp = LORAWAN_STATUS_OK;
+        return copyLoRaWanResultInfos(hciResult, rspStatus);
+    }
+#endif
+
     localHciRes = SapLoRaWan.GetLinkAdrReqConfig(linkAdrReqCfg, &localStatusRsp);
-    return copyLoRaWanResultInfos(hciResult, rspStatus);
+    cmdResult   = copyLoRaWanResultInfos(hciResult, rspStatus);
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+    if (cmdResult) {
+        ConfigCache.PutLinkAdrReqConfig(*linkAdrReqCfg);
+    }
+#endif
+    return cmdResult;
 }
 
 //-----------------------------------------------------------------------------
@@ -2203,8 +3470,24 @@ bool WiMODLoRaWAN::SetLinkAdrReqConfig(TWiMODLORAWAN_LinkAdrReqConfig& linkAdrRe
 								   TWiMDLRResultCodes*  hciResult,
 								   UINT8*               rspStatus)
 {
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+	if (ConfigCache.SkipWrite(ConfigCache.IsLinkAdrReqConfigEqual(linkAdrReqCfg))) {
+		localHciRes    = WiMODLR_RESULT_OK;
+		localStatusRsp = LORAWAN_STATUS_OK;
+		return copyLoRaWanResultInfos(hciResult, rspStatus);
+	}
+#endif
+
 	localHciRes = SapLoRaWan.SetLinkAdrReqConfig(linkAdrReqCfg,  &localStatusRsp);
-	return copyLoRaWanResultInfos(hciResult, rspStatus);
+	cmdResult   = copyLoRaWanResultInfos(hciResult, rspStatus);
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+	if (cmdResult) {
+		ConfigCache.PutLinkAdrReqConfig(linkAdrReqCfg);
+	} else {
+		ConfigCache.Invalidate(LORAWAN_CFG_CACHE_LINK_ADR_REQ);
+	}
+#endif
+	return cmdResult;
 }
 
 
@@ -2313,10 +3596,20 @@ void WiMODLoRaWAN::ProcessUnexpectedRxMessage(TWiMODLR_HCIMessage& rxMsg)
     switch(rxMsg.SapID)
     {
         case    DEVMGMT_SAP_ID:
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+                if (rxMsg.MsgID == DEVMGMT_MSG_POWER_UP_IND) {
+                    // module has been restarted (e.g. watchdog / reset pin)
+                    ConfigCache.Invalidate();
+                }
+#endif
                 SapDevMgmt.DispatchDeviceMgmtMessage(rxMsg);
                 break;
 
         case    LORAWAN_SAP_ID:
+                trackLinkMetrics(rxMsg);
+#if WIMOD_LORAWAN_USE_TIME_SYNC
+                trackTimeSync(rxMsg);
+#endif
                 SapLoRaWan.DispatchLoRaWANMessage(rxMsg);
                 break;
 
@@ -2382,9 +3675,202 @@ bool WiMODLoRaWAN::copyLoRaWanResultInfos(TWiMDLRResultCodes* hciResult, UINT8*
 //
 //------------------------------------------------------------------------------
 
+//! @cond Doxygen_Suppress
+void WiMODLoRaWAN::trackLinkMetrics(TWiMODLR_HCIMessage& rxMsg)
+{
+#if WIMOD_LORAWAN_USE_LINK_ADAPTATION
+    TWiMODLORAWAN_RX_ACK_Data      ackData;
+    TWiMODLORAWAN_RX_Data          rxData;
+#endif
+#if WIMOD_LORAWAN_USE_UPLINK_SCHEDULER || WIMOD_LORAWAN_USE_POWER_POLICY
+    TWiMODLORAWAN_TxIndData        txInd;
+#endif
+#if WIMOD_LORAWAN_USE_UPLINK_SCHEDULER
+    TWiMODLORAWAN_RX_JoinedNwkData joinedData;
+#endif
+#if WIMOD_LORAWAN_USE_CONFIRMED_UPLINK
+    bool                           busy = CUplink.IsBusy();
+#endif
+
+    switch (rxMsg.MsgID)
+    {
+#if WIMOD_LORAWAN_USE_LINK_ADAPTATION
+        case LORAWAN_MSG_RECV_ACK_IND:
+            if (SapLoRaWan.convert(rxMsg, &ackData) && ackData.OptionalInfoAvaiable) {
+                LinkAdapt.OnDownlink(ackData.RSSI, ackData.SNR);
+            }
+            break;
+#endif
+        case LORAWAN_MSG_RECV_UDATA_IND:
+        case LORAWAN_MSG_RECV_CDATA_IND:
+#if WIMOD_LORAWAN_USE_LINK_ADAPTATION
+            if (SapLoRaWan.convert(rxMsg, &rxData) && rxData.OptionalInfoAvaiable) {
+                LinkAdapt.OnDownlink(rxData.RSSI, rxData.SNR);
+            }
+#endif
+#if WIMOD_LORAWAN_USE_POWER_POLICY
+            PowerPolicy.OnDownlink(millis());
+#endif
+            break;
+#if WIMOD_LORAWAN_USE_UPLINK_SCHEDULER || WIMOD_LORAWAN_USE_POWER_POLICY
+        case LORAWAN_MSG_SEND_UDATA_TX_IND:
+        case LORAWAN_MSG_SEND_CDATA_TX_IND:
+            if (SapLoRaWan.convert(rxMsg, &txInd)
+                    && (txInd.FieldAvailability != LORAWAN_OPT_TX_IND_INFOS_NOT_AVAILABLE)) {
+#if WIMOD_LORAWAN_USE_POWER_POLICY
+                PowerPolicy.OnTx(txInd.RfMsgAirtime);
+#endif
+#if WIMOD_LORAWAN_USE_UPLINK_SCHEDULER
+                Scheduler.SetDataRate(txInd.DataRateIndex);
+                // C-Data is reported when the uplink has been acked or given up
+                if ((rxMsg.MsgID == LORAWAN_MSG_SEND_UDATA_TX_IND)
+                        && (txInd.FieldAvailability == LORAWAN_OPT_TX_IND_INFOS_INCL_PKT_CNT)) {
+                    Scheduler.OnUplink(txInd.NumTxPackets, true);
+                }
+#endif
+            }
+            break;
+#endif
+#if WIMOD_LORAWAN_USE_UPLINK_SCHEDULER
+        case LORAWAN_MSG_JOIN_NETWORK_IND:
+            if (!schedulerSeedSet && SapLoRaWan.convert(rxMsg, &joinedData)) {
+                Scheduler.SetSeed(joinedData.DeviceAddress);
+            }
+            break;
+#endif
+        default:
+            break;
+    }
+
+#if WIMOD_LORAWAN_USE_CONFIRMED_UPLINK
+    trackConfirmedUplink(rxMsg);
+
+    // delivery of a finished confirmed uplink
+    if (busy && !CUplink.IsBusy()) {
+        const TWiMODLORAWAN_CUplinkInfo& info = CUplink.GetInfo();
+        if ((info.State == LORAWAN_CUPLINK_STATE_ACKED)
+                || (info.State == LORAWAN_CUPLINK_STATE_NOT_ACKED)) {
+#if WIMOD_LORAWAN_USE_LINK_ADAPTATION
+            LinkAdapt.OnUplink(info.NumTxPackets, info.State == LORAWAN_CUPLINK_STATE_ACKED);
+#endif
+#if WIMOD_LORAWAN_USE_UPLINK_SCHEDULER
+            Scheduler.OnUplink(info.NumTxPackets, info.State == LORAWAN_CUPLINK_STATE_ACKED);
+#endif
+        }
+    }
+#endif
+}
+
+#if WIMOD_LORAWAN_USE_CONFIRMED_UPLINK
+void WiMODLoRaWAN::trackConfirmedUplink(TWiMODLR_HCIMessage& rxMsg)
+{
+    TWiMODLORAWAN_TxIndData txInd;
+    UINT32                  now = millis();
+
+    if (!CUplink.IsBusy()) {
+        return;
+    }
+
+    switch (rxMsg.MsgID)
+    {
+        case LORAWAN_MSG_SEND_CDATA_TX_IND:
+            if (SapLoRaWan.convert(rxMsg, &txInd)) {
+                CUplink.OnTxIndication(txInd, now);
+            }
+            break;
+        case LORAWAN_MSG_RECV_ACK_IND:
+            CUplink.OnAck(now);
+            break;
+        case LORAWAN_MSG_RECV_UDATA_IND:
+        case LORAWAN_MSG_RECV_CDATA_IND:
+            // ack piggybacked on a downlink
+            if ((rxMsg.Length >= 1) && (rxMsg.Payload[0] & LORAWAN_FORMAT_ACK_RECEIVED)) {
+                CUplink.OnAck(now);
+            }
+            break;
+        case LORAWAN_MSG_RECV_NO_DATA_IND:
+            CUplink.OnNoData(now);
+            break;
+        default:
+            break;
+    }
+    CUplink.CheckTimeout(now);
+}
+#endif
+
+#if WIMOD_LORAWAN_USE_MAC_CMD_QUEUE
+//-----------------------------------------------------------------------------
+/**
+ * @brief Hand queued MAC commands to the module ahead of an uplink
+ *
+ * Commands are handed over in FIFO order as long as they fit the header
+ * MAC command capacity. The first command is always handed over, so a
+ * command larger than the capacity does not block the queue; the stack
+ * sends it as it would have done for SendMacCmd(). A command that is not
+ * accepted stays queued.
+ */
+void WiMODLoRaWAN::flushMacCmdQueue(void)
+{
+    TWiMODLORAWAN_RadioStackConfig radioCfg;
+    const TWiMODLORAWAN_MacCmd*    cmd;
+    UINT8                          capacity = LORAWAN_HEADER_MAC_CMD_CAP_MAX;
+    UINT8                          used     = 0;
+
+    if (MacCmdQueue.GetCount() == 0) {
+        return;
+    }
+
+    if (GetRadioStackConfig(&radioCfg)) {
+        capacity = radioCfg.HeaderMacCmdCapacity;
+    }
+
+    while ((cmd = MacCmdQueue.Front()) != NULL) {
+        UINT8 size = WiMOD_LoRaWAN_MacCmdQueue::GetSize(*cmd);
+
+        if (used && ((used + size) > capacity)) {
+            break;
+        }
+        localHciRes = SapLoRaWan.SendMacCmd(cmd, &localStatusRsp);
+        if ((localHciRes != WiMODLR_RESULT_OK) || (localStatusRsp != LORAWAN_STATUS_OK)) {
+            break;
+        }
+        MacCmdQueue.PopFront();
+        used += size;
+    }
+
+    if (used) {
+        MacCmdQueue.OnFlush();
+    }
+}
+#endif
+
+#if WIMOD_LORAWAN_USE_TIME_SYNC
+void WiMODLoRaWAN::trackTimeSync(TWiMODLR_HCIMessage& rxMsg)
+{
+    TWiMODLORAWAN_RX_MacCmdView macCmdView;
+    TWiMODLORAWAN_DeviceTimeAns deviceTimeAns;
+
+    switch (rxMsg.MsgID)
+    {
+        case LORAWAN_MSG_SEND_UDATA_TX_IND:
+        case LORAWAN_MSG_SEND_CDATA_TX_IND:
+            TimeSync.OnTxDone(millis());
+            break;
+        case LORAWAN_MSG_RECV_MAC_CMD_IND:
+            if (SapLoRaWan.convert(rxMsg, &macCmdView)
+                    && SapLoRaWan.convert(macCmdView, &deviceTimeAns)) {
+                TimeSync.OnDeviceTimeAns(deviceTimeAns, millis());
+            }
+            break;
+        default:
+            break;
+    }
+}
+#endif
+//! @endcond
+
 
 
 //------------------------------------------------------------------------------
 // EOF
 //------------------------------------------------------------------------------
-
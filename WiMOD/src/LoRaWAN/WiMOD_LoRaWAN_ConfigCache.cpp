@@ -0,0 +1,424 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LoRaWAN_ConfigCache.cpp
+//! @ingroup WiMODLoRaWAN
+//! <!------------------------------------------------------------------------->
+//! @brief Implementation of the module configuration cache
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//!
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "WiMOD_LoRaWAN_ConfigCache.h"
+
+#include <string.h>
+
+//------------------------------------------------------------------------------
+//
+// Section public functions
+//
+//------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Constructor; the cache is enabled and empty
+ */
+WiMOD_LoRaWAN_ConfigCache::WiMOD_LoRaWAN_ConfigCache(void)
+{
+    enabled    = true;
+    validItems = 0;
+
+    memset(&radioStackConfig, 0x00, sizeof(radioStackConfig));
+    memset(deviceEUI, 0x00, sizeof(deviceEUI));
+    memset(&supportedBands, 0x00, sizeof(supportedBands));
+    memset(&txPwrLimitConfig, 0x00, sizeof(txPwrLimitConfig));
+    linkAdrReqConfig = LinkAdrCfg_Option_LoRaWAN_V1_0_2;
+    rfGain           = 0;
+    memset(&stats, 0x00, sizeof(stats));
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Enable / disable the cache; a disabled cache is cleared
+ */
+void WiMOD_LoRaWAN_ConfigCache::Enable(bool enable)
+{
+    enabled = enable;
+    if (!enabled) {
+        validItems = 0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Mark the given items as invalid
+ *
+ * @param items     bit mask of LORAWAN_CFG_CACHE_* items
+ */
+void WiMOD_LoRaWAN_ConfigCache::Invalidate(UINT8 items)
+{
+    if (validItems & items) {
+        stats.Invalidations++;
+    }
+    validItems &= ~items;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Check if an item can be served from the cache
+ *
+ * @param item      one of the LORAWAN_CFG_CACHE_* items
+ */
+bool WiMOD_LoRaWAN_ConfigCache::IsValid(UINT8 item) const
+{
+    if (!enabled || !(validItems & item)) {
+        return false;
+    }
+    // with ADR the network server owns data rate and TX power level
+    if ((item == LORAWAN_CFG_CACHE_RADIO_STACK)
+            && (radioStackConfig.Options & LORAWAN_STK_OPTION_ADR)) {
+        return false;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Decide if a write can be skipped and update the statistics
+ *
+ * @param equal     true if the new value equals the cached one
+ *
+ * @retval true     if the write must not be sent to the module
+ */
+bool WiMOD_LoRaWAN_ConfigCache::SkipWrite(bool equal)
+{
+    if (enabled && equal) {
+        stats.WritesSkipped++;
+        return true;
+    }
+    stats.WritesSent++;
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Read the radio stack config from the cache
+ *
+ * @retval true     if the cached value has been copied to data
+ */
+bool WiMOD_LoRaWAN_ConfigCache::GetRadioStackConfig(TWiMODLORAWAN_RadioStackConfig* data)
+{
+    if (!lookup(LORAWAN_CFG_CACHE_RADIO_STACK)) {
+        return false;
+    }
+    if (data) {
+        *data = radioStackConfig;
+        data->WrongParamErrCode = 0;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Store the radio stack config
+ *
+ * @param data          config read from or written to the module
+ * @param fromModule    true: data is a complete read result;
+ *                      false: only the writable fields of data are taken
+ *                      over (the item must have been read before)
+ */
+void WiMOD_LoRaWAN_ConfigCache::PutRadioStackConfig(const TWiMODLORAWAN_RadioStackConfig& data, bool fromModule)
+{
+    if (!enabled) {
+        return;
+    }
+    if (fromModule) {
+        radioStackConfig = data;
+        validItems |= LORAWAN_CFG_CACHE_RADIO_STACK;
+    } else if (validItems & LORAWAN_CFG_CACHE_RADIO_STACK) {
+        radioStackConfig.DataRateIndex   = data.DataRateIndex;
+        radioStackConfig.TXPowerLevel    = data.TXPowerLevel;
+        radioStackConfig.Options         = data.Options;
+        radioStackConfig.PowerSavingMode = data.PowerSavingMode;
+        radioStackConfig.Retransmissions = data.Retransmissions;
+        radioStackConfig.BandIndex       = data.BandIndex;
+        radioStackConfig.SubBandMask1    = data.SubBandMask1;
+        radioStackConfig.SubBandMask2    = data.SubBandMask2;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Compare the writable fields of a radio stack config
+ *
+ * @param data      new config
+ * @param subBands  true if the sub band masks are used (US915 only)
+ */
+bool WiMOD_LoRaWAN_ConfigCache::IsRadioStackConfigEqual(const TWiMODLORAWAN_RadioStackConfig& data, bool subBands) const
+{
+    const TWiMODLORAWAN_RadioStackConfig& c = radioStackConfig;
+
+    if (!IsValid(LORAWAN_CFG_CACHE_RADIO_STACK)) {
+        return false;
+    }
+    if ((c.DataRateIndex   != data.DataRateIndex)
+     || (c.TXPowerLevel    != data.TXPowerLevel)
+     || (c.Options         != data.Options)
+     || (c.PowerSavingMode != data.PowerSavingMode)
+     || (c.Retransmissions != data.Retransmissions)
+     || (c.BandIndex       != data.BandIndex)) {
+        return false;
+    }
+    if (subBands && ((c.SubBandMask1 != data.SubBandMask1) || (c.SubBandMask2 != data.SubBandMask2))) {
+        return false;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Read the device EUI from the cache
+ */
+bool WiMOD_LoRaWAN_ConfigCache::GetDeviceEUI(UINT8* deviceEUI)
+{
+    if (!lookup(LORAWAN_CFG_CACHE_DEVICE_EUI)) {
+        return false;
+    }
+    if (deviceEUI) {
+        memcpy(deviceEUI, this->deviceEUI, sizeof(this->deviceEUI));
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Store the device EUI
+ */
+void WiMOD_LoRaWAN_ConfigCache::PutDeviceEUI(const UINT8* deviceEUI)
+{
+    if (enabled && deviceEUI) {
+        memcpy(this->deviceEUI, deviceEUI, sizeof(this->deviceEUI));
+        validItems |= LORAWAN_CFG_CACHE_DEVICE_EUI;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Compare a device EUI with the cached one
+ */
+bool WiMOD_LoRaWAN_ConfigCache::IsDeviceEUIEqual(const UINT8* deviceEUI) const
+{
+    return IsValid(LORAWAN_CFG_CACHE_DEVICE_EUI) && deviceEUI
+           && (memcmp(this->deviceEUI, deviceEUI, sizeof(this->deviceEUI)) == 0);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Read the supported bands from the cache
+ */
+bool WiMOD_LoRaWAN_ConfigCache::GetSupportedBands(TWiMODLORAWAN_SupportedBands* supportedBands)
+{
+    if (!lookup(LORAWAN_CFG_CACHE_SUPPORTED_BANDS)) {
+        return false;
+    }
+    if (supportedBands) {
+        *supportedBands = this->supportedBands;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Store the supported bands
+ */
+void WiMOD_LoRaWAN_ConfigCache::PutSupportedBands(const TWiMODLORAWAN_SupportedBands& supportedBands)
+{
+    if (enabled) {
+        this->supportedBands = supportedBands;
+        validItems |= LORAWAN_CFG_CACHE_SUPPORTED_BANDS;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Read the TX power limit table from the cache
+ */
+bool WiMOD_LoRaWAN_ConfigCache::GetTxPowerLimitConfig(TWiMODLORAWAN_TxPwrLimitConfig* txPwrLimitCfg)
+{
+    if (!lookup(LORAWAN_CFG_CACHE_TX_PWR_LIMIT)) {
+        return false;
+    }
+    if (txPwrLimitCfg) {
+        *txPwrLimitCfg = txPwrLimitConfig;
+        txPwrLimitCfg->WrongParamErrCode = 0;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Store the complete TX power limit table (read result)
+ */
+void WiMOD_LoRaWAN_ConfigCache::PutTxPowerLimitConfig(const TWiMODLORAWAN_TxPwrLimitConfig& txPwrLimitCfg)
+{
+    if (enabled) {
+        txPwrLimitConfig = txPwrLimitCfg;
+        validItems |= LORAWAN_CFG_CACHE_TX_PWR_LIMIT;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Compare the single sub band entry of a set request with the table
+ */
+bool WiMOD_LoRaWAN_ConfigCache::IsTxPowerLimitEqual(const TWiMODLORAWAN_TxPwrLimitConfig& txPwrLimitCfg) const
+{
+    int i = findSubBand(txPwrLimitCfg.SubBandIndex[0]);
+
+    if (!IsValid(LORAWAN_CFG_CACHE_TX_PWR_LIMIT) || (i < 0)) {
+        return false;
+    }
+    return (txPwrLimitConfig.TxPwrLimitFlag[i]  == txPwrLimitCfg.TxPwrLimitFlag[0])
+        && (txPwrLimitConfig.TxPwrLimitValue[i] == txPwrLimitCfg.TxPwrLimitValue[0]);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Take over the single sub band entry of a successful set request
+ */
+void WiMOD_LoRaWAN_ConfigCache::UpdateTxPowerLimit(const TWiMODLORAWAN_TxPwrLimitConfig& txPwrLimitCfg)
+{
+    int i = findSubBand(txPwrLimitCfg.SubBandIndex[0]);
+
+    if (i < 0) {
+        // unknown sub band: table must be read again
+        validItems &= ~LORAWAN_CFG_CACHE_TX_PWR_LIMIT;
+        return;
+    }
+    txPwrLimitConfig.TxPwrLimitFlag[i]  = txPwrLimitCfg.TxPwrLimitFlag[0];
+    txPwrLimitConfig.TxPwrLimitValue[i] = txPwrLimitCfg.TxPwrLimitValue[0];
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Read the LinkAdrReq config from the cache
+ */
+bool WiMOD_LoRaWAN_ConfigCache::GetLinkAdrReqConfig(TWiMODLORAWAN_LinkAdrReqConfig* linkAdrReqCfg)
+{
+    if (!lookup(LORAWAN_CFG_CACHE_LINK_ADR_REQ)) {
+        return false;
+    }
+    if (linkAdrReqCfg) {
+        *linkAdrReqCfg = linkAdrReqConfig;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Store the LinkAdrReq config
+ */
+void WiMOD_LoRaWAN_ConfigCache::PutLinkAdrReqConfig(TWiMODLORAWAN_LinkAdrReqConfig linkAdrReqCfg)
+{
+    if (enabled) {
+        linkAdrReqConfig = linkAdrReqCfg;
+        validItems |= LORAWAN_CFG_CACHE_LINK_ADR_REQ;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Compare a LinkAdrReq config with the cached one
+ */
+bool WiMOD_LoRaWAN_ConfigCache::IsLinkAdrReqConfigEqual(TWiMODLORAWAN_LinkAdrReqConfig linkAdrReqCfg) const
+{
+    return IsValid(LORAWAN_CFG_CACHE_LINK_ADR_REQ) && (linkAdrReqConfig == linkAdrReqCfg);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Read the custom config (rf gain) from the cache
+ */
+bool WiMOD_LoRaWAN_ConfigCache::GetCustomConfig(INT8* rfGain)
+{
+    if (!lookup(LORAWAN_CFG_CACHE_CUSTOM_CONFIG)) {
+        return false;
+    }
+    if (rfGain) {
+        *rfGain = this->rfGain;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Store the custom config (rf gain)
+ */
+void WiMOD_LoRaWAN_ConfigCache::PutCustomConfig(INT8 rfGain)
+{
+    if (enabled) {
+        this->rfGain = rfGain;
+        validItems |= LORAWAN_CFG_CACHE_CUSTOM_CONFIG;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Compare a custom config (rf gain) with the cached one
+ */
+bool WiMOD_LoRaWAN_ConfigCache::IsCustomConfigEqual(INT8 rfGain) const
+{
+    return IsValid(LORAWAN_CFG_CACHE_CUSTOM_CONFIG) && (this->rfGain == rfGain);
+}
+
+//------------------------------------------------------------------------------
+//
+// Section private functions
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+bool WiMOD_LoRaWAN_ConfigCache::lookup(UINT8 item)
+{
+    bool valid = IsValid(item);
+
+    if (enabled) {
+        if (valid) {
+            stats.ReadHits++;
+        } else {
+            stats.ReadMisses++;
+        }
+    }
+    return valid;
+}
+
+int WiMOD_LoRaWAN_ConfigCache::findSubBand(UINT8 subBandIndex) const
+{
+    UINT8 i;
+
+    for (i = 0; (i < txPwrLimitConfig.NumOfEntries) && (i < (WiMODLORAWAN_APP_PAYLOAD_LEN / 3)); i++) {
+        if (txPwrLimitConfig.SubBandIndex[i] == subBandIndex) {
+            return i;
+        }
+    }
+    return -1;
+}
+//! @endcond
+
+//------------------------------------------------------------------------------
+// EOF
+//------------------------------------------------------------------------------
@@ -0,0 +1,137 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LoRaWAN_ConfigCache.h
+//! @ingroup WiMODLoRaWAN
+//! <!------------------------------------------------------------------------->
+//! @brief Declarations for the module configuration cache
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//! Shadow copy of the module configuration: reads are served locally and
+//! writes are only sent to the module if a value has really changed.
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+
+#ifndef ARDUINO_WIMOD_LORAWAN_CONFIGCACHE_H_
+#define ARDUINO_WIMOD_LORAWAN_CONFIGCACHE_H_
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "../SAP/WiMOD_SAP_LORAWAN_IDs.h"
+
+//------------------------------------------------------------------------------
+//
+// Section defines
+//
+//------------------------------------------------------------------------------
+
+/** cache items; bit mask */
+#define LORAWAN_CFG_CACHE_RADIO_STACK               0x01
+#define LORAWAN_CFG_CACHE_DEVICE_EUI                0x02
+#define LORAWAN_CFG_CACHE_SUPPORTED_BANDS           0x04
+#define LORAWAN_CFG_CACHE_TX_PWR_LIMIT              0x08
+#define LORAWAN_CFG_CACHE_LINK_ADR_REQ              0x10
+#define LORAWAN_CFG_CACHE_CUSTOM_CONFIG             0x20
+#define LORAWAN_CFG_CACHE_ALL                       0x3F
+
+//------------------------------------------------------------------------------
+//
+// Section types
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Statistics of the configuration cache
+ */
+typedef struct TWiMODLORAWAN_ConfigCacheStats
+{
+    UINT32      ReadHits;                                                       /*!< reads served from the cache */
+    UINT32      ReadMisses;                                                     /*!< reads sent to the module */
+    UINT32      WritesSent;                                                     /*!< writes sent to the module */
+    UINT32      WritesSkipped;                                                  /*!< writes skipped (no change) */
+    UINT32      Invalidations;                                                  /*!< number of (power up / reset) invalidations */
+} TWiMODLORAWAN_ConfigCacheStats;
+
+//------------------------------------------------------------------------------
+//
+// Section class
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Shadow cache for the configuration of the LoRaWAN firmware
+ *
+ * The cache only stores values; the module access is done by the
+ * WiMODLoRaWAN class. An item is filled by the first successful read or
+ * write and stays valid until the module reports a power up / reset.
+ *
+ * The radio stack config is not used while ADR is enabled, because the
+ * network server may change the data rate and TX power level then.
+ */
+class WiMOD_LoRaWAN_ConfigCache
+{
+public:
+    WiMOD_LoRaWAN_ConfigCache(void);
+
+    void                Enable(bool enable);
+    bool                IsEnabled(void) const { return enabled; }
+    void                Invalidate(UINT8 items = LORAWAN_CFG_CACHE_ALL);
+    bool                IsValid(UINT8 item) const;
+
+    bool                GetRadioStackConfig(TWiMODLORAWAN_RadioStackConfig* data);
+    void                PutRadioStackConfig(const TWiMODLORAWAN_RadioStackConfig& data, bool fromModule);
+    bool                IsRadioStackConfigEqual(const TWiMODLORAWAN_RadioStackConfig& data, bool subBands) const;
+
+    bool                GetDeviceEUI(UINT8* deviceEUI);
+    void                PutDeviceEUI(const UINT8* deviceEUI);
+    bool                IsDeviceEUIEqual(const UINT8* deviceEUI) const;
+
+    bool                GetSupportedBands(TWiMODLORAWAN_SupportedBands* supportedBands);
+    void                PutSupportedBands(const TWiMODLORAWAN_SupportedBands& supportedBands);
+
+    bool                GetTxPowerLimitConfig(TWiMODLORAWAN_TxPwrLimitConfig* txPwrLimitCfg);
+    void                PutTxPowerLimitConfig(const TWiMODLORAWAN_TxPwrLimitConfig& txPwrLimitCfg);
+    bool                IsTxPowerLimitEqual(const TWiMODLORAWAN_TxPwrLimitConfig& txPwrLimitCfg) const;
+    void                UpdateTxPowerLimit(const TWiMODLORAWAN_TxPwrLimitConfig& txPwrLimitCfg);
+
+    bool                GetLinkAdrReqConfig(TWiMODLORAWAN_LinkAdrReqConfig* linkAdrReqCfg);
+    void                PutLinkAdrReqConfig(TWiMODLORAWAN_LinkAdrReqConfig linkAdrReqCfg);
+    bool                IsLinkAdrReqConfigEqual(TWiMODLORAWAN_LinkAdrReqConfig linkAdrReqCfg) const;
+
+    bool                GetCustomConfig(INT8* rfGain);
+    void                PutCustomConfig(INT8 rfGain);
+    bool                IsCustomConfigEqual(INT8 rfGain) const;
+
+    bool                SkipWrite(bool equal);
+
+    const TWiMODLORAWAN_ConfigCacheStats& GetStats(void) const { return stats; }
+
+private:
+    //! @cond Doxygen_Suppress
+    bool                lookup(UINT8 item);
+    int                 findSubBand(UINT8 subBandIndex) const;
+
+    bool                enabled;
+    UINT8               validItems;
+
+    TWiMODLORAWAN_RadioStackConfig  radioStackConfig;
+    UINT8                           deviceEUI[8];
+    TWiMODLORAWAN_SupportedBands    supportedBands;
+    TWiMODLORAWAN_TxPwrLimitConfig  txPwrLimitConfig;
+    TWiMODLORAWAN_LinkAdrReqConfig  linkAdrReqConfig;
+    INT8                            rfGain;
+
+    TWiMODLORAWAN_ConfigCacheStats  stats;
+    //! @endcond
+};
+
+#endif /* ARDUINO_WIMOD_LORAWAN_CONFIGCACHE_H_ */
@@ -0,0 +1,356 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LoRaWAN_ConfirmedUplink.cpp
+//! @ingroup WiMODLoRaWAN
+//! <!------------------------------------------------------------------------->
+//! @brief Implementation of the confirmed uplink tracker
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//!
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "WiMOD_LoRaWAN_ConfirmedUplink.h"
+
+#include <string.h>
+
+//------------------------------------------------------------------------------
+//
+// Section public functions
+//
+//------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Constructor
+ *
+ * The policy is disabled by default; the tracker only records the uplinks.
+ */
+WiMOD_LoRaWAN_ConfirmedUplink::WiMOD_LoRaWAN_ConfirmedUplink(void)
+{
+    memset(&policy, 0x00, sizeof(policy));
+    memset(&info, 0x00, sizeof(info));
+    memset(&stats, 0x00, sizeof(stats));
+
+    policy.AckTimeoutMs = LORAWAN_CUPLINK_DEFAULT_ACK_TIMEOUT_MS;
+    clientCB      = NULL;
+    nextSeqID     = 0;
+    ackReceived   = false;
+    fallback      = false;
+    probeCnt      = 0;
+    dataRateRaised = false;
+    baseDataRate  = 0;
+    targetDataRate = 0;
+    avgAirtimeMs8 = 0;
+    avgBytes8     = 0;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Set the host side policy
+ *
+ * @param policy    new policy; MaxAirtimePerByteUs = 0 disables all actions
+ */
+void WiMOD_LoRaWAN_ConfirmedUplink::SetPolicy(const TWiMODLORAWAN_CUplinkPolicy& policy)
+{
+    this->policy = policy;
+    if (this->policy.AckTimeoutMs == 0) {
+        this->policy.AckTimeoutMs = LORAWAN_CUPLINK_DEFAULT_ACK_TIMEOUT_MS;
+    }
+    fallback      = false;
+    dataRateRaised = false;
+    targetDataRate = 0;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Register a callback that is called when an uplink reached its final state
+ */
+void WiMOD_LoRaWAN_ConfirmedUplink::RegisterClient(TConfirmedUplinkCallback cb)
+{
+    clientCB = cb;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Check if a confirmed uplink is in flight
+ */
+bool WiMOD_LoRaWAN_ConfirmedUplink::IsBusy(void) const
+{
+    return (info.State == LORAWAN_CUPLINK_STATE_WAIT_TX_IND)
+        || (info.State == LORAWAN_CUPLINK_STATE_WAIT_ACK);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Decide if the next uplink is to be sent confirmed
+ *
+ * In fallback mode only every ProbeInterval-th uplink is sent confirmed, in
+ * order to detect when the link has recovered. The uplinks are counted by
+ * OnRequest() once the module accepted them.
+ */
+bool WiMOD_LoRaWAN_ConfirmedUplink::UseConfirmed(void) const
+{
+    if (!fallback) {
+        return true;
+    }
+    return policy.ProbeInterval && ((probeCnt + 1) >= policy.ProbeInterval);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Data rate to be used for the next uplink
+ *
+ * Once the airtime per byte has recovered, the raised data rate is lowered
+ * step by step back to the one used before the first raise.
+ *
+ * @param   dataRateIndex   data rate currently configured
+ *
+ * @return  data rate requested by the policy; otherwise dataRateIndex
+ */
+UINT8 WiMOD_LoRaWAN_ConfirmedUplink::GetDataRateAdvice(UINT8 dataRateIndex) const
+{
+    if (dataRateRaised || (targetDataRate > dataRateIndex)) {
+        return targetDataRate;
+    }
+    return dataRateIndex;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief The data rate advice has been written to the module
+ *
+ * Must only be called if the module accepted the new data rate; otherwise
+ * the advice is repeated for the next uplink.
+ *
+ * @param   oldDataRate     data rate configured before
+ * @param   newDataRate     data rate now configured
+ */
+void WiMOD_LoRaWAN_ConfirmedUplink::OnDataRateApplied(UINT8 oldDataRate, UINT8 newDataRate)
+{
+    if (!dataRateRaised) {
+        baseDataRate   = oldDataRate;
+        dataRateRaised = true;
+    }
+    if (newDataRate <= baseDataRate) {
+        // back on the original data rate
+        dataRateRaised = false;
+        targetDataRate = 0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Start tracking of a new uplink request
+ *
+ * @param   data        payload of the request
+ * @param   confirmed   true if sent as C-Data, false if sent as U-Data
+ * @param   accepted    true if the module accepted the request
+ * @param   rspStatus   status byte of the response
+ * @param   now         current time in ms
+ *
+ * @return  sequence ID of the uplink
+ */
+UINT16 WiMOD_LoRaWAN_ConfirmedUplink::OnRequest(const TWiMODLORAWAN_TX_Data* data, bool confirmed,
+                                                bool accepted, UINT8 rspStatus, UINT32 now)
+{
+    memset(&info, 0x00, sizeof(info));
+    info.SeqID     = nextSeqID++;
+    info.RspStatus = rspStatus;
+    info.StartTime = now;
+    if (data) {
+        info.Port   = data->Port;
+        info.Length = data->Length;
+    }
+    ackReceived = false;
+    stats.Requests++;
+
+    // count the uplinks in fallback mode; a probe restarts the interval
+    if (accepted && fallback) {
+        probeCnt = confirmed ? 0 : (probeCnt + 1);
+    }
+
+    if (!accepted) {
+        complete(LORAWAN_CUPLINK_STATE_REJECTED, now);
+    } else if (!confirmed) {
+        complete(LORAWAN_CUPLINK_STATE_UNCONFIRMED, now);
+    } else {
+        info.State = LORAWAN_CUPLINK_STATE_WAIT_TX_IND;
+    }
+    return info.SeqID;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Process a SEND_CDATA_TX_IND
+ *
+ * The module reports the airtime of a single radio packet; the total
+ * airtime is estimated as packet airtime * number of packets.
+ */
+void WiMOD_LoRaWAN_ConfirmedUplink::OnTxIndication(const TWiMODLORAWAN_TxIndData& txInd, UINT32 now)
+{
+    if (info.State != LORAWAN_CUPLINK_STATE_WAIT_TX_IND) {
+        return;
+    }
+
+    info.NumTxPackets = 1;
+    if (txInd.FieldAvailability != LORAWAN_OPT_TX_IND_INFOS_NOT_AVAILABLE) {
+        info.DataRateIndex = txInd.DataRateIndex;
+        if (txInd.FieldAvailability == LORAWAN_OPT_TX_IND_INFOS_INCL_PKT_CNT) {
+            info.NumTxPackets = MAX(1, txInd.NumTxPackets);
+        }
+        info.AirtimeMs = txInd.RfMsgAirtime * info.NumTxPackets;
+    }
+
+    if (txInd.StatusFormat & (LORAWAN_DATA_TX_IND_FORMAT_STATUS_ERR_MAX_RETRANS
+                              | LORAWAN_DATA_TX_IND_FORMAT_STATUS_ERR_PAYLOAD)) {
+        complete(LORAWAN_CUPLINK_STATE_NOT_ACKED, now);
+    } else if (ackReceived) {
+        complete(LORAWAN_CUPLINK_STATE_ACKED, now);
+    } else {
+        info.State = LORAWAN_CUPLINK_STATE_WAIT_ACK;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Process a RECV_ACK_IND (or a downlink with the ACK flag set)
+ */
+void WiMOD_LoRaWAN_ConfirmedUplink::OnAck(UINT32 now)
+{
+    if (info.State == LORAWAN_CUPLINK_STATE_WAIT_TX_IND) {
+        // TX indication still pending
+        ackReceived = true;
+    } else if (info.State == LORAWAN_CUPLINK_STATE_WAIT_ACK) {
+        complete(LORAWAN_CUPLINK_STATE_ACKED, now);
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Process a RECV_NO_DATA_IND
+ *
+ * Before the TX indication the module is still retransmitting; only a
+ * NO_DATA after the last transmission finishes the uplink.
+ */
+void WiMOD_LoRaWAN_ConfirmedUplink::OnNoData(UINT32 now)
+{
+    if (info.State == LORAWAN_CUPLINK_STATE_WAIT_ACK) {
+        complete(LORAWAN_CUPLINK_STATE_NOT_ACKED, now);
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Finish an uplink whose indications did not arrive in time
+ */
+void WiMOD_LoRaWAN_ConfirmedUplink::CheckTimeout(UINT32 now)
+{
+    if (IsBusy() && ((UINT32)(now - info.StartTime) >= policy.AckTimeoutMs)) {
+        complete(LORAWAN_CUPLINK_STATE_NOT_ACKED, now);
+    }
+}
+
+//------------------------------------------------------------------------------
+//
+// Section private functions
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+void WiMOD_LoRaWAN_ConfirmedUplink::complete(TWiMODLORAWAN_CUplinkState state, UINT32 now)
+{
+    UINT32 delivered = 0;
+
+    info.State    = state;
+    info.Duration = now - info.StartTime;
+
+    switch (state)
+    {
+        case LORAWAN_CUPLINK_STATE_ACKED:
+            stats.Acked++;
+            delivered = info.Length;
+            break;
+        case LORAWAN_CUPLINK_STATE_NOT_ACKED:
+            stats.NotAcked++;
+            break;
+        case LORAWAN_CUPLINK_STATE_REJECTED:
+            stats.Rejected++;
+            break;
+        case LORAWAN_CUPLINK_STATE_UNCONFIRMED:
+            stats.Unconfirmed++;
+            break;
+        default:
+            break;
+    }
+    stats.TxPackets      += info.NumTxPackets;
+    stats.AirtimeMs      += info.AirtimeMs;
+    stats.DeliveredBytes += delivered;
+
+    // only confirmed uplinks tell if the payload has been delivered
+    if ((state == LORAWAN_CUPLINK_STATE_ACKED) || (state == LORAWAN_CUPLINK_STATE_NOT_ACKED)) {
+        if ((stats.Acked + stats.NotAcked) == 1) {
+            avgAirtimeMs8 = info.AirtimeMs * 8;
+            avgBytes8     = delivered * 8;
+        } else {
+            // exponential moving average; gain 1/8
+            avgAirtimeMs8 = avgAirtimeMs8 - (avgAirtimeMs8 >> 3) + info.AirtimeMs;
+            avgBytes8     = avgBytes8 - (avgBytes8 >> 3) + delivered;
+        }
+        if (avgBytes8) {
+            stats.AirtimePerByteUs = (UINT32)(((uint64_t) avgAirtimeMs8 * 1000) / avgBytes8);
+        } else {
+            stats.AirtimePerByteUs = avgAirtimeMs8 ? 0xFFFFFFFF : 0;
+        }
+        applyPolicy();
+    }
+
+    if (clientCB) {
+        clientCB(info);
+    }
+}
+
+void WiMOD_LoRaWAN_ConfirmedUplink::applyPolicy(void)
+{
+    if (policy.MaxAirtimePerByteUs == 0) {
+        return;
+    }
+
+    if (stats.AirtimePerByteUs > policy.MaxAirtimePerByteUs) {
+        // raise the data rate first (if allowed and possible), then stop
+        // requesting acks
+        if ((policy.Actions & LORAWAN_CUPLINK_ACTION_RAISE_DR)
+                && (info.DataRateIndex < policy.MaxDataRateIndex)) {
+            targetDataRate = MAX(targetDataRate, info.DataRateIndex + 1);
+        } else if (policy.Actions & LORAWAN_CUPLINK_ACTION_UNCONFIRMED) {
+            fallback = true;
+            probeCnt = 0;
+        }
+    } else if (stats.AirtimePerByteUs <= (policy.MaxAirtimePerByteUs - (policy.MaxAirtimePerByteUs >> 2))) {
+        // recovered with some hysteresis: acks first, then one data rate
+        // step down per uplink
+        if (fallback) {
+            fallback = false;
+        } else if (!dataRateRaised) {
+            targetDataRate = 0;
+        } else if (targetDataRate > baseDataRate) {
+            targetDataRate--;
+        }
+    }
+}
+//! @endcond
+
+//------------------------------------------------------------------------------
+// EOF
+//------------------------------------------------------------------------------
@@ -0,0 +1,183 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LoRaWAN_ConfirmedUplink.h
+//! @ingroup WiMODLoRaWAN
+//! <!------------------------------------------------------------------------->
+//! @brief Declarations for the confirmed uplink tracker
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//! Tracks a confirmed uplink (C-Data) from the request to the final result
+//! and applies a host side policy to bound the airtime per delivered byte.
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+
+#ifndef ARDUINO_WIMOD_LORAWAN_CONFIRMEDUPLINK_H_
+#define ARDUINO_WIMOD_LORAWAN_CONFIRMEDUPLINK_H_
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "../SAP/WiMOD_SAP_LORAWAN_IDs.h"
+#include "../HCI/WiMODLRHCI.h"
+
+#ifdef WIMOD_USE_CPP11
+#include <functional>
+#endif
+
+//------------------------------------------------------------------------------
+//
+// Section defines
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+#define LORAWAN_CUPLINK_DEFAULT_ACK_TIMEOUT_MS      30000
+//! @endcond
+
+/** policy action: raise the data rate if the airtime per byte is too high */
+#define LORAWAN_CUPLINK_ACTION_RAISE_DR             0x01
+/** policy action: send unconfirmed uplinks if the airtime per byte is too high */
+#define LORAWAN_CUPLINK_ACTION_UNCONFIRMED          0x02
+
+//------------------------------------------------------------------------------
+//
+// Section types
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief States of a tracked uplink
+ */
+typedef enum TWiMODLORAWAN_CUplinkState
+{
+    LORAWAN_CUPLINK_STATE_IDLE = 0,                                             /*!< nothing in flight */
+    LORAWAN_CUPLINK_STATE_WAIT_TX_IND,                                          /*!< request accepted (SEND_CDATA_RSP) */
+    LORAWAN_CUPLINK_STATE_WAIT_ACK,                                             /*!< radio packet sent (SEND_CDATA_TX_IND) */
+    LORAWAN_CUPLINK_STATE_ACKED,                                                /*!< ack received (RECV_ACK_IND) */
+    LORAWAN_CUPLINK_STATE_NOT_ACKED,                                            /*!< no ack after all retransmissions / timeout */
+    LORAWAN_CUPLINK_STATE_REJECTED,                                             /*!< request rejected by the module */
+    LORAWAN_CUPLINK_STATE_UNCONFIRMED,                                          /*!< sent as unconfirmed uplink due to the policy */
+} TWiMODLORAWAN_CUplinkState;
+
+/**
+ * @brief Information about a single tracked uplink
+ */
+typedef struct TWiMODLORAWAN_CUplinkInfo
+{
+    UINT16                      SeqID;                                          /*!< sequence ID assigned by the tracker */
+    TWiMODLORAWAN_CUplinkState  State;                                          /*!< current / final state */
+    UINT8                       Port;                                           /*!< LoRaWAN port */
+    UINT8                       Length;                                         /*!< payload length */
+    UINT8                       RspStatus;                                      /*!< status of the SEND_CDATA_RSP */
+    UINT8                       DataRateIndex;                                  /*!< data rate of the last transmission (if reported) */
+    UINT8                       NumTxPackets;                                   /*!< number of radio packets used (if reported) */
+    UINT32                      AirtimeMs;                                      /*!< total airtime used in ms (if reported) */
+    UINT32                      StartTime;                                      /*!< time stamp (ms) of the request */
+    UINT32                      Duration;                                       /*!< time (ms) from request to final state */
+} TWiMODLORAWAN_CUplinkInfo;
+
+/**
+ * @brief Host side policy for confirmed uplinks
+ */
+typedef struct TWiMODLORAWAN_CUplinkPolicy
+{
+    UINT32      MaxAirtimePerByteUs;                                            /*!< upper bound of airtime per delivered byte in us; 0 = policy off */
+    UINT8       Actions;                                                        /*!< LORAWAN_CUPLINK_ACTION_* flags */
+    UINT8       MaxDataRateIndex;                                               /*!< highest data rate used by the RAISE_DR action */
+    UINT8       ProbeInterval;                                                  /*!< in fallback mode every n-th uplink is sent confirmed */
+    UINT32      AckTimeoutMs;                                                   /*!< max. time from request to final state */
+} TWiMODLORAWAN_CUplinkPolicy;
+
+/**
+ * @brief Statistics of the confirmed uplink tracker
+ */
+typedef struct TWiMODLORAWAN_CUplinkStats
+{
+    UINT32      Requests;                                                       /*!< number of uplink requests */
+    UINT32      Acked;                                                          /*!< number of acknowledged uplinks */
+    UINT32      NotAcked;                                                       /*!< number of uplinks without ack */
+    UINT32      Rejected;                                                       /*!< number of rejected requests */
+    UINT32      Unconfirmed;                                                    /*!< number of uplinks sent unconfirmed */
+    UINT32      TxPackets;                                                      /*!< total number of radio packets */
+    UINT32      AirtimeMs;                                                      /*!< total airtime in ms */
+    UINT32      DeliveredBytes;                                                 /*!< total number of acknowledged payload bytes */
+    UINT32      AirtimePerByteUs;                                               /*!< smoothed airtime per delivered byte in us */
+} TWiMODLORAWAN_CUplinkStats;
+
+// C++11 check
+#ifdef WIMOD_USE_CPP11
+	/** Type definition for a 'confirmed uplink done' callback  */
+	typedef std::function<void (const TWiMODLORAWAN_CUplinkInfo& info)> TConfirmedUplinkCallback;
+#else
+	/** Type definition for a 'confirmed uplink done' callback function */
+	typedef void (*TConfirmedUplinkCallback)(const TWiMODLORAWAN_CUplinkInfo& info);
+#endif
+
+//------------------------------------------------------------------------------
+//
+// Section class
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Tracker for confirmed uplinks
+ *
+ * The tracker is fed with the events of the LoRaWAN SAP by the WiMODLoRaWAN
+ * class: SEND_CDATA_RSP -> SEND_CDATA_TX_IND -> RECV_ACK_IND / RECV_NO_DATA_IND.
+ * Only one confirmed uplink can be in flight at a time.
+ */
+class WiMOD_LoRaWAN_ConfirmedUplink
+{
+public:
+    WiMOD_LoRaWAN_ConfirmedUplink(void);
+
+    void                SetPolicy(const TWiMODLORAWAN_CUplinkPolicy& policy);
+    void                RegisterClient(TConfirmedUplinkCallback cb);
+
+    bool                IsBusy(void) const;
+    bool                UseConfirmed(void) const;
+    UINT8               GetDataRateAdvice(UINT8 dataRateIndex) const;
+    void                OnDataRateApplied(UINT8 oldDataRate, UINT8 newDataRate);
+
+    UINT16              OnRequest(const TWiMODLORAWAN_TX_Data* data, bool confirmed,
+                                  bool accepted, UINT8 rspStatus, UINT32 now);
+    void                OnTxIndication(const TWiMODLORAWAN_TxIndData& txInd, UINT32 now);
+    void                OnAck(UINT32 now);
+    void                OnNoData(UINT32 now);
+    void                CheckTimeout(UINT32 now);
+
+    const TWiMODLORAWAN_CUplinkInfo&    GetInfo(void) const { return info; }
+    const TWiMODLORAWAN_CUplinkStats&   GetStats(void) const { return stats; }
+
+private:
+    //! @cond Doxygen_Suppress
+    void                complete(TWiMODLORAWAN_CUplinkState state, UINT32 now);
+    void                applyPolicy(void);
+
+    TWiMODLORAWAN_CUplinkPolicy policy;
+    TWiMODLORAWAN_CUplinkInfo   info;
+    TWiMODLORAWAN_CUplinkStats  stats;
+    TConfirmedUplinkCallback    clientCB;
+
+    UINT16              nextSeqID;
+    bool                ackReceived;
+    bool                fallback;
+    UINT8               probeCnt;
+    bool                dataRateRaised;                                         // module runs on targetDataRate
+    UINT8               baseDataRate;                                           // data rate before the first raise
+    UINT8               targetDataRate;
+    UINT32              avgAirtimeMs8;                                          // smoothed airtime * 8
+    UINT32              avgBytes8;                                              // smoothed delivered bytes * 8
+    //! @endcond
+};
+
+#endif /* ARDUINO_WIMOD_LORAWAN_CONFIRMEDUPLINK_H_ */
@@ -0,0 +1,293 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LoRaWAN_LinkAdaptation.cpp
+//! @ingroup WiMODLoRaWAN
+//! <!------------------------------------------------------------------------->
+//! @brief Implementation of the host side link adaptation
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//!
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "WiMOD_LoRaWAN_LinkAdaptation.h"
+
+#include <string.h>
+
+//------------------------------------------------------------------------------
+//
+// Section Const Data
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+// demodulation floor per data rate in 1/10 dB (SX127x datasheet);
+// DR6 uses the doubled bandwidth -> 3 dB more noise than measured at 125 kHz
+static const INT16 RequiredSNR10[LORAWAN_LINKADAPT_MAX_DR + 1] =
+{
+    -200,   // DR0: SF12 / 125 kHz
+    -175,   // DR1: SF11 / 125 kHz
+    -150,   // DR2: SF10 / 125 kHz
+    -125,   // DR3: SF9  / 125 kHz
+    -100,   // DR4: SF8  / 125 kHz
+     -75,   // DR5: SF7  / 125 kHz
+     -45,   // DR6: SF7  / 250 kHz
+};
+//! @endcond
+
+//------------------------------------------------------------------------------
+//
+// Section public functions
+//
+//------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Constructor
+ *
+ * Default: DR0..DR5, 2..14 dBm in 2 dB steps, 90 % delivery per radio packet,
+ * 5 dB installation margin, 3 dB hysteresis, 6 samples between decisions.
+ */
+WiMOD_LoRaWAN_LinkAdaptation::WiMOD_LoRaWAN_LinkAdaptation(void)
+{
+    config.MinDataRateIndex       = 0;
+    config.MaxDataRateIndex       = 5;
+    config.MinTxPower             = 2;
+    config.MaxTxPower             = 14;
+    config.TxPowerStep            = 2;
+    config.TargetDeliveryPermille = 900;
+    config.InstallMarginDb        = 5;
+    config.HysteresisDb           = 3;
+    config.MinSamples             = 6;
+
+    Reset();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Set a new configuration; the windows are cleared
+ */
+void WiMOD_LoRaWAN_LinkAdaptation::SetConfig(const TWiMODLORAWAN_LinkAdaptConfig& config)
+{
+    this->config = config;
+
+    if (this->config.MaxDataRateIndex > LORAWAN_LINKADAPT_MAX_DR) {
+        this->config.MaxDataRateIndex = LORAWAN_LINKADAPT_MAX_DR;
+    }
+    if (this->config.MinDataRateIndex > this->config.MaxDataRateIndex) {
+        this->config.MinDataRateIndex = this->config.MaxDataRateIndex;
+    }
+    if (this->config.MinTxPower > this->config.MaxTxPower) {
+        this->config.MinTxPower = this->config.MaxTxPower;
+    }
+    if (this->config.TxPowerStep == 0) {
+        this->config.TxPowerStep = 1;
+    }
+    Reset();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Clear the sliding windows
+ */
+void WiMOD_LoRaWAN_LinkAdaptation::Reset(void)
+{
+    dlCount = 0;
+    dlIndex = 0;
+    ulCount = 0;
+    ulIndex = 0;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Add the RSSI / SNR of a received downlink (ack or data)
+ *
+ * @param rssi      RSSI in dBm
+ * @param snr       SNR in dB
+ */
+void WiMOD_LoRaWAN_LinkAdaptation::OnDownlink(INT8 rssi, INT8 snr)
+{
+    dlRSSI[dlIndex] = rssi;
+    dlSNR[dlIndex]  = snr;
+    dlIndex = (dlIndex + 1) % LORAWAN_LINKADAPT_WINDOW_SIZE;
+    if (dlCount < LORAWAN_LINKADAPT_WINDOW_SIZE) {
+        dlCount++;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Add the result of a finished confirmed uplink
+ *
+ * @param numTxPackets  number of radio packets used (from the TX indication)
+ * @param delivered     true if the uplink has been acknowledged
+ */
+void WiMOD_LoRaWAN_LinkAdaptation::OnUplink(UINT8 numTxPackets, bool delivered)
+{
+    if (numTxPackets == 0) {
+        // not reported by the module
+        numTxPackets = 1;
+    }
+    ulTxPackets[ulIndex] = numTxPackets;
+    ulDelivered[ulIndex] = delivered;
+    ulIndex = (ulIndex + 1) % LORAWAN_LINKADAPT_WINDOW_SIZE;
+    if (ulCount < LORAWAN_LINKADAPT_WINDOW_SIZE) {
+        ulCount++;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Derive the data rate and TX power for the next uplinks
+ *
+ * One step per decision:
+ * - delivery below target or SNR margin < 0:
+ *   raise the TX power, at max. power lower the data rate
+ * - delivery ok and SNR margin >= step + hysteresis:
+ *   raise the data rate, at max. data rate lower the TX power
+ *
+ * Without downlink SNR samples only the step down is possible.
+ *
+ * @param dataRateIndex     data rate currently used
+ * @param txPower           TX power level currently used in dBm
+ * @param newDataRateIndex  pointer where to store the advised data rate
+ * @param newTxPower        pointer where to store the advised TX power level
+ *
+ * @retval true     if a different setting is advised; the windows are cleared
+ */
+bool WiMOD_LoRaWAN_LinkAdaptation::Evaluate(UINT8 dataRateIndex, UINT8 txPower,
+                                            UINT8* newDataRateIndex, UINT8* newTxPower)
+{
+    TWiMODLORAWAN_LinkMetrics metrics;
+    INT16                     margin10 = 0;
+    INT16                     hyst10   = (INT16) config.HysteresisDb * 10;
+    UINT8                     dr       = dataRateIndex;
+    UINT8                     pwr      = txPower;
+    bool                      deliveryLow;
+
+    if ((newDataRateIndex == NULL) || (newTxPower == NULL)) {
+        return false;
+    }
+    *newDataRateIndex = dataRateIndex;
+    *newTxPower       = txPower;
+
+    if ((UINT16) dlCount + ulCount < config.MinSamples) {
+        return false;
+    }
+
+    // settings outside of the allowed range are corrected at once
+    dr  = MAX(config.MinDataRateIndex, MIN(dr, config.MaxDataRateIndex));
+    pwr = MAX(config.MinTxPower, MIN(pwr, config.MaxTxPower));
+
+    GetMetrics(&metrics);
+
+    deliveryLow = (metrics.DeliveryPermille < config.TargetDeliveryPermille);
+    if (metrics.NumDownlinks) {
+        margin10 = metrics.AvgSNR10 - GetRequiredSNR10(dr)
+                   - (INT16) config.InstallMarginDb * 10
+                   - ((INT16) config.MaxTxPower - pwr) * 10;
+    }
+
+    if ((dr == dataRateIndex) && (pwr == txPower)) {
+        if (deliveryLow || (metrics.NumDownlinks && (margin10 < 0))) {
+            // link too weak: more power first, then slower
+            if (pwr < config.MaxTxPower) {
+                pwr = MIN(config.MaxTxPower, pwr + config.TxPowerStep);
+            } else if (dr > config.MinDataRateIndex) {
+                dr--;
+            }
+        } else if (metrics.NumDownlinks) {
+            // link strong enough: faster first, then less power
+            if ((dr < config.MaxDataRateIndex)
+                    && (margin10 >= (GetRequiredSNR10(dr + 1) - GetRequiredSNR10(dr)) + hyst10)) {
+                dr++;
+            } else if ((pwr > config.MinTxPower)
+                    && (margin10 >= (INT16) config.TxPowerStep * 10 + hyst10)) {
+                pwr = (pwr - config.MinTxPower > config.TxPowerStep) ? pwr - config.TxPowerStep : config.MinTxPower;
+            }
+        }
+    }
+
+    if ((dr == dataRateIndex) && (pwr == txPower)) {
+        return false;
+    }
+
+    *newDataRateIndex = dr;
+    *newTxPower       = pwr;
+    Reset();
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the link metrics over the current windows
+ *
+ * @param metrics   pointer where to store the metrics
+ */
+void WiMOD_LoRaWAN_LinkAdaptation::GetMetrics(TWiMODLORAWAN_LinkMetrics* metrics) const
+{
+    INT32 sumRSSI = 0;
+    INT32 sumSNR  = 0;
+    INT16 minSNR  = 127;
+    UINT8 i;
+
+    if (metrics == NULL) {
+        return;
+    }
+    memset(metrics, 0x00, sizeof(TWiMODLORAWAN_LinkMetrics));
+
+    for (i = 0; i < dlCount; i++) {
+        sumRSSI += dlRSSI[i];
+        sumSNR  += dlSNR[i];
+        minSNR   = MIN(minSNR, (INT16) dlSNR[i]);
+    }
+    metrics->NumDownlinks = dlCount;
+    if (dlCount) {
+        metrics->AvgRSSI  = (INT16)(sumRSSI / dlCount);
+        metrics->AvgSNR10 = (INT16)((sumSNR * 10) / dlCount);
+        metrics->MinSNR10 = minSNR * 10;
+    }
+
+    for (i = 0; i < ulCount; i++) {
+        metrics->TxPackets += ulTxPackets[i];
+        if (ulDelivered[i]) {
+            metrics->Delivered++;
+        }
+    }
+    metrics->NumUplinks       = ulCount;
+    metrics->DeliveryPermille = 1000;
+    if (metrics->TxPackets) {
+        metrics->DeliveryPermille = (UINT16)(((UINT32) metrics->Delivered * 1000) / metrics->TxPackets);
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Demodulation floor of a data rate in 1/10 dB
+ *
+ * Data rates beyond DR6 (e.g. FSK) are treated as DR6.
+ */
+INT16 WiMOD_LoRaWAN_LinkAdaptation::GetRequiredSNR10(UINT8 dataRateIndex)
+{
+    if (dataRateIndex > LORAWAN_LINKADAPT_MAX_DR) {
+        dataRateIndex = LORAWAN_LINKADAPT_MAX_DR;
+    }
+    return RequiredSNR10[dataRateIndex];
+}
+
+//------------------------------------------------------------------------------
+// EOF
+//------------------------------------------------------------------------------
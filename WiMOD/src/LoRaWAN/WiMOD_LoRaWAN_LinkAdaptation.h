@@ -0,0 +1,130 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LoRaWAN_LinkAdaptation.h
+//! @ingroup WiMODLoRaWAN
+//! <!------------------------------------------------------------------------->
+//! @brief Declarations for the host side link adaptation
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//! Keeps a sliding window of link metrics (downlink RSSI/SNR, number of
+//! radio packets and delivery of confirmed uplinks) and derives the data
+//! rate and TX power level to use.
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+
+#ifndef ARDUINO_WIMOD_LORAWAN_LINKADAPTATION_H_
+#define ARDUINO_WIMOD_LORAWAN_LINKADAPTATION_H_
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "../utils/WMDefs.h"
+
+//------------------------------------------------------------------------------
+//
+// Section defines
+//
+//------------------------------------------------------------------------------
+
+/** number of entries of the sliding windows (downlinks / uplinks) */
+#define LORAWAN_LINKADAPT_WINDOW_SIZE               16
+
+/** highest data rate index known by the engine (DR6 = SF7 / 250 kHz) */
+#define LORAWAN_LINKADAPT_MAX_DR                    6
+
+//------------------------------------------------------------------------------
+//
+// Section types
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Configuration of the link adaptation
+ */
+typedef struct TWiMODLORAWAN_LinkAdaptConfig
+{
+    UINT8       MinDataRateIndex;                                               /*!< slowest data rate that may be used */
+    UINT8       MaxDataRateIndex;                                               /*!< fastest data rate that may be used */
+    UINT8       MinTxPower;                                                     /*!< lowest TX power level in dBm */
+    UINT8       MaxTxPower;                                                     /*!< highest TX power level in dBm */
+    UINT8       TxPowerStep;                                                    /*!< TX power step in dB */
+    UINT16      TargetDeliveryPermille;                                         /*!< min. ratio of delivered uplinks per radio packet in 1/1000 */
+    UINT8       InstallMarginDb;                                                /*!< SNR margin kept above the demodulation floor in dB */
+    UINT8       HysteresisDb;                                                   /*!< extra margin required before a faster / weaker setting is used */
+    UINT8       MinSamples;                                                     /*!< min. number of samples after a change before the next decision */
+} TWiMODLORAWAN_LinkAdaptConfig;
+
+/**
+ * @brief Link metrics over the current window
+ */
+typedef struct TWiMODLORAWAN_LinkMetrics
+{
+    UINT8       NumDownlinks;                                                   /*!< number of downlinks with RSSI/SNR info */
+    INT16       AvgRSSI;                                                        /*!< mean RSSI in dBm */
+    INT16       AvgSNR10;                                                       /*!< mean SNR in 1/10 dB */
+    INT16       MinSNR10;                                                       /*!< min. SNR in 1/10 dB */
+    UINT8       NumUplinks;                                                     /*!< number of finished confirmed uplinks */
+    UINT16      TxPackets;                                                      /*!< radio packets used for these uplinks */
+    UINT16      Delivered;                                                      /*!< number of acknowledged uplinks */
+    UINT16      DeliveryPermille;                                               /*!< Delivered / TxPackets in 1/1000; 1000 if no uplinks */
+} TWiMODLORAWAN_LinkMetrics;
+
+//------------------------------------------------------------------------------
+//
+// Section class
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Link adaptation engine
+ *
+ * The engine only makes decisions; applying them to the module is done by
+ * WiMODLoRaWAN::ApplyLinkAdaptation(). Downlink SNR is used as estimate of
+ * the uplink SNR, corrected by the TX power reduction of the device.
+ * After every change the windows are cleared, so the next decision is based
+ * on samples of the new setting only.
+ */
+class WiMOD_LoRaWAN_LinkAdaptation
+{
+public:
+    WiMOD_LoRaWAN_LinkAdaptation(void);
+
+    void                SetConfig(const TWiMODLORAWAN_LinkAdaptConfig& config);
+    const TWiMODLORAWAN_LinkAdaptConfig& GetConfig(void) const { return config; }
+
+    void                Reset(void);
+    void                OnDownlink(INT8 rssi, INT8 snr);
+    void                OnUplink(UINT8 numTxPackets, bool delivered);
+
+    bool                Evaluate(UINT8 dataRateIndex, UINT8 txPower,
+                                 UINT8* newDataRateIndex, UINT8* newTxPower);
+    void                GetMetrics(TWiMODLORAWAN_LinkMetrics* metrics) const;
+
+    static INT16        GetRequiredSNR10(UINT8 dataRateIndex);
+
+private:
+    //! @cond Doxygen_Suppress
+    TWiMODLORAWAN_LinkAdaptConfig config;
+
+    INT8                dlRSSI[LORAWAN_LINKADAPT_WINDOW_SIZE];
+    INT8                dlSNR[LORAWAN_LINKADAPT_WINDOW_SIZE];
+    UINT8               dlCount;
+    UINT8               dlIndex;
+
+    UINT8               ulTxPackets[LORAWAN_LINKADAPT_WINDOW_SIZE];
+    bool                ulDelivered[LORAWAN_LINKADAPT_WINDOW_SIZE];
+    UINT8               ulCount;
+    UINT8               ulIndex;
+    //! @endcond
+};
+
+#endif /* ARDUINO_WIMOD_LORAWAN_LINKADAPTATION_H_ */
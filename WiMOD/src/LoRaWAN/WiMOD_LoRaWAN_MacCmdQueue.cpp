@@ -0,0 +1,131 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LoRaWAN_MacCmdQueue.cpp
+//! @ingroup WiMODLoRaWAN
+//! <!------------------------------------------------------------------------->
+//! @brief Implementation of the MAC command queue
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//!
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "WiMOD_LoRaWAN_MacCmdQueue.h"
+
+#include <string.h>
+
+//------------------------------------------------------------------------------
+//
+// Section public functions
+//
+//------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Constructor; the queue is empty
+ */
+WiMOD_LoRaWAN_MacCmdQueue::WiMOD_LoRaWAN_MacCmdQueue(void)
+{
+    count = 0;
+    memset(queue, 0x00, sizeof(queue));
+    memset(&stats, 0x00, sizeof(stats));
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Add a command; replaces a pending command with the same ID
+ *
+ * @param cmd   MAC command to send with the next uplink
+ *
+ * @retval true     if the command is pending now
+ * @retval false    if the payload is too long or the queue is full
+ */
+bool WiMOD_LoRaWAN_MacCmdQueue::Add(const TWiMODLORAWAN_MacCmd& cmd)
+{
+    UINT8 i;
+
+    if (cmd.Length > WiMODLORAWAN_MAC_CMD_PAYLOAD_LENGTH) {
+        return false;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (queue[i].MacCmdID == cmd.MacCmdID) {
+            queue[i] = cmd;
+            stats.Merged++;
+            return true;
+        }
+    }
+
+    if (count >= LORAWAN_MAC_CMD_QUEUE_SIZE) {
+        stats.Dropped++;
+        return false;
+    }
+    queue[count++] = cmd;
+    stats.Queued++;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Remove all pending commands
+ */
+void WiMOD_LoRaWAN_MacCmdQueue::Clear(void)
+{
+    count = 0;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Oldest pending command
+ *
+ * @return pointer to the command; NULL if the queue is empty
+ */
+const TWiMODLORAWAN_MacCmd* WiMOD_LoRaWAN_MacCmdQueue::Front(void) const
+{
+    return (count > 0) ? &queue[0] : NULL;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Remove the oldest command after it has been accepted by the module
+ */
+void WiMOD_LoRaWAN_MacCmdQueue::PopFront(void)
+{
+    if (count == 0) {
+        return;
+    }
+    count--;
+    memmove(&queue[0], &queue[1], count * sizeof(TWiMODLORAWAN_MacCmd));
+    stats.Sent++;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Count an uplink that carried queued commands
+ */
+void WiMOD_LoRaWAN_MacCmdQueue::OnFlush(void)
+{
+    stats.Flushes++;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Size of a command in the frame header (CID + payload)
+ */
+UINT8 WiMOD_LoRaWAN_MacCmdQueue::GetSize(const TWiMODLORAWAN_MacCmd& cmd)
+{
+    return 1 + cmd.Length;
+}
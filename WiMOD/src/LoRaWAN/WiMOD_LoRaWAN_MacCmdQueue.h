@@ -0,0 +1,97 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LoRaWAN_MacCmdQueue.h
+//! @ingroup WiMODLoRaWAN
+//! <!------------------------------------------------------------------------->
+//! @brief Declarations for the MAC command queue
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//! Collects MAC commands (LinkCheckReq, DeviceTimeReq, ...) and hands them
+//! to the module right before the next application uplink.
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+
+#ifndef ARDUINO_WIMOD_LORAWAN_MACCMDQUEUE_H_
+#define ARDUINO_WIMOD_LORAWAN_MACCMDQUEUE_H_
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "../SAP/WiMOD_SAP_LORAWAN_IDs.h"
+
+//------------------------------------------------------------------------------
+//
+// Section defines
+//
+//------------------------------------------------------------------------------
+
+/** max. number of queued MAC commands */
+#define LORAWAN_MAC_CMD_QUEUE_SIZE                  4
+
+//------------------------------------------------------------------------------
+//
+// Section types
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Statistics of the MAC command queue
+ */
+typedef struct TWiMODLORAWAN_MacCmdQueueStats
+{
+    UINT32      Queued;                                                         /*!< commands added to the queue */
+    UINT32      Merged;                                                         /*!< commands replacing a pending one with the same ID */
+    UINT32      Dropped;                                                        /*!< commands rejected (queue full) */
+    UINT32      Sent;                                                           /*!< commands handed to the module */
+    UINT32      Flushes;                                                        /*!< uplinks that carried queued commands */
+} TWiMODLORAWAN_MacCmdQueueStats;
+
+//------------------------------------------------------------------------------
+//
+// Section class
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief FIFO of pending MAC commands
+ *
+ * The queue only stores commands; the module access is done by the
+ * WiMODLoRaWAN class. A command with the same ID as a pending one replaces
+ * the pending one, e.g. two LinkCheckReq result in a single request.
+ */
+class WiMOD_LoRaWAN_MacCmdQueue
+{
+public:
+    WiMOD_LoRaWAN_MacCmdQueue(void);
+
+    bool                Add(const TWiMODLORAWAN_MacCmd& cmd);
+    void                Clear(void);
+
+    UINT8               GetCount(void) const { return count; }
+    const TWiMODLORAWAN_MacCmd* Front(void) const;
+    void                PopFront(void);
+    void                OnFlush(void);
+
+    static UINT8        GetSize(const TWiMODLORAWAN_MacCmd& cmd);
+
+    const TWiMODLORAWAN_MacCmdQueueStats& GetStats(void) const { return stats; }
+
+private:
+    //! @cond Doxygen_Suppress
+    TWiMODLORAWAN_MacCmd            queue[LORAWAN_MAC_CMD_QUEUE_SIZE];
+    UINT8                           count;
+
+    TWiMODLORAWAN_MacCmdQueueStats  stats;
+    //! @endcond
+};
+
+#endif /* ARDUINO_WIMOD_LORAWAN_MACCMDQUEUE_H_ */
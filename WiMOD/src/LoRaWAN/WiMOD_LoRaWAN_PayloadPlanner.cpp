@@ -0,0 +1,370 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LoRaWAN_PayloadPlanner.cpp
+//! @ingroup WiMODLoRaWAN
+//! <!------------------------------------------------------------------------->
+//! @brief Implementation of the uplink payload planner
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//!
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "WiMOD_LoRaWAN_PayloadPlanner.h"
+
+#include <string.h>
+
+//------------------------------------------------------------------------------
+//
+// Section public functions
+//
+//------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Constructor; no records pending
+ */
+WiMOD_LoRaWAN_PayloadPlanner::WiMOD_LoRaWAN_PayloadPlanner(void)
+{
+    config.Port              = LORAWAN_PLANNER_DEFAULT_PORT;
+    config.Confirmed         = false;
+    config.RecordHeaderLen   = 0;
+    config.DefaultPayloadLen = LORAWAN_PLANNER_DEFAULT_PAYLOAD_LEN;
+
+    count     = 0;
+    limit     = 0;
+    numFrames = 0;
+    memset(records, 0x00, sizeof(records));
+    memset(&stats, 0x00, sizeof(stats));
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Set port, uplink type and header size of the planned uplinks
+ *
+ * @param config    new settings
+ */
+void WiMOD_LoRaWAN_PayloadPlanner::SetConfig(const TWiMODLORAWAN_PlannerConfig& config)
+{
+    this->config = config;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Add a record; the data is copied
+ *
+ * The record stays unplanned until the next call of Plan().
+ *
+ * @param data      record as it shall appear in the payload
+ * @param length    length of the record
+ * @param priority  records with a higher priority are sent first
+ *
+ * @retval true     if the record is pending now
+ * @retval false    if the record is too long or there is no space left
+ */
+bool WiMOD_LoRaWAN_PayloadPlanner::Add(const UINT8* data, UINT8 length, UINT8 priority)
+{
+    UINT16 offset = used();
+
+    if ((data == NULL) || (length == 0) || (length > WiMODLORAWAN_APP_PAYLOAD_LEN)
+        || (count >= LORAWAN_PLANNER_MAX_RECORDS) || ((offset + length) > LORAWAN_PLANNER_POOL_SIZE)) {
+        stats.Rejected++;
+        return false;
+    }
+
+    memcpy(&pool[offset], data, length);
+    records[count].Offset   = (UINT8) offset;
+    records[count].Length   = length;
+    records[count].Priority = priority;
+    records[count].Frame    = LORAWAN_PLANNER_NO_FRAME;
+    count++;
+    stats.Added++;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Remove all pending records
+ */
+void WiMOD_LoRaWAN_PayloadPlanner::Clear(void)
+{
+    count     = 0;
+    numFrames = 0;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Distribute the pending records to frames
+ *
+ * First-fit-decreasing: the records are taken from the largest to the
+ * smallest and put into the first frame with enough space left. The
+ * frames are then ordered by the highest priority of their records.
+ *
+ * @param maxPayload    max. application payload of the current data rate
+ *
+ * @return number of frames needed for the planned records
+ */
+UINT8 WiMOD_LoRaWAN_PayloadPlanner::Plan(UINT8 maxPayload)
+{
+    UINT8 order[LORAWAN_PLANNER_MAX_RECORDS];
+    UINT8 fill[LORAWAN_PLANNER_MAX_RECORDS];
+    UINT8 prio[LORAWAN_PLANNER_MAX_RECORDS];
+    UINT8 rank[LORAWAN_PLANNER_MAX_RECORDS];
+    UINT8 bins = 0;
+    UINT8 i;
+    UINT8 j;
+    UINT8 b;
+
+    limit = (maxPayload < WiMODLORAWAN_APP_PAYLOAD_LEN) ? maxPayload : WiMODLORAWAN_APP_PAYLOAD_LEN;
+
+    // sort by length (descending), then priority (descending); stable
+    for (i = 0; i < count; i++) {
+        const TRecord& r = records[i];
+
+        for (j = i; j > 0; j--) {
+            const TRecord& o = records[order[j - 1]];
+
+            if ((o.Length > r.Length) || ((o.Length == r.Length) && (o.Priority >= r.Priority))) {
+                break;
+            }
+            order[j] = order[j - 1];
+        }
+        order[j] = i;
+    }
+
+    // first fit
+    for (i = 0; i < count; i++) {
+        TRecord& r = records[order[i]];
+
+        r.Frame = LORAWAN_PLANNER_NO_FRAME;
+        if (r.Length > limit) {
+            continue;
+        }
+        for (b = 0; b < bins; b++) {
+            if ((fill[b] + r.Length) <= limit) {
+                break;
+            }
+        }
+        if (b == bins) {
+            fill[b] = 0;
+            prio[b] = 0;
+            bins++;
+        }
+        fill[b] += r.Length;
+        if (r.Priority > prio[b]) {
+            prio[b] = r.Priority;
+        }
+        r.Frame = b;
+    }
+
+    // send order: highest priority first, then as planned
+    for (b = 0; b < bins; b++) {
+        rank[b] = 0;
+        for (j = 0; j < bins; j++) {
+            if ((prio[j] > prio[b]) || ((prio[j] == prio[b]) && (j < b))) {
+                rank[b]++;
+            }
+        }
+    }
+    for (i = 0; i < count; i++) {
+        if (records[i].Frame != LORAWAN_PLANNER_NO_FRAME) {
+            records[i].Frame = rank[records[i].Frame];
+        }
+    }
+
+    numFrames = bins;
+    return numFrames;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Number of pending records without frame
+ *
+ * These are records added after the last Plan() and records that are
+ * larger than the max. payload.
+ */
+UINT8 WiMOD_LoRaWAN_PayloadPlanner::GetNumUnplanned(void) const
+{
+    UINT8 n = 0;
+    UINT8 i;
+
+    for (i = 0; i < count; i++) {
+        if (records[i].Frame == LORAWAN_PLANNER_NO_FRAME) {
+            n++;
+        }
+    }
+    return n;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Remove the records that are larger than the max. payload
+ *
+ * Uses the max. payload of the last Plan(); the planned frames are not
+ * changed.
+ *
+ * @retval number of removed records
+ */
+UINT8 WiMOD_LoRaWAN_PayloadPlanner::DropOversized(void)
+{
+    UINT8 n = 0;
+    UINT8 i;
+
+    if (limit == 0) {
+        return 0;
+    }
+    for (i = count; i-- > 0; ) {
+        if (records[i].Length > limit) {
+            remove(i);
+            n++;
+        }
+    }
+    stats.Dropped += n;
+    return n;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Content and fill ratio of a planned frame
+ *
+ * @param index     0 = next frame to send
+ * @param info      filled with the frame infos
+ *
+ * @retval true     if the frame exists
+ */
+bool WiMOD_LoRaWAN_PayloadPlanner::GetFrameInfo(UINT8 index, TWiMODLORAWAN_PlannedFrame* info) const
+{
+    UINT8 i;
+
+    if ((info == NULL) || (index >= numFrames) || (limit == 0)) {
+        return false;
+    }
+
+    memset(info, 0x00, sizeof(TWiMODLORAWAN_PlannedFrame));
+    info->Limit = limit;
+    for (i = 0; i < count; i++) {
+        if (records[i].Frame == index) {
+            info->Records++;
+            info->Length += records[i].Length;
+            if (records[i].Priority > info->Priority) {
+                info->Priority = records[i].Priority;
+            }
+        }
+    }
+
+    info->FillPermille   = (UINT16) ((UINT32) info->Length * 1000 / limit);
+    info->HeaderPermille = (UINT16) ((UINT32) (LORAWAN_PLANNER_MAC_OVERHEAD + info->Records * config.RecordHeaderLen) * 1000
+                                     / (LORAWAN_PLANNER_MAC_OVERHEAD + info->Length));
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Copy the records of the next planned frame into a payload buffer
+ *
+ * Records with a higher priority come first.
+ *
+ * @param payload   destination
+ * @param size      size of the destination
+ *
+ * @return length of the payload; 0 if nothing is planned or size is too small
+ */
+UINT8 WiMOD_LoRaWAN_PayloadPlanner::BuildFrame(UINT8* payload, UINT8 size) const
+{
+    UINT16 prio;
+    UINT8  length = 0;
+    UINT8  i;
+
+    if ((payload == NULL) || (numFrames == 0)) {
+        return 0;
+    }
+
+    for (prio = 0x100; prio-- > 0; ) {
+        for (i = 0; i < count; i++) {
+            const TRecord& r = records[i];
+
+            if ((r.Frame != 0) || (r.Priority != prio)) {
+                continue;
+            }
+            if ((length + r.Length) > size) {
+                return 0;
+            }
+            memcpy(&payload[length], &pool[r.Offset], r.Length);
+            length += r.Length;
+        }
+    }
+    return length;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Remove the records of the next frame after the module accepted it
+ */
+void WiMOD_LoRaWAN_PayloadPlanner::OnFrameSent(void)
+{
+    TWiMODLORAWAN_PlannedFrame info;
+    UINT8                      i;
+
+    if (!GetFrameInfo(0, &info)) {
+        return;
+    }
+
+    stats.Frames++;
+    stats.Records       += info.Records;
+    stats.PayloadBytes  += info.Length;
+    stats.CapacityBytes += info.Limit;
+    stats.HeaderBytes   += LORAWAN_PLANNER_MAC_OVERHEAD + info.Records * config.RecordHeaderLen;
+
+    for (i = count; i-- > 0; ) {
+        if (records[i].Frame == 0) {
+            remove(i);
+        } else if (records[i].Frame != LORAWAN_PLANNER_NO_FRAME) {
+            records[i].Frame--;
+        }
+    }
+    numFrames--;
+}
+
+//------------------------------------------------------------------------------
+//
+// Section private functions
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+void WiMOD_LoRaWAN_PayloadPlanner::remove(UINT8 index)
+{
+    UINT8  offset = records[index].Offset;
+    UINT8  length = records[index].Length;
+    UINT16 end    = used();
+    UINT8  i;
+
+    memmove(&pool[offset], &pool[offset + length], end - offset - length);
+    for (i = 0; i < count; i++) {
+        if (records[i].Offset > offset) {
+            records[i].Offset -= length;
+        }
+    }
+
+    count--;
+    memmove(&records[index], &records[index + 1], (count - index) * sizeof(TRecord));
+}
+
+UINT16 WiMOD_LoRaWAN_PayloadPlanner::used(void) const
+{
+    return (count > 0) ? (UINT16) (records[count - 1].Offset + records[count - 1].Length) : 0;
+}
+//! @endcond
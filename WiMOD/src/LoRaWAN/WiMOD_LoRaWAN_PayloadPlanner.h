@@ -0,0 +1,167 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LoRaWAN_PayloadPlanner.h
+//! @ingroup WiMODLoRaWAN
+//! <!------------------------------------------------------------------------->
+//! @brief Declarations for the uplink payload planner
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//! Packs pending application records (e.g. Cayenne LPP records) into the
+//! minimum number of uplinks for the max. payload of the current data rate.
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+
+#ifndef ARDUINO_WIMOD_LORAWAN_PAYLOADPLANNER_H_
+#define ARDUINO_WIMOD_LORAWAN_PAYLOADPLANNER_H_
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "../SAP/WiMOD_SAP_LORAWAN_IDs.h"
+
+//------------------------------------------------------------------------------
+//
+// Section defines
+//
+//------------------------------------------------------------------------------
+
+/** max. number of pending records */
+#define LORAWAN_PLANNER_MAX_RECORDS                 16
+
+/** bytes for the data of all pending records */
+#define LORAWAN_PLANNER_POOL_SIZE                   256
+
+/** record without frame (larger than the max. payload) */
+#define LORAWAN_PLANNER_NO_FRAME                    0xFF
+
+/** LoRaWAN overhead of an uplink without FOpts: MHDR, FHDR, FPort, MIC */
+#define LORAWAN_PLANNER_MAC_OVERHEAD                13
+
+//! @cond Doxygen_Suppress
+#define LORAWAN_PLANNER_DEFAULT_PORT                1
+#define LORAWAN_PLANNER_DEFAULT_PAYLOAD_LEN         51
+//! @endcond
+
+//------------------------------------------------------------------------------
+//
+// Section types
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Settings of the payload planner
+ */
+typedef struct TWiMODLORAWAN_PlannerConfig
+{
+    UINT8       Port;                                                           /*!< LoRaWAN port of the planned uplinks */
+    bool        Confirmed;                                                      /*!< true: C-Data; false: U-Data */
+    UINT8       RecordHeaderLen;                                                /*!< header bytes per record (Cayenne LPP: 2) */
+    UINT8       DefaultPayloadLen;                                              /*!< max. payload if the module does not report it */
+} TWiMODLORAWAN_PlannerConfig;
+
+/**
+ * @brief One planned uplink
+ */
+typedef struct TWiMODLORAWAN_PlannedFrame
+{
+    UINT8       Records;                                                        /*!< number of records in the frame */
+    UINT8       Length;                                                         /*!< application payload in bytes */
+    UINT8       Limit;                                                          /*!< max. payload used for the plan */
+    UINT8       Priority;                                                       /*!< highest priority of the records */
+    UINT16      FillPermille;                                                   /*!< Length / Limit */
+    UINT16      HeaderPermille;                                                 /*!< MAC and record headers / PHY payload */
+} TWiMODLORAWAN_PlannedFrame;
+
+/**
+ * @brief Statistics of the payload planner
+ */
+typedef struct TWiMODLORAWAN_PlannerStats
+{
+    UINT32      Added;                                                          /*!< records added */
+    UINT32      Rejected;                                                       /*!< records rejected (too long or no space) */
+    UINT32      Dropped;                                                        /*!< records dropped (larger than the max. payload) */
+    UINT32      Frames;                                                         /*!< planned frames sent */
+    UINT32      Records;                                                        /*!< records sent */
+    UINT32      PayloadBytes;                                                   /*!< application payload sent */
+    UINT32      CapacityBytes;                                                  /*!< sum of the limits of the sent frames */
+    UINT32      HeaderBytes;                                                    /*!< MAC and record headers sent */
+} TWiMODLORAWAN_PlannerStats;
+
+//------------------------------------------------------------------------------
+//
+// Section class
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Packs records into the minimum number of uplinks
+ *
+ * Records are never split. Plan() distributes the pending records with
+ * first-fit-decreasing (largest record first, into the first frame with
+ * enough space) and orders the frames by the highest priority they
+ * contain, so urgent records go out with the first uplink. Records that
+ * do not fit into an empty frame are not planned; DropOversized() removes
+ * them.
+ *
+ * The planner only stores the records; the module access is done by the
+ * WiMODLoRaWAN class.
+ */
+class WiMOD_LoRaWAN_PayloadPlanner
+{
+public:
+    WiMOD_LoRaWAN_PayloadPlanner(void);
+
+    void                SetConfig(const TWiMODLORAWAN_PlannerConfig& config);
+    const TWiMODLORAWAN_PlannerConfig& GetConfig(void) const { return config; }
+
+    bool                Add(const UINT8* data, UINT8 length, UINT8 priority);
+    void                Clear(void);
+    UINT8               GetCount(void) const { return count; }
+
+    UINT8               Plan(UINT8 maxPayload);
+    UINT8               GetNumFrames(void) const { return numFrames; }
+    UINT8               GetNumUnplanned(void) const;
+    UINT8               DropOversized(void);
+    bool                GetFrameInfo(UINT8 index, TWiMODLORAWAN_PlannedFrame* info) const;
+
+    UINT8               BuildFrame(UINT8* payload, UINT8 size) const;
+    void                OnFrameSent(void);
+
+    const TWiMODLORAWAN_PlannerStats& GetStats(void) const { return stats; }
+
+private:
+    //! @cond Doxygen_Suppress
+    typedef struct TRecord
+    {
+        UINT8   Offset;                                                         // position in pool
+        UINT8   Length;
+        UINT8   Priority;
+        UINT8   Frame;                                                          // rank of the frame; LORAWAN_PLANNER_NO_FRAME
+    } TRecord;
+
+    void                remove(UINT8 index);
+    UINT16              used(void) const;
+
+    TWiMODLORAWAN_PlannerConfig config;
+
+    TRecord             records[LORAWAN_PLANNER_MAX_RECORDS];
+    UINT8               count;
+    UINT8               pool[LORAWAN_PLANNER_POOL_SIZE];
+
+    UINT8               limit;
+    UINT8               numFrames;
+
+    TWiMODLORAWAN_PlannerStats stats;
+    //! @endcond
+};
+
+#endif /* ARDUINO_WIMOD_LORAWAN_PAYLOADPLANNER_H_ */
@@ -0,0 +1,257 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LoRaWAN_PowerPolicy.cpp
+//! @ingroup WiMODLoRaWAN
+//! <!------------------------------------------------------------------------->
+//! @brief Implementation of the device class / power saving policy
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//!
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "WiMOD_LoRaWAN_PowerPolicy.h"
+
+#include <string.h>
+
+//------------------------------------------------------------------------------
+//
+// Section local functions
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+// energy in mJ of a current (uA) @ supply (mV) over a time given in ms
+static UINT32 energyMJ(UINT32 currentUA, UINT16 supplyMv, UINT64 timeMs)
+{
+    return (UINT32) (((UINT64) currentUA * supplyMv * timeMs) / 1000000000ULL);
+}
+//! @endcond
+
+//------------------------------------------------------------------------------
+//
+// Section public functions
+//
+//------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Constructor; policy disabled, default window and currents
+ */
+WiMOD_LoRaWAN_PowerPolicy::WiMOD_LoRaWAN_PowerPolicy(void)
+{
+    config.ClassCWindowMs = LORAWAN_POWER_DEFAULT_CLASS_C_WINDOW_MS;
+    config.SupplyMv       = LORAWAN_POWER_DEFAULT_SUPPLY_MV;
+    config.SleepCurrentUA = LORAWAN_POWER_DEFAULT_SLEEP_UA;
+    config.RxCurrentUA    = LORAWAN_POWER_DEFAULT_RX_UA;
+    config.TxCurrentUA    = LORAWAN_POWER_DEFAULT_TX_UA;
+
+    enabled    = false;
+    modeKnown  = false;
+    mode       = LORAWAN_POWER_MODE_CLASS_A;
+    windowOpen = false;
+    windowEnd  = 0;
+    lastUpdate = 0;
+    txTimeMs   = 0;
+    switches   = 0;
+    failures   = 0;
+    retryWait  = false;
+    retryTime  = 0;
+    retryDelay = LORAWAN_POWER_RETRY_MIN_MS;
+    memset(restMs, 0x00, sizeof(restMs));
+    memset(timeS, 0x00, sizeof(timeS));
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Set the window length and the currents used for the estimate
+ */
+void WiMOD_LoRaWAN_PowerPolicy::SetConfig(const TWiMODLORAWAN_PowerPolicyConfig& cfg)
+{
+    config = cfg;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief A downlink has been received; keep the receiver on for a while
+ *
+ * @param now       current time stamp (ms)
+ */
+void WiMOD_LoRaWAN_PowerPolicy::OnDownlink(UINT32 now)
+{
+    if (config.ClassCWindowMs) {
+        openWindow(config.ClassCWindowMs, now);
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Account the airtime of a transmission
+ *
+ * @param airtimeMs airtime reported by the TX indication
+ */
+void WiMOD_LoRaWAN_PowerPolicy::OnTx(UINT32 airtimeMs)
+{
+    txTimeMs += airtimeMs;
+
+    // the module is responsive again; retry a failed mode change now
+    retryWait = false;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Request Class C for a given time (e.g. a maintenance session)
+ *
+ * An already open window is only extended, never shortened.
+ *
+ * @param durationMs    length of the window
+ * @param now           current time stamp (ms)
+ */
+void WiMOD_LoRaWAN_PowerPolicy::RequestClassC(UINT32 durationMs, UINT32 now)
+{
+    openWindow(durationMs, now);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Close an open Class C window
+ */
+void WiMOD_LoRaWAN_PowerPolicy::ReleaseClassC(void)
+{
+    windowOpen = false;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Check if the module has to be switched to another mode
+ *
+ * @param now       current time stamp (ms)
+ * @param newMode   receives the mode to apply
+ *
+ * @retval true     if the mode differs from the applied one
+ */
+bool WiMOD_LoRaWAN_PowerPolicy::Evaluate(UINT32 now, TWiMODLORAWAN_PowerMode* newMode)
+{
+    if (windowOpen && ((INT32) (now - windowEnd) >= 0)) {
+        windowOpen = false;
+    }
+
+    *newMode = windowOpen ? LORAWAN_POWER_MODE_CLASS_C : LORAWAN_POWER_MODE_CLASS_A;
+
+    // last attempt failed: wait for the next uplink or the retry time
+    if (retryWait && ((INT32) (now - retryTime) < 0)) {
+        return false;
+    }
+    return !modeKnown || (*newMode != mode);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief The module has been configured for a mode
+ *
+ * @param newMode   mode written to the module
+ * @param now       current time stamp (ms)
+ */
+void WiMOD_LoRaWAN_PowerPolicy::OnModeApplied(TWiMODLORAWAN_PowerMode newMode, UINT32 now)
+{
+    update(now);
+    if (modeKnown && (newMode != mode)) {
+        switches++;
+    }
+    mode       = newMode;
+    modeKnown  = true;
+    retryWait  = false;
+    retryDelay = LORAWAN_POWER_RETRY_MIN_MS;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief The module could not be configured for the new mode
+ *
+ * Evaluate() does not ask for the mode change again before the next
+ * uplink or the retry time; the retry time doubles with every failure in
+ * a row, up to LORAWAN_POWER_RETRY_MAX_MS.
+ *
+ * @param now       current time stamp (ms)
+ */
+void WiMOD_LoRaWAN_PowerPolicy::OnModeFailed(UINT32 now)
+{
+    failures++;
+    retryWait = true;
+    retryTime = now + retryDelay;
+    if (retryDelay < LORAWAN_POWER_RETRY_MAX_MS / 2) {
+        retryDelay *= 2;
+    } else {
+        retryDelay = LORAWAN_POWER_RETRY_MAX_MS;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the time and the estimated energy per mode
+ *
+ * @param now       current time stamp (ms)
+ * @param report    pointer where to store the report
+ */
+void WiMOD_LoRaWAN_PowerPolicy::GetReport(UINT32 now, TWiMODLORAWAN_PowerReport* report)
+{
+    update(now);
+
+    report->Mode            = mode;
+    report->ClassCRequested = windowOpen;
+    report->Switches        = switches;
+    report->FailedSwitches  = failures;
+    for (UINT8 i = 0; i < LORAWAN_POWER_NUM_MODES; i++) {
+        report->TimeS[i] = timeS[i];
+    }
+    report->EnergyMJ[LORAWAN_POWER_MODE_CLASS_A] = energyMJ(config.SleepCurrentUA, config.SupplyMv,
+                                                            (UINT64) timeS[LORAWAN_POWER_MODE_CLASS_A] * 1000);
+    report->EnergyMJ[LORAWAN_POWER_MODE_CLASS_C] = energyMJ(config.RxCurrentUA, config.SupplyMv,
+                                                            (UINT64) timeS[LORAWAN_POWER_MODE_CLASS_C] * 1000);
+    report->TxTimeMs   = txTimeMs;
+    report->TxEnergyMJ = energyMJ(config.TxCurrentUA, config.SupplyMv, txTimeMs);
+}
+
+//------------------------------------------------------------------------------
+//
+// Section private functions
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+void WiMOD_LoRaWAN_PowerPolicy::update(UINT32 now)
+{
+    UINT32 elapsed = now - lastUpdate;
+
+    lastUpdate = now;
+    if (!modeKnown) {
+        return;
+    }
+    elapsed       += restMs[mode];
+    timeS[mode]   += elapsed / 1000;
+    restMs[mode]   = (UINT16) (elapsed % 1000);
+}
+
+void WiMOD_LoRaWAN_PowerPolicy::openWindow(UINT32 durationMs, UINT32 now)
+{
+    UINT32 end = now + durationMs;
+
+    if (!windowOpen || ((INT32) (end - windowEnd) > 0)) {
+        windowEnd = end;
+    }
+    windowOpen = true;
+}
+//! @endcond
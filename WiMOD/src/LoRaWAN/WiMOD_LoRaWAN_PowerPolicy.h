@@ -0,0 +1,160 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LoRaWAN_PowerPolicy.h
+//! @ingroup WiMODLoRaWAN
+//! <!------------------------------------------------------------------------->
+//! @brief Declarations for the device class / power saving policy
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//! Switches between Class A with power saving and Class C and keeps track
+//! of the time spent in each mode.
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+
+#ifndef ARDUINO_WIMOD_LORAWAN_POWERPOLICY_H_
+#define ARDUINO_WIMOD_LORAWAN_POWERPOLICY_H_
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "../SAP/WiMOD_SAP_LORAWAN_IDs.h"
+
+//------------------------------------------------------------------------------
+//
+// Section defines
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+#define LORAWAN_POWER_NUM_MODES                     2
+
+// defaults: 1 min Class C after a downlink; rough iM880B figures @ 3.3 V
+#define LORAWAN_POWER_DEFAULT_CLASS_C_WINDOW_MS     60000
+#define LORAWAN_POWER_DEFAULT_SUPPLY_MV             3300
+#define LORAWAN_POWER_DEFAULT_SLEEP_UA              2
+#define LORAWAN_POWER_DEFAULT_RX_UA                 11000
+#define LORAWAN_POWER_DEFAULT_TX_UA                 40000
+
+// retry of a failed mode change; doubled per failure in a row
+#define LORAWAN_POWER_RETRY_MIN_MS                  5000
+#define LORAWAN_POWER_RETRY_MAX_MS                  300000
+//! @endcond
+
+//------------------------------------------------------------------------------
+//
+// Section types
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Operating modes of the power policy
+ */
+typedef enum TWiMODLORAWAN_PowerMode
+{
+    LORAWAN_POWER_MODE_CLASS_A = 0,                                             /*!< Class A, automatic power saving */
+    LORAWAN_POWER_MODE_CLASS_C,                                                 /*!< Class C, power saving off */
+} TWiMODLORAWAN_PowerMode;
+
+/**
+ * @brief Configuration of the power policy
+ */
+typedef struct TWiMODLORAWAN_PowerPolicyConfig
+{
+    UINT32      ClassCWindowMs;                                                 /*!< Class C time after a downlink; 0 = stay in Class A */
+    UINT16      SupplyMv;                                                       /*!< module supply voltage */
+    UINT32      SleepCurrentUA;                                                 /*!< module current in Class A between uplinks */
+    UINT32      RxCurrentUA;                                                    /*!< module current in Class C (receiver on) */
+    UINT32      TxCurrentUA;                                                    /*!< module current while transmitting */
+} TWiMODLORAWAN_PowerPolicyConfig;
+
+/**
+ * @brief Time and estimated energy per mode
+ */
+typedef struct TWiMODLORAWAN_PowerReport
+{
+    TWiMODLORAWAN_PowerMode Mode;                                               /*!< mode currently applied */
+    bool                    ClassCRequested;                                    /*!< a downlink / maintenance window is open */
+    UINT32                  Switches;                                           /*!< number of mode changes */
+    UINT32                  FailedSwitches;                                     /*!< number of failed attempts to change the mode */
+    UINT32                  TimeS[LORAWAN_POWER_NUM_MODES];                     /*!< time per mode in s */
+    UINT32                  EnergyMJ[LORAWAN_POWER_NUM_MODES];                  /*!< estimated energy per mode in mJ (without TX) */
+    UINT32                  TxTimeMs;                                           /*!< airtime of all uplinks */
+    UINT32                  TxEnergyMJ;                                         /*!< estimated TX energy in mJ */
+} TWiMODLORAWAN_PowerReport;
+
+//------------------------------------------------------------------------------
+//
+// Section class
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Device class / power saving policy
+ *
+ * The node stays in Class A with automatic power saving; the module sleeps
+ * between uplinks and the host only needs to service the UART around its
+ * own requests. A downlink or a maintenance request opens a window in
+ * Class C with power saving off, so that further downlinks (e.g. a remote
+ * configuration session) are received without waiting for the next uplink.
+ * The node returns to Class A when the window has expired.
+ *
+ * The class only decides and keeps the statistics; the module is
+ * reconfigured by the WiMODLoRaWAN class. The energy figures are estimates
+ * from the configured currents; the receive windows of Class A are not
+ * accounted.
+ */
+class WiMOD_LoRaWAN_PowerPolicy
+{
+public:
+    WiMOD_LoRaWAN_PowerPolicy(void);
+
+    void                SetConfig(const TWiMODLORAWAN_PowerPolicyConfig& config);
+    const TWiMODLORAWAN_PowerPolicyConfig& GetConfig(void) const { return config; }
+
+    void                Enable(bool flag) { enabled = flag; }
+    bool                IsEnabled(void) const { return enabled; }
+
+    void                OnDownlink(UINT32 now);
+    void                OnTx(UINT32 airtimeMs);
+    void                RequestClassC(UINT32 durationMs, UINT32 now);
+    void                ReleaseClassC(void);
+
+    bool                Evaluate(UINT32 now, TWiMODLORAWAN_PowerMode* newMode);
+    void                OnModeApplied(TWiMODLORAWAN_PowerMode newMode, UINT32 now);
+    void                OnModeFailed(UINT32 now);
+
+    void                GetReport(UINT32 now, TWiMODLORAWAN_PowerReport* report);
+
+private:
+    //! @cond Doxygen_Suppress
+    void                update(UINT32 now);
+    void                openWindow(UINT32 durationMs, UINT32 now);
+
+    TWiMODLORAWAN_PowerPolicyConfig config;
+    bool                            enabled;
+    bool                            modeKnown;
+    TWiMODLORAWAN_PowerMode         mode;
+    bool                            windowOpen;
+    UINT32                          windowEnd;
+    UINT32                          lastUpdate;
+    UINT16                          restMs[LORAWAN_POWER_NUM_MODES];
+    UINT32                          timeS[LORAWAN_POWER_NUM_MODES];
+    UINT32                          txTimeMs;
+    UINT32                          switches;
+    UINT32                          failures;
+    bool                            retryWait;
+    UINT32                          retryTime;
+    UINT32                          retryDelay;
+    //! @endcond
+};
+
+#endif /* ARDUINO_WIMOD_LORAWAN_POWERPOLICY_H_ */
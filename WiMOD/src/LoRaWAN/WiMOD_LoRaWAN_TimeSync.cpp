@@ -0,0 +1,294 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LoRaWAN_TimeSync.cpp
+//! @ingroup WiMODLoRaWAN
+//! <!------------------------------------------------------------------------->
+//! @brief Implementation of the network time synchronisation
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//!
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "WiMOD_LoRaWAN_TimeSync.h"
+#include "../SAP/WiMOD_SAP_DEVMGMT_IDs.h"
+
+#include <string.h>
+
+//------------------------------------------------------------------------------
+//
+// Section defines
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+#define SECONDS_PER_DAY         86400UL
+// days from 0000-03-01 to 1970-01-01 (proleptic gregorian calendar)
+#define DAYS_0000_TO_1970       719468UL
+//! @endcond
+
+//------------------------------------------------------------------------------
+//
+// Section local functions
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+// civil date from days since 1970-01-01; see H. Hinnant, "chrono-compatible
+// low-level date algorithms"
+static void civilFromDays(UINT32 days, UINT16* year, UINT8* month, UINT8* day)
+{
+    UINT32 z   = days + DAYS_0000_TO_1970;
+    UINT32 era = z / 146097;
+    UINT32 doe = z - era * 146097;
+    UINT32 yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    UINT32 doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    UINT32 mp  = (5 * doy + 2) / 153;
+
+    *day   = (UINT8)(doy - (153 * mp + 2) / 5 + 1);
+    *month = (UINT8)(mp < 10 ? mp + 3 : mp - 9);
+    *year  = (UINT16)(yoe + era * 400 + (*month <= 2 ? 1 : 0));
+}
+
+static UINT32 min64(UINT64 a, UINT32 b)
+{
+    return (a < b) ? (UINT32) a : b;
+}
+
+static UINT32 daysFromCivil(UINT16 year, UINT8 month, UINT8 day)
+{
+    UINT32 y   = year - (month <= 2 ? 1 : 0);
+    UINT32 era = y / 400;
+    UINT32 yoe = y - era * 400;
+    UINT32 doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    UINT32 doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return era * 146097 + doe - DAYS_0000_TO_1970;
+}
+//! @endcond
+
+//------------------------------------------------------------------------------
+//
+// Section public functions
+//
+//------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Constructor; the clock runs on the local millis()
+ */
+WiMOD_LoRaWAN_TimeSync::WiMOD_LoRaWAN_TimeSync(void)
+{
+    baseMs      = 0;
+    baseMillis  = 0;
+    lastMs      = 0;
+    txDoneTime  = 0;
+    txDoneValid = false;
+    memset(&info, 0x00, sizeof(info));
+    info.Source = LORAWAN_TIME_SOURCE_LOCAL;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief An uplink has been sent (SEND_UDATA_TX_IND / SEND_CDATA_TX_IND)
+ *
+ * The DeviceTimeAns refers to the end of the uplink that carried the
+ * DeviceTimeReq, so the time stamp of the TX indication is used as
+ * reference instead of the (later) reception of the answer.
+ */
+void WiMOD_LoRaWAN_TimeSync::OnTxDone(UINT32 now)
+{
+    txDoneTime  = now;
+    txDoneValid = true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Take over the network time of a DeviceTimeAns
+ *
+ * @param ans   decoded answer
+ * @param now   current time in ms (reception of the answer)
+ */
+void WiMOD_LoRaWAN_TimeSync::OnDeviceTimeAns(const TWiMODLORAWAN_DeviceTimeAns& ans, UINT32 now)
+{
+    UINT32 ref = now;
+    UINT64 timeMs;
+    UINT64 localMs;
+
+    if (txDoneValid && ((UINT32)(now - txDoneTime) <= LORAWAN_TIME_TX_REF_MAX_AGE_MS)) {
+        ref = txDoneTime;
+    }
+    txDoneValid = false;
+
+    // fractional second in 1/256 s
+    timeMs = (UINT64) ans.GpsSeconds * 1000 + (((UINT32) ans.FractionalSecond * 1000) >> 8);
+
+    if (info.Source != LORAWAN_TIME_SOURCE_LOCAL) {
+        localMs = baseMs + (UINT32)(ref - baseMillis);
+        if (timeMs >= localMs) {
+            info.LastCorrectionMs =  (INT32) min64(timeMs - localMs, 0x7FFFFFFFUL);
+        } else {
+            info.LastCorrectionMs = -(INT32) min64(localMs - timeMs, 0x7FFFFFFFUL);
+        }
+    }
+
+    setTime(timeMs, ref);
+    info.Source           = LORAWAN_TIME_SOURCE_NETWORK;
+    info.NumSyncs++;
+    info.LastSyncTime     = now;
+    info.RtcUpdatePending = true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Seed the clock from the module RTC
+ *
+ * Ignored once the clock has been synchronised by the network.
+ *
+ * @param rtcTime   RTC time stamp (@see WIMOD_RTC_* macros)
+ * @param now       current time in ms
+ */
+void WiMOD_LoRaWAN_TimeSync::OnRtc(UINT32 rtcTime, UINT32 now)
+{
+    if (info.Source == LORAWAN_TIME_SOURCE_NETWORK) {
+        return;
+    }
+    setTime((UINT64) RtcToGps(rtcTime) * 1000, now);
+    info.Source = LORAWAN_TIME_SOURCE_RTC;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief The module RTC has been checked / set after a sync
+ *
+ * @param rtcErrorS     RTC - network time in s before the update
+ */
+void WiMOD_LoRaWAN_TimeSync::OnRtcUpdated(INT32 rtcErrorS)
+{
+    info.LastRtcErrorS    = rtcErrorS;
+    info.RtcUpdatePending = false;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Current time of the clock
+ *
+ * @param now   current time in ms (millis())
+ *
+ * @return ms since the GPS epoch; ms since start-up if not synchronised
+ */
+UINT64 WiMOD_LoRaWAN_TimeSync::GetTimeMs(UINT32 now)
+{
+    UINT32 elapsed = now - baseMillis;
+    UINT64 timeMs;
+
+    // keep the elapsed time far from the millis() wrap around
+    if (elapsed > 0x7FFFFFFFUL) {
+        baseMs    += elapsed;
+        baseMillis = now;
+        elapsed    = 0;
+    }
+
+    timeMs = baseMs + elapsed;
+    if (timeMs < lastMs) {
+        // hold the clock after a negative correction
+        timeMs = lastMs;
+    }
+    lastMs = timeMs;
+    return timeMs;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Time until the next slot of a periodic schedule
+ *
+ * Slots start at all times t with (t - offsetMs) mod periodMs == 0. Nodes
+ * using the same period and offset hit the same slots once synchronised.
+ *
+ * @param now       current time in ms (millis())
+ * @param periodMs  period of the schedule
+ * @param offsetMs  offset of the slots within the period
+ *
+ * @return ms until the next slot; periodMs if a slot starts right now
+ */
+UINT32 WiMOD_LoRaWAN_TimeSync::GetMsUntilSlot(UINT32 now, UINT32 periodMs, UINT32 offsetMs)
+{
+    UINT32 phase;
+
+    if (periodMs == 0) {
+        return 0;
+    }
+    phase = (UINT32)((GetTimeMs(now) + periodMs - (offsetMs % periodMs)) % periodMs);
+    return periodMs - phase;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Convert GPS time to a RTC time stamp (UTC)
+ *
+ * @param gpsSeconds    s since the GPS epoch
+ *
+ * @return RTC time stamp (@see WIMOD_RTC_* macros)
+ */
+UINT32 WiMOD_LoRaWAN_TimeSync::GpsToRtc(UINT32 gpsSeconds)
+{
+    UINT32 unixTime = gpsSeconds + LORAWAN_TIME_GPS_EPOCH_UNIX - LORAWAN_TIME_GPS_LEAP_SECONDS;
+    UINT32 secs     = unixTime % SECONDS_PER_DAY;
+    UINT16 year;
+    UINT8  month;
+    UINT8  day;
+
+    civilFromDays(unixTime / SECONDS_PER_DAY, &year, &month, &day);
+
+    return WIMOD_RTC_MAKE_DATETIME_U32(secs % 60, (secs / 60) % 60, secs / 3600,
+                                       day, month, year);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Convert a RTC time stamp (UTC) to GPS time
+ *
+ * @param rtcTime   RTC time stamp (@see WIMOD_RTC_* macros)
+ *
+ * @return s since the GPS epoch
+ */
+UINT32 WiMOD_LoRaWAN_TimeSync::RtcToGps(UINT32 rtcTime)
+{
+    UINT32 unixTime;
+
+    unixTime = daysFromCivil(WIMOD_RTC_GET_YEARS(rtcTime),
+                             WIMOD_RTC_GET_MONTHS(rtcTime),
+                             WIMOD_RTC_GET_DAYS(rtcTime)) * SECONDS_PER_DAY
+               + WIMOD_RTC_GET_HOURS(rtcTime) * 3600UL
+               + WIMOD_RTC_GET_MINUTES(rtcTime) * 60UL
+               + WIMOD_RTC_GET_SECONDS(rtcTime);
+
+    return unixTime - LORAWAN_TIME_GPS_EPOCH_UNIX + LORAWAN_TIME_GPS_LEAP_SECONDS;
+}
+
+//------------------------------------------------------------------------------
+//
+// Section private functions
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+void WiMOD_LoRaWAN_TimeSync::setTime(UINT64 timeMs, UINT32 ref)
+{
+    baseMs     = timeMs;
+    baseMillis = ref;
+}
+//! @endcond
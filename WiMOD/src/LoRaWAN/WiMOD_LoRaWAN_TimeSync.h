@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LoRaWAN_TimeSync.h
+//! @ingroup WiMODLoRaWAN
+//! <!------------------------------------------------------------------------->
+//! @brief Declarations for the network time synchronisation
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//! Host clock aligned to the network time (DeviceTimeAns) that is used to
+//! compute sampling / uplink slots and to set the RTC of the module.
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+
+#ifndef ARDUINO_WIMOD_LORAWAN_TIMESYNC_H_
+#define ARDUINO_WIMOD_LORAWAN_TIMESYNC_H_
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "../SAP/WiMOD_SAP_LORAWAN_IDs.h"
+
+//------------------------------------------------------------------------------
+//
+// Section defines
+//
+//------------------------------------------------------------------------------
+
+/** Unix time of the GPS epoch (1980-01-06 00:00:00 UTC) */
+#define LORAWAN_TIME_GPS_EPOCH_UNIX                 315964800UL
+
+/** GPS - UTC offset in s; must be updated if a new leap second is announced */
+#ifndef LORAWAN_TIME_GPS_LEAP_SECONDS
+#define LORAWAN_TIME_GPS_LEAP_SECONDS               18
+#endif
+
+/** max. age of a TX indication used as reference of a DeviceTimeAns */
+#define LORAWAN_TIME_TX_REF_MAX_AGE_MS              10000
+
+//------------------------------------------------------------------------------
+//
+// Section types
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Source of the current host clock
+ */
+typedef enum TWiMODLORAWAN_TimeSource
+{
+    LORAWAN_TIME_SOURCE_LOCAL = 0,                                              /*!< not synchronised; local millis() */
+    LORAWAN_TIME_SOURCE_RTC,                                                    /*!< seeded from the module RTC (1 s resolution) */
+    LORAWAN_TIME_SOURCE_NETWORK,                                                /*!< synchronised by a DeviceTimeAns */
+} TWiMODLORAWAN_TimeSource;
+
+/**
+ * @brief Status of the time synchronisation
+ */
+typedef struct TWiMODLORAWAN_TimeSyncInfo
+{
+    TWiMODLORAWAN_TimeSource    Source;                                         /*!< source of the current clock */
+    UINT32                      NumSyncs;                                       /*!< number of DeviceTimeAns taken over */
+    UINT32                      LastSyncTime;                                   /*!< time stamp (ms) of the last DeviceTimeAns */
+    INT32                       LastCorrectionMs;                               /*!< network time - host clock at the last sync */
+    INT32                       LastRtcErrorS;                                  /*!< RTC - network time at the last RTC update */
+    bool                        RtcUpdatePending;                               /*!< RTC has not been set since the last sync */
+} TWiMODLORAWAN_TimeSyncInfo;
+
+//------------------------------------------------------------------------------
+//
+// Section class
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Network aligned host clock
+ *
+ * The clock counts ms since the GPS epoch once a DeviceTimeAns has been
+ * received; before that it is seeded from the module RTC or runs on the
+ * local millis(). The clock never runs backwards: a negative correction
+ * holds the clock until the network time has caught up.
+ *
+ * The class only keeps the time; the module access is done by the
+ * WiMODLoRaWAN class.
+ */
+class WiMOD_LoRaWAN_TimeSync
+{
+public:
+    WiMOD_LoRaWAN_TimeSync(void);
+
+    void                OnTxDone(UINT32 now);
+    void                OnDeviceTimeAns(const TWiMODLORAWAN_DeviceTimeAns& ans, UINT32 now);
+    void                OnRtc(UINT32 rtcTime, UINT32 now);
+    void                OnRtcUpdated(INT32 rtcErrorS);
+
+    UINT64              GetTimeMs(UINT32 now);
+    UINT32              GetMsUntilSlot(UINT32 now, UINT32 periodMs, UINT32 offsetMs);
+
+    const TWiMODLORAWAN_TimeSyncInfo& GetInfo(void) const { return info; }
+
+    static UINT32       GpsToRtc(UINT32 gpsSeconds);
+    static UINT32       RtcToGps(UINT32 rtcTime);
+
+private:
+    //! @cond Doxygen_Suppress
+    void                setTime(UINT64 timeMs, UINT32 ref);
+
+    UINT64              baseMs;                                                 // clock value at baseMillis
+    UINT32              baseMillis;
+    UINT64              lastMs;                                                 // last value returned (monotonic)
+    UINT32              txDoneTime;
+    bool                txDoneValid;
+
+    TWiMODLORAWAN_TimeSyncInfo  info;
+    //! @endcond
+};
+
+#endif /* ARDUINO_WIMOD_LORAWAN_TIMESYNC_H_ */
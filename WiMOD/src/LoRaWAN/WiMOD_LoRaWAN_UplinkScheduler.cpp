@@ -0,0 +1,184 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LoRaWAN_UplinkScheduler.cpp
+//! @ingroup WiMODLoRaWAN
+//! <!------------------------------------------------------------------------->
+//! @brief Implementation of the slotted uplink scheduler
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//!
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "WiMOD_LoRaWAN_UplinkScheduler.h"
+#include "../utils/AirTimeCalc.h"
+
+#include <string.h>
+
+//------------------------------------------------------------------------------
+//
+// Section local functions
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+// 32 bit finalizer of MurmurHash3; spreads consecutive seeds over all bits
+static UINT32 mix32(UINT32 h)
+{
+    h ^= h >> 16;
+    h *= 0x85EBCA6BUL;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35UL;
+    h ^= h >> 16;
+    return h;
+}
+//! @endcond
+
+//------------------------------------------------------------------------------
+//
+// Section public functions
+//
+//------------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Constructor; default period, DR0 slot width, seed 0
+ */
+WiMOD_LoRaWAN_UplinkScheduler::WiMOD_LoRaWAN_UplinkScheduler(void)
+{
+    config.PeriodMs           = LORAWAN_SCHED_DEFAULT_PERIOD_MS;
+    config.MaxPayloadLen      = LORAWAN_SCHED_DEFAULT_PAYLOAD_LEN;
+    config.GuardMs            = LORAWAN_SCHED_DEFAULT_GUARD_MS;
+    config.CollisionThreshold = 1;
+
+    memset(&info, 0x00, sizeof(info));
+    dataRate        = 0;
+    collisionsInRow = 0;
+    assignSlot();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Set a new configuration; the slot is assigned again
+ */
+void WiMOD_LoRaWAN_UplinkScheduler::SetConfig(const TWiMODLORAWAN_SchedulerConfig& config)
+{
+    this->config = config;
+    assignSlot();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Set the hash seed, e.g. the DevAddr or MakeSeed(DeviceEUI)
+ *
+ * A new seed restarts the slot sequence.
+ */
+void WiMOD_LoRaWAN_UplinkScheduler::SetSeed(UINT32 seed)
+{
+    if (seed == info.Seed) {
+        return;
+    }
+    info.Seed       = seed;
+    info.Reseeds    = 0;
+    collisionsInRow = 0;
+    assignSlot();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Set the data rate used for the slot width
+ */
+void WiMOD_LoRaWAN_UplinkScheduler::SetDataRate(UINT8 dataRateIndex)
+{
+    if (dataRateIndex == dataRate) {
+        return;
+    }
+    dataRate = dataRateIndex;
+    assignSlot();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Report the result of an uplink
+ *
+ * @param numTxPackets  radio packets used (TX indication); 0 if unknown
+ * @param delivered     false if a confirmed uplink has not been acked
+ */
+void WiMOD_LoRaWAN_UplinkScheduler::OnUplink(UINT8 numTxPackets, bool delivered)
+{
+    info.Uplinks++;
+
+    if (delivered && (numTxPackets <= 1)) {
+        collisionsInRow = 0;
+        return;
+    }
+
+    info.Collisions++;
+    collisionsInRow++;
+    if (config.CollisionThreshold && (collisionsInRow >= config.CollisionThreshold)) {
+        collisionsInRow = 0;
+        info.Reseeds++;
+        assignSlot();
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Hash an ID (e.g. DeviceEUI) into a seed; FNV-1a
+ */
+UINT32 WiMOD_LoRaWAN_UplinkScheduler::MakeSeed(const UINT8* id, UINT8 len)
+{
+    UINT32 h = 0x811C9DC5UL;
+
+    if (id == NULL) {
+        return 0;
+    }
+    while (len--) {
+        h ^= *id++;
+        h *= 0x01000193UL;
+    }
+    return h;
+}
+
+//------------------------------------------------------------------------------
+//
+// Section private functions
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+void WiMOD_LoRaWAN_UplinkScheduler::assignSlot(void)
+{
+    UINT32 width;
+    UINT32 numSlots;
+
+    width = (AirTimeCalc_LoRaWanUs(dataRate, config.MaxPayloadLen) + 999) / 1000 + config.GuardMs;
+    if (width == 0) {
+        width = 1;
+    }
+    numSlots = config.PeriodMs / width;
+    if (numSlots == 0) {
+        numSlots = 1;
+    } else if (numSlots > 0xFFFF) {
+        numSlots = 0xFFFF;
+    }
+
+    info.SlotWidthMs = width;
+    info.NumSlots    = (UINT16) numSlots;
+    info.Slot        = (UINT16)(mix32(info.Seed ^ mix32(info.Reseeds + 1)) % numSlots);
+    info.OffsetMs    = info.Slot * width;
+}
+//! @endcond
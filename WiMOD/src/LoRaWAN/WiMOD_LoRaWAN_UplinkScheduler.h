@@ -0,0 +1,124 @@
+//------------------------------------------------------------------------------
+//! @file WiMOD_LoRaWAN_UplinkScheduler.h
+//! @ingroup WiMODLoRaWAN
+//! <!------------------------------------------------------------------------->
+//! @brief Declarations for the slotted uplink scheduler
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//! Assigns each node a deterministic uplink slot within the reporting period
+//! and moves it to another slot if collisions are inferred.
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+
+#ifndef ARDUINO_WIMOD_LORAWAN_UPLINKSCHEDULER_H_
+#define ARDUINO_WIMOD_LORAWAN_UPLINKSCHEDULER_H_
+
+//------------------------------------------------------------------------------
+//
+// Section Includes Files
+//
+//------------------------------------------------------------------------------
+
+#include "../SAP/WiMOD_SAP_LORAWAN_IDs.h"
+
+//------------------------------------------------------------------------------
+//
+// Section defines
+//
+//------------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+#define LORAWAN_SCHED_DEFAULT_PERIOD_MS             60000
+#define LORAWAN_SCHED_DEFAULT_PAYLOAD_LEN           20
+#define LORAWAN_SCHED_DEFAULT_GUARD_MS              50
+//! @endcond
+
+//------------------------------------------------------------------------------
+//
+// Section types
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Configuration of the uplink scheduler
+ */
+typedef struct TWiMODLORAWAN_SchedulerConfig
+{
+    UINT32      PeriodMs;                                                       /*!< reporting period */
+    UINT8       MaxPayloadLen;                                                  /*!< application payload used for the slot width */
+    UINT16      GuardMs;                                                        /*!< guard time per slot (clock error of the nodes) */
+    UINT8       CollisionThreshold;                                             /*!< collisions in a row before moving to another slot; 0 = never */
+} TWiMODLORAWAN_SchedulerConfig;
+
+/**
+ * @brief Status of the uplink scheduler
+ */
+typedef struct TWiMODLORAWAN_SchedulerInfo
+{
+    UINT32      Seed;                                                           /*!< hash seed (DevAddr / DeviceEUI) */
+    UINT32      SlotWidthMs;                                                    /*!< time on air + guard time */
+    UINT16      NumSlots;                                                       /*!< slots per period */
+    UINT16      Slot;                                                           /*!< own slot */
+    UINT32      OffsetMs;                                                       /*!< start of the own slot within the period */
+    UINT32      Uplinks;                                                        /*!< uplinks reported */
+    UINT32      Collisions;                                                     /*!< inferred collisions */
+    UINT32      Reseeds;                                                        /*!< slot changes due to collisions */
+} TWiMODLORAWAN_SchedulerInfo;
+
+//------------------------------------------------------------------------------
+//
+// Section class
+//
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Slotted uplink scheduler
+ *
+ * The reporting period is divided into slots of the time on air of a full
+ * uplink plus a guard time. Each node hashes its seed into one slot, so
+ * nodes with a common (network aligned) clock spread their uplinks over
+ * the period instead of colliding at random phases.
+ *
+ * A collision is inferred from a confirmed uplink without ack or from an
+ * uplink that needed more than one radio packet. After CollisionThreshold
+ * collisions in a row the node moves to the next slot of its hash
+ * sequence; the sequence is deterministic for a given seed.
+ */
+class WiMOD_LoRaWAN_UplinkScheduler
+{
+public:
+    WiMOD_LoRaWAN_UplinkScheduler(void);
+
+    void                SetConfig(const TWiMODLORAWAN_SchedulerConfig& config);
+    const TWiMODLORAWAN_SchedulerConfig& GetConfig(void) const { return config; }
+    void                SetSeed(UINT32 seed);
+    void                SetDataRate(UINT8 dataRateIndex);
+
+    UINT32              GetPeriodMs(void) const { return config.PeriodMs; }
+    UINT32              GetOffsetMs(void) const { return info.OffsetMs; }
+
+    void                OnUplink(UINT8 numTxPackets, bool delivered);
+
+    const TWiMODLORAWAN_SchedulerInfo& GetInfo(void) const { return info; }
+
+    static UINT32       MakeSeed(const UINT8* id, UINT8 len);
+
+private:
+    //! @cond Doxygen_Suppress
+    void                assignSlot(void);
+
+    TWiMODLORAWAN_SchedulerConfig   config;
+    TWiMODLORAWAN_SchedulerInfo     info;
+    UINT8                           dataRate;
+    UINT8                           collisionsInRow;
+    //! @endcond
+};
+
+#endif /* ARDUINO_WIMOD_LORAWAN_UPLINKSCHEDULER_H_ */
@@ -230,7 +230,7 @@ typedef enum TRadioCfg_RadioMode
 {
     RadioMode_Standard = 0,                                                     /*!< normal operation mode */
     RadioMode_Echo,                                                             /*!< DO NOT USE */
-    RadioMode_Sniffer,                                                          /*!< DO NOT USE */
+    RadioMode_Sniffer,                                                          /*!< raw frame capture; see WiMODLRBASE::EnableSniffer() */
 } TRadioCfg_RadioMode;
 
 
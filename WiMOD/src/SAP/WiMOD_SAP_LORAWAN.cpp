@@ -106,6 +106,14 @@ void WiMOD_SAP_LoRaWAN::setRegion(TLoRaWANregion regionalSetting) {
 	region = regionalSetting;
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * @brief Get the regional settings used for the LoRaWAN Firmware
+ */
+TLoRaWANregion WiMOD_SAP_LoRaWAN::getRegion(void) const {
+	return region;
+}
+
 //-----------------------------------------------------------------------------
 /**
  * @brief Activates the device via the APB procedure
@@ -276,13 +284,13 @@ TWiMDLRResultCodes WiMOD_SAP_LoRaWAN::SendUData(const TWiMODLORAWAN_TX_Data* dat
     UINT8              offset = 0;
     UINT8              tmpSize;
 
-    if ( data && (data->Length > 0) && statusRsp) {
+    if ( data && (data->Length > 0) && (data->Length <= WiMODLORAWAN_APP_PAYLOAD_LEN) && statusRsp) {
 
-        tmpSize = MIN((WiMOD_LORAWAN_TX_PAYLOAD_SIZE-1), data->Length);
+        tmpSize = data->Length;
 
-        if (txPayloadSize >= tmpSize) {
+        if (txPayloadSize > tmpSize) {
             txPayload[offset++] = data->Port;
-            memcpy(&txPayload[offset], data->Payload, MIN((WiMOD_LORAWAN_TX_PAYLOAD_SIZE-1), tmpSize));
+            memcpy(&txPayload[offset], data->Payload, tmpSize);
             offset += tmpSize;
 
             result = HciParser->SendHCIMessage(LORAWAN_SAP_ID,
@@ -299,6 +307,9 @@ TWiMDLRResultCodes WiMOD_SAP_LoRaWAN::SendUData(const TWiMODLORAWAN_TX_Data* dat
 
     } else {
         result = WiMODLR_RESULT_PAYLOAD_PTR_ERROR;
+        if (data && (data->Length > WiMODLORAWAN_APP_PAYLOAD_LEN)) {
+            result = WiMODLR_RESULT_PAYLOAD_LENGTH_ERROR;
+        }
     }
     return result;
 
@@ -322,11 +333,11 @@ TWiMDLRResultCodes WiMOD_SAP_LoRaWAN::SendCData(const TWiMODLORAWAN_TX_Data* dat
     TWiMDLRResultCodes result = WiMODLR_RESULT_TRANMIT_ERROR;
     UINT8              offset = 0;
 
-    if ( data && (data->Length > 0) && statusRsp) {
+    if ( data && (data->Length > 0) && (data->Length <= WiMODLORAWAN_APP_PAYLOAD_LEN) && statusRsp) {
 
         txPayload[offset++] = data->Port;
-        memcpy(&txPayload[offset], data->Payload, MIN((WiMOD_LORAWAN_TX_PAYLOAD_SIZE-1), data->Length));
-        offset += MIN((WiMOD_LORAWAN_TX_PAYLOAD_SIZE-1), data->Length);
+        memcpy(&txPayload[offset], data->Payload, data->Length);
+        offset += data->Length;
 
         result = HciParser->SendHCIMessage(LORAWAN_SAP_ID,
                                            LORAWAN_MSG_SEND_CDATA_REQ,
@@ -338,6 +349,9 @@ TWiMDLRResultCodes WiMOD_SAP_LoRaWAN::SendCData(const TWiMODLORAWAN_TX_Data* dat
         }
     } else {
         result = WiMODLR_RESULT_PAYLOAD_PTR_ERROR;
+        if (data && (data->Length > WiMODLORAWAN_APP_PAYLOAD_LEN)) {
+            result = WiMODLR_RESULT_PAYLOAD_LENGTH_ERROR;
+        }
     }
     return result;
 
@@ -491,6 +505,72 @@ bool WiMOD_SAP_LoRaWAN::convert(TWiMODLR_HCIMessage&    RxMsg,
     return false;
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * @brief Reference the Rx Data of a received low level HCI-Msg without copying
+ *
+ * Same layout as the conversion into TWiMODLORAWAN_RX_Data, but the payload
+ * stays inside the HCI message; rxDataView->Payload points into RxMsg.
+ *
+ * @param   RxMsg       Reference to low-level HCI message.
+ *                      @warning DO NOT MANIPULATE THESE VALUES !!!
+ *
+ * @param   rxDataView  Pointer to the view to fill
+ *
+ * @retval true     if the message contains a valid Rx Data field
+ */
+bool WiMOD_SAP_LoRaWAN::convert(const TWiMODLR_HCIMessage&  RxMsg,
+                                TWiMODLORAWAN_RX_DataView*  rxDataView)
+{
+    INT16 dataLen = RxMsg.Length;
+    UINT8 offset  = 0;
+
+    if (rxDataView == NULL) {
+        return false;
+    }
+    rxDataView->Port                 = 0;
+    rxDataView->Length               = 0;
+    rxDataView->Payload              = NULL;
+    rxDataView->OptionalInfoAvaiable = false;
+
+    if (RxMsg.Length < 1) {
+        return false;
+    }
+
+    rxDataView->StatusFormat = RxMsg.Payload[offset++];
+
+    if (rxDataView->StatusFormat & LORAWAN_FORMAT_EXT_HCI_OUT_ACTIVE) {
+        dataLen -= (0x01 + 0x05); // format + rx ch info
+        rxDataView->OptionalInfoAvaiable = true;
+    } else {
+        dataLen -= 0x01; // format; only
+    }
+
+    // LoRaWAN port ID
+    if (dataLen > 0) {
+        rxDataView->Port = RxMsg.Payload[offset++];
+        dataLen--;
+    }
+
+    if (dataLen > 0) {
+        rxDataView->Payload = &RxMsg.Payload[offset];
+        rxDataView->Length  = (UINT8) dataLen;
+        offset += (UINT8) dataLen;
+    }
+
+    // check if optional attributes are present
+    if (rxDataView->OptionalInfoAvaiable && ((offset + 5) <= RxMsg.Length)) {
+        rxDataView->ChannelIndex  = (UINT8) RxMsg.Payload[offset++];
+        rxDataView->DataRateIndex = (UINT8) RxMsg.Payload[offset++];
+        rxDataView->RSSI          = (INT8)  RxMsg.Payload[offset++];
+        rxDataView->SNR           = (INT8)  RxMsg.Payload[offset++];
+        rxDataView->RxSlot        = (UINT8) RxMsg.Payload[offset++];
+    } else {
+        rxDataView->OptionalInfoAvaiable = false;
+    }
+    return true;
+}
+
 //-----------------------------------------------------------------------------
 /**
  * @brief Convert a received low level HCI-Msg to a high-level MAC-Cmd structure
@@ -552,6 +632,109 @@ bool WiMOD_SAP_LoRaWAN::convert(TWiMODLR_HCIMessage&         RxMsg,
 }
 
 
+//-----------------------------------------------------------------------------
+/**
+ * @brief Reference the MAC commands of a received low level HCI-Msg without copying
+ *
+ * @param   RxMsg       Reference to low-level HCI message.
+ *                      @warning DO NOT MANIPULATE THESE VALUES !!!
+ *
+ * @param   macCmdView  Pointer to the view to fill
+ *
+ * @retval true     if the message contains a MAC command field
+ */
+bool WiMOD_SAP_LoRaWAN::convert(const TWiMODLR_HCIMessage&   RxMsg,
+                                TWiMODLORAWAN_RX_MacCmdView* macCmdView)
+{
+    INT16 dataLen = RxMsg.Length;
+    UINT8 offset  = 0;
+    UINT8 format;
+
+    if (macCmdView == NULL) {
+        return false;
+    }
+    macCmdView->Length               = 0;
+    macCmdView->MacCmdData           = NULL;
+    macCmdView->OptionalInfoAvaiable = false;
+
+    if (RxMsg.Length < 1) {
+        return false;
+    }
+
+    format = RxMsg.Payload[offset++];
+
+    if (format & LORAWAN_FORMAT_EXT_HCI_OUT_ACTIVE) {
+        dataLen -= (0x01 + 0x05); // format + rx ch info
+        macCmdView->OptionalInfoAvaiable = true;
+    } else {
+        dataLen -= 0x01; // format; only
+    }
+
+    if (dataLen > 0) {
+        macCmdView->MacCmdData = &RxMsg.Payload[offset];
+        macCmdView->Length     = (UINT8) dataLen;
+        offset += (UINT8) dataLen;
+    }
+
+    // check if optional attributes are present
+    if (macCmdView->OptionalInfoAvaiable && ((offset + 5) <= RxMsg.Length)) {
+        macCmdView->ChannelIndex  = (UINT8) RxMsg.Payload[offset++];
+        macCmdView->DataRateIndex = (UINT8) RxMsg.Payload[offset++];
+        macCmdView->RSSI          = (INT8)  RxMsg.Payload[offset++];
+        macCmdView->SNR           = (INT8)  RxMsg.Payload[offset++];
+        macCmdView->RxSlot        = (UINT8) RxMsg.Payload[offset++];
+    } else {
+        macCmdView->OptionalInfoAvaiable = false;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Decode a LinkCheckAns contained in received MAC commands
+ *
+ * @param   macCmdView      MAC commands referenced by convert()
+ *
+ * @param   linkCheckAns    Pointer to the decoded answer
+ *
+ * @retval true     if the MAC commands contain a LinkCheckAns
+ */
+bool WiMOD_SAP_LoRaWAN::convert(const TWiMODLORAWAN_RX_MacCmdView& macCmdView,
+                                TWiMODLORAWAN_LinkCheckAns*        linkCheckAns)
+{
+    const UINT8* p = findMacCmd(macCmdView, LORAWAN_MAC_CMD_LINK_CHECK);
+
+    if ((p == NULL) || (linkCheckAns == NULL)) {
+        return false;
+    }
+    linkCheckAns->Margin = p[0];
+    linkCheckAns->GwCnt  = p[1];
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @brief Decode a DeviceTimeAns contained in received MAC commands
+ *
+ * @param   macCmdView      MAC commands referenced by convert()
+ *
+ * @param   deviceTimeAns   Pointer to the decoded answer
+ *
+ * @retval true     if the MAC commands contain a DeviceTimeAns
+ */
+bool WiMOD_SAP_LoRaWAN::convert(const TWiMODLORAWAN_RX_MacCmdView& macCmdView,
+                                TWiMODLORAWAN_DeviceTimeAns*       deviceTimeAns)
+{
+    const UINT8* p = findMacCmd(macCmdView, LORAWAN_MAC_CMD_DEVICE_TIME);
+
+    if ((p == NULL) || (deviceTimeAns == NULL)) {
+        return false;
+    }
+    deviceTimeAns->GpsSeconds       = NTOH32(p);
+    deviceTimeAns->FractionalSecond = p[4];
+    return true;
+}
+
 //-----------------------------------------------------------------------------
 /**
  * @brief Convert a received low level HCI-Msg to a high-level NwkJoined structure
@@ -1578,4 +1761,54 @@ WiMOD_SAP_LoRaWAN::DispatchLoRaWANMessage(TWiMODLR_HCIMessage& rxMsg) {
 //
 //------------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+/**
+ * @internal
+ *
+ * @brief Search a MAC command in a list of downlink MAC commands
+ *
+ * The list is walked using the payload length of each known command ID;
+ * the search stops at the first unknown command ID.
+ *
+ * @return pointer to the payload of the command; NULL if not found
+ *
+ * @endinternal
+ */
+const UINT8* WiMOD_SAP_LoRaWAN::findMacCmd(const TWiMODLORAWAN_RX_MacCmdView& macCmdView,
+                                           UINT8                              cid)
+{
+    UINT8 offset = 0;
+    UINT8 len;
+
+    if (macCmdView.MacCmdData == NULL) {
+        return NULL;
+    }
 
+    while (offset < macCmdView.Length) {
+        UINT8 id = macCmdView.MacCmdData[offset++];
+
+        // payload length of the server -> device commands
+        switch (id) {
+            case LORAWAN_MAC_CMD_LINK_CHECK:        len = 2; break;
+            case LORAWAN_MAC_CMD_LINK_ADR:          len = 4; break;
+            case LORAWAN_MAC_CMD_DUTY_CYCLE:        len = 1; break;
+            case LORAWAN_MAC_CMD_RX_PARAM_SETUP:    len = 4; break;
+            case LORAWAN_MAC_CMD_DEV_STATUS:        len = 0; break;
+            case LORAWAN_MAC_CMD_NEW_CHANNEL:       len = 5; break;
+            case LORAWAN_MAC_CMD_RX_TIMING_SETUP:   len = 1; break;
+            case LORAWAN_MAC_CMD_TX_PARAM_SETUP:    len = 1; break;
+            case LORAWAN_MAC_CMD_DL_CHANNEL:        len = 4; break;
+            case LORAWAN_MAC_CMD_DEVICE_TIME:       len = 5; break;
+            default:
+                return NULL;
+        }
+        if ((offset + len) > macCmdView.Length) {
+            return NULL;
+        }
+        if (id == cid) {
+            return &macCmdView.MacCmdData[offset];
+        }
+        offset += len;
+    }
+    return NULL;
+}
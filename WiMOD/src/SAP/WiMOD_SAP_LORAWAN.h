@@ -172,6 +172,7 @@ public:
 
 
     void setRegion(TLoRaWANregion regionalSetting);
+    TLoRaWANregion getRegion(void) const;
 
     TWiMDLRResultCodes ActivateDevice(TWiMODLORAWAN_ActivateDeviceData& activationData, UINT8* statusRsp);
     TWiMDLRResultCodes ReactivateDevice(UINT32* devAdr, UINT8* statusRsp);
@@ -182,9 +183,13 @@ public:
 
 //    bool               convert(TWiMODLR_HCIMessage& RxMsg, TWiMODLORAWAN_JoinNwkTxIndData* indicationData);
     bool               convert(TWiMODLR_HCIMessage& RxMsg, TWiMODLORAWAN_RX_Data* loraWanRxData);
+    bool               convert(const TWiMODLR_HCIMessage& RxMsg, TWiMODLORAWAN_RX_DataView* rxDataView);
 //    bool               convert(TWiMODLR_HCIMessage& rxMsg, TWiMODLORAWAN_SendDataTxInd_Data* sendIndData);
     bool               convert(TWiMODLR_HCIMessage& rxMsg, TWiMODLORAWAN_TxIndData* sendIndData);
     bool               convert(TWiMODLR_HCIMessage& RxMsg, TWiMODLORAWAN_RX_MacCmdData* loraWanMacCmdData);
+    bool               convert(const TWiMODLR_HCIMessage& RxMsg, TWiMODLORAWAN_RX_MacCmdView* macCmdView);
+    bool               convert(const TWiMODLORAWAN_RX_MacCmdView& macCmdView, TWiMODLORAWAN_LinkCheckAns* linkCheckAns);
+    bool               convert(const TWiMODLORAWAN_RX_MacCmdView& macCmdView, TWiMODLORAWAN_DeviceTimeAns* deviceTimeAns);
     bool               convert(TWiMODLR_HCIMessage& RxMsg, TWiMODLORAWAN_RX_JoinedNwkData* joinedNwkData);
     bool               convert(TWiMODLR_HCIMessage& RxMsg, TWiMODLORAWAN_RX_ACK_Data* ackData);
     bool 			   convert(TWiMODLR_HCIMessage& RxMsg, TWiMODLORAWAN_NoData_Data* info);
@@ -242,7 +247,7 @@ protected:
     //! @endcond
 private:
     //! @cond Doxygen_Suppress
-
+    const UINT8*       findMacCmd(const TWiMODLORAWAN_RX_MacCmdView& macCmdView, UINT8 cid);
     //! @endcond
 
 };
@@ -367,6 +367,18 @@ typedef enum TLoRaWAN_NwkStatus
 
 //! @endcond
 
+/** MAC command IDs (CID); see LoRaWAN spec. */
+#define LORAWAN_MAC_CMD_LINK_CHECK                  0x02
+#define LORAWAN_MAC_CMD_LINK_ADR                    0x03
+#define LORAWAN_MAC_CMD_DUTY_CYCLE                  0x04
+#define LORAWAN_MAC_CMD_RX_PARAM_SETUP              0x05
+#define LORAWAN_MAC_CMD_DEV_STATUS                  0x06
+#define LORAWAN_MAC_CMD_NEW_CHANNEL                 0x07
+#define LORAWAN_MAC_CMD_RX_TIMING_SETUP             0x08
+#define LORAWAN_MAC_CMD_TX_PARAM_SETUP              0x09
+#define LORAWAN_MAC_CMD_DL_CHANNEL                  0x0A
+#define LORAWAN_MAC_CMD_DEVICE_TIME                 0x0D
+
 //------------------------------------------------------------------------------
 //
 // misc. defines
@@ -484,6 +496,28 @@ typedef struct TWiMODLORAWAN_RX_Data
     bool        OptionalInfoAvaiable;                                           /*!< are the optional value fields available */
 } TWiMODLORAWAN_RX_Data;
 
+/**
+ * @brief Structure referencing RX (user) payload data inside a HCI message
+ *
+ * The payload is not copied; the pointer is only valid as long as the
+ * HCI message is valid (i.e. within the indication callback).
+ */
+typedef struct TWiMODLORAWAN_RX_DataView
+{
+    UINT8       StatusFormat;                                                   /*!< Status/Format Field for this message */
+    UINT8       Port;                                                           /*!< (Target) LoRaWAN port */
+    UINT8       Length;                                                         /*!< Length of the used (user) payload field */
+    const UINT8* Payload;                                                       /*!< payload data inside the HCI message */
+
+    // optional RX info
+    UINT8       ChannelIndex;                                                   /*!< used channel index (@see TLoRaWAN_Channel_* definitions)*/
+    UINT8       DataRateIndex;                                                  /*!< used data rate index (@see TLoRaWANDataRate*)  */
+    INT8        RSSI;                                                           /*!< RSSI value for the received packet */
+    INT8        SNR;                                                            /*!< SNR value for the received packet  */
+    UINT8       RxSlot;                                                         /*!< number of the rx slot that contained the messsage */
+    bool        OptionalInfoAvaiable;                                           /*!< are the optional value fields available */
+} TWiMODLORAWAN_RX_DataView;
+
 
 /**
  * @brief Structure containing a received MAC command
@@ -502,6 +536,44 @@ typedef struct TWiMODLORAWAN_RX_MacCmdData
     bool        OptionalInfoAvaiable;                                           /*!< are the optional value fields available */
 } TWiMODLORAWAN_RX_MacCmdData;
 
+/**
+ * @brief Structure referencing received MAC commands inside a HCI message
+ *
+ * The MAC commands are not copied; the pointer is only valid as long as
+ * the HCI message is valid (i.e. within the indication callback).
+ */
+typedef struct TWiMODLORAWAN_RX_MacCmdView
+{
+    UINT8       Length;                                                         /*!< length of the MAC command / data */
+    const UINT8* MacCmdData;                                                    /*!< MAC commands inside the HCI message */
+
+    // optional RX info
+    UINT8       ChannelIndex;                                                   /*!< used channel index (@see TLoRaWAN_Channel_* definitions)*/
+    UINT8       DataRateIndex;                                                  /*!< used data rate index (@see TLoRaWANDataRate*)  */
+    INT8        RSSI;                                                           /*!< RSSI value for the received packet */
+    INT8        SNR;                                                            /*!< SNR value for the received packet  */
+    UINT8       RxSlot;                                                         /*!< number of the rx slot that contained the messsage */
+    bool        OptionalInfoAvaiable;                                           /*!< are the optional value fields available */
+} TWiMODLORAWAN_RX_MacCmdView;
+
+/**
+ * @brief Decoded LinkCheckAns MAC command
+ */
+typedef struct TWiMODLORAWAN_LinkCheckAns
+{
+    UINT8       Margin;                                                         /*!< link margin in dB of the last LinkCheckReq */
+    UINT8       GwCnt;                                                          /*!< number of gateways that received the LinkCheckReq */
+} TWiMODLORAWAN_LinkCheckAns;
+
+/**
+ * @brief Decoded DeviceTimeAns MAC command
+ */
+typedef struct TWiMODLORAWAN_DeviceTimeAns
+{
+    UINT32      GpsSeconds;                                                     /*!< seconds since the GPS epoch (1980-01-06) */
+    UINT8       FractionalSecond;                                               /*!< fractional second in 1/256 s */
+} TWiMODLORAWAN_DeviceTimeAns;
+
 /**
  * @brief Structure containing data of the joined network indication
  */
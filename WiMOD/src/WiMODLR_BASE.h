@@ -61,6 +61,58 @@
 
 #include "utils/FreqCalc.h"
 
+//-----------------------------------------------------------------------------
+// optional components
+//
+// Every component is a member of WiMODLRBASE and takes RAM even if it is
+// never used. Set a define to 0 (here or by a compiler flag) to leave the
+// component and its API functions out, e.g. on AVR boards with 2 KB RAM.
+//-----------------------------------------------------------------------------
+//! @cond Doxygen_Suppress
+#ifndef WIMOD_LR_BASE_USE_BULK_TRANSFER
+#define WIMOD_LR_BASE_USE_BULK_TRANSFER             1
+#endif
+
+#ifndef WIMOD_LR_BASE_USE_SNIFFER
+#define WIMOD_LR_BASE_USE_SNIFFER                   1
+#endif
+
+#ifndef WIMOD_LR_BASE_USE_CHANNEL_PLAN
+#define WIMOD_LR_BASE_USE_CHANNEL_PLAN              1
+#endif
+
+#ifndef WIMOD_LR_BASE_USE_TDMA
+#define WIMOD_LR_BASE_USE_TDMA                      1
+#endif
+
+#ifndef WIMOD_LR_BASE_USE_CONCENTRATOR
+#define WIMOD_LR_BASE_USE_CONCENTRATOR              1
+#endif
+
+#ifndef WIMOD_LR_BASE_USE_LINK_BENCH
+#define WIMOD_LR_BASE_USE_LINK_BENCH                1
+#endif
+//! @endcond
+
+#if WIMOD_LR_BASE_USE_BULK_TRANSFER
+#include "LR-BASE/WiMOD_LRBASE_BulkTransfer.h"
+#endif
+#if WIMOD_LR_BASE_USE_SNIFFER
+#include "LR-BASE/WiMOD_LRBASE_Sniffer.h"
+#endif
+#if WIMOD_LR_BASE_USE_CHANNEL_PLAN
+#include "LR-BASE/WiMOD_LRBASE_ChannelPlan.h"
+#endif
+#if WIMOD_LR_BASE_USE_TDMA
+#include "LR-BASE/WiMOD_LRBASE_Tdma.h"
+#endif
+#if WIMOD_LR_BASE_USE_CONCENTRATOR
+#include "LR-BASE/WiMOD_LRBASE_Concentrator.h"
+#endif
+#if WIMOD_LR_BASE_USE_LINK_BENCH
+#include "LR-BASE/WiMOD_LRBASE_LinkBench.h"
+#endif
+
 /*
  * C++11 supports a better way for function pointers / function objects
  * But C++11 mode is not supported by all platforms.
@@ -172,6 +224,61 @@ public:
     void RegisterAckRxTimeoutClient(TRadioLinkAckRxTimeoutIndicationCallback cb);
     void RegisterAckTxCallback(TRadioLinkAckTxIndicationCallback cb);
 
+#if WIMOD_LR_BASE_USE_BULK_TRANSFER
+    void SetBulkTransferConfig(const TWiMODLR_BulkConfig& config);
+    void SetBulkTransferSession(UINT16 session);
+    bool BulkSend(UINT8 groupAddress, UINT16 deviceAddress, const UINT8* data, UINT32 length);
+    bool BulkReceive(UINT8* buffer, UINT32 size);
+    void BulkAbort(void);
+    bool ServiceBulkTransfer(TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
+    void GetBulkTransferStats(TWiMODLR_BulkStats* stats);
+#endif
+
+#if WIMOD_LR_BASE_USE_SNIFFER
+    bool EnableSniffer(UINT8* ringBuffer, UINT32 size, TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
+    bool DisableSniffer(TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
+    UINT8 GetSnifferLogHeader(UINT8* buffer, UINT32 size);
+    UINT32 DrainSniffer(UINT8* buffer, UINT32 size);
+    void GetSnifferStats(TWiMODLR_SnifferStats* stats);
+#endif
+
+#if WIMOD_LR_BASE_USE_CHANNEL_PLAN
+    void SetChannelPlan(const TWiMODLR_Channel* channels, UINT8 numChannels);
+    bool Retune(UINT8 channel, TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
+    void GetRetuneStats(TWiMODLR_RetuneStats* stats);
+#endif
+
+#if WIMOD_LR_BASE_USE_TDMA
+    void SetTdmaConfig(const TWiMODLR_TdmaConfig& config);
+    bool StartTdmaCollector(TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
+    bool StartTdmaNode(TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
+    void StopTdma(void);
+    bool ServiceTdma(TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
+    UINT32 GetMsUntilTdmaSlot(void);
+    bool GetTdmaCollector(UINT8* groupAddress, UINT16* deviceAddress);
+    void GetTdmaInfo(TWiMODLR_TdmaInfo* info);
+#endif
+
+#if WIMOD_LR_BASE_USE_CONCENTRATOR
+    bool EnableConcentrator(TWiMODLR_PeerInfo* peerTable, UINT32 entries);
+    void DisableConcentrator(void);
+    void RegisterConcentratorRxClient(TConcentratorRxCallback cb);
+    const TWiMODLR_PeerInfo* GetConcentratorPeer(UINT8 groupAddress, UINT16 deviceAddress);
+    const TWiMODLR_PeerInfo* GetNextConcentratorPeer(UINT32* iterator);
+    UINT32 ExpireConcentratorPeers(UINT32 maxAgeMs);
+    void SetConcentratorResyncAge(UINT32 ageMs);
+    void GetConcentratorStats(TWiMODLR_ConcentratorStats* stats);
+#endif
+
+#if WIMOD_LR_BASE_USE_LINK_BENCH
+    bool StartLinkBenchSender(const TWiMODLR_BenchConfig& config, TWiMODLR_BenchResult* results, TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
+    bool StartLinkBenchReceiver(TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
+    bool StopLinkBench(TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
+    bool ServiceLinkBench(TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
+    bool IsLinkBenchDone(void);
+    UINT8 GetLinkBenchPointsDone(void);
+#endif
+
     /*
      * Hardware Test SAP
      */
@@ -195,9 +302,55 @@ protected:
 
     WiMOD_SAP_DevMgmt   SapDevMgmt;                                             /*!< Service Access Point for 'DeviceManagement' */
     WiMOD_SAP_RadioLink SapRadioLink;                                           /*!< Service Access Point for 'RadioLink' */
+#if WIMOD_LR_BASE_USE_BULK_TRANSFER
+    WiMOD_LRBASE_BulkTransfer Bulk;                                             /*!< fragmented transfer of large buffers */
+#endif
+#if WIMOD_LR_BASE_USE_SNIFFER
+    WiMOD_LRBASE_Sniffer Sniffer;                                               /*!< capture ring for raw frames */
+#endif
+#if WIMOD_LR_BASE_USE_CHANNEL_PLAN
+    WiMOD_LRBASE_ChannelPlan ChannelPlan;                                       /*!< channel plan and cached radio config */
+#endif
+#if WIMOD_LR_BASE_USE_TDMA
+    WiMOD_LRBASE_Tdma   Tdma;                                                   /*!< TDMA beacon and slot timing */
+#endif
+#if WIMOD_LR_BASE_USE_CONCENTRATOR
+    WiMOD_LRBASE_Concentrator Concentrator;                                     /*!< per-source de-duplication of received frames */
+#endif
+#if WIMOD_LR_BASE_USE_LINK_BENCH
+    WiMOD_LRBASE_LinkBench Bench;                                               /*!< link throughput / PER benchmark */
+#endif
 //    WiMOD_SAP_HWTest	SapHwTest;												/*!< Service Access Point for 'HW Test' */
 private:
     //! @cond Doxygen_Suppress
+#if WIMOD_LR_BASE_USE_BULK_TRANSFER
+    bool                trackBulkTransfer(TWiMODLR_HCIMessage& rxMsg);
+#endif
+#if WIMOD_LR_BASE_USE_SNIFFER
+    bool                captureRawFrame(TWiMODLR_HCIMessage& rxMsg);
+    bool                setSnifferRadioMode(bool enable);
+#endif
+#if WIMOD_LR_BASE_USE_TDMA
+    bool                trackTdma(TWiMODLR_HCIMessage& rxMsg);
+#endif
+#if WIMOD_LR_BASE_USE_CONCENTRATOR
+    bool                trackConcentrator(TWiMODLR_HCIMessage& rxMsg);
+#endif
+#if WIMOD_LR_BASE_USE_LINK_BENCH
+    bool                trackLinkBench(TWiMODLR_HCIMessage& rxMsg);
+    bool                setBenchRadio(const TWiMODLR_BenchPoint& point, TWiMDLRResultCodes* hciResult, UINT8* rspStatus);
+    void                getBenchPoint(const TWiMODLR_DevMgmt_RadioConfig& radioCfg, TWiMODLR_BenchPoint* point);
+#endif
+
+#if WIMOD_LR_BASE_USE_CONCENTRATOR
+    TConcentratorRxCallback concentratorRxCB;
+#endif
+
+#if WIMOD_LR_BASE_USE_SNIFFER
+    TRadioCfg_RadioMode snifferPrevRadioMode;
+    UINT8               snifferPrevMiscOptions;
+#endif
+
     UINT8               txBuffer[WiMOD_LR_BASE_TX_BUFFER_SIZE];
 
     UINT8               localStatusRsp;
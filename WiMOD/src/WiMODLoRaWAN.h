@@ -57,6 +57,77 @@
 #include "utils/ComSLIP.h"
 #include "HCI/WiMODLRHCI.h"
 
+//-----------------------------------------------------------------------------
+// optional components
+//
+// Every component is a member of WiMODLoRaWAN and takes RAM even if it is
+// never used. Set a define to 0 (here or by a compiler flag) to leave the
+// component and its API functions out, e.g. on AVR boards with 2 KB RAM.
+//-----------------------------------------------------------------------------
+//! @cond Doxygen_Suppress
+#ifndef WIMOD_LORAWAN_USE_CONFIRMED_UPLINK
+#define WIMOD_LORAWAN_USE_CONFIRMED_UPLINK          1
+#endif
+
+#ifndef WIMOD_LORAWAN_USE_LINK_ADAPTATION
+#define WIMOD_LORAWAN_USE_LINK_ADAPTATION           1
+#endif
+
+#ifndef WIMOD_LORAWAN_USE_CONFIG_CACHE
+#define WIMOD_LORAWAN_USE_CONFIG_CACHE              1
+#endif
+
+#ifndef WIMOD_LORAWAN_USE_MAC_CMD_QUEUE
+#define WIMOD_LORAWAN_USE_MAC_CMD_QUEUE             1
+#endif
+
+#ifndef WIMOD_LORAWAN_USE_TIME_SYNC
+#define WIMOD_LORAWAN_USE_TIME_SYNC                 1
+#endif
+
+// the uplink slots are aligned to the network time
+#ifndef WIMOD_LORAWAN_USE_UPLINK_SCHEDULER
+#define WIMOD_LORAWAN_USE_UPLINK_SCHEDULER          WIMOD_LORAWAN_USE_TIME_SYNC
+#endif
+
+#ifndef WIMOD_LORAWAN_USE_POWER_POLICY
+#define WIMOD_LORAWAN_USE_POWER_POLICY              1
+#endif
+
+#ifndef WIMOD_LORAWAN_USE_PAYLOAD_PLANNER
+#define WIMOD_LORAWAN_USE_PAYLOAD_PLANNER           1
+#endif
+
+#if WIMOD_LORAWAN_USE_UPLINK_SCHEDULER && !WIMOD_LORAWAN_USE_TIME_SYNC
+#error "WIMOD_LORAWAN_USE_UPLINK_SCHEDULER requires WIMOD_LORAWAN_USE_TIME_SYNC"
+#endif
+//! @endcond
+
+#if WIMOD_LORAWAN_USE_CONFIRMED_UPLINK
+#include "LoRaWAN/WiMOD_LoRaWAN_ConfirmedUplink.h"
+#endif
+#if WIMOD_LORAWAN_USE_LINK_ADAPTATION
+#include "LoRaWAN/WiMOD_LoRaWAN_LinkAdaptation.h"
+#endif
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+#include "LoRaWAN/WiMOD_LoRaWAN_ConfigCache.h"
+#endif
+#if WIMOD_LORAWAN_USE_MAC_CMD_QUEUE
+#include "LoRaWAN/WiMOD_LoRaWAN_MacCmdQueue.h"
+#endif
+#if WIMOD_LORAWAN_USE_TIME_SYNC
+#include "LoRaWAN/WiMOD_LoRaWAN_TimeSync.h"
+#endif
+#if WIMOD_LORAWAN_USE_UPLINK_SCHEDULER
+#include "LoRaWAN/WiMOD_LoRaWAN_UplinkScheduler.h"
+#endif
+#if WIMOD_LORAWAN_USE_POWER_POLICY
+#include "LoRaWAN/WiMOD_LoRaWAN_PowerPolicy.h"
+#endif
+#if WIMOD_LORAWAN_USE_PAYLOAD_PLANNER
+#include "LoRaWAN/WiMOD_LoRaWAN_PayloadPlanner.h"
+#endif
+
 //-----------------------------------------------------------------------------
 // common defines
 //-----------------------------------------------------------------------------
@@ -131,10 +202,18 @@ public:
     bool
     convert(TWiMODLR_HCIMessage& RxMsg, TWiMODLORAWAN_RX_Data* loraWanRxData);
     bool
+    convert(const TWiMODLR_HCIMessage& RxMsg, TWiMODLORAWAN_RX_DataView* rxDataView);
+    bool
     convert(TWiMODLR_HCIMessage& rxMsg, TWiMODLORAWAN_TxIndData* sendIndData);
 
     bool
     convert(TWiMODLR_HCIMessage& RxMsg, TWiMODLORAWAN_RX_MacCmdData* loraWanMacCmdData);
+    bool
+    convert(const TWiMODLR_HCIMessage& RxMsg, TWiMODLORAWAN_RX_MacCmdView* macCmdView);
+    bool
+    convert(const TWiMODLORAWAN_RX_MacCmdView& macCmdView, TWiMODLORAWAN_LinkCheckAns* linkCheckAns);
+    bool
+    convert(const TWiMODLORAWAN_RX_MacCmdView& macCmdView, TWiMODLORAWAN_DeviceTimeAns* deviceTimeAns);
 
     bool
     convert(TWiMODLR_HCIMessage& RxMsg,TWiMODLORAWAN_RX_JoinedNwkData* joinedNwkData);
@@ -171,6 +250,27 @@ public:
 
     bool SendUData(const TWiMODLORAWAN_TX_Data* data, TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
     bool SendCData(const TWiMODLORAWAN_TX_Data* data,TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
+
+#if WIMOD_LORAWAN_USE_CONFIRMED_UPLINK
+    bool SendConfirmedUplink(const TWiMODLORAWAN_TX_Data* data, UINT16* seqID = NULL, TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
+    void SetConfirmedUplinkPolicy(const TWiMODLORAWAN_CUplinkPolicy& policy);
+    void RegisterConfirmedUplinkClient(TConfirmedUplinkCallback cb);
+    bool GetConfirmedUplinkInfo(TWiMODLORAWAN_CUplinkInfo* info);
+    void GetConfirmedUplinkStats(TWiMODLORAWAN_CUplinkStats* stats);
+#endif
+
+#if WIMOD_LORAWAN_USE_LINK_ADAPTATION
+    void SetLinkAdaptationConfig(const TWiMODLORAWAN_LinkAdaptConfig& config);
+    bool ApplyLinkAdaptation(bool* changed = NULL, TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
+    void GetLinkMetrics(TWiMODLORAWAN_LinkMetrics* metrics);
+#endif
+
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+    void EnableConfigCache(bool enable);
+    void InvalidateConfigCache(void);
+    void GetConfigCacheStats(TWiMODLORAWAN_ConfigCacheStats* stats);
+#endif
+
     bool SetRadioStackConfig(TWiMODLORAWAN_RadioStackConfig* data,TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
     bool GetRadioStackConfig(TWiMODLORAWAN_RadioStackConfig* data, TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
     bool DeactivateDevice(TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
@@ -180,6 +280,48 @@ public:
 //    bool GetNwkStatus(UINT8* nwkStatus, TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL); // implementation for spec up to  V1.13
     bool GetNwkStatus(TWiMODLORAWAN_NwkStatus_Data*	nwkStatus, TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL); // new implementation for spec. V1.14
     bool SendMacCmd(const TWiMODLORAWAN_MacCmd* cmd, TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
+#if WIMOD_LORAWAN_USE_MAC_CMD_QUEUE
+    bool QueueMacCmd(const TWiMODLORAWAN_MacCmd* cmd);
+    UINT8 GetQueuedMacCmdCount(void);
+    void ClearMacCmdQueue(void);
+    void GetMacCmdQueueStats(TWiMODLORAWAN_MacCmdQueueStats* stats);
+#endif
+
+#if WIMOD_LORAWAN_USE_TIME_SYNC
+    bool RequestDeviceTime(void);
+    bool LoadTimeFromRtc(TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
+    bool UpdateRtc(TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
+    UINT64 GetNetworkTimeMs(void);
+    UINT32 GetMsUntilSlot(UINT32 periodMs, UINT32 offsetMs = 0);
+    void GetTimeSyncInfo(TWiMODLORAWAN_TimeSyncInfo* info);
+#endif
+
+#if WIMOD_LORAWAN_USE_UPLINK_SCHEDULER
+    void SetUplinkSchedulerConfig(const TWiMODLORAWAN_SchedulerConfig& config);
+    void SetUplinkSchedulerSeed(UINT32 seed);
+    UINT32 GetMsUntilUplinkSlot(void);
+    void GetUplinkSchedulerInfo(TWiMODLORAWAN_SchedulerInfo* info);
+#endif
+
+#if WIMOD_LORAWAN_USE_POWER_POLICY
+    void SetPowerPolicyConfig(const TWiMODLORAWAN_PowerPolicyConfig& config);
+    void EnablePowerPolicy(bool enable);
+    void RequestClassC(UINT32 durationMs);
+    void ReleaseClassC(void);
+    bool ApplyPowerPolicy(bool* changed = NULL, TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
+    void GetPowerReport(TWiMODLORAWAN_PowerReport* report);
+#endif
+
+#if WIMOD_LORAWAN_USE_PAYLOAD_PLANNER
+    void SetPayloadPlannerConfig(const TWiMODLORAWAN_PlannerConfig& config);
+    bool AddPlannedRecord(const UINT8* data, UINT8 length, UINT8 priority = 0);
+    bool PlanUplinks(UINT8* numFrames = NULL, TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
+    bool GetPlannedFrameInfo(UINT8 index, TWiMODLORAWAN_PlannedFrame* info);
+    bool SendNextPlannedUplink(TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
+    UINT8 GetPlannedRecordCount(void);
+    void GetPayloadPlannerStats(TWiMODLORAWAN_PlannerStats* stats);
+#endif
+
     bool SetCustomConfig(const INT8 rfGain, TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
     bool GetCustomConfig(INT8* rfGain, TWiMDLRResultCodes* hciResult = NULL, UINT8* rspStatus = NULL);
     bool GetSupportedBands(TWiMODLORAWAN_SupportedBands* supportedBands, TWiMDLRResultCodes*  hciResult = NULL, UINT8* rspStatus = NULL);
@@ -195,6 +337,30 @@ public:
 protected:
     WiMOD_SAP_DevMgmt   SapDevMgmt;                                             /*!< Service Access Point for 'DeviceManagement' */
     WiMOD_SAP_LoRaWAN   SapLoRaWan;                                             /*!< Service Access Point for 'LoRaWAN' */
+#if WIMOD_LORAWAN_USE_CONFIRMED_UPLINK
+    WiMOD_LoRaWAN_ConfirmedUplink CUplink;                                      /*!< tracker for confirmed uplinks */
+#endif
+#if WIMOD_LORAWAN_USE_LINK_ADAPTATION
+    WiMOD_LoRaWAN_LinkAdaptation  LinkAdapt;                                    /*!< host side link adaptation */
+#endif
+#if WIMOD_LORAWAN_USE_CONFIG_CACHE
+    WiMOD_LoRaWAN_ConfigCache     ConfigCache;                                  /*!< shadow copy of the module configuration */
+#endif
+#if WIMOD_LORAWAN_USE_MAC_CMD_QUEUE
+    WiMOD_LoRaWAN_MacCmdQueue     MacCmdQueue;                                  /*!< MAC commands sent with the next uplink */
+#endif
+#if WIMOD_LORAWAN_USE_TIME_SYNC
+    WiMOD_LoRaWAN_TimeSync        TimeSync;                                     /*!< network aligned host clock */
+#endif
+#if WIMOD_LORAWAN_USE_UPLINK_SCHEDULER
+    WiMOD_LoRaWAN_UplinkScheduler Scheduler;                                    /*!< slotted uplink scheduler */
+#endif
+#if WIMOD_LORAWAN_USE_POWER_POLICY
+    WiMOD_LoRaWAN_PowerPolicy     PowerPolicy;                                  /*!< device class / power saving policy */
+#endif
+#if WIMOD_LORAWAN_USE_PAYLOAD_PLANNER
+    WiMOD_LoRaWAN_PayloadPlanner  Planner;                                      /*!< packs records into uplinks */
+#endif
 
 
     virtual void       ProcessUnexpectedRxMessage(TWiMODLR_HCIMessage& rxMsg);
@@ -203,8 +369,23 @@ protected:
     bool               copyDevMgmtResultInfos(TWiMDLRResultCodes* hciResult, UINT8* rspStatus);
 private:
     //! @cond Doxygen_Suppress
+#if WIMOD_LORAWAN_USE_CONFIRMED_UPLINK
+    void                trackConfirmedUplink(TWiMODLR_HCIMessage& rxMsg);
+#endif
+    void                trackLinkMetrics(TWiMODLR_HCIMessage& rxMsg);
+#if WIMOD_LORAWAN_USE_MAC_CMD_QUEUE
+    void                flushMacCmdQueue(void);
+#endif
+#if WIMOD_LORAWAN_USE_TIME_SYNC
+    void                trackTimeSync(TWiMODLR_HCIMessage& rxMsg);
+#endif
+
     UINT8               txBuffer[WiMOD_LORAWAN_TX_BUFFER_SIZE];
 
+#if WIMOD_LORAWAN_USE_UPLINK_SCHEDULER
+    bool                schedulerSeedSet;
+#endif
+
     UINT8               localStatusRsp;
     bool                cmdResult;
     TWiMDLRResultCodes  localHciRes;
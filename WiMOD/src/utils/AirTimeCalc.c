@@ -0,0 +1,110 @@
+//------------------------------------------------------------------------------
+//! @file AirTimeCalc.c
+//! @ingroup Utils
+//! <!------------------------------------------------------------------------->
+//! @brief Helper Utility to calc the time on air of a radio packet
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//! Implementation of time on air calculator
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+#include "AirTimeCalc.h"
+
+/**
+ * @brief Calculates the time on air of a LoRa packet (integer arithmetic)
+ *
+ * Formula according to the SX127x datasheet; the low data rate optimization
+ * is enabled automatically for symbol times >= 16 ms.
+ *
+ * @param sf             spreading factor (6..12)
+ * @param bandwidth      bandwidth in Hz
+ * @param codingRate     coding rate 1..4 (= 4/5 .. 4/8)
+ * @param preambleLen    number of programmed preamble symbols (LoRaWAN: 8)
+ * @param payloadLen     PHY payload length in bytes
+ * @param explicitHeader != 0 if the explicit header mode is used
+ * @param crcOn          != 0 if the payload CRC is enabled
+ *
+ * @retval time on air in us; 0 if the parameters are invalid
+ */
+uint32_t AirTimeCalc_LoRaUs(uint8_t sf, uint32_t bandwidth, uint8_t codingRate,
+                            uint16_t preambleLen, uint8_t payloadLen,
+                            uint8_t explicitHeader, uint8_t crcOn)
+{
+	uint32_t tSymUs;
+	int32_t  num;
+	int32_t  den;
+	int32_t  nPayload;
+	uint8_t  lowDrOpt;
+
+	if ((sf < 6) || (sf > 12) || (bandwidth == 0) || (codingRate < 1) || (codingRate > 4)) {
+		return 0;
+	}
+
+	tSymUs   = (uint32_t)(((uint64_t) 1000000 << sf) / bandwidth);
+	lowDrOpt = (tSymUs >= 16000) ? 1 : 0;
+
+	num = 8 * (int32_t) payloadLen - 4 * (int32_t) sf + 28
+	      + (crcOn ? 16 : 0) - (explicitHeader ? 0 : 20);
+	den = 4 * ((int32_t) sf - 2 * lowDrOpt);
+
+	nPayload = 8;
+	if (num > 0) {
+		// ceil(num / den) * (CR + 4)
+		nPayload += ((num + den - 1) / den) * ((int32_t) codingRate + 4);
+	}
+
+	// preamble: (n + 4.25) symbols
+	return ((uint32_t) preambleLen * 4 + 17) * tSymUs / 4 + (uint32_t) nPayload * tSymUs;
+}
+
+/**
+ * @brief Calculates the time on air of a (LoRaWAN) FSK packet
+ *
+ * preamble (5) + sync word (3) + length (1) + payload + CRC (2)
+ *
+ * @param bitRate        bit rate in bit/s
+ * @param payloadLen     PHY payload length in bytes
+ *
+ * @retval time on air in us
+ */
+uint32_t AirTimeCalc_FskUs(uint32_t bitRate, uint8_t payloadLen)
+{
+	if (bitRate == 0) {
+		return 0;
+	}
+	return (uint32_t)(((uint64_t)(5 + 3 + 1 + payloadLen + 2) * 8 * 1000000) / bitRate);
+}
+
+/**
+ * @brief Time on air of a LoRaWAN uplink without FOpts
+ *
+ * Data rate mapping of EU868 / AS923 / IN865 / RU868:
+ * DR0..DR5 = SF12..SF7 @ 125 kHz, DR6 = SF7 @ 250 kHz, DR7 = FSK 50 kbit/s
+ *
+ * @param dataRateIndex  LoRaWAN data rate index
+ * @param appPayloadLen  application payload length in bytes
+ *
+ * @retval time on air in us; 0 if the data rate is not supported
+ */
+uint32_t AirTimeCalc_LoRaWanUs(uint8_t dataRateIndex, uint8_t appPayloadLen)
+{
+	uint8_t phyLen = appPayloadLen + AIRTIME_LORAWAN_OVERHEAD;
+
+	if (dataRateIndex <= 5) {
+		return AirTimeCalc_LoRaUs(12 - dataRateIndex, 125000, 1, 8, phyLen, 1, 1);
+	}
+	if (dataRateIndex == 6) {
+		return AirTimeCalc_LoRaUs(7, 250000, 1, 8, phyLen, 1, 1);
+	}
+	if (dataRateIndex == 7) {
+		return AirTimeCalc_FskUs(50000, phyLen);
+	}
+	return 0;
+}
@@ -0,0 +1,42 @@
+//------------------------------------------------------------------------------
+//! @file AirTimeCalc.h
+//! @ingroup Utils
+//! <!------------------------------------------------------------------------->
+//! @brief Helper Utility to calc the time on air of a radio packet
+//! @version 0.1
+//! <!------------------------------------------------------------------------->
+//!
+//! Declarations for time on air calculator
+//!
+//! <!--------------------------------------------------------------------------
+//! Copyright (c) 2026
+//! RS485-XYMD-02 contributors
+//! --------------------------------------------------------------------------->
+//! @author RS485-XYMD-02 contributors
+//------------------------------------------------------------------------------
+
+#ifndef ARDUINO_UTILS_AIRTIMECALC_H_
+#define ARDUINO_UTILS_AIRTIMECALC_H_
+
+
+#include <stdint.h>
+
+/** LoRaWAN frame overhead: MHDR + DevAddr + FCtrl + FCnt + FPort + MIC */
+#define AIRTIME_LORAWAN_OVERHEAD        13
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint32_t AirTimeCalc_LoRaUs(uint8_t sf, uint32_t bandwidth, uint8_t codingRate,
+                            uint16_t preambleLen, uint8_t payloadLen,
+                            uint8_t explicitHeader, uint8_t crcOn);
+uint32_t AirTimeCalc_FskUs(uint32_t bitRate, uint8_t payloadLen);
+uint32_t AirTimeCalc_LoRaWanUs(uint8_t dataRateIndex, uint8_t appPayloadLen);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* ARDUINO_UTILS_AIRTIMECALC_H_ */
@@ -36,6 +36,15 @@
 
 #include <stdint.h>
 
+/*
+ * Same calculation as FreqCalc_calcFreqToRegister() as constant expression;
+ * for tables that are calculated by the compiler, e.g. a channel plan
+ */
+#define FREQCALC_FRF(freq)              ((uint32_t) (((uint64_t) (freq) << 19) / 32000000))
+#define FREQCALC_FRF_MSB(freq)          ((uint8_t) (FREQCALC_FRF(freq) >> 16))
+#define FREQCALC_FRF_MID(freq)          ((uint8_t) (FREQCALC_FRF(freq) >> 8))
+#define FREQCALC_FRF_LSB(freq)          ((uint8_t) (FREQCALC_FRF(freq) >> 0))
+
 #ifdef __cplusplus
 extern "C" {
 #endif